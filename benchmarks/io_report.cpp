@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <random>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "constants.hpp"
+#include "FileReaderCSV.hpp"
+#include "FileReaderMTX.hpp"
+#include "FileReaderTXT.hpp"
+#include "MemoryReport.hpp"
+#include "ParallelKernels.hpp"
+#include "PowerMethodSolver.hpp"
+
+using type_bench = double;
+
+// Repetitions of each read: the best time is kept
+const int REPETITIONS = 3;
+
+// Writes a synthetic n x n matrix in the format of a reader (csv, txt or mtx), with the given fraction of nonzero
+// entries (fixed seed). Returns the number of values the reader parses: all the entries for csv and txt, the
+// nonzero ones for mtx.
+long WriteMatrix(const std::string &path, const std::string &format, int n, double density)
+{
+    std::mt19937 generator(20240917);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    std::uniform_real_distribution<double> draw(0.0, 1.0);
+    std::ofstream file(path);
+    file << std::setprecision(17);
+    long values = 0;
+
+    if (format == "mtx")
+    {
+        // The entries are written to a buffer first: the header holds their number
+        std::ostringstream entries;
+        entries << std::setprecision(17);
+        for (int j = 0; j < n; ++j)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                if (draw(generator) < density)
+                {
+                    entries << i + 1 << " " << j + 1 << " " << value(generator) << "\n";
+                    ++values;
+                }
+            }
+        }
+        file << "%%MatrixMarket matrix coordinate real general\n"
+             << n << " " << n << " " << values << "\n"
+             << entries.str();
+        return values;
+    }
+
+    const char separator = format == "csv" ? ',' : ' ';
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            if (j > 0)
+                file << separator;
+            if (draw(generator) < density)
+                file << value(generator);
+            else
+                file << 0;
+        }
+        file << "\n";
+    }
+    return static_cast<long>(n) * n;
+}
+
+// Returns the best wall time (in ms) of a raw read() of the whole file, in blocks of 1 MiB
+double RawReadTime(const std::string &path)
+{
+    std::vector<char> buffer(1 << 20);
+    double best = 0.0;
+    for (int r = 0; r < REPETITIONS; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+            throw FileException("Failed to open file " + path);
+        while (read(descriptor, buffer.data(), buffer.size()) > 0)
+            ;
+        close(descriptor);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (r == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+// Measures of a reader on a file
+struct ReaderMeasure
+{
+    double readTime = 0.0;       // Best time of ReadFile (ms)
+    double firstIteration = 0.0; // Time from the start of the read to the end of the first power iteration (ms)
+    long peakBytes = 0;          // Peak resident bytes above the ones before the read
+};
+
+// Times a reader (best of a few reads), its peak memory and the time to the first iteration of the power method
+ReaderMeasure MeasureReader(const std::function<std::unique_ptr<FileReader<type_bench>>()> &makeReader)
+{
+    ReaderMeasure measure;
+    for (int r = 0; r < REPETITIONS; ++r)
+    {
+#ifdef __GLIBC__
+        malloc_trim(0); // Returns the memory freed by the previous reads, which would hide the peak of this one
+#endif
+        MemoryReport::ResetPeak();
+        long before = MemoryReport::ResidentBytes();
+        auto start = std::chrono::steady_clock::now();
+        MatrixPointer<type_bench> matrix = makeReader()->ReadFile();
+        auto read = std::chrono::steady_clock::now();
+        measure.peakBytes = std::max(measure.peakBytes, MemoryReport::PeakResidentBytes() - before);
+
+        // One iteration of the power method: the first result the user gets from the file
+        std::streambuf *coutBuffer = std::cout.rdbuf(nullptr);
+        std::streambuf *cerrBuffer = std::cerr.rdbuf(nullptr);
+        PowerMethodSolver<type_bench> solver(-1.0, 1, 0.0);
+        solver.SetMatrix(matrix);
+        solver.FindEigenvalues();
+        std::cout.rdbuf(coutBuffer);
+        std::cerr.rdbuf(cerrBuffer);
+        auto iterated = std::chrono::steady_clock::now();
+
+        double readTime = std::chrono::duration<double, std::milli>(read - start).count();
+        double firstIteration = std::chrono::duration<double, std::milli>(iterated - start).count();
+        if (r == 0 || readTime < measure.readTime)
+            measure.readTime = readTime;
+        if (r == 0 || firstIteration < measure.firstIteration)
+            measure.firstIteration = firstIteration;
+    }
+    return measure;
+}
+
+// Throughput of the file readers on synthetic matrices, compared with a raw read() of the same files.
+// The files are written in a temporary folder of the matrices folder (removed at the end), and are read
+// from the page cache: the raw read is the speed of the memory copy, the upper bound of a reader.
+// Usage: io_report [matrix size] [density] [number of threads]
+int main(int argc, char *argv[])
+{
+    std::vector<int> sizes = {500, 1000, 2000};
+    if (argc > 1)
+        sizes = {std::stoi(argv[1])};
+    const double density = argc > 2 ? std::stod(argv[2]) : 0.05;
+    ParallelKernels::SetNumThreads(argc > 3 ? std::stoi(argv[3]) : 1);
+
+    // The readers open the files relative to the matrices folder
+    std::string pattern = Paths::PATH_MATRICES + "io_report_XXXXXX";
+    if (mkdtemp(pattern.data()) == nullptr)
+    {
+        std::cerr << "Failed to create a temporary folder in " << Paths::PATH_MATRICES << std::endl;
+        return 1;
+    }
+    const std::string folder = pattern.substr(Paths::PATH_MATRICES.size()) + "/";
+
+    std::vector<std::string> lines;
+    try
+    {
+        for (int n : sizes)
+        {
+            for (const std::string format : {"csv", "txt", "mtx"})
+            {
+                const std::string fileName = folder + "matrix." + format;
+                const std::string path = Paths::PATH_MATRICES + fileName;
+                long values = WriteMatrix(path, format, n, density);
+                double megabytes = std::filesystem::file_size(path) * 1e-6;
+
+                double rawTime = RawReadTime(path);
+                ReaderMeasure measure = MeasureReader([&]() -> std::unique_ptr<FileReader<type_bench>>
+                                                      {
+                    if (format == "csv")
+                        return std::make_unique<FileReaderCSV<type_bench>>(fileName);
+                    if (format == "txt")
+                        return std::make_unique<FileReaderTXT<type_bench>>(fileName);
+                    return std::make_unique<FileReaderMTX<type_bench>>(fileName); });
+
+                double readerRate = megabytes / (measure.readTime * 1e-3);
+                double rawRate = megabytes / (rawTime * 1e-3);
+                std::ostringstream line;
+                line << std::setw(8) << n << std::setw(8) << format << std::fixed << std::setprecision(1)
+                     << std::setw(10) << megabytes << std::setw(12) << measure.readTime << std::setw(12) << readerRate
+                     << std::setw(14) << values / (measure.readTime * 1e-3) * 1e-6 << std::setw(12) << rawRate
+                     << std::setw(10) << 100.0 * readerRate / rawRate << " %" << std::setw(12) << measure.peakBytes * 1e-6
+                     << std::setw(14) << measure.firstIteration;
+                lines.push_back(line.str());
+                std::filesystem::remove(path);
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::filesystem::remove_all(pattern);
+        return 1;
+    }
+    std::filesystem::remove_all(pattern);
+
+    std::cout << "==== I/O REPORT ====" << std::endl;
+    std::cout << "Density: " << density << ", threads: " << ParallelKernels::GetNumThreads() << std::endl;
+    std::cout << std::setw(8) << "n" << std::setw(8) << "Format" << std::setw(10) << "Size" << std::setw(12) << "Read"
+              << std::setw(12) << "Reader" << std::setw(14) << "Values" << std::setw(12) << "read()" << std::setw(12)
+              << "Of read()" << std::setw(12) << "Peak" << std::setw(14) << "First iter." << std::endl;
+    for (const std::string &line : lines)
+        std::cout << line << std::endl;
+    std::cout << "(size and peak memory above the resident one before the read in MB, times in ms, "
+              << "throughputs in MB/s and Mvalues/s, best of " << REPETITIONS << " reads)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "constants.hpp"
+#include "InversePowerMethodSolver.hpp"
+#include "ParallelKernels.hpp"
+
+using type_bench = double;
+
+// Symmetric matrix with the eigenvalues 1, 2, ..., n and random eigenvectors
+MatrixPointer<type_bench> CreateMatrix(int n)
+{
+    Matrix<type_bench> random = Matrix<type_bench>::Random(n, n);
+    Matrix<type_bench> Q = Eigen::HouseholderQR<Matrix<type_bench>>(random).householderQ();
+    Vector<type_bench> eigenvalues = Vector<type_bench>::LinSpaced(n, 1.0, n);
+    return std::make_shared<Matrix<type_bench>>(Q * eigenvalues.asDiagonal() * Q.transpose());
+}
+
+// Solves the problem with the given factorization, returns the wall time (in s)
+double Solve(MatrixPointer<type_bench> matrix, const std::string &factorization, type_bench &eigenvalue, SolverReport &report)
+{
+    InversePowerMethodSolver<type_bench> solver(1e-12, 1000, 0.5, factorization);
+    solver.SetMatrix(matrix);
+    auto start = std::chrono::steady_clock::now();
+    eigenvalue = solver.FindEigenvalues()(0);
+    auto stop = std::chrono::steady_clock::now();
+    report = solver.GetReport();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+// Speedup of the inverse power method with a float factorization and iterative refinement,
+// compared with a double factorization (smallest eigenvalue, shift 0.5, condition number 2n)
+// Usage: refinement_report [maximum matrix size] [number of threads]
+int main(int argc, char *argv[])
+{
+    int maxSize = argc > 1 ? std::stoi(argv[1]) : 1000;
+    ParallelKernels::SetNumThreads(argc > 2 ? std::stoi(argv[2]) : 1);
+
+    std::vector<std::string> lines;
+    for (int n = 250; n <= maxSize; n *= 2)
+    {
+        MatrixPointer<type_bench> matrix = CreateMatrix(n);
+        type_bench fullEigenvalue, mixedEigenvalue;
+        SolverReport fullReport, mixedReport;
+        double fullSeconds = Solve(matrix, "full", fullEigenvalue, fullReport);
+        double mixedSeconds = Solve(matrix, "mixed", mixedEigenvalue, mixedReport);
+
+        std::ostringstream line;
+        line << std::setw(8) << n << std::fixed << std::setprecision(3)
+             << std::setw(14) << fullReport.factorizationSeconds << std::setw(14) << mixedReport.factorizationSeconds
+             << std::setw(12) << fullSeconds << std::setw(12) << mixedSeconds
+             << std::setw(10) << std::setprecision(2) << fullSeconds / mixedSeconds
+             << std::setw(12) << std::setprecision(2) << static_cast<double>(mixedReport.refinementSteps) / std::max(1, mixedReport.iterations)
+             << std::setw(14) << std::scientific << std::setprecision(1) << std::abs(mixedEigenvalue - fullEigenvalue)
+             << "  " << mixedReport.factorization;
+        lines.push_back(line.str());
+    }
+
+    std::cout << "==== MIXED-PRECISION INVERSE ITERATION REPORT ====" << std::endl;
+    std::cout << std::setw(8) << "n" << std::setw(14) << "Fact. double" << std::setw(14) << "Fact. float"
+              << std::setw(12) << "Total dbl" << std::setw(12) << "Total mixed" << std::setw(10) << "Speedup"
+              << std::setw(12) << "Steps/solve" << std::setw(14) << "|Difference|" << "  Factorization" << std::endl;
+    for (const std::string &line : lines)
+        std::cout << line << std::endl;
+    std::cout << "(times in s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "constants.hpp"
+#include "ParallelKernels.hpp"
+#include "QrMethodSolver.hpp"
+#include "JacobiSolver.hpp"
+#include "TaskScheduler.hpp"
+
+using type_bench = double;
+
+// Returns the best wall time (in ms) over a few repetitions of the kernel
+double TimeKernel(const std::function<void()> &kernel, int repetitions)
+{
+    double best = 0.0;
+    for (int r = 0; r < repetitions; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        kernel();
+        auto stop = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(stop - start).count();
+        if (r == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+// Scaling report of the parallel kernels: speedup of each kernel from 1 to N threads
+// Usage: scaling_report [matrix size] [maximum number of threads]
+int main(int argc, char *argv[])
+{
+    int n = argc > 1 ? std::stoi(argv[1]) : 2000;
+    int maxThreads = argc > 2 ? std::stoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+    // Thread counts: powers of two up to the maximum number of threads
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    Matrix<type_bench> A = Matrix<type_bench>::Random(n, n);
+    Matrix<type_bench> B = Matrix<type_bench>::Random(n, n);
+    Matrix<type_bench> C(n, n);
+    Matrix<type_bench> U = A.triangularView<Eigen::Upper>();
+    U.diagonal().array() += n; // Well-conditioned triangular matrix
+    Vector<type_bench> x = Vector<type_bench>::Random(n);
+    Vector<type_bench> y(n);
+    Vector<type_bench> v = Vector<type_bench>::Random(n).normalized();
+    Matrix<float> floatA = A.cast<float>();
+    Matrix<Eigen::half> halfA = A.cast<Eigen::half>();
+    Matrix<Eigen::bfloat16> bfloatA = A.cast<Eigen::bfloat16>();
+    Matrix<type_bench> Q(n, n);
+    Matrix<type_bench> R(n, n);
+    QrMethodSolver<type_bench> qrSolver(0.0, 1);
+    // A Jacobi sweep costs about 6 n^3 operations: it is timed on a symmetric matrix of size n / 4
+    const int jacobiSize = std::max(2, n / 4);
+    Matrix<type_bench> S = A.topLeftCorner(jacobiSize, jacobiSize) + A.topLeftCorner(jacobiSize, jacobiSize).transpose();
+    Matrix<type_bench> J(jacobiSize, jacobiSize);
+    JacobiSolver<type_bench> jacobiSolver(1e-15, 1);
+
+    std::vector<std::pair<std::string, std::function<void()>>> kernels = {
+        {"GEMV", [&]()
+         { ParallelKernels::MatVec(A, x, y); }},
+        {"GEMV + dots (fused)", [&]()
+         { type_bench xy, yy; ParallelKernels::MatVecDots<type_bench>(A, x, 0.0, y, xy, yy); }},
+        {"GEMV (float A)", [&]()
+         { ParallelKernels::MatVecMixed<type_bench, float>(floatA, x, y); }},
+        {"GEMV (half A)", [&]()
+         { ParallelKernels::MatVecMixed<type_bench, Eigen::half>(halfA, x, y); }},
+        {"GEMV (bfloat16 A)", [&]()
+         { ParallelKernels::MatVecMixed<type_bench, Eigen::bfloat16>(bfloatA, x, y); }},
+        {"GEMM", [&]()
+         { ParallelKernels::MatMul(A, B, C); }},
+        {"Reflector (left)", [&]()
+         { ParallelKernels::ApplyReflectorLeft<type_bench>(C, v); }},
+        {"Reflector (right)", [&]()
+         { ParallelKernels::ApplyReflectorRight<type_bench>(C, v); }},
+        {"Triangular solve", [&]()
+         { y = x; ParallelKernels::SolveUpperTriangular<type_bench>(U, y); }},
+        {"Tiled QR", [&]()
+         { qrSolver.TiledQrDecomposition(A, Q, R); }},
+        {"Jacobi sweep (n/4)", [&]()
+         { J = S; jacobiSolver.Sweep(J); }}};
+
+    std::cout << "==== SCALING REPORT (n = " << n << ") ====" << std::endl;
+    std::cout << std::left << std::setw(20) << "Kernel" << std::right << std::setw(10) << "Threads"
+              << std::setw(14) << "Time (ms)" << std::setw(12) << "Speedup" << std::setw(14) << "Efficiency" << std::endl;
+    for (const auto &[name, kernel] : kernels)
+    {
+        double reference = 0.0;
+        for (int threads : threadCounts)
+        {
+            ParallelKernels::SetNumThreads(threads);
+            kernel(); // Warm-up
+            double elapsed = TimeKernel(kernel, 5);
+            if (threads == 1)
+                reference = elapsed;
+            double speedup = reference / elapsed;
+            std::cout << std::left << std::setw(20) << name << std::right << std::setw(10) << threads
+                      << std::setw(14) << std::fixed << std::setprecision(3) << elapsed
+                      << std::setw(12) << std::setprecision(2) << speedup
+                      << std::setw(13) << std::setprecision(0) << 100.0 * speedup / threads << "%" << std::endl;
+        }
+    }
+
+    // Load balance of the workers for all kernels on the maximum number of threads
+    std::cout << std::endl;
+    TaskScheduler::Instance().ResetStats();
+    for (const auto &[name, kernel] : kernels)
+        TimeKernel(kernel, 5);
+    TaskScheduler::Instance().PrintUtilization();
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "constants.hpp"
+#include "SimdKernels.hpp"
+
+// Runs a kernel until it took at least 0.2 s, returns the time of one call (in s)
+double TimeKernel(const std::function<void()> &kernel)
+{
+    kernel(); // Warm-up: the arrays are in the cache
+    int repetitions = 1;
+    while (true)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repetitions; ++r)
+            kernel();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds > 0.2)
+            return seconds / repetitions;
+        repetitions *= 2;
+    }
+}
+
+// Throughput (in GFLOP/s) of the vector kernels for each instruction set supported by the processor
+template <typename T>
+void Report(int n, const std::string &type)
+{
+    Vector<T> x = Vector<T>::Random(n);
+    Vector<T> y = Vector<T>::Random(n);
+    volatile T sink = 0; // Keeps the results of the reductions alive
+
+    for (SimdKernels::Isa isa : SimdKernels::SupportedIsas())
+    {
+        SimdKernels::SetIsa(isa);
+        double dot = TimeKernel([&]()
+                                { sink = SimdKernels::Dot<T>(x.data(), y.data(), n); });
+        // The scaling factors keep the entries bounded over the repetitions
+        double axpy = TimeKernel([&]()
+                                 { SimdKernels::Axpy<T>(T(1e-3), x.data(), y.data(), n); });
+        double scale = TimeKernel([&]()
+                                  { SimdKernels::Scale<T>(T(1), y.data(), n); });
+        double absSum = TimeKernel([&]()
+                                   { sink = SimdKernels::AbsSum<T>(x.data(), n); });
+
+        std::cout << std::setw(8) << type << std::setw(10) << SimdKernels::IsaName(isa) << std::fixed << std::setprecision(2)
+                  << std::setw(10) << 2.0 * n / dot * 1e-9 << std::setw(10) << 2.0 * n / axpy * 1e-9
+                  << std::setw(10) << n / scale * 1e-9 << std::setw(10) << n / absSum * 1e-9 << std::endl;
+    }
+    SimdKernels::SetIsa(SimdKernels::DetectIsa());
+}
+
+// Usage: simd_report [vector size]
+int main(int argc, char *argv[])
+{
+    // By default, the vectors of both types fit in the L2 cache
+    int n = argc > 1 ? std::stoi(argv[1]) : 4096;
+
+    std::cout << "==== SIMD KERNELS REPORT ====" << std::endl;
+    std::cout << "Detected instruction set: " << SimdKernels::IsaName(SimdKernels::DetectIsa()) << ", n = " << n << std::endl;
+    std::cout << std::setw(8) << "Type" << std::setw(10) << "ISA" << std::setw(10) << "Dot" << std::setw(10) << "Axpy"
+              << std::setw(10) << "Scale" << std::setw(10) << "AbsSum" << std::endl;
+    Report<double>(n, "double");
+    Report<float>(n, "float");
+    std::cout << "(GFLOP/s)" << std::endl;
+    return 0;
+}
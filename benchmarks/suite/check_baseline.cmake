@@ -0,0 +1,5 @@
+# Stops benchmark_regression before the suite runs when no baseline has been recorded
+# Usage: cmake -DBASELINE=<baseline.json> -P check_baseline.cmake
+if(NOT EXISTS "${BASELINE}")
+   message(FATAL_ERROR "No benchmark baseline (${BASELINE}): run `make benchmark_baseline` first, on the reference machine, and commit the file")
+endif()
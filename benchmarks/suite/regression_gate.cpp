@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+namespace
+{
+    // Default thresholds: relative slowdown of the median, and number of standard errors of the difference of the medians
+    const double DEFAULT_THRESHOLD = 0.05;
+    const double DEFAULT_NOISE_FACTOR = 3.0;
+    // The MAD times this factor estimates the standard deviation of normally distributed times
+    const double MAD_TO_SIGMA = 1.4826;
+    // Standard error of the median of n normally distributed samples: this factor times sigma / sqrt(n)
+    const double MEDIAN_STANDARD_ERROR = 1.2533;
+    // Repetitions below which the MAD is not meaningful: only the threshold is used
+    const int MIN_REPETITIONS = 3;
+
+    // Times (ns) of the repetitions of each benchmark of a run
+    using RunTimes = std::map<std::string, std::vector<double>>;
+
+    // A run of the suite: the times of the benchmarks that ran, and the error message of those that failed
+    struct Run
+    {
+        RunTimes times;
+        std::map<std::string, std::string> errors;
+    };
+
+    // Statistics of the repetitions of a benchmark
+    struct Statistics
+    {
+        double median = 0.0;
+        double mad = 0.0; // Median absolute deviation from the median
+        int repetitions = 0;
+
+        // Estimated standard error of the median (robust to the outliers through the MAD)
+        double StandardError() const { return MEDIAN_STANDARD_ERROR * MAD_TO_SIGMA * mad / std::sqrt(repetitions); }
+    };
+
+    double Median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        const size_t middle = values.size() / 2;
+        return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+    }
+
+    Statistics ComputeStatistics(const std::vector<double> &times)
+    {
+        Statistics statistics;
+        statistics.repetitions = static_cast<int>(times.size());
+        statistics.median = Median(times);
+        std::vector<double> deviations;
+        for (double time : times)
+            deviations.push_back(std::abs(time - statistics.median));
+        statistics.mad = Median(deviations);
+        return statistics;
+    }
+
+    // Factor converting a time unit of Google Benchmark to nanoseconds
+    double UnitToNanoseconds(const std::string &unit)
+    {
+        if (unit == "us")
+            return 1e3;
+        if (unit == "ms")
+            return 1e6;
+        if (unit == "s")
+            return 1e9;
+        return 1.0;
+    }
+
+    // Reads the real times of the repetitions in a JSON output of Google Benchmark (--benchmark_out). The
+    // aggregates (mean, median...) are ignored. The benchmarks that failed (SkipWithError) are kept apart.
+    // yaml-cpp reads the JSON files: JSON is a subset of YAML.
+    Run ReadRun(const std::string &fileName)
+    {
+        YAML::Node node = YAML::LoadFile(fileName);
+        if (!node["benchmarks"])
+            throw std::runtime_error("No benchmarks in " + fileName + " (expected the JSON output of Google Benchmark)");
+        Run run;
+        for (const YAML::Node &benchmark : node["benchmarks"])
+        {
+            if (benchmark["run_type"] && benchmark["run_type"].as<std::string>() != "iteration")
+                continue;
+            const std::string name = benchmark["run_name"] ? benchmark["run_name"].as<std::string>() : benchmark["name"].as<std::string>();
+            if (benchmark["error_occurred"] && benchmark["error_occurred"].as<bool>())
+            {
+                run.errors[name] = benchmark["error_message"] ? benchmark["error_message"].as<std::string>() : "";
+                continue;
+            }
+            const std::string unit = benchmark["time_unit"] ? benchmark["time_unit"].as<std::string>() : "ns";
+            run.times[name].push_back(benchmark["real_time"].as<double>() * UnitToNanoseconds(unit));
+        }
+        // A benchmark with an error in any repetition failed
+        for (const auto &[name, message] : run.errors)
+            run.times.erase(name);
+        return run;
+    }
+
+    // Formats a time in ns with a suitable unit
+    std::string FormatTime(double nanoseconds)
+    {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(3);
+        if (nanoseconds >= 1e9)
+            text << nanoseconds * 1e-9 << " s";
+        else if (nanoseconds >= 1e6)
+            text << nanoseconds * 1e-6 << " ms";
+        else if (nanoseconds >= 1e3)
+            text << nanoseconds * 1e-3 << " us";
+        else
+            text << nanoseconds << " ns";
+        return text.str();
+    }
+}
+
+// Compares a run of the benchmark suite with a baseline run (JSON outputs of Google Benchmark, with repetitions).
+// A benchmark is slower when the median of its times grows by more than the threshold and by more than the noise
+// (noise factor times the standard error of the difference of the medians, estimated from the MADs of both runs).
+// The exit status is 1 if any benchmark is slower, failed in the current run, or is missing from it (unless
+// --allow-missing is given, e.g. for a run of a subset of the suite with --benchmark_filter).
+// Usage: regression_gate <baseline.json> <current.json> [--threshold=0.05] [--noise-factor=3] [--allow-missing]
+int main(int argc, char *argv[])
+{
+    double threshold = DEFAULT_THRESHOLD;
+    double noiseFactor = DEFAULT_NOISE_FACTOR;
+    bool allowMissing = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--threshold=", 12) == 0)
+            threshold = std::stod(argv[i] + 12);
+        else if (std::strncmp(argv[i], "--noise-factor=", 15) == 0)
+            noiseFactor = std::stod(argv[i] + 15);
+        else if (std::strcmp(argv[i], "--allow-missing") == 0)
+            allowMissing = true;
+        else
+            files.push_back(argv[i]);
+    }
+    if (files.size() != 2)
+    {
+        std::cerr << "Usage: regression_gate <baseline.json> <current.json> [--threshold=0.05] [--noise-factor=3] [--allow-missing]" << std::endl;
+        return 2;
+    }
+
+    Run baselineRun;
+    Run currentRun;
+    try
+    {
+        baselineRun = ReadRun(files[0]);
+        currentRun = ReadRun(files[1]);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+
+    const RunTimes &baseline = baselineRun.times;
+    const RunTimes &current = currentRun.times;
+    size_t nameWidth = 9;
+    for (const auto &[name, times] : current)
+        nameWidth = std::max(nameWidth, name.size());
+    for (const auto &[name, message] : currentRun.errors)
+        nameWidth = std::max(nameWidth, name.size());
+    std::cout << "==== REGRESSION GATE ====" << std::endl;
+    std::cout << "Threshold: " << 100.0 * threshold << " %, noise factor: " << noiseFactor << " standard errors" << std::endl;
+    std::cout << std::left << std::setw(nameWidth + 2) << "Benchmark" << std::right << std::setw(14) << "Baseline"
+              << std::setw(14) << "Current" << std::setw(10) << "Delta" << std::setw(10) << "Noise" << "  Status" << std::endl;
+
+    int slower = 0;
+    int faster = 0;
+    bool fewRepetitions = false;
+    for (const auto &[name, times] : current)
+    {
+        std::cout << std::left << std::setw(nameWidth + 2) << name << std::right;
+        auto reference = baseline.find(name);
+        if (reference == baseline.end())
+        {
+            std::cout << std::setw(14) << "-" << std::setw(14) << FormatTime(Median(times)) << std::setw(10) << "-"
+                      << std::setw(10) << "-" << "  new" << std::endl;
+            continue;
+        }
+
+        Statistics before = ComputeStatistics(reference->second);
+        Statistics after = ComputeStatistics(times);
+        const double delta = after.median - before.median;
+        const double noise = std::hypot(before.StandardError(), after.StandardError());
+        const bool measurable = before.repetitions >= MIN_REPETITIONS && after.repetitions >= MIN_REPETITIONS;
+        fewRepetitions |= !measurable;
+        const bool significant = std::abs(delta) > threshold * before.median && (!measurable || std::abs(delta) > noiseFactor * noise);
+
+        std::string status = "ok";
+        if (significant && delta > 0)
+        {
+            status = "SLOWER";
+            ++slower;
+        }
+        else if (significant)
+        {
+            status = "faster";
+            ++faster;
+        }
+        std::cout << std::setw(14) << FormatTime(before.median) << std::setw(14) << FormatTime(after.median) << std::fixed
+                  << std::setprecision(1) << std::setw(9) << 100.0 * delta / before.median << "%" << std::setw(9)
+                  << 100.0 * noise / before.median << "%" << "  " << status << std::endl;
+    }
+    // Failures: benchmarks that threw in the current run, and benchmarks of the baseline that did not run
+    int failed = 0;
+    for (const auto &[name, message] : currentRun.errors)
+    {
+        auto reference = baseline.find(name);
+        std::cout << std::left << std::setw(nameWidth + 2) << name << std::right << std::setw(14)
+                  << (reference != baseline.end() ? FormatTime(Median(reference->second)) : "-") << std::setw(14) << "-"
+                  << std::setw(10) << "-" << std::setw(10) << "-" << "  ERROR: " << message << std::endl;
+        ++failed;
+    }
+    int missing = 0;
+    for (const auto &[name, times] : baseline)
+    {
+        if (current.find(name) == current.end() && currentRun.errors.find(name) == currentRun.errors.end())
+        {
+            std::cout << std::left << std::setw(nameWidth + 2) << name << std::right << std::setw(14)
+                      << FormatTime(Median(times)) << std::setw(14) << "-" << std::setw(10) << "-" << std::setw(10)
+                      << "-" << (allowMissing ? "  missing" : "  MISSING") << std::endl;
+            ++missing;
+        }
+    }
+    for (const auto &[name, message] : baselineRun.errors)
+    {
+        if (current.find(name) == current.end() && currentRun.errors.find(name) == currentRun.errors.end())
+        {
+            std::cout << std::left << std::setw(nameWidth + 2) << name << std::right << std::setw(14) << "error"
+                      << std::setw(14) << "-" << std::setw(10) << "-" << std::setw(10) << "-"
+                      << (allowMissing ? "  missing" : "  MISSING") << std::endl;
+            ++missing;
+        }
+    }
+    if (!baselineRun.errors.empty())
+        std::cout << "[WARNING] " << baselineRun.errors.size() << " benchmarks failed in the baseline: record it again" << std::endl;
+
+    if (fewRepetitions)
+        std::cout << "[WARNING] Less than " << MIN_REPETITIONS << " repetitions of some benchmarks: only the threshold is used "
+                  << "(run with --benchmark_repetitions)" << std::endl;
+    std::cout << "(medians of the real times of the repetitions, noise: standard error of the difference of the medians)" << std::endl;
+    std::cout << slower << " slower, " << faster << " faster, " << failed << " failed, " << missing << " missing, of "
+              << current.size() + failed << " benchmarks" << std::endl;
+    return slower > 0 || failed > 0 || (missing > 0 && !allowMissing) ? 1 : 0;
+}
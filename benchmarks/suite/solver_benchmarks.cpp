@@ -0,0 +1,326 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BatchSolver.hpp"
+#include "constants.hpp"
+#include "FileReaderCSV.hpp"
+#include "FileReaderMTX.hpp"
+#include "FileReaderTXT.hpp"
+#include "MatrixGeneratorFactory.hpp"
+#include "ParallelKernels.hpp"
+#include "SimdKernels.hpp"
+#include "SolverFactory.hpp"
+
+namespace
+{
+    // Matrix families (functions of the "function" input type): the random ones have a fixed seed
+    const std::vector<std::string> FAMILIES = {"hilbert", "identity", "random_symmetric", "random", "laplacian"};
+
+    // Solvers, with their arguments (tolerance, maximum iterations, shift) and the sizes of the grid
+    struct SolverCase
+    {
+        std::string method;
+        std::vector<std::string> methodArgs;
+        std::vector<int> sizes;
+    };
+    const std::vector<SolverCase> SOLVERS = {
+        {"power_method", {"1e-6", "500", "0.0"}, {128, 512, 2048}},
+        {"inverse_power_method", {"1e-6", "500", "0.5"}, {128, 512, 1024}},
+        {"QR_method", {"1e-6", "200"}, {32, 64, 128}},
+        {"lanczos_method", {"1e-6", "200"}, {128, 512, 2048}},
+        {"jacobi_method", {"1e-6", "100"}, {32, 64, 128}}};
+
+    // Formats of the file readers, and the sizes of the matrices read
+    const std::vector<std::string> FORMATS = {"csv", "txt", "mtx"};
+    const std::vector<int> READ_SIZES = {256, 1024};
+
+    // Small matrices solved by the fixed-size or the dynamic-size solvers: sizes 2 to MAX_FIXED_SIZE
+    const std::vector<SolverCase> SMALL_SOLVERS = {
+        {"power_method", {"1e-6", "500", "0.0"}, {}},
+        {"QR_method", {"1e-6", "200"}, {}}};
+
+    // Batches of small matrices: number of matrices, and the sizes of the matrices
+    const int BATCH_COUNT = 4096;
+    const std::vector<int> BATCH_SIZES = {4, 8, 16};
+
+    // Estimated work of a solve: floating-point operations and bytes read or written in memory.
+    // Dominant terms of the algorithms, the same model for all the matrices of a size.
+    struct Work
+    {
+        double flops;
+        double bytes;
+    };
+
+    Work EstimateWork(const std::string &method, double n, double iterations, double scalarBytes)
+    {
+        const double matrixBytes = n * n * scalarBytes;
+        if (method == "power_method") // One product per iteration, and the first one
+            return {2 * n * n * (iterations + 1), matrixBytes * (iterations + 1)};
+        if (method == "inverse_power_method") // Factorization, then a solve (Q^T, R^-1) and a product per iteration
+            return {4.0 / 3.0 * n * n * n + 5 * n * n * iterations, matrixBytes * (2 + 2 * iterations)};
+        if (method == "QR_method") // Householder QR (R and Q) and RQ product: 16/3 n^3 per iteration
+            return {16.0 / 3.0 * n * n * n * iterations, (n / 3 + n / 2 + 3) * 2 * matrixBytes * iterations};
+        if (method == "jacobi_method") // n (n - 1) / 2 rotations per sweep (two columns and two rows, 6 n each), n - 1 rounds reading and writing the matrix twice
+            return {6 * n * n * n * iterations, 4 * n * matrixBytes * iterations};
+        // Lanczos method: a product and two Gram-Schmidt passes against the k vectors of the basis at step k
+        return {2 * n * n * iterations + 4 * n * iterations * iterations, matrixBytes * iterations + 2 * n * iterations * iterations * scalarBytes};
+    }
+
+    // Solves the problem of a family and a size at each benchmark iteration
+    template <typename T>
+    void SolveBenchmark(benchmark::State &state, const SolverCase &solverCase, const std::string &family)
+    {
+        const int n = state.range(0);
+        MatrixGeneratorFactory<T> generatorFactory("function", {family, std::to_string(n), std::to_string(n)});
+        MatrixPointer<T> matrix = generatorFactory.ChooseGenerator()->GenerateMatrix();
+        SolverFactory<T> solverFactory(solverCase.method, solverCase.methodArgs);
+        std::unique_ptr<AbstractIterativeSolver<T>> solver = solverFactory.ChooseSolver();
+
+        long iterations = 0;
+        long converged = 0;
+        for (auto _ : state)
+        {
+            solver->SetMatrix(matrix); // Not owned: the matrix is unchanged between the solves
+            try
+            {
+                benchmark::DoNotOptimize(solver->FindEigenvalues());
+            }
+            catch (const std::exception &e) // E.g. the shifted matrix is singular
+            {
+                state.SkipWithError(e.what());
+                return;
+            }
+            iterations += solver->GetReport().iterations;
+            converged += solver->GetReport().converged;
+        }
+
+        const double solves = static_cast<double>(state.iterations());
+        Work work = EstimateWork(solverCase.method, n, iterations / solves, sizeof(T));
+        state.counters["iterations"] = iterations / solves;
+        state.counters["converged"] = converged / solves;
+        state.counters["FLOPS"] = benchmark::Counter(work.flops * solves, benchmark::Counter::kIsRate);
+        state.SetBytesProcessed(static_cast<int64_t>(work.bytes * solves));
+    }
+
+    // Writes a matrix in a file of the matrices folder, in the format of a reader (all the entries for mtx)
+    template <typename T>
+    void WriteMatrixFile(const Matrix<T> &matrix, const std::string &path, const std::string &format)
+    {
+        std::ofstream file(path);
+        file << std::setprecision(17);
+        if (format == "mtx")
+        {
+            file << "%%MatrixMarket matrix coordinate real general\n"
+                 << matrix.rows() << " " << matrix.cols() << " " << matrix.size() << "\n";
+            for (int j = 0; j < matrix.cols(); ++j)
+                for (int i = 0; i < matrix.rows(); ++i)
+                    file << i + 1 << " " << j + 1 << " " << matrix(i, j) << "\n";
+            return;
+        }
+        const char separator = format == "csv" ? ',' : ' ';
+        for (int i = 0; i < matrix.rows(); ++i)
+        {
+            for (int j = 0; j < matrix.cols(); ++j)
+                file << (j > 0 ? std::string(1, separator) : "") << matrix(i, j);
+            file << "\n";
+        }
+    }
+
+    // Reads a random symmetric matrix from a file at each benchmark iteration (the file is written in the
+    // matrices folder before the first read and removed after the last one)
+    template <typename T>
+    void ReadBenchmark(benchmark::State &state, const std::string &format)
+    {
+        const int n = state.range(0);
+        MatrixGeneratorFactory<T> generatorFactory("function", {"random_symmetric", std::to_string(n), std::to_string(n)});
+        const std::string fileName = "solver_benchmarks_" + std::to_string(n) + "." + format;
+        const std::string path = Paths::PATH_MATRICES + fileName;
+        WriteMatrixFile(*generatorFactory.ChooseGenerator()->GenerateMatrix(), path, format);
+        if (!std::filesystem::exists(path))
+        {
+            state.SkipWithError(("Failed to write " + path).c_str());
+            return;
+        }
+
+        std::unique_ptr<FileReader<T>> reader;
+        if (format == "csv")
+            reader = std::make_unique<FileReaderCSV<T>>(fileName);
+        else if (format == "txt")
+            reader = std::make_unique<FileReaderTXT<T>>(fileName);
+        else
+            reader = std::make_unique<FileReaderMTX<T>>(fileName);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(reader->ReadFile());
+
+        state.counters["values"] = benchmark::Counter(static_cast<double>(n) * n * state.iterations(), benchmark::Counter::kIsRate);
+        state.SetBytesProcessed(static_cast<int64_t>(std::filesystem::file_size(path) * state.iterations()));
+        std::filesystem::remove(path);
+    }
+
+    // Solves a small Hilbert matrix at each benchmark iteration, with the solver of its size (fixed) or the
+    // general one (dynamic). The matrix is copied by the fixed-size solvers: the copy is part of the solve.
+    template <typename T>
+    void SmallSolveBenchmark(benchmark::State &state, const SolverCase &solverCase, bool fixedSize)
+    {
+        const int n = state.range(0);
+        MatrixGeneratorFactory<T> generatorFactory("function", {"hilbert", std::to_string(n), std::to_string(n)});
+        MatrixPointer<T> matrix = generatorFactory.ChooseGenerator()->GenerateMatrix();
+        SolverFactory<T> solverFactory(solverCase.method, solverCase.methodArgs);
+        std::unique_ptr<AbstractIterativeSolver<T>> solver = solverFactory.ChooseSolver(fixedSize ? n : 0);
+
+        long iterations = 0;
+        for (auto _ : state)
+        {
+            solver->SetMatrix(matrix);
+            benchmark::DoNotOptimize(solver->FindEigenvalues());
+            iterations += solver->GetReport().iterations;
+        }
+        state.counters["iterations"] = iterations / static_cast<double>(state.iterations());
+        state.SetItemsProcessed(state.iterations()); // Solves per second
+    }
+
+    // Solves a batch of random matrices at each benchmark iteration: symmetric (Jacobi kernel), or general
+    // (QR kernel) with a diagonal n, n - 1, ..., 1 and a small strictly lower part, so that the eigenvalues are real and distinct
+    template <typename T>
+    void BatchBenchmark(benchmark::State &state, const std::string &kind)
+    {
+        const int n = state.range(0);
+        MatrixBatch<T> batch(BATCH_COUNT, n);
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        for (int matrix = 0; matrix < batch.count; ++matrix)
+        {
+            T *a = batch.Data(matrix);
+            for (int i = 0; i < n; ++i)
+                for (int j = kind == "symmetric" ? i : 0; j < n; ++j)
+                {
+                    T value = static_cast<T>(distribution(generator));
+                    if (kind == "general")
+                        value = i == j ? static_cast<T>(n - i) : (j > i ? value : static_cast<T>(0.01) * value);
+                    a[i * n + j] = value;
+                    if (kind == "symmetric")
+                        a[j * n + i] = value;
+                }
+        }
+        BatchSolver<T> solver(1e-6, 200, kind);
+
+        long unconverged = 0;
+        for (auto _ : state)
+        {
+            BatchResult<T> result = solver.Solve(batch);
+            unconverged += result.Unconverged();
+            benchmark::DoNotOptimize(result.eigenvalues.data());
+        }
+        state.counters["lanes"] = BatchSolver<T>::Lanes();
+        state.counters["unconverged"] = unconverged / static_cast<double>(state.iterations());
+        state.SetItemsProcessed(static_cast<int64_t>(batch.count) * state.iterations()); // Matrices per second
+    }
+
+    template <typename T>
+    void RegisterSolverBenchmarks(const std::string &typeName)
+    {
+        for (const SolverCase &solverCase : SOLVERS)
+        {
+            for (const std::string &family : FAMILIES)
+            {
+                const std::string name = solverCase.method + "/" + typeName + "/" + family;
+                benchmark::internal::Benchmark *bench = benchmark::RegisterBenchmark(name.c_str(), SolveBenchmark<T>, solverCase, family);
+                for (int n : solverCase.sizes)
+                    bench->Arg(n);
+                bench->ArgName("n")->Unit(benchmark::kMillisecond);
+            }
+        }
+    }
+
+    template <typename T>
+    void RegisterReadBenchmarks(const std::string &typeName)
+    {
+        for (const std::string &format : FORMATS)
+        {
+            const std::string name = "read/" + typeName + "/" + format;
+            benchmark::internal::Benchmark *bench = benchmark::RegisterBenchmark(name.c_str(), ReadBenchmark<T>, format);
+            for (int n : READ_SIZES)
+                bench->Arg(n);
+            bench->ArgName("n")->Unit(benchmark::kMillisecond);
+        }
+    }
+
+    template <typename T>
+    void RegisterSmallBenchmarks(const std::string &typeName)
+    {
+        for (const SolverCase &solverCase : SMALL_SOLVERS)
+        {
+            for (bool fixedSize : {false, true})
+            {
+                const std::string name = "small/" + solverCase.method + "/" + typeName + (fixedSize ? "/fixed" : "/dynamic");
+                benchmark::internal::Benchmark *bench = benchmark::RegisterBenchmark(name.c_str(), SmallSolveBenchmark<T>, solverCase, fixedSize);
+                bench->DenseRange(2, DefaultSolverArgs::MAX_FIXED_SIZE, 1)->ArgName("n")->Unit(benchmark::kMicrosecond);
+            }
+        }
+    }
+
+    template <typename T>
+    void RegisterBatchBenchmarks(const std::string &typeName)
+    {
+        for (const std::string &kind : {"symmetric", "general"})
+        {
+            const std::string name = "batch/" + typeName + "/" + kind;
+            benchmark::internal::Benchmark *bench = benchmark::RegisterBenchmark(name.c_str(), BatchBenchmark<T>, kind);
+            for (int n : BATCH_SIZES)
+                bench->Arg(n);
+            bench->ArgName("n")->Unit(benchmark::kMillisecond);
+        }
+    }
+}
+
+// Benchmarks of the solvers over sizes, data types and matrix families, of the file readers, of the fixed-size solvers of the small matrices and of the batched solver.
+// Usage: solver_benchmarks [--threads=<number of threads>] [Google Benchmark options, e.g. --benchmark_filter=QR_method/double]
+// The number of threads is fixed (1 by default) so that the results are repeatable.
+int main(int argc, char *argv[])
+{
+    int threads = 1;
+    std::vector<char *> args;
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--threads=", 10) == 0)
+            threads = std::stoi(argv[i] + 10);
+        else
+            args.push_back(argv[i]);
+    }
+    int benchmarkArgc = static_cast<int>(args.size());
+    ParallelKernels::SetNumThreads(threads);
+    benchmark::AddCustomContext("threads", std::to_string(ParallelKernels::GetNumThreads()));
+    benchmark::AddCustomContext("vector kernels", SimdKernels::IsaName(SimdKernels::GetIsa()));
+
+    benchmark::Initialize(&benchmarkArgc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(benchmarkArgc, args.data()))
+        return 1;
+    RegisterSolverBenchmarks<float>("float");
+    RegisterSolverBenchmarks<double>("double");
+    RegisterReadBenchmarks<double>("double");
+    RegisterSmallBenchmarks<double>("double");
+    RegisterBatchBenchmarks<float>("float");
+    RegisterBatchBenchmarks<double>("double");
+
+    // The solvers print their progress: only the results are shown
+    std::ostream console(std::cout.rdbuf());
+    std::ostream errors(std::cerr.rdbuf());
+    std::cout.rdbuf(nullptr);
+    std::cerr.rdbuf(nullptr);
+    benchmark::ConsoleReporter reporter;
+    reporter.SetOutputStream(&console);
+    reporter.SetErrorStream(&errors);
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    std::cout.rdbuf(console.rdbuf());
+    std::cerr.rdbuf(errors.rdbuf());
+    benchmark::Shutdown();
+    return 0;
+}
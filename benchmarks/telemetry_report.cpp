@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "constants.hpp"
+#include "PowerMethodSolver.hpp"
+#include "ParallelKernels.hpp"
+
+using type_bench = double;
+
+// Runs a fixed number of power iterations, returns the best wall time per iteration (in ns) over a few repetitions
+double TimePerIteration(MatrixPointer<type_bench> matrix, int iterations, bool telemetry)
+{
+    // A negative tolerance is never reached: all the solves run the same number of iterations
+    PowerMethodSolver<type_bench> solver(-1.0, iterations, 0.0);
+    solver.SetMatrix(matrix);
+    if (telemetry)
+        solver.EnableTelemetry(iterations);
+    double best = 1e300;
+    for (int repetition = 0; repetition < 5; ++repetition)
+    {
+        auto start = std::chrono::steady_clock::now();
+        solver.FindEigenvalues();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, seconds * 1e9 / iterations);
+    }
+    return best;
+}
+
+// Cost of the per-iteration telemetry of the power method: not enabled at run time, and enabled.
+// Build with TELEMETRY=OFF to measure the solvers without the recording code.
+// Usage: telemetry_report [number of threads]
+int main(int argc, char *argv[])
+{
+    ParallelKernels::SetNumThreads(argc > 1 ? std::stoi(argv[1]) : 1);
+
+    std::vector<std::string> lines;
+    for (int n : {32, 128, 512, 2048})
+    {
+        MatrixPointer<type_bench> matrix = std::make_shared<Matrix<type_bench>>(Matrix<type_bench>::Random(n, n));
+        const int iterations = std::max(200, static_cast<int>(4e8 / (static_cast<double>(n) * n)));
+        double disabled = TimePerIteration(matrix, iterations, false);
+        double enabled = Telemetry::ENABLED ? TimePerIteration(matrix, iterations, true) : disabled;
+
+        std::ostringstream line;
+        line << std::setw(8) << n << std::setw(12) << iterations << std::fixed << std::setprecision(1)
+             << std::setw(16) << disabled << std::setw(16) << enabled
+             << std::setw(12) << std::setprecision(2) << 100.0 * (enabled - disabled) / disabled << " %";
+        lines.push_back(line.str());
+    }
+
+    std::cout << "==== TELEMETRY REPORT ====" << std::endl;
+    std::cout << "Recording compiled in: " << (Telemetry::ENABLED ? "yes" : "no (TELEMETRY=OFF)") << std::endl;
+    std::cout << std::setw(8) << "n" << std::setw(12) << "Iterations" << std::setw(16) << "Not enabled" << std::setw(16)
+              << "Enabled" << std::setw(14) << "Overhead" << std::endl;
+    for (const std::string &line : lines)
+        std::cout << line << std::endl;
+    std::cout << "(times in ns per iteration, best of 5 solves)" << std::endl;
+    return 0;
+}
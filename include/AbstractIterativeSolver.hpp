@@ -5,6 +5,37 @@
 #include <Eigen/Dense>
 
 #include "constants.hpp"
+#include "ConvergenceMonitor.hpp"
+#include "LinearOperator.hpp"
+#include "SolverWorkspace.hpp"
+#include "WarmStart.hpp"
+
+/**
+ * \brief Structure to hold the statistics of a run of a solver.
+ *
+ * Filled by `FindEigenvalues`. The acceleration fields are only set by the solvers
+ * offering an acceleration mode (see `PowerMethodSolver`), the factorization fields
+ * by the inverse power method (see `InversePowerMethodSolver`). The convergence fields
+ * come from the stopping test of the solver (see `ConvergenceMonitor`).
+ */
+struct SolverReport
+{
+    int iterations = 0;                 /**< Number of iterations performed */
+    bool converged = false;             /**< Whether the stopping criterion was met */
+    std::string acceleration = "none";  /**< Acceleration mode used */
+    int extraProducts = 0;              /**< Matrix-vector products outside of the iterations (e.g. spectral bounds) */
+    int iterationsSaved = 0;            /**< Estimated iterations saved compared with no acceleration (extra products included) */
+    double convergenceRate = 0.0;       /**< Estimated reduction of the eigenvalue error per iteration (0: unknown) */
+    std::string factorization = "";     /**< Factorization used by the inner solves (empty: none) */
+    double factorizationSeconds = 0.0;  /**< Time spent factorizing the matrix */
+    int refinementSteps = 0;            /**< Iterative refinement steps of all the inner solves (mixed-precision factorization) */
+    std::string stoppingCriterion = ""; /**< Stopping test used (change, residual, lower_part, subdiagonal or ritz_residual) */
+    int checkInterval = 1;              /**< Iterations between two expensive convergence checks */
+    int convergenceChecks = 0;          /**< Number of convergence checks */
+    double finalError = 0.0;            /**< Error measured by the last check */
+    bool warmStarted = false;           /**< Whether the solve started from the vectors of a warm start */
+    double warmStartChange = 0.0;       /**< Largest relative change of the eigenvalues since the estimates of the warm start */
+};
 
 /**
  * \brief Abstract base class for solving an eigenvalue problem
@@ -18,12 +49,37 @@ class AbstractIterativeSolver
 {
 public:
     /// Constructor
-    AbstractIterativeSolver(double tolerance, int maxIter) : tolerance(tolerance), maxIter(maxIter) {};
+    AbstractIterativeSolver(double tolerance, int maxIter) : monitor(tolerance), tolerance(tolerance), maxIter(maxIter) {};
     /// Destructor
     virtual ~AbstractIterativeSolver();
 
     // Public methods
+    /**
+     * \brief Sets the matrix to find eigenvalues of (also accessible through `GetOperator`).
+     *
+     * The workspace of the solver is sized for the matrix: successive solves of matrices
+     * of the same size reuse its buffers.
+     */
     void SetMatrix(MatrixPointer<T> matrix);
+    /**
+     * \brief Sets the operator used by the solvers based on matrix-vector products only.
+     *
+     * This allows to solve problems whose matrix is not stored in the memory of the
+     * calling process (e.g. distributed among several processes).
+     */
+    void SetOperator(std::shared_ptr<LinearOperator<T>> linearOperator);
+    /**
+     * \brief Hands the matrix over to the solver, which may then overwrite it (destructive mode).
+     *
+     * The solvers that copy the matrix (e.g. the QR method or the inverse power method) work in
+     * its storage instead, which lowers the peak memory of a solve by one or more copies of the
+     * matrix. The matrix is released once the eigenvalues are found: it must be set again before
+     * the next solve.
+     *
+     * \param matrix The matrix, of which the solver must be the only owner.
+     * \throws std::invalid_argument If the matrix is shared with another owner.
+     */
+    void TakeMatrix(MatrixPointer<T> &&matrix);
     /**
      * \brief Pure virtual function to find the eigenvalues of the matrix associated to the instance of the class.
      *
@@ -34,15 +90,101 @@ public:
      */
     virtual Vector<T> FindEigenvalues() = 0;
 
+    /**
+     * \brief Sets the stopping test of the power and inverse power methods (see `ConvergenceMonitor`).
+     *
+     * \throws std::invalid_argument If the criterion is unknown.
+     */
+    void SetStoppingCriterion(const std::string &criterion) { monitor.SetCriterion(criterion); }
+    /**
+     * \brief Sets the number of iterations between two expensive convergence checks.
+     *
+     * \throws std::invalid_argument If the interval is not positive.
+     */
+    void SetCheckInterval(int interval) { monitor.SetCheckInterval(interval); }
+
+    /**
+     * \brief Sets the vectors and eigenvalue estimates the next solves start from (see `WarmStart`).
+     *
+     * An empty warm start restores the default initial guess. The vectors must have the size of
+     * the matrix: this is checked by the solve (std::invalid_argument).
+     */
+    void SetWarmStart(const WarmStart<T> &warmStart) { initialGuess = warmStart; }
+    /**
+     * \brief Keeps the final vectors of the next solves, returned by `GetWarmStart`.
+     *
+     * The QR method then accumulates its Schur vectors, which costs a matrix product per iteration.
+     */
+    void SetExportVectors(bool exportVectors) { this->exportVectors = exportVectors; }
+    /// Returns the eigenvalues of the last solve, and its vectors if they are exported (see `SetExportVectors`)
+    const WarmStart<T> &GetWarmStart() const { return finalVectors; }
+
+    /**
+     * \brief Records the eigenvalue estimate, the error and the time of each iteration of the next solves.
+     *
+     * The telemetry keeps the last `capacity` iterations of the last solve (see `ConvergenceTelemetry`).
+     * Without this call, or when the telemetry is compiled out, the solvers record nothing.
+     */
+    void EnableTelemetry(int capacity = DefaultOptions::TELEMETRY_CAPACITY);
+    /// Returns the telemetry of the last solve (nullptr if not enabled)
+    const ConvergenceTelemetry<T> *GetTelemetry() const { return telemetry.get(); }
+
     // Get methods
     int GetMaxIter() const { return maxIter; }
     double GetTolerance() const { return tolerance; }
     MatrixPointer<T> GetMatrix() const;
+    std::shared_ptr<LinearOperator<T>> GetOperator() const;
+    /// Returns whether the matrix is stored in memory (set with `SetMatrix`)
+    bool HasMatrix() const { return matrixPointer != nullptr; }
+    /// Returns whether the matrix was handed over with `TakeMatrix` (and may be overwritten)
+    bool OwnsMatrix() const { return ownsMatrix; }
+    /// Returns the statistics of the last call to `FindEigenvalues`
+    const SolverReport &GetReport() const { return report; }
+    /// Prints the statistics of the last call to `FindEigenvalues`
+    void PrintReport() const;
+    /// Returns the buffers reused by the solver
+    const SolverWorkspace<T> &GetWorkspace() const { return workspace; }
+
+protected:
+    SolverReport report;          /**< Statistics of the last run, filled by the derived classes */
+    SolverWorkspace<T> workspace; /**< Buffers of the iterations, sized on SetMatrix / SetOperator */
+    ConvergenceMonitor<T> monitor; /**< Stopping test, shared by all the solvers */
+
+    /// Frees a matrix handed over with `TakeMatrix`, once a solve has consumed it
+    void ReleaseMatrix();
+    /// Copies the statistics of the stopping test into the report (the test is named after what it measured)
+    void RecordConvergence(const std::string &stoppingCriterion);
+    /// Returns whether the solve starts from the vectors of a warm start
+    bool HasWarmStart() const { return !initialGuess.Empty(); }
+    /// Returns the vectors of the warm start, checking that they have the given number of rows
+    const Matrix<T> &WarmStartVectors(int rows) const;
+    /**
+     * \brief Sets the initial vector of the vector iterations to the sum of the vectors of the warm start.
+     *
+     * Only the local rows are kept when the operator is distributed.
+     *
+     * \return Whether there was a warm start (x is left unchanged otherwise).
+     */
+    bool InitialVector(Vector<T> &x);
+    /**
+     * \brief Keeps the eigenvalues (and the vectors, if exported) of the solve for `GetWarmStart`.
+     *
+     * Also measures the change of the eigenvalues since the estimates of the warm start.
+     */
+    void RecordResult(const Vector<T> &eigenvalues, const Matrix<T> &vectors);
+    /// Returns whether the final vectors are exported (see `SetExportVectors`)
+    bool ExportsVectors() const { return exportVectors; }
 
 private:
     int maxIter;                    /**< Maximum number of iteration in the iterative method */
     double tolerance;               /**< Tolerance to stop the iterative method */
     MatrixPointer<T> matrixPointer; /**< Pointer to the matrix to find eigenvalues of */
+    std::shared_ptr<LinearOperator<T>> operatorPointer; /**< Operator applying the matrix */
+    bool ownsMatrix = false;        /**< Whether the matrix was handed over to the solver */
+    WarmStart<T> initialGuess;      /**< Vectors and eigenvalue estimates the solves start from */
+    WarmStart<T> finalVectors;      /**< Eigenvalues and vectors of the last solve */
+    bool exportVectors = false;     /**< Whether the solves keep their final vectors */
+    std::unique_ptr<ConvergenceTelemetry<T>> telemetry; /**< Per-iteration history, recorded through the monitor */
 };
 
 /**
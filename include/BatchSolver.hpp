@@ -0,0 +1,119 @@
+#ifndef __BATCH_SOLVER_HPP__
+#define __BATCH_SOLVER_HPP__
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "constants.hpp"
+
+/**
+ * \brief Many small square matrices of the same size, stored contiguously.
+ *
+ * The matrices are stored one after the other, each one row-major: there is one allocation for
+ * the whole batch instead of one per matrix.
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+struct MatrixBatch
+{
+    int count = 0;          /**< Number of matrices */
+    int size = 0;           /**< Number of rows (and columns) of each matrix */
+    std::vector<T> entries; /**< Entries, matrix after matrix, row-major (count * size * size) */
+
+    /// Constructor: a batch of zero matrices
+    MatrixBatch(int count = 0, int size = 0) : count(count), size(size), entries(static_cast<size_t>(count) * size * size) {}
+
+    /// Returns the entries of a matrix (row-major)
+    T *Data(int matrix) { return entries.data() + static_cast<size_t>(matrix) * size * size; }
+    /// Returns the entries of a matrix (row-major)
+    const T *Data(int matrix) const { return entries.data() + static_cast<size_t>(matrix) * size * size; }
+    /// Returns whether all the matrices are symmetric
+    bool IsSymmetric() const;
+
+    /**
+     * \brief Reads a batch file of the matrices folder.
+     *
+     * The file holds the number of matrices and their size, then the entries of each matrix
+     * row by row, separated by spaces or line breaks. Lines starting with `#` or `%` are comments.
+     *
+     * \throws FileException If the file can not be opened, or if it is invalid (e.g. missing entries).
+     */
+    static MatrixBatch<T> FromFile(const std::string &fileName);
+};
+
+/**
+ * \brief Eigenvalues of the matrices of a batch.
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+struct BatchResult
+{
+    Matrix<T> eigenvalues;       /**< Eigenvalues of each matrix in decreasing order, one row per matrix */
+    std::vector<int> iterations; /**< Sweeps (Jacobi) or iterations (QR) until each matrix converged */
+    std::vector<char> converged; /**< Whether each matrix converged within the maximum number of iterations */
+    std::string kernel;          /**< Kernel of the solve (jacobi or qr) */
+    int lanes = 0;               /**< Matrices solved together, one per SIMD lane */
+
+    /// Returns the number of matrices that did not converge
+    int Unconverged() const;
+    /// Writes the result as a table: one line per matrix (index, iterations, converged, eigenvalues)
+    void WriteTable(std::ostream &out) const;
+};
+
+/**
+ * \brief Solves the eigenvalue problems of a batch of small matrices (e.g. 3x3 to 16x16) with SIMD kernels.
+ *
+ * The matrices are interleaved in structure-of-arrays layout by groups of as many matrices as
+ * the SIMD registers hold (4 doubles with AVX2, 8 with AVX-512...): entry (i, j) of the matrices
+ * of a group is contiguous, so that one lane of each vector instruction handles one matrix and all
+ * the matrices of a group follow the same sequence of operations. The groups are solved in
+ * parallel by the workers of the `TaskScheduler`. The instruction set is the one of `SimdKernels`.
+ *
+ * All the eigenvalues of each matrix are computed:
+ * - symmetric matrices: cyclic Jacobi method, until the off-diagonal part is below the tolerance
+ *   relative to the Frobenius norm of the matrix (maximum iterations: sweeps);
+ * - general matrices: QR method (Householder factorization, A = RQ), until the strictly lower
+ *   part is below the tolerance relative to the Frobenius norm. As with `QrMethodSolver`, the
+ *   diagonal converges to the eigenvalues when they are real with distinct absolute values.
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class BatchSolver
+{
+public:
+    /**
+     * \brief Constructor
+     *
+     * \param tolerance The tolerance of the off-diagonal (Jacobi) or lower (QR) part, relative to the norm of the matrix.
+     * \param maxIter The maximum number of sweeps (Jacobi) or iterations (QR).
+     * \param kind The kind of the matrices: symmetric, general or auto (symmetric if all the matrices of the batch are).
+     * \throws std::invalid_argument If an argument is invalid.
+     */
+    BatchSolver(double tolerance, int maxIter, const std::string &kind = "auto");
+
+    /**
+     * \brief Creates a solver from the arguments of the method and of the `batch` input type.
+     *
+     * \param methodArgs The tolerance and the maximum number of iterations (the other arguments are not used).
+     * \param inputArgs The batch file, and optionally the kind of the matrices.
+     * \throws std::invalid_argument If the arguments are invalid.
+     */
+    static BatchSolver<T> FromArgs(const std::vector<std::string> &methodArgs, const std::vector<std::string> &inputArgs);
+
+    /// Returns the number of matrices of a group (one per SIMD lane) with the selected instruction set
+    static int Lanes();
+
+    /// Solves the eigenvalue problems of the matrices of a batch
+    BatchResult<T> Solve(const MatrixBatch<T> &batch) const;
+
+private:
+    double tolerance; /**< Tolerance of the off-diagonal or lower part, relative to the norm of the matrix */
+    int maxIter;      /**< Maximum number of sweeps or iterations */
+    std::string kind; /**< Kind of the matrices (symmetric, general or auto) */
+};
+
+#endif
@@ -5,6 +5,8 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include "constants.hpp"
+
 /**
  * \brief Sructure to hold the configuration settings parsed from a YAML file.
  *
@@ -35,6 +37,28 @@ struct Config
         std::string type;
         std::vector<std::string> outputArgs;
     } output;
+
+    /// Structure to hold the optional execution parameters
+    struct Options
+    {
+        int threads = DefaultOptions::THREADS;
+        bool utilizationReport = DefaultOptions::UTILIZATION_REPORT;
+        bool solverReport = DefaultOptions::SOLVER_REPORT;
+        bool inPlace = DefaultOptions::IN_PLACE;
+        bool memoryReport = DefaultOptions::MEMORY_REPORT;
+        std::string storage = DefaultOptions::STORAGE;
+        bool accuracyReport = DefaultOptions::ACCURACY_REPORT;
+        std::string simd = DefaultOptions::SIMD;
+        std::string stoppingCriterion = DefaultOptions::STOPPING_CRITERION;
+        int checkInterval = DefaultOptions::CHECK_INTERVAL;
+        std::string warmStart = DefaultOptions::WARM_START;
+        std::string exportVectors = DefaultOptions::EXPORT_VECTORS;
+        int sweepSegments = DefaultOptions::SWEEP_SEGMENTS;
+        std::string telemetry = DefaultOptions::TELEMETRY;
+        std::string trace = DefaultOptions::TRACE;
+        bool hardwareCounters = DefaultOptions::HARDWARE_COUNTERS;
+        bool rooflineReport = DefaultOptions::ROOFLINE_REPORT;
+    } options;
 };
 
 /**
@@ -42,7 +66,8 @@ struct Config
  *
  * This function reads a YAML configuration file, extracts the relevant
  * information. It also checks that the arguments are among the accepted
- * arguments stored in constants.hpp
+ * arguments stored in constants.hpp. The `options` section is optional:
+ * missing options keep their default value.
  *
  * \param fileName The name of the YAML configuration file to be parsed.
  * \return A Config structure containing the parsed configuration data.
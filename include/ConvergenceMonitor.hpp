@@ -0,0 +1,131 @@
+#ifndef __CONVERGENCE_MONITOR_HPP__
+#define __CONVERGENCE_MONITOR_HPP__
+
+#include <string>
+
+#include "constants.hpp"
+#include "LinearOperator.hpp"
+#include "Telemetry.hpp"
+
+/**
+ * \brief Stopping test shared by the iterative solvers.
+ *
+ * The solvers measure their error with one of the functions of the monitor, which records
+ * the last error and the number of checks. Two criteria are available for the methods
+ * computing one eigenpair (power and inverse power methods):
+ * - `change`: relative change of the eigenvalue estimate between two iterations. Cheap,
+ *   but it can stop too early when the convergence is slow, and too late when the estimate
+ *   converges faster than the tolerance can measure.
+ * - `residual`: relative residual \f$ \|A x - \lambda x\| / |\lambda| \f$ of the eigenpair.
+ *   It bounds the distance of \f$ \lambda \f$ to the spectrum (symmetric matrices).
+ *
+ * The QR method always measures the part of its iterate below the diagonal: only the
+ * subdiagonal for Hessenberg (or tridiagonal) matrices, which the QR iterations preserve.
+ *
+ * The tests that cost a pass over a vector or a matrix (residual, below-diagonal part,
+ * Ritz values of the Lanczos method) only run every `checkInterval` iterations: see
+ * `IsCheckDue`. The change of the eigenvalue is tested at every iteration.
+ *
+ * The solvers also report every iteration to `Record`, which feeds the attached telemetry (if any).
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class ConvergenceMonitor
+{
+public:
+    /**
+     * \brief Constructor
+     *
+     * \throws std::invalid_argument If the criterion is unknown or the interval is not positive.
+     */
+    ConvergenceMonitor(double tolerance,
+                       const std::string &criterion = DefaultSolverArgs::STOPPING_CRITERION,
+                       int checkInterval = DefaultSolverArgs::CHECK_INTERVAL);
+
+    /// Sets the stopping criterion (change or residual)
+    void SetCriterion(const std::string &criterion);
+    /// Sets the number of iterations between two expensive checks
+    void SetCheckInterval(int interval);
+    const std::string &GetCriterion() const { return criterion; }
+    int GetCheckInterval() const { return checkInterval; }
+    /// Returns whether the criterion is the residual of the eigenpair
+    bool UsesResidual() const { return criterion == "residual"; }
+
+    /// Forgets the checks of the previous solve (and restarts the attached telemetry)
+    void Reset();
+    /// Attaches a telemetry recording the iterations (none: nullptr)
+    void AttachTelemetry(ConvergenceTelemetry<T> *newTelemetry) { telemetry = newTelemetry; }
+    /// Records the eigenvalue estimate of an iteration and the last error in the attached telemetry (compiled out when disabled)
+    void Record(int iteration, T estimate)
+    {
+        if constexpr (Telemetry::ENABLED)
+        {
+            if (telemetry != nullptr)
+                telemetry->Record(iteration, estimate, error);
+        }
+    }
+    /// Returns whether an expensive check runs after the given iteration (every `checkInterval` iterations)
+    bool IsCheckDue(int iteration) const { return iteration % checkInterval == 0; }
+
+    /// Records an error computed by the solver and returns whether it is below the tolerance
+    bool Check(double error);
+    /// Tests the relative change \f$ |new - old| / |scale| \f$ of an eigenvalue estimate
+    bool CheckChange(T newValue, T oldValue, T scale);
+    /// Same, relative to the new value
+    bool CheckChange(T newValue, T oldValue) { return CheckChange(newValue, oldValue, newValue); }
+
+    /**
+     * \brief Tests the relative residual \f$ \|A x - \lambda x\| / (|scale| \, \|x\|) \f$.
+     *
+     * Both norms are computed in one pass, without temporary vector.
+     *
+     * \param x The local entries of the eigenvector estimate.
+     * \param Ax The local entries of the product \f$ A x \f$.
+     * \param lambda The eigenvalue estimate of the matrix of the product.
+     * \param scale The eigenvalue relative to which the residual is measured (e.g. before a shift).
+     * \param reduction The operator summing the partial norms over the processes (none: a single process).
+     */
+    bool CheckResidual(const Vector<T> &x, const Vector<T> &Ax, T lambda, T scale, LinearOperator<T> *reduction = nullptr);
+
+    /**
+     * \brief Tests the sum of the absolute values of the entries of a QR iterate below its diagonal.
+     *
+     * \param A The iterate.
+     * \param hessenberg Whether the iterate is Hessenberg: only its subdiagonal is read (n entries instead of n^2 / 2).
+     */
+    bool CheckLowerPart(const Matrix<T> &A, bool hessenberg);
+
+    /// Returns the sum of the absolute values of the entries below the diagonal
+    static T LowerTriangleSum(const Matrix<T> &A);
+    /// Returns the sum of the absolute values of the subdiagonal
+    static T SubdiagonalSum(const Matrix<T> &A);
+    /// Returns whether all the entries below the subdiagonal are zero
+    static bool IsHessenberg(const Matrix<T> &A);
+    /**
+     * \brief Returns the residual norms \f$ \|A x_i - \lambda_i x_i\| / \|x_i\| \f$ of several eigenpairs.
+     *
+     * \param A The matrix.
+     * \param eigenvalues The eigenvalues \f$ \lambda_i \f$.
+     * \param eigenvectors The eigenvectors \f$ x_i \f$, one per column.
+     */
+    static Vector<T> ResidualNorms(const Matrix<T> &A, const Vector<T> &eigenvalues, const Matrix<T> &eigenvectors);
+
+    /// Returns whether the last check passed
+    bool Converged() const { return error <= tolerance; }
+    /// Returns the error of the last check (infinite before the first one)
+    double GetError() const { return error; }
+    /// Returns the number of checks since the last `Reset`
+    int GetChecks() const { return checks; }
+
+private:
+    double tolerance;                             /**< Tolerance of the stopping test */
+    std::string criterion;                        /**< Stopping criterion (change or residual) */
+    int checkInterval;                            /**< Iterations between two expensive checks */
+    double error;                                 /**< Error of the last check */
+    int checks = 0;                               /**< Number of checks */
+    Vector<T> normsBuffer = Vector<T>(2);         /**< Partial norms of the residual check, reduced at once */
+    ConvergenceTelemetry<T> *telemetry = nullptr; /**< Telemetry recording the iterations (not owned) */
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef __DENSE_OPERATOR_HPP__
+#define __DENSE_OPERATOR_HPP__
+
+#include "LinearOperator.hpp"
+
+/**
+ * \brief Linear operator for a dense matrix stored in the memory of the calling process.
+ *
+ * The products are computed with the thread-parallel kernels (see `ParallelKernels`).
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class DenseOperator : public LinearOperator<T>
+{
+public:
+    /// Constructor
+    DenseOperator(MatrixPointer<T> matrix);
+    /// Destructor
+    ~DenseOperator() {};
+
+    int GetSize() const override { return matrix->rows(); }
+    int GetLocalRows() const override { return matrix->rows(); }
+    /// Returns the pointer to the matrix
+    const MatrixPointer<T> &GetMatrix() const { return matrix; }
+
+    /// Computes the product \f$ y = A x \f$
+    void Apply(const Vector<T> &x, Vector<T> &y) override;
+    /// Computes \f$ y = (A - \sigma I) x \f$, \f$ x^T y \f$ and \f$ y^T y \f$ in a single pass over the matrix
+    void ApplyWithDots(const Vector<T> &x, T shift, Vector<T> &y, T &xDotY, T &yDotY) override;
+
+private:
+    MatrixPointer<T> matrix; /**< Pointer to the matrix */
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef __DISTRIBUTED_OPERATOR_HPP__
+#define __DISTRIBUTED_OPERATOR_HPP__
+
+#include <vector>
+
+#include <mpi.h>
+
+#include "LinearOperator.hpp"
+
+/**
+ * \brief Linear operator for a matrix distributed by blocks of rows among MPI processes.
+ *
+ * Each process stores a block of consecutive rows of the matrix, and the entries of the
+ * vectors with the same indices. To compute its rows of \f$ y = A x \f$, a process needs the
+ * entries of x matching the nonzero columns of its block: these columns are found once, when
+ * the operator is created, and only the corresponding entries are exchanged at each product.
+ * The columns of the block are compressed accordingly, so that the product is computed on a
+ * dense matrix with only the needed columns. Dot products and norms are summed with an allreduce.
+ *
+ * The time spent in the communications and in the local products is accumulated, so that
+ * the solvers can report how they scale with the number of processes (see `PrintTimings`).
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class DistributedOperator : public LinearOperator<T>
+{
+public:
+    /// Time spent since the creation of the operator (or the last reset)
+    struct Timings
+    {
+        double computeSeconds;       /**< Time spent in the local matrix-vector products */
+        double communicationSeconds; /**< Time spent exchanging vector entries and reducing dot products */
+        long products;               /**< Number of matrix-vector products */
+        long exchangedEntries;       /**< Number of vector entries received from other processes per product */
+    };
+
+    /**
+     * \brief Constructor: analyzes the block to find the vector entries to exchange.
+     *
+     * This is a collective operation: all the processes of the communicator must call it.
+     *
+     * \param localBlock The rows of the matrix stored by the calling process (all the columns).
+     * \param firstRow The global index of the first row of the block.
+     * \param communicator The processes sharing the matrix.
+     */
+    DistributedOperator(MatrixPointer<T> localBlock, int firstRow, MPI_Comm communicator = MPI_COMM_WORLD);
+    /// Destructor
+    ~DistributedOperator() {};
+
+    /**
+     * \brief Computes the bounds of the block of rows stored by a process.
+     *
+     * The rows are split in blocks of (almost) equal size, in the order of the ranks.
+     *
+     * \param size The global number of rows.
+     * \param rank The rank of the process.
+     * \param processes The number of processes.
+     * \param firstRow First row of the block (output).
+     * \param lastRow One past the last row of the block (output).
+     */
+    static void Partition(int size, int rank, int processes, int &firstRow, int &lastRow);
+
+    int GetSize() const override { return size; }
+    int GetLocalRows() const override { return localRows; }
+    int GetFirstRow() const override { return firstRow; }
+
+    /// Computes the local rows of \f$ y = A x \f$ (collective operation)
+    void Apply(const Vector<T> &x, Vector<T> &y) override;
+    /// Sums partial results over all the processes (collective operation)
+    void Reduce(Vector<T> &values) override;
+
+    /// Returns the timings of the calling process
+    Timings GetTimings() const;
+    /// Resets the timings
+    void ResetTimings();
+    /**
+     * \brief Prints the compute and communication times (maximum over the processes).
+     *
+     * This is a collective operation: only the process of rank 0 prints.
+     */
+    void PrintTimings() const;
+
+private:
+    MPI_Comm communicator;              /**< Processes sharing the matrix */
+    int rank;                           /**< Rank of the calling process */
+    int processes;                      /**< Number of processes */
+    int size;                           /**< Global number of rows and columns */
+    int firstRow;                       /**< Global index of the first local row */
+    int localRows;                      /**< Number of local rows */
+    Matrix<T> compressedBlock;          /**< Local rows, restricted to the needed columns */
+    std::vector<int> sendIndices;       /**< Local indices of the entries sent to the other processes */
+    std::vector<int> sendCounts;        /**< Number of entries sent to each process */
+    std::vector<int> sendOffsets;       /**< Offset of the entries sent to each process */
+    std::vector<int> receiveCounts;     /**< Number of entries received from each process */
+    std::vector<int> receiveOffsets;    /**< Offset of the entries received from each process */
+    std::vector<T> sendBuffer;          /**< Entries sent to the other processes */
+    Vector<T> neededEntries;            /**< Entries of x matching the columns of the compressed block */
+    double computeSeconds = 0.0;        /**< Time spent in the local products */
+    double communicationSeconds = 0.0;  /**< Time spent in the communications */
+    long products = 0;                  /**< Number of products */
+};
+
+#endif
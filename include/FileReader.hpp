@@ -2,6 +2,10 @@
 #ifndef __FILE_READER__HH__
 #define __FILE_READER__HH__
 
+#include <fstream>
+#include <string>
+#include <vector>
+
 #include "constants.hpp"
 
 /**
@@ -32,6 +36,55 @@ public:
     virtual MatrixPointer<T> ReadFile() = 0;
 
 protected:
+    /// A range of whole lines of a file read in memory
+    struct LineRange
+    {
+        size_t begin;     /**< Offset of the first character of the range */
+        size_t end;       /**< Offset one past the last character of the range (after its last newline) */
+        size_t firstLine; /**< Index of the first line of the range in the file */
+    };
+
+    /**
+     * \brief Reads a file from the current position of the stream to its end, in a single buffer.
+     *
+     * \param file The opened file.
+     * \return The contents of the file.
+     */
+    static std::string ReadRemaining(std::ifstream &file);
+
+    /**
+     * \brief Splits a buffer into ranges of whole lines, to parse them in parallel.
+     *
+     * The boundaries of the ranges follow a newline. The lines of the ranges are counted in parallel.
+     *
+     * \param contents The buffer.
+     * \param numLines The number of lines of the buffer (output). A last line without newline counts.
+     * \return The ranges, in the order of the buffer.
+     */
+    static std::vector<LineRange> SplitLines(const std::string &contents, size_t &numLines);
+
+    /**
+     * \brief Parses a value at the beginning of the characters [begin, end) (leading spaces are skipped).
+     *
+     * \param begin First character.
+     * \param end One past the last character that can belong to the value.
+     * \param value The value (output).
+     * \param next One past the last character of the value (output).
+     * \return False if there is no value, or if it is out of the range of T.
+     */
+    static bool ParseValue(const char *begin, const char *end, T &value, const char *&next);
+
+    /**
+     * \brief Reads a dense matrix stored as one row per line, the values separated by `separator`.
+     *
+     * The file is read in a single buffer and the lines are parsed in parallel.
+     *
+     * \param separator The character separating the values of a row.
+     * \param format The name of the format, for the error messages.
+     * \return A pointer to an Eigen matrix containing the data read from the file.
+     */
+    MatrixPointer<T> ReadDelimited(char separator, const std::string &format);
+
     std::string fileName; /**< The name of the file to be read. */
 };
 
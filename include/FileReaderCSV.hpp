@@ -21,7 +21,9 @@ public:
     /// Destructor
     ~FileReaderCSV();
     /**
-     * \brief Reads the matrix data from the CSV file line-by-line and store it in an Eigen matrix object.
+     * \brief Reads the matrix data from the CSV file (one row per line) and store it in an Eigen matrix object.
+     *
+     * The file is read in a single buffer and its lines are parsed in parallel.
      *
      * \return A pointer to an Eigen matrix containing the data read from the CSV file.
      */
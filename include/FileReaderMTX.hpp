@@ -2,6 +2,8 @@
 #ifndef __FILE_READER_MTX__HH__
 #define __FILE_READER_MTX__HH__
 
+#include <fstream>
+
 #include "FileReader.hpp"
 
 /**
@@ -21,10 +23,34 @@ public:
     /// Destructor
     ~FileReaderMTX();
     /**
-     * \brief Reads the matrix data from the MTX file line-by-line and store it in an Eigen matrix object.
+     * \brief Reads the matrix data from the MTX file and store it in an Eigen matrix object.
+     *
+     * The entries are read in a single buffer and parsed in parallel. When an entry appears on several
+     * lines, the last one is kept.
      * \return A pointer to an Eigen matrix containing the data read from the MTX file.
      */
     MatrixPointer<T> ReadFile() override;
+    /**
+     * \brief Reads the number of rows and columns of the matrix from the header of the MTX file.
+     * \param numRows The number of rows (output).
+     * \param numCols The number of columns (output).
+     */
+    void ReadDimensions(size_t &numRows, size_t &numCols);
+    /**
+     * \brief Reads only the entries of a block of consecutive rows of the MTX file.
+     *
+     * The file is streamed line-by-line and the entries outside of the block are skipped,
+     * so that the memory used is proportional to the size of the block.
+     *
+     * \param firstRow The first row of the block (0-based).
+     * \param lastRow One past the last row of the block.
+     * \return A pointer to an Eigen matrix with the rows of the block (and all the columns).
+     */
+    MatrixPointer<T> ReadRowBlock(size_t firstRow, size_t lastRow);
+
+private:
+    /// Opens the MTX file and reads its header, leaving the stream on the first entry
+    void OpenFile(std::ifstream &file, size_t &numRows, size_t &numCols);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef __FIXED_SIZE_SOLVER_HPP__
+#define __FIXED_SIZE_SOLVER_HPP__
+
+#include <memory>
+#include <string>
+
+#include "AbstractIterativeSolver.hpp"
+
+/**
+ * \brief QR method on a matrix whose size is known at compile time.
+ *
+ * Same iterations, stopping test and results as `QrMethodSolver` (Householder QR decomposition,
+ * then A = RQ), but the iterate, its factors and the reflectors are `Eigen::Matrix<T, N, N>` on the
+ * stack: there is no allocation, and the loops over the rows and columns have constant bounds, so
+ * that the compiler unrolls them. The matrix is copied once at the start of the solve. Chosen by
+ * `SolverFactory` for the small matrices (see `DefaultSolverArgs::MAX_FIXED_SIZE`).
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ * \tparam N The number of rows (and columns) of the matrix.
+ */
+template <typename T, int N>
+class FixedSizeQrSolver : public AbstractIterativeSolver<T>
+{
+public:
+    /// Constructor
+    FixedSizeQrSolver(double tolerance, int maxIter) : AbstractIterativeSolver<T>(tolerance, maxIter) {}
+
+    /**
+     * \brief Finds the eigenvalues of the matrix with the QR method.
+     *
+     * \throws std::invalid_argument If the matrix is not stored in memory or is not of size N.
+     */
+    Vector<T> FindEigenvalues() override;
+};
+
+/**
+ * \brief Power method on a matrix whose size is known at compile time.
+ *
+ * Same iterations and stopping tests as `PowerMethodSolver` without acceleration, the matrix and
+ * the vectors being fixed-size Eigen types on the stack.
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ * \tparam N The number of rows (and columns) of the matrix.
+ */
+template <typename T, int N>
+class FixedSizePowerSolver : public AbstractIterativeSolver<T>
+{
+public:
+    /// Constructor
+    FixedSizePowerSolver(double tolerance, int maxIter, double shift) : AbstractIterativeSolver<T>(tolerance, maxIter), shift(shift) {}
+
+    /**
+     * \brief Finds the dominant eigenvalue of the matrix with the power method.
+     *
+     * \throws std::invalid_argument If the matrix is not stored in memory or is not of size N.
+     */
+    Vector<T> FindEigenvalues() override;
+
+private:
+    double shift; /**< Optional shift */
+};
+
+/**
+ * \brief Creates the fixed-size solver of a method for matrices of a given size.
+ *
+ * \param methodName The method: `QR_method` or `power_method` (without acceleration).
+ * \param size The number of rows of the matrices, from 2 to `DefaultSolverArgs::MAX_FIXED_SIZE`.
+ * \return The solver, or nullptr if there is no fixed-size solver of the method or of the size.
+ */
+template <typename T>
+std::unique_ptr<AbstractIterativeSolver<T>> CreateFixedSizeSolver(const std::string &methodName, int size, double tolerance, int maxIter, double shift);
+
+#endif
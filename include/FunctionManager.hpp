@@ -12,6 +12,10 @@
  * based on the input function name. Once selected, these functions can be used to generate
  * matrix elements at specified row and column positions.
  *
+ * The random matrices ("random", "random_symmetric") are generated from a hash of the indices
+ * with a fixed seed: an element does not depend on the order of generation, so that the matrix
+ * is the same for any number of threads or processes.
+ *
  * \tparam T The data type of the matrix elements (e.g. float, double).
  */
 template <typename T>
@@ -60,6 +64,36 @@ private:
      * \return The Hilbert matrix element.
      */
     T HilbertMatrix(int row, int col);
+    /**
+     * \brief Generates an element of the 1D Laplacian matrix (sparse, tridiagonal).
+     *
+     * The element at position \f$(i, j)\f$ is:
+     * \f[a_{i,j} = \begin{cases} 2 & \text{if } i = j \\
+     *                            -1 & \text{if } |i - j| = 1 \\
+     *                            0 & \text{otherwise} \end{cases} \f]
+     * Its eigenvalues \f$ 2 - 2 \cos(k \pi / (n + 1)) \f$ are known and close to each other.
+     *
+     * \param row The row index of the matrix element (\f$i\f$).
+     * \param col The column index of the matrix element (\f$j\f$).
+     * \return The Laplacian matrix element.
+     */
+    T LaplacianMatrix(int row, int col);
+    /**
+     * \brief Generates an element of a random matrix, uniform in \f$[-1, 1)\f$.
+     *
+     * \param row The row index of the matrix element.
+     * \param col The column index of the matrix element.
+     * \return The random matrix element (the same for the same indices).
+     */
+    T RandomMatrix(int row, int col);
+    /**
+     * \brief Generates an element of a random symmetric matrix, uniform in \f$[-1, 1)\f$ (\f$a_{i,j} = a_{j,i}\f$).
+     *
+     * \param row The row index of the matrix element.
+     * \param col The column index of the matrix element.
+     * \return The random matrix element (the same for the same indices).
+     */
+    T RandomSymmetricMatrix(int row, int col);
 };
 
 #endif
\ No newline at end of file
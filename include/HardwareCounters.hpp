@@ -0,0 +1,139 @@
+#ifndef __HARDWARE_COUNTERS_HPP__
+#define __HARDWARE_COUNTERS_HPP__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Process-wide hardware counters (Linux `perf_event_open`) of named regions of the kernels.
+ *
+ * When enabled, the counters (CPU time, cycles, instructions and last-level cache misses) are
+ * opened for each thread of the process, the workers of the `TaskScheduler` included: a region
+ * reads the sums over the threads at its start and at its end, so that a parallel kernel is
+ * measured on all the cores it runs on. Threads started after `Enable` are not counted.
+ *
+ * Each counter is opened on its own: the ones the system does not provide (e.g. in a virtual
+ * machine, or with a restrictive `perf_event_paranoid`) are reported as unavailable. When no
+ * counter can be opened, or on other systems, `Enable` returns false and the regions do nothing.
+ * The counts are scaled by the fraction of time each counter was scheduled (multiplexing).
+ * `Enable` and `Disable` must not be called while regions run.
+ */
+class HardwareCounters
+{
+public:
+    /// Counters measured for each region
+    enum Counter
+    {
+        CPU_TIME,     /**< Time spent on the cores by the threads (ns) */
+        CYCLES,       /**< Core cycles */
+        INSTRUCTIONS, /**< Instructions retired */
+        LLC_MISSES,   /**< Last-level cache misses (memory traffic of 64-byte lines) */
+        NUM_COUNTERS
+    };
+
+    /// Values of the counters, summed over the threads
+    using Sample = std::array<double, NUM_COUNTERS>;
+
+    /// Accumulated measures of a region
+    struct Region
+    {
+        long calls = 0;       /**< Number of times the region ran */
+        double seconds = 0.0; /**< Wall time */
+        Sample counts{};      /**< Counter increments */
+    };
+
+    /// Returns the process-wide counters
+    static HardwareCounters &Instance();
+
+    HardwareCounters(const HardwareCounters &) = delete;
+    HardwareCounters &operator=(const HardwareCounters &) = delete;
+
+    /**
+     * \brief Opens the counters for the threads of the process.
+     * \return Whether at least one counter is available (otherwise the regions do nothing).
+     */
+    bool Enable();
+    /// Closes the counters (the measures of the regions, and which counters were available, are kept)
+    void Disable();
+    /// Returns whether the regions are measured
+    bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    /// Returns whether a counter could be opened by the last call to `Enable`
+    bool IsAvailable(Counter counter) const { return available[counter]; }
+
+    /// Returns the current values of the counters, summed over the threads (0 for the unavailable ones)
+    Sample Read() const;
+    /// Adds the measures of a run of a region, between two samples
+    void AddRegion(const char *name, const Sample &start, const Sample &end, double seconds);
+    /// Returns the measures of the regions, by name
+    std::map<std::string, Region> GetRegions() const;
+    /// Forgets the measures of the regions (the counters stay open)
+    void Reset();
+    /**
+     * \brief Prints the measures of each region: time, counters and derived metrics.
+     *
+     * The derived metrics are the instructions per cycle, the memory bandwidth (64 bytes per
+     * cache miss) and the arithmetic intensity, in instructions per byte of memory traffic.
+     */
+    void PrintReport() const;
+
+private:
+    /// Constructor: the counters start closed
+    HardwareCounters() = default;
+    /// Destructor: closes the counters
+    ~HardwareCounters();
+
+    std::atomic<bool> enabled{false};                      /**< Whether the regions are measured */
+    std::array<bool, NUM_COUNTERS> available{};            /**< Whether each counter could be opened */
+    std::vector<std::array<int, NUM_COUNTERS>> descriptors; /**< Descriptors of the counters of each thread (-1 if unavailable) */
+    mutable std::mutex mutex;                              /**< Protects the measures of the regions */
+    std::map<std::string, Region> regions;                 /**< Measures of the regions, by name */
+};
+
+/**
+ * \brief Scoped region of the hardware counters: measures the counters between its construction and its destruction.
+ *
+ * Usage: `CounterRegion region("factorization");` at the start of a block. The name must be a
+ * string literal. When the counters are disabled (the default), a region only reads an atomic flag.
+ */
+class CounterRegion
+{
+public:
+    /// Constructor: reads the counters if they are enabled
+    explicit CounterRegion(const char *name) : name(name), active(HardwareCounters::Instance().IsEnabled())
+    {
+        if (active)
+        {
+            start = HardwareCounters::Instance().Read();
+            startTime = std::chrono::steady_clock::now();
+        }
+    }
+    /// Destructor: measures the region, unless it was ended before
+    ~CounterRegion() { End(); }
+
+    /// Adds the increments of the counters to the region now (for a region ending before its block)
+    void End()
+    {
+        if (active)
+        {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            HardwareCounters::Instance().AddRegion(name, start, HardwareCounters::Instance().Read(), seconds);
+        }
+        active = false;
+    }
+
+    CounterRegion(const CounterRegion &) = delete;
+    CounterRegion &operator=(const CounterRegion &) = delete;
+
+private:
+    const char *name;                                /**< Name of the region */
+    bool active;                                     /**< Whether the counters were enabled at the start, and the region not ended */
+    HardwareCounters::Sample start{};                /**< Counters at the start */
+    std::chrono::steady_clock::time_point startTime; /**< Time at the start */
+};
+
+#endif
@@ -13,26 +13,86 @@
  * When no shift is specified, this methods finds the smallest eigenvalue of the matrix.
  * Otherwise, it finds the eigenvalue closest to the shift value.
  *
+ * The shifted matrix is factorized once (\f$ (A - \sigma I) P = Q R \f$). With the `mixed`
+ * factorization, it is factorized in float, which halves the memory traffic and doubles the
+ * SIMD width of the factorization, and each inner solve recovers the accuracy of T with a
+ * few steps of iterative refinement, whose residuals are computed in T with the original
+ * matrix. When the refinement stagnates (the shifted matrix is too badly conditioned for a
+ * float factorization), the solver falls back to a factorization in T.
+ *
  * \tparam T The data type of the matrix elements (e.g. float, double).
  */
 template <typename T>
 class InversePowerMethodSolver : public AbstractIterativeSolver<T>
 {
 public:
-    /// Constructor
-    InversePowerMethodSolver(double tolerance, int maxIter, double shift);
+    /**
+     * \brief Constructor
+     *
+     * \param factorization The factorization of the shifted matrix: "full" (in T) or "mixed" (in float,
+     * with iterative refinement; same as "full" when T is float).
+     * \throws std::invalid_argument If the factorization is not supported.
+     */
+    InversePowerMethodSolver(double tolerance, int maxIter, double shift, const std::string &factorization = DefaultSolverArgs::FACTORIZATION);
     /// Destructor
     ~InversePowerMethodSolver();
 
     // public methods
     /**
      * \brief Finds the Eigenvalue of the matrix stored in matrixPointer using the inverse power method.
+     *
+     * If the solver owns the matrix (see `TakeMatrix`), the matrix is shifted and factorized in its
+     * own storage, without copy: the products with the shifted matrix are then computed from its
+     * factors, and the matrix is released at the end. With the mixed factorization, the matrix is
+     * only read (the residuals need it), and released at the end.
+     *
      * \return An Eigen vector of size (1) containing the eigenvalue found by the method.
      */
     Vector<T> FindEigenvalues() override;
 
+    /// Sets the shift of the next solves (e.g. to follow an eigenvalue along a parameter sweep)
+    void SetShift(double newShift) { shift = newShift; }
+    double GetShift() const { return shift; }
+
 private:
-    double shift; /**< Optional shift */
+    /**
+     * \brief Runs the inverse iterations.
+     *
+     * \param solve Function solving \f$ (A - \sigma I) x = b \f$, called as solve(b, x).
+     * \param multiply Function computing \f$ y = (A - \sigma I) x \f$, called as multiply(x, y).
+     * \return The last Rayleigh quotient of the shifted matrix.
+     */
+    template <typename Solve, typename Multiply>
+    T InverseIteration(Solve &&solve, Multiply &&multiply);
+    /**
+     * \brief Solves \f$ (A - \sigma I) x = b \f$ with the float factorization and iterative refinement.
+     *
+     * Falls back to (and keeps using) a factorization in T when the residual stops decreasing.
+     */
+    void SolveWithRefinement(const Matrix<T> &A, const Vector<T> &b, Vector<T> &x);
+    /// Factorizes the shifted matrix in T (full factorization, or fallback of the mixed one)
+    void FactorizeFull(const Matrix<T> &A);
+
+    /// Solves \f$ Q R P^T x = c \f$ with the factors of `qr`: c is overwritten, x is the solution
+    template <typename Decomposition, typename VectorType>
+    static void SolveFactorized(const Decomposition &qr, VectorType &c, VectorType &x);
+    /// Computes \f$ Q^T c \f$ in-place, Q being the orthogonal factor of `qr`
+    template <typename Decomposition, typename VectorType>
+    static void ApplyQTranspose(const Decomposition &qr, VectorType &c);
+    /// Computes \f$ Q c \f$ in-place, Q being the orthogonal factor of `qr`
+    template <typename Decomposition, typename VectorType>
+    static void ApplyQ(const Decomposition &qr, VectorType &c);
+
+    double shift;                                        /**< Optional shift */
+    std::string factorizationMode;                       /**< Factorization of the shifted matrix (full or mixed) */
+    Eigen::ColPivHouseholderQR<Matrix<T>> factorization; /**< Factorization of the shifted matrix, reused across solves */
+
+    // Mixed-precision factorization
+    Eigen::ColPivHouseholderQR<Matrix<float>> lowFactorization; /**< Float factorization of the shifted matrix */
+    Vector<float> lowRightHandSide;                             /**< Right-hand side of the float solves */
+    Vector<float> lowSolution;                                  /**< Solution of the float solves */
+    T matrixNorm = 0;                                           /**< Frobenius norm of the shifted matrix (refinement criterion) */
+    bool fellBack = false;                                      /**< Whether the refinement stagnated (the solves use `factorization`) */
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,75 @@
+#ifndef __JACOBI_SOLVER_HPP__
+#define __JACOBI_SOLVER_HPP__
+
+#include <utility>
+#include <vector>
+
+#include "AbstractIterativeSolver.hpp"
+
+/**
+ * \brief Class for finding all the eigenvalues of a symmetric matrix with the cyclic Jacobi method.
+ *
+ * Each rotation zeroes an off-diagonal entry (p, q) of the matrix. A sweep visits every pair
+ * (p, q) once, in the round-robin order of a tournament: the sweep is split in rounds of n / 2
+ * pairs without common index, whose rotations commute. The rotations of a round are applied
+ * together, in two passes over the columns of the matrix run in parallel by the `TaskScheduler`
+ * (first the columns p and q of each pair, then rows p and q of every column).
+ *
+ * A rotation is skipped when the entry is small relative to the diagonal:
+ * \f$ |a_{pq}| \le tol \sqrt{|a_{pp} a_{qq}|} \f$. With this test, the eigenvalues of a symmetric
+ * positive definite matrix are found with a high relative accuracy, down to the smallest ones,
+ * whereas the QR method only bounds their error relative to the largest eigenvalue. The
+ * iterations are the sweeps, and the solve has converged after a sweep without rotation (the
+ * error of the monitor is the largest ratio of the sweep). The tolerance is at least the machine
+ * epsilon of T.
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class JacobiSolver : public AbstractIterativeSolver<T>
+{
+public:
+    /// Constructor
+    JacobiSolver(double tolerance, int maxIter);
+    /// Destructor
+    ~JacobiSolver();
+
+    // Public methods
+    /**
+     * \brief Finds the eigenvalues of the matrix with the cyclic Jacobi method.
+     *
+     * If the solver owns the matrix (see `TakeMatrix`), the rotations are applied in its storage,
+     * and the matrix is released at the end. The eigenvectors are accumulated when they are
+     * exported, or when the solve starts from a warm start (the matrix is then first transformed
+     * with the orthonormalized vectors, as in the QR method).
+     *
+     * \return An Eigen vector of length equal to the number of rows of the matrix containing the
+     * eigenvalues, in decreasing order.
+     * \throws SolverException If the matrix is not symmetric.
+     */
+    Vector<T> FindEigenvalues() override;
+
+    /**
+     * \brief Performs one sweep of rotations on a symmetric matrix, in place.
+     *
+     * \param A The matrix, overwritten by J^T A J with J the product of the rotations.
+     * \param V The matrix accumulating the rotations (V J), or nullptr.
+     * \return The largest ratio \f$ |a_{pq}| / \sqrt{|a_{pp} a_{qq}|} \f$ of the sweep, before the rotations.
+     */
+    T Sweep(Matrix<T> &A, Matrix<T> *V = nullptr);
+
+    /**
+     * \brief Returns the rounds of a sweep over the pairs of indices of a matrix of size n.
+     *
+     * Round-robin tournament: the n - 1 rounds (n if n is odd) hold n / 2 pairs (p, q), p < q,
+     * without common index, and every pair appears in exactly one round.
+     */
+    static std::vector<std::vector<std::pair<int, int>>> RoundRobinPairs(int n);
+
+private:
+    std::vector<std::vector<std::pair<int, int>>> rounds; /**< Rounds of the sweeps (see `RoundRobinPairs`) */
+    int roundsSize = -1;                                  /**< Size of the matrices of the rounds */
+    std::vector<int> active;                              /**< Pairs of the current round that are rotated */
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef __LANCZOS_SOLVER_HPP__
+#define __LANCZOS_SOLVER_HPP__
+
+#include "AbstractIterativeSolver.hpp"
+
+/**
+ * \brief Class for finding eigenvalues of a symmetric matrix using the Lanczos method.
+ *
+ * This class extends the AbstractIterativeSolver base class by providing the Lanczos
+ * method, which builds an orthonormal basis of the Krylov space of the matrix one vector
+ * per iteration. The eigenvalues of the projection of the matrix on this space (a
+ * tridiagonal matrix) approximate the eigenvalues of the matrix, starting with the
+ * extreme ones. The basis is fully reorthogonalized at each iteration to avoid spurious
+ * copies of the converged eigenvalues.
+ *
+ * The method only needs matrix-vector products and dot products, so it also works on a
+ * matrix distributed among several processes (see `SetOperator`).
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class LanczosSolver : public AbstractIterativeSolver<T>
+{
+public:
+    /// Constructor
+    LanczosSolver(double tolerance, int maxIter);
+    /// Destructor
+    ~LanczosSolver();
+
+    // Public methods
+    /**
+     * \brief Finds eigenvalues of the matrix using the Lanczos method.
+     *
+     * The iterations stop when the largest and smallest eigenvalues of the tridiagonal
+     * matrix have converged (estimated residual below `tolerance` times the largest
+     * eigenvalue in magnitude), when the Krylov space is invariant, or when its
+     * dimension reaches the maximum number of iterations (or the size of the matrix).
+     *
+     * \return An Eigen vector containing the converged eigenvalues, in decreasing order.
+     */
+    Vector<T> FindEigenvalues() override;
+
+    /**
+     * \brief Runs a fixed number of Lanczos steps and returns all the eigenvalues of the tridiagonal matrix.
+     *
+     * Cheap estimate of the spectrum of a symmetric matrix, used for instance to bound the
+     * spectrum before an accelerated iteration. Stops earlier if the Krylov space is invariant.
+     *
+     * \param A The operator (the vectors only hold the entries stored by the calling process).
+     * \param steps The maximum number of steps (matrix-vector products).
+     * \param residuals The estimated residual norms of the returned values (output).
+     * \return The eigenvalues of the tridiagonal matrix (Ritz values), in increasing order.
+     */
+    static Vector<T> RitzValues(LinearOperator<T> &A, int steps, Vector<T> &residuals);
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef __LINEAR_OPERATOR_HPP__
+#define __LINEAR_OPERATOR_HPP__
+
+#include <cmath>
+
+#include "constants.hpp"
+#include "SimdKernels.hpp"
+
+/**
+ * \brief Abstract base class for the matrices seen by the iterative solvers.
+ *
+ * The solvers that only need matrix-vector products (e.g. the power method or the
+ * Lanczos method) access the matrix through this interface. The vectors passed to
+ * the operator only hold the entries stored by the calling process: the whole vector
+ * for a matrix stored in memory, or the entries of a block of rows when the matrix is
+ * distributed among several processes. Dot products must therefore be computed with
+ * `Dot`, which sums the partial results of all the processes.
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class LinearOperator
+{
+public:
+    /// Constructor
+    LinearOperator() {};
+    /// Destructor
+    virtual ~LinearOperator() {};
+
+    /// Returns the global number of rows (and columns) of the matrix
+    virtual int GetSize() const = 0;
+    /// Returns the number of rows (and vector entries) stored by the calling process
+    virtual int GetLocalRows() const = 0;
+    /// Returns the global index of the first row stored by the calling process
+    virtual int GetFirstRow() const { return 0; }
+
+    /**
+     * \brief Pure virtual function computing the product \f$ y = A x \f$.
+     *
+     * \param x The local entries of the vector to multiply.
+     * \param y The local entries of the result, resized if needed.
+     */
+    virtual void Apply(const Vector<T> &x, Vector<T> &y) = 0;
+
+    /**
+     * \brief Computes the shifted product \f$ y = (A - \sigma I) x \f$ together with the global
+     * dot products \f$ x^T y \f$ and \f$ y^T y \f$.
+     *
+     * Gives everything an iteration of the power method needs with a single product. Both dot
+     * products are reduced at once. Derived classes can override it to compute the dot products
+     * in the same pass over the matrix as the product.
+     *
+     * \param x The local entries of the vector to multiply.
+     * \param shift The shift \f$ \sigma \f$.
+     * \param y The local entries of the result, resized if needed. It must not alias x.
+     * \param xDotY The global dot product \f$ x^T y \f$ (output).
+     * \param yDotY The global squared norm \f$ y^T y \f$ (output).
+     */
+    virtual void ApplyWithDots(const Vector<T> &x, T shift, Vector<T> &y, T &xDotY, T &yDotY)
+    {
+        Apply(x, y);
+        y -= shift * x;
+        dotsBuffer << x.dot(y), y.squaredNorm();
+        Reduce(dotsBuffer);
+        xDotY = dotsBuffer(0);
+        yDotY = dotsBuffer(1);
+    }
+
+    /**
+     * \brief Sums partial results in-place over all the processes sharing the matrix.
+     *
+     * Nothing to do when the matrix is stored by a single process.
+     *
+     * \param values The partial results, overwritten by the sums.
+     */
+    virtual void Reduce(Vector<T> & /*values*/) {}
+
+    /// Returns the global dot product of two distributed vectors
+    T Dot(const Vector<T> &a, const Vector<T> &b)
+    {
+        dotBuffer(0) = SimdKernels::Dot<T>(a.data(), b.data(), a.size());
+        Reduce(dotBuffer);
+        return dotBuffer(0);
+    }
+
+    /// Returns the global Euclidean norm of a distributed vector
+    T Norm(const Vector<T> &a) { return std::sqrt(Dot(a, a)); }
+
+private:
+    // Buffers of the reductions, kept to avoid an allocation per dot product in the iteration loops
+    Vector<T> dotBuffer = Vector<T>(1);
+    Vector<T> dotsBuffer = Vector<T>(2);
+};
+
+#endif
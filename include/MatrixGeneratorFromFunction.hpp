@@ -27,6 +27,17 @@ public:
      * \return A shared pointer to an Eigen matrix of type T containing the generated data.
      */
     MatrixPointer<T> GenerateMatrix() override;
+    /**
+     * \brief Generates only a block of consecutive rows of the matrix.
+     *
+     * Used when the matrix is distributed among several processes, so that each
+     * process only allocates and computes its own rows.
+     *
+     * \param firstRow The first row of the block.
+     * \param lastRow One past the last row of the block.
+     * \return A shared pointer to an Eigen matrix with the rows of the block (and all the columns).
+     */
+    MatrixPointer<T> GenerateRowBlock(int firstRow, int lastRow);
 
 private:
     int nbRows;                                   /**< The number of rows in the generated matrix. */
@@ -0,0 +1,50 @@
+#ifndef __MEMORY_REPORT_HPP__
+#define __MEMORY_REPORT_HPP__
+
+#include <string>
+#include <vector>
+
+/**
+ * \brief Class measuring the resident memory of the process during the phases of a run.
+ *
+ * The resident set size and its peak are read from `/proc/self/status` (Linux). The peak
+ * is reset at the start of each phase (through `/proc/self/clear_refs`), so that the peak of
+ * a phase does not include the one of the previous phases. When the reset is not permitted,
+ * the reported peak is the peak of the process since its start, an upper bound.
+ * On other systems, the measurements are zero.
+ */
+class MemoryReport
+{
+public:
+    /// Statistics of a phase
+    struct Phase
+    {
+        std::string name;     /**< Name of the phase */
+        long startBytes = 0;  /**< Resident bytes at the start of the phase */
+        long endBytes = 0;    /**< Resident bytes at the end of the phase */
+        long peakBytes = 0;   /**< Peak resident bytes during the phase */
+        bool peakReset = false; /**< Whether the peak only covers the phase (see the class description) */
+    };
+
+    /// Starts a new phase, ending the current one if any
+    void StartPhase(const std::string &name);
+    /// Ends the current phase (nothing to do if no phase is running)
+    void EndPhase();
+    /// Returns the phases measured so far
+    const std::vector<Phase> &GetPhases() const { return phases; }
+    /// Prints the resident memory of each phase
+    void Print() const;
+
+    /// Returns the resident bytes of the process (VmRSS), or 0 if unknown
+    static long ResidentBytes();
+    /// Returns the peak resident bytes of the process since the last reset (VmHWM), or 0 if unknown
+    static long PeakResidentBytes();
+    /// Resets the peak resident bytes to the current ones; returns false if not permitted
+    static bool ResetPeak();
+
+private:
+    std::vector<Phase> phases; /**< Measured phases, in order */
+    bool running = false;      /**< Whether the last phase is still running */
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef __MIXED_PRECISION_OPERATOR_HPP__
+#define __MIXED_PRECISION_OPERATOR_HPP__
+
+#include <string>
+
+#include "LinearOperator.hpp"
+
+/**
+ * \brief Linear operator for a dense matrix stored in a smaller type than the computations.
+ *
+ * The matrix-vector products of the power and Lanczos methods are limited by the memory
+ * bandwidth: each product reads the whole matrix once. Storing the matrix in float (for double
+ * computations), or in 16-bit floating point types (Eigen::half, Eigen::bfloat16), reduces the
+ * data read by each product by a factor of 2 to 4. The entries are converted to T as they are
+ * loaded and all the sums are computed in T (see `ParallelKernels::MatVecMixed`): the only error
+ * introduced is the rounding of the matrix entries, i.e. a perturbation of relative size the unit
+ * roundoff of S (about 6e-8 for float, 5e-4 for half and 4e-3 for bfloat16).
+ *
+ * \tparam T The data type of the computations (float or double).
+ * \tparam S The storage type of the matrix entries (float, Eigen::half or Eigen::bfloat16).
+ */
+template <typename T, typename S>
+class MixedPrecisionOperator : public LinearOperator<T>
+{
+public:
+    /**
+     * \brief Constructor: converts the matrix to the storage type.
+     *
+     * The conversion is done once, in parallel over blocks of columns: the full-precision
+     * matrix can be freed afterwards.
+     */
+    MixedPrecisionOperator(const Matrix<T> &matrix);
+    /// Destructor
+    ~MixedPrecisionOperator() {};
+
+    int GetSize() const override { return matrix.rows(); }
+    int GetLocalRows() const override { return matrix.rows(); }
+
+    /// Computes the product \f$ y = A x \f$, accumulated in T
+    void Apply(const Vector<T> &x, Vector<T> &y) override;
+
+private:
+    Matrix<S> matrix; /**< The matrix, in the storage type */
+};
+
+/**
+ * \brief Creates the operator of a matrix stored in the given storage type.
+ *
+ * \param matrix The matrix, in full precision.
+ * \param storage The storage type (see `SupportedArguments::SUPPORTED_STORAGE_TYPES`). With "full",
+ * or a storage type equal to T, the matrix is used as is (see `DenseOperator`).
+ * \return The operator. It does not keep a reference to the matrix, unless it is used as is.
+ * \throws std::invalid_argument If the storage type is not supported.
+ */
+template <typename T>
+std::shared_ptr<LinearOperator<T>> CreateStorageOperator(MatrixPointer<T> matrix, const std::string &storage);
+
+/**
+ * \brief Returns the size in bytes of a matrix entry in the given storage type.
+ *
+ * \param storage The storage type (see `SupportedArguments::SUPPORTED_STORAGE_TYPES`).
+ * \param fullBytes The size of an entry in full precision.
+ */
+int StorageBytes(const std::string &storage, int fullBytes);
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef __OUT_OF_CORE_OPERATOR_HPP__
+#define __OUT_OF_CORE_OPERATOR_HPP__
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "LinearOperator.hpp"
+
+/**
+ * \brief Linear operator for a matrix stored on disk, too large to be loaded in memory.
+ *
+ * The matrix is stored in a tiled binary file (see `WriteTiledFile`): square tiles of
+ * `tileSize` x `tileSize` entries, stored tile row after tile row, each tile in column-major
+ * order. A tile row (a panel of `tileSize` rows) is contiguous in the file.
+ *
+ * Each product streams the panels through a window of two buffers: while the product
+ * with one panel is computed, the next panel is read asynchronously into the other buffer.
+ * The memory used is thus bounded by two panels, whatever the size of the matrix.
+ *
+ * The amount of data read, the time spent reading and the time the products waited for
+ * the reads are accumulated (see `PrintIoReport`).
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class OutOfCoreOperator : public LinearOperator<T>
+{
+public:
+    /// I/O counters since the creation of the operator (or the last reset)
+    struct IoStats
+    {
+        std::uint64_t bytesRead; /**< Amount of data read from the file */
+        double readSeconds;      /**< Time spent reading (in the background) */
+        double waitSeconds;      /**< Time the products waited for a panel to be read */
+        double applySeconds;     /**< Total time of the products */
+        long products;           /**< Number of matrix-vector products */
+    };
+
+    /**
+     * \brief Constructor: opens the tiled file and allocates the two panel buffers.
+     * \param fileName The name of the tiled file (in the folder of the matrices).
+     */
+    OutOfCoreOperator(const std::string &fileName);
+    /// Destructor: waits for the pending read and closes the file
+    ~OutOfCoreOperator();
+
+    OutOfCoreOperator(const OutOfCoreOperator &) = delete;
+    OutOfCoreOperator &operator=(const OutOfCoreOperator &) = delete;
+
+    /**
+     * \brief Writes a matrix in the tiled format, one panel of rows at a time.
+     *
+     * \param fileName The name of the tiled file (in the folder of the matrices).
+     * \param size The number of rows (and columns) of the matrix.
+     * \param tileSize The size of the tiles.
+     * \param rowBlock Function returning the rows [first, last) of the matrix (all the columns).
+     */
+    static void WriteTiledFile(const std::string &fileName, int size, int tileSize,
+                               const std::function<MatrixPointer<T>(int, int)> &rowBlock);
+
+    int GetSize() const override { return size; }
+    int GetLocalRows() const override { return size; }
+    /// Returns the size of the tiles of the file
+    int GetTileSize() const { return tileSize; }
+
+    /// Computes the product \f$ y = A x \f$ by streaming the panels of the file
+    void Apply(const Vector<T> &x, Vector<T> &y) override;
+
+    /// Returns the I/O counters
+    IoStats GetIoStats() const { return stats; }
+    /// Resets the I/O counters
+    void ResetIoStats();
+    /// Prints the read bandwidth and the fraction of the time spent waiting for the reads
+    void PrintIoReport() const;
+
+private:
+    /// Reads the panel `panel` into `buffer` (executed in the background)
+    void ReadPanel(int panel, std::vector<T> &buffer);
+    /// Number of rows of the panel `panel` (the last one may be smaller)
+    int PanelRows(int panel) const;
+
+    std::string fileName;              /**< Name of the tiled file */
+    int fileDescriptor = -1;           /**< File opened for the reads */
+    int size;                          /**< Number of rows and columns */
+    int tileSize;                      /**< Size of the tiles */
+    int panels;                        /**< Number of tile rows */
+    std::vector<T> buffers[2];         /**< Window of two panels */
+    std::future<double> pendingRead;   /**< Read in progress (returns its duration) */
+    IoStats stats = {0, 0.0, 0.0, 0.0, 0}; /**< I/O counters */
+};
+
+#endif
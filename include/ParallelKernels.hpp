@@ -0,0 +1,173 @@
+#ifndef __PARALLEL_KERNELS_HPP__
+#define __PARALLEL_KERNELS_HPP__
+
+#include <Eigen/Dense>
+
+#include "constants.hpp"
+
+/**
+ * \brief Namespace for the thread-parallel dense kernels used by the solvers.
+ *
+ * The kernels split the work into contiguous blocks of rows (or columns), one per
+ * thread, and execute them on the process-wide `TaskScheduler` with `ParallelForParts`:
+ * block p is always computed by the worker p. Large row blocks are aligned on memory pages,
+ * so that no page is shared between two blocks: combined with the first-touch initialization
+ * of the matrix by the same blocks (see `MatrixGeneratorFromFunction`), the pages of a block
+ * are allocated on the NUMA node of the thread that uses them.
+ */
+namespace ParallelKernels
+{
+    /**
+     * \brief Sets the number of threads used by the kernels (number of workers of the `TaskScheduler`).
+     *
+     * \param threads The number of threads. A value of 0 selects all available cores.
+     */
+    void SetNumThreads(int threads);
+
+    /// Returns the number of threads used by the kernels.
+    int GetNumThreads();
+
+    /**
+     * \brief Computes the bounds of the block `part` when `size` rows are split in `parts` blocks.
+     *
+     * The boundaries between blocks are multiples of `align`, except the last one.
+     *
+     * \param size The number of rows to split.
+     * \param parts The number of blocks.
+     * \param align The alignment of the block boundaries.
+     * \param part The index of the block.
+     * \param begin First row of the block (output).
+     * \param end One past the last row of the block (output).
+     */
+    void Partition(int size, int parts, int align, int part, int &begin, int &end);
+
+    /**
+     * \brief Returns the alignment (in number of rows) of the row blocks used by the kernels.
+     *
+     * Large matrices are split on memory page boundaries, smaller ones on cache lines.
+     *
+     * \param rows The number of rows of the matrix.
+     */
+    template <typename T>
+    int RowAlignment(int rows);
+
+    /**
+     * \brief Matrix-vector product \f$ y = A x \f$, parallelized over blocks of rows.
+     *
+     * \param A The matrix.
+     * \param x The vector to multiply.
+     * \param y The result, resized if needed.
+     */
+    template <typename T>
+    void MatVec(const Matrix<T> &A, const Vector<T> &x, Vector<T> &y);
+
+    /**
+     * \brief Fused shifted matrix-vector product and dot products, in a single pass over A:
+     * \f$ y = (A - \sigma I) x \f$, \f$ x^T y \f$ and \f$ y^T y \f$.
+     *
+     * The dot products of each block of rows are computed right after the block of y,
+     * while it is still in cache. The partial results of the blocks are summed in order,
+     * so that the result does not depend on the scheduling.
+     *
+     * \param A The matrix.
+     * \param x The vector to multiply.
+     * \param shift The shift \f$ \sigma \f$.
+     * \param y The result, resized if needed. It must not alias x.
+     * \param xDotY The dot product \f$ x^T y \f$ (output).
+     * \param yDotY The squared norm \f$ y^T y \f$ (output).
+     */
+    template <typename T>
+    void MatVecDots(const Matrix<T> &A, const Vector<T> &x, T shift, Vector<T> &y, T &xDotY, T &yDotY);
+
+    /**
+     * \brief Mixed-precision matrix-vector product \f$ y = A x \f$: A is stored in a smaller type S
+     * (e.g. float, Eigen::half or Eigen::bfloat16), the products and sums are computed in T.
+     *
+     * The product streams the matrix from memory, so its time is proportional to the size of
+     * the matrix entries: a smaller storage type reads less data. Each entry is converted to T
+     * right after it is loaded. The blocks of rows are split in small chunks, whose entries of
+     * y stay in cache while the columns of the matrix are streamed.
+     *
+     * \param A The matrix, stored in type S.
+     * \param x The vector to multiply.
+     * \param y The result, resized if needed.
+     */
+    template <typename T, typename S>
+    void MatVecMixed(const Matrix<S> &A, const Vector<T> &x, Vector<T> &y);
+
+    /**
+     * \brief Matrix-matrix product \f$ C = A B \f$, parallelized over blocks of columns of C.
+     *
+     * \param A The left matrix.
+     * \param B The right matrix.
+     * \param C The result, resized if needed. It must not alias A or B.
+     */
+    template <typename T>
+    void MatMul(const Matrix<T> &A, const Matrix<T> &B, Matrix<T> &C);
+
+    /**
+     * \brief Computes the matrix-matrix product \f$ A = A B \f$ in-place, for a square matrix B.
+     *
+     * Each row of the result only depends on the same row of A, so the blocks of rows are
+     * distributed among the threads and computed in a small buffer per thread (a few rows),
+     * instead of a full copy of the result.
+     *
+     * \param A The left factor, overwritten by the product. It must not alias B.
+     * \param B The right factor.
+     */
+    template <typename T>
+    void MatMulInPlace(Matrix<T> &A, const Matrix<T> &B);
+
+    /**
+     * \brief Applies the Householder reflector \f$ P = I - 2 v v^T \f$ from the left: \f$ R = P R \f$.
+     *
+     * The columns of R are independent and are distributed among the threads.
+     *
+     * \param R The (sub)matrix to update in-place.
+     * \param v The normalized Householder vector.
+     */
+    template <typename T>
+    void ApplyReflectorLeft(Eigen::Ref<Matrix<T>> R, const Eigen::Ref<const Vector<T>> &v);
+
+    /**
+     * \brief Same as above, with a caller-provided buffer for \f$ v^T R \f$ (no allocation).
+     *
+     * \param work Buffer of size `R.cols()`, overwritten.
+     */
+    template <typename T>
+    void ApplyReflectorLeft(Eigen::Ref<Matrix<T>> R, const Eigen::Ref<const Vector<T>> &v, Eigen::Ref<Vector<T>> work);
+
+    /**
+     * \brief Applies the Householder reflector \f$ P = I - 2 v v^T \f$ from the right: \f$ Q = Q P \f$.
+     *
+     * The rows of Q are independent and are distributed among the threads.
+     *
+     * \param Q The (sub)matrix to update in-place.
+     * \param v The normalized Householder vector.
+     */
+    template <typename T>
+    void ApplyReflectorRight(Eigen::Ref<Matrix<T>> Q, const Eigen::Ref<const Vector<T>> &v);
+
+    /**
+     * \brief Same as above, with a caller-provided buffer for \f$ Q v \f$ (no allocation).
+     *
+     * \param work Buffer of size `Q.rows()`, overwritten.
+     */
+    template <typename T>
+    void ApplyReflectorRight(Eigen::Ref<Matrix<T>> Q, const Eigen::Ref<const Vector<T>> &v, Eigen::Ref<Vector<T>> work);
+
+    /**
+     * \brief Solves the upper triangular system \f$ U x = b \f$ in-place.
+     *
+     * The system is solved by blocks, starting from the bottom. After each diagonal
+     * block is solved, the update of the remaining right-hand side is parallelized
+     * over blocks of rows.
+     *
+     * \param U The upper triangular matrix (only the upper part is read).
+     * \param b The right-hand side, overwritten by the solution.
+     */
+    template <typename T>
+    void SolveUpperTriangular(const Eigen::Ref<const Matrix<T>> &U, Eigen::Ref<Vector<T>> b);
+}
+
+#endif
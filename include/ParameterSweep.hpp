@@ -0,0 +1,83 @@
+#ifndef __PARAMETER_SWEEP_HPP__
+#define __PARAMETER_SWEEP_HPP__
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "constants.hpp"
+#include "SolverFactory.hpp"
+
+/**
+ * \brief Eigenvalues of a matrix family along a grid of parameters.
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+struct SweepResult
+{
+    Vector<T> parameters;        /**< Parameters of the grid, in increasing order */
+    Matrix<T> eigenvalues;       /**< Eigenvalues found at each parameter, one row per parameter (NaN when fewer were found) */
+    std::vector<int> iterations; /**< Iterations of the solve at each parameter */
+    int segments = 0;            /**< Number of segments of the grid solved in parallel */
+
+    /// Writes the result as a table: one line per parameter (parameter, iterations, eigenvalues)
+    void WriteTable(std::ostream &out) const;
+};
+
+/**
+ * \brief Solves the eigenvalue problems of a polynomial matrix family along a grid of parameters.
+ *
+ * The family is \f$ A(t) = \sum_k t^k A_k \f$ (e.g. \f$ A_0 + t A_1 \f$ with two terms), and the grid
+ * has equally spaced parameters. The grid is split into contiguous segments solved in parallel
+ * (one task per segment). Along a segment, the problems are solved by continuation: one solver and
+ * one matrix are reused for all the parameters, each solve starts from the vectors of the previous
+ * one (see `WarmStart`), and the shift of the inverse power method follows the eigenvalue it found
+ * first, so that the same eigenvalue is tracked along the path.
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class ParameterSweep
+{
+public:
+    /**
+     * \brief Constructor
+     *
+     * \param terms The matrices \f$ A_k \f$ of the family (square, of the same size).
+     * \param first The first parameter of the grid.
+     * \param last The last parameter of the grid.
+     * \param points The number of parameters of the grid.
+     * \throws std::invalid_argument If there is no matrix, if their sizes differ, or if the grid is empty.
+     */
+    ParameterSweep(const std::vector<MatrixPointer<T>> &terms, double first, double last, int points);
+
+    /**
+     * \brief Creates a sweep from the arguments of the `sweep` input type.
+     *
+     * \param inputArgs The first and last parameters, the number of parameters and the files of
+     * the matrices \f$ A_0, A_1, \dots \f$ (in the matrices folder).
+     * \throws std::invalid_argument If the arguments are invalid.
+     */
+    static ParameterSweep<T> FromArgs(const std::vector<std::string> &inputArgs);
+
+    /// Returns the parameters of the grid
+    const Vector<T> &GetParameters() const { return parameters; }
+    /// Computes \f$ A(t) \f$ in A (resized if needed)
+    void Assemble(T t, Matrix<T> &A) const;
+
+    /**
+     * \brief Solves the problems of the grid.
+     *
+     * \param factory The factory of the solvers (one solver per segment).
+     * \param segments The number of segments solved in parallel (0: one per worker of the scheduler).
+     * \param continuation Whether each solve starts from the previous one (otherwise they are independent).
+     */
+    SweepResult<T> Run(SolverFactory<T> &factory, int segments = 0, bool continuation = true) const;
+
+private:
+    std::vector<MatrixPointer<T>> terms; /**< Matrices of the family, by increasing power of the parameter */
+    Vector<T> parameters;                /**< Parameters of the grid */
+};
+
+#endif
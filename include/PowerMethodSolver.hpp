@@ -13,6 +13,17 @@
  * The eigenvalue found by this method is the dominant eigenvalue. By choosing
  * a value for the shift, the convergence of the method may be increased.
  *
+ * The iterations can be accelerated, which helps when the two dominant eigenvalues are
+ * close (the plain method converges at rate \f$ |\lambda_2 / \lambda_1| \f$):
+ * - `chebyshev`: the iterates are Chebyshev polynomials in the matrix, which damp the
+ *   eigenvalues of an interval \f$ [a, b] \f$ containing the unwanted part of the spectrum.
+ *   The interval is estimated with a short Lanczos run (and the Gershgorin discs when the
+ *   matrix is stored in memory), so this mode assumes a symmetric matrix.
+ * - `aitken`: Aitken's delta-squared extrapolation of the sequence of Rayleigh quotients.
+ *
+ * The mode used, the estimated convergence rate and the estimated number of iterations
+ * saved are stored in the solver report (see `GetReport`).
+ *
  * \tparam T The data type of the matrix elements (e.g. float, double).
  */
 template <typename T>
@@ -20,7 +31,7 @@ class PowerMethodSolver : public AbstractIterativeSolver<T>
 {
 public:
     /// Constructor
-    PowerMethodSolver(double tolerance, int maxIter, double shift);
+    PowerMethodSolver(double tolerance, int maxIter, double shift, const std::string &acceleration = DefaultSolverArgs::ACCELERATION);
     /// Destructor
     ~PowerMethodSolver();
 
@@ -32,7 +43,13 @@ public:
     Vector<T> FindEigenvalues() override;
 
 private:
-    double shift; /**< Optional shift */
+    double shift;             /**< Optional shift */
+    std::string acceleration; /**< Acceleration mode (none, chebyshev or aitken) */
+
+    /// Plain power iteration, optionally with Aitken extrapolation. Returns the eigenvalue of the matrix.
+    T PowerIteration(LinearOperator<T> &A, bool aitken);
+    /// Chebyshev-accelerated iteration (falls back to the plain iteration if the bounds are unusable)
+    T ChebyshevIteration(LinearOperator<T> &A);
 };
 
 #endif
\ No newline at end of file
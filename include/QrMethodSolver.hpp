@@ -2,6 +2,8 @@
 #ifndef __QR_METHOD_SOLVER_HPP__
 #define __QR_METHOD_SOLVER_HPP__
 
+#include <memory>
+
 #include "AbstractIterativeSolver.hpp"
 
 /**
@@ -25,15 +27,62 @@ public:
     /**
      * \brief Performs the QR decomposition of A using the Householder transformation.
      * Q and R are modified in-place.
+     *
+     * Matrices with at least two tiles per dimension are decomposed with `TiledQrDecomposition`.
      */
     void QrDecomposition(const Matrix<T> &A_iter, Matrix<T> &Q, Matrix<T> &R);
 
+    /**
+     * \brief Same as `QrDecomposition`, but R overwrites A: no copy of the matrix is made.
+     *
+     * \param A The matrix to decompose, replaced by R.
+     * \param Q The orthogonal factor (output).
+     */
+    void QrDecompositionInPlace(Matrix<T> &A, Matrix<T> &Q);
+
+    /**
+     * \brief Performs the QR decomposition of A by tiles of size `tileSize` x `tileSize`.
+     * Q and R are modified in-place.
+     *
+     * The factorization is split in tile kernels: GEQRT (QR of a diagonal tile), UNMQR (update
+     * of a tile on the right of a diagonal tile), TSQRT (QR of a diagonal tile stacked on a tile
+     * below it) and TSMQR (update of the corresponding pair of tiles on the right). The kernels
+     * form a graph of tasks executed by the `TaskScheduler` as soon as their dependencies are
+     * done, so that the factorization of the next panel overlaps the updates of the trailing matrix.
+     * Q is then formed by applying the reflectors to the identity, in parallel over blocks of rows.
+     *
+     * The reflectors are kept in the workspace, and the graph of tasks is built at the first
+     * decomposition of a size and executed again by the next ones: the decompositions of the
+     * iterations do not allocate memory.
+     */
+    void TiledQrDecomposition(const Matrix<T> &A_iter, Matrix<T> &Q, Matrix<T> &R);
+
     /**
      * \brief Finds the Eigenvalues of the matrix stored in matrixPointer using the QR algorithm.
+     *
+     * If the solver owns the matrix (see `TakeMatrix`), the iterations overwrite it: the
+     * factorization and the product RQ are computed in its storage, and the matrix is released
+     * at the end.
+     *
      * \return An Eigen vector of length equal to the number of row of the matrix containing the
      * eigenvalues found by the method.
      */
     Vector<T> FindEigenvalues() override;
+
+    // Set methods
+    /// Sets the size of the tiles of the tiled QR decomposition
+    void SetTileSize(int size);
+
+private:
+    struct TiledGraph;
+
+    int tileSize;                           /**< Size of the tiles of the tiled QR decomposition */
+    std::unique_ptr<TiledGraph> tiledGraph; /**< Tasks of the last tiled decomposition, executed again for the same sizes */
+
+    /// Unblocked Householder QR decomposition, R overwriting the matrix
+    void HouseholderQrInPlace(Matrix<T> &R, Matrix<T> &Q);
+    /// Tiled QR decomposition, R overwriting the matrix
+    void TiledQrInPlace(Matrix<T> &R, Matrix<T> &Q);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,131 @@
+#ifndef __ROOFLINE_HPP__
+#define __ROOFLINE_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+ * \brief Process-wide accounting of the floating-point operations and of the memory traffic of the kernels, for a roofline report.
+ *
+ * When enabled, each kernel (matrix-vector product, reflector application, factorization,
+ * triangular solve...) adds its analytic counts to its entry: the operations of the algorithm
+ * (a multiply-add counts as 2) and the bytes it must move between the memory and the cores (each
+ * operand read or written once). The bytes are a lower bound of the actual traffic: the
+ * arithmetic intensity of a kernel is an upper bound.
+ *
+ * The report compares the achieved throughputs with the peaks of the machine, measured once by
+ * `MeasurePeak`: the arithmetic peak by chains of multiply-adds on all the threads, the memory
+ * bandwidth by a STREAM-like triad. A kernel is memory-bound when its arithmetic intensity is below
+ * the ridge point (peak flops / peak bandwidth), and its attainable throughput is
+ * min(peak flops, intensity x peak bandwidth).
+ */
+class Roofline
+{
+public:
+    /// Peak throughputs of the machine
+    struct Peak
+    {
+        double flops = 0.0;     /**< Floating-point operations per second */
+        double bandwidth = 0.0; /**< Bytes per second */
+        int threads = 0;        /**< Number of threads of the measure */
+    };
+
+    /// Accumulated counts of a kernel
+    struct Kernel
+    {
+        long calls = 0;       /**< Number of calls */
+        double seconds = 0.0; /**< Wall time */
+        double flops = 0.0;   /**< Floating-point operations */
+        double bytes = 0.0;   /**< Bytes moved from and to the memory */
+    };
+
+    /// Returns the process-wide accounting
+    static Roofline &Instance();
+
+    Roofline(const Roofline &) = delete;
+    Roofline &operator=(const Roofline &) = delete;
+
+    /// Enables or disables the accounting (disabled by default)
+    void SetEnabled(bool enabled) { this->enabled.store(enabled, std::memory_order_relaxed); }
+    /// Returns whether the kernels are accounted
+    bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /// Adds a call of a kernel
+    void Add(const char *name, double flops, double bytes, double seconds);
+    /// Returns the counts of the kernels, by name
+    std::map<std::string, Kernel> GetKernels() const;
+    /// Forgets the counts of the kernels
+    void Reset();
+
+    /**
+     * \brief Measures the peak throughputs of the machine with the threads of the `TaskScheduler` and the selected SIMD instruction set.
+     *
+     * Takes about a second, and allocates three arrays of 32 MB.
+     */
+    template <typename T>
+    static Peak MeasurePeak();
+
+    /// Prints the counts of each kernel, the achieved throughputs and their fraction of the attainable peak
+    void PrintReport(const Peak &peak) const;
+
+private:
+    /// Constructor: the accounting starts disabled
+    Roofline() = default;
+
+    std::atomic<bool> enabled{false};      /**< Whether the kernels are accounted */
+    mutable std::mutex mutex;              /**< Protects the counts */
+    std::map<std::string, Kernel> kernels; /**< Counts of the kernels, by name */
+};
+
+/**
+ * \brief Scoped call of a kernel: adds its analytic counts and its time to the roofline accounting at its destruction.
+ *
+ * Usage: `RooflineRegion region("matvec", 2.0 * m * n, sizeof(T) * (m * n + m + n));` at the start
+ * of the kernel. The name must be a string literal. A region started within another one on the
+ * same thread is ignored, so that a kernel built on other kernels is counted once. When the
+ * accounting is disabled (the default), a region only reads an atomic flag.
+ */
+class RooflineRegion
+{
+public:
+    /// Constructor: starts the clock if the accounting is enabled
+    RooflineRegion(const char *name, double flops, double bytes)
+        : name(name), flops(flops), bytes(bytes), active(Roofline::Instance().IsEnabled() && !inside)
+    {
+        if (active)
+        {
+            inside = true;
+            startTime = std::chrono::steady_clock::now();
+        }
+    }
+    /// Destructor: adds the call to the accounting, unless it was ended before
+    ~RooflineRegion() { End(); }
+
+    /// Adds the call to the accounting now (for a kernel ending before its block)
+    void End()
+    {
+        if (active)
+        {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            Roofline::Instance().Add(name, flops, bytes, seconds);
+            inside = false;
+        }
+        active = false;
+    }
+
+    RooflineRegion(const RooflineRegion &) = delete;
+    RooflineRegion &operator=(const RooflineRegion &) = delete;
+
+private:
+    const char *name;                                /**< Name of the kernel */
+    double flops;                                    /**< Floating-point operations of the call */
+    double bytes;                                    /**< Bytes moved by the call */
+    bool active;                                     /**< Whether the call is accounted, and not ended */
+    std::chrono::steady_clock::time_point startTime; /**< Time at the start */
+    inline static thread_local bool inside = false;  /**< Whether a region runs on this thread */
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef __SIMD_KERNELS_HPP__
+#define __SIMD_KERNELS_HPP__
+
+#include <string>
+#include <vector>
+
+/**
+ * \brief Namespace for the hand-vectorized vector kernels of the solver hot loops.
+ *
+ * Each kernel is compiled for several instruction sets in the same binary: a portable scalar
+ * version, AVX2 + FMA and AVX-512 on x86-64, NEON on ARM64. The instruction set is selected
+ * once, at the first call, from the features of the processor (CPUID on x86-64), so that the
+ * same binary runs on every machine and uses the widest vectors available. It can be forced
+ * with `SetIsa` (e.g. to compare the results or the throughput of the instruction sets).
+ *
+ * The vectorized versions sum in a different order than the scalar one: the results of the
+ * reductions (`Dot`, `AbsSum`) differ from the scalar reference by rounding errors only.
+ *
+ * The pointers passed to the kernels need no particular alignment.
+ */
+namespace SimdKernels
+{
+    /// Instruction sets of the kernels
+    enum class Isa
+    {
+        SCALAR,
+        AVX2,
+        AVX512,
+        NEON
+    };
+
+    /// Returns the widest instruction set supported by the processor
+    Isa DetectIsa();
+    /// Returns whether the kernels can run with the given instruction set on this processor
+    bool IsSupported(Isa isa);
+    /// Returns the instruction sets supported by this processor, scalar first
+    std::vector<Isa> SupportedIsas();
+
+    /**
+     * \brief Selects the instruction set of the kernels (by default, the one of `DetectIsa`).
+     *
+     * Must not be called while kernels are running.
+     *
+     * \throws std::invalid_argument If the processor does not support the instruction set.
+     */
+    void SetIsa(Isa isa);
+    /// Returns the instruction set used by the kernels
+    Isa GetIsa();
+
+    /// Returns the name of an instruction set (scalar, avx2, avx512 or neon)
+    std::string IsaName(Isa isa);
+    /**
+     * \brief Returns the instruction set with the given name.
+     *
+     * \throws std::invalid_argument If the name is unknown.
+     */
+    Isa IsaFromName(const std::string &name);
+
+    /// Returns the dot product \f$ x^T y \f$ of two arrays of n entries
+    template <typename T>
+    T Dot(const T *x, const T *y, int n);
+
+    /// Computes \f$ y = y + \alpha x \f$ for two arrays of n entries
+    template <typename T>
+    void Axpy(T alpha, const T *x, T *y, int n);
+
+    /// Computes \f$ x = \alpha x \f$ for an array of n entries
+    template <typename T>
+    void Scale(T alpha, T *x, int n);
+
+    /// Returns the sum of the absolute values of an array of n entries
+    template <typename T>
+    T AbsSum(const T *x, int n);
+
+    /**
+     * \brief Runs independent chains of multiply-adds \f$ x = a x + b \f$ (from \f$ x = 0 \f$) in registers only.
+     *
+     * Measures the peak arithmetic throughput of a core: there is no memory access.
+     *
+     * \param iterations Number of multiply-adds of each chain.
+     * \param result Sum of the chains at the end (so that the loop is not optimized out).
+     * \return The number of floating-point operations (2 per multiply-add), which depends on the vector width.
+     */
+    template <typename T>
+    long FmaLoop(T a, T b, long iterations, T &result);
+}
+
+#endif
@@ -19,7 +19,10 @@ class SolverFactory
 {
 public:
     /// Constructor
-    SolverFactory(const std::string &methodName, const std::vector<std::string> &methodArgs) : methodName(methodName), methodArgs(methodArgs) {};
+    SolverFactory(const std::string &methodName, const std::vector<std::string> &methodArgs,
+                  const std::string &stoppingCriterion = DefaultSolverArgs::STOPPING_CRITERION,
+                  int checkInterval = DefaultSolverArgs::CHECK_INTERVAL)
+        : methodName(methodName), methodArgs(methodArgs), stoppingCriterion(stoppingCriterion), checkInterval(checkInterval) {};
     /// Destructor
     ~SolverFactory() {};
     /**
@@ -28,15 +31,24 @@ public:
      *
      * This method evaluates the method name (`methodName`) and create the solver
      * with the right arguments (`methodArgs`). The method also checks that the
-     * method arguments are valid, and converts them to the right type.
+     * method arguments are valid, and converts them to the right type. The stopping
+     * test of the solver is set from the criterion and the check interval.
      *
+     * When the size of the matrix is given and small (2 to `DefaultSolverArgs::MAX_FIXED_SIZE`),
+     * the QR method and the power method without acceleration are instantiated for that size
+     * (see `FixedSizeQrSolver` and `FixedSizePowerSolver`): the solver then only accepts matrices
+     * of that size, stored in memory.
+     *
+     * \param size The number of rows of the matrix (0: unknown, or to keep the dynamic-size solvers).
      * \return A unique pointer to a solver object.
      */
-    std::unique_ptr<AbstractIterativeSolver<T>> ChooseSolver();
+    std::unique_ptr<AbstractIterativeSolver<T>> ChooseSolver(int size = 0);
 
 private:
     const std::string methodName;              /**< The name of the solver method. */
     const std::vector<std::string> methodArgs; /**< Arguments relative to the solver. */
+    const std::string stoppingCriterion;       /**< Stopping test of the solver (see ConvergenceMonitor). */
+    const int checkInterval;                   /**< Iterations between two expensive convergence checks. */
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef __SOLVER_WORKSPACE_HPP__
+#define __SOLVER_WORKSPACE_HPP__
+
+#include <deque>
+
+#include "constants.hpp"
+
+/**
+ * \brief Buffers reused by a solver across its iterations and across successive solves.
+ *
+ * A solver asks for its temporaries by slot number instead of creating them in its
+ * iteration loop. The vectors have the size of the problem, set when the matrix or the
+ * operator is given to the solver: solving another matrix of the same size reuses the
+ * memory of the previous solve. A buffer is only (re)allocated the first time its slot
+ * is used or when the size changes.
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class SolverWorkspace
+{
+public:
+    /// Constructor
+    SolverWorkspace() {};
+    /// Destructor
+    ~SolverWorkspace() {};
+
+    /// Sets the size of the problem, resizing the vectors already in use if it changes
+    void SetSize(int size);
+    /// Returns the size of the problem
+    int GetSize() const { return size; }
+
+    /// Returns the vector of the given slot, of the size of the problem (contents are not initialized)
+    Vector<T> &GetVector(int slot);
+    /// Returns the matrix of the given slot, resized to rows x cols if needed (contents are not initialized)
+    Matrix<T> &GetMatrix(int slot, int rows, int cols);
+
+    /// Returns the number of buffer (re)allocations since the creation of the workspace
+    long GetAllocations() const { return allocations; }
+
+private:
+    int size = 0;                   /**< Size of the problem */
+    std::deque<Vector<T>> vectors;  /**< Vector buffers (a deque keeps the references valid when slots are added) */
+    std::deque<Matrix<T>> matrices; /**< Matrix buffers */
+    long allocations = 0;           /**< Number of buffer (re)allocations */
+};
+
+#endif
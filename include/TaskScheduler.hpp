@@ -0,0 +1,298 @@
+#ifndef __TASK_SCHEDULER_HPP__
+#define __TASK_SCHEDULER_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Process-wide task scheduler shared by the generators, the file readers and the solvers.
+ *
+ * The scheduler owns a fixed pool of workers. Each worker has its own deque of tasks:
+ * it pushes and pops tasks at the back of its deque, and idle workers steal tasks from
+ * the front of the deques of the other workers (work stealing). The threads that do not
+ * belong to the pool (e.g. the main thread) share the first deque. A thread waiting for
+ * the chunks of a `ParallelFor` or the tasks of a `TaskGroup` helps executing them, and
+ * only them: unrelated work (e.g. a whole solve of a parameter sweep) never starts inside
+ * the wait of a kernel. The total number of running threads never exceeds the number of
+ * workers. The parts of a `ParallelForParts` are pinned to a worker instead of being
+ * stolen, so that a thread always works on the same data.
+ *
+ * With a single worker, no thread is created and all the work runs on the calling thread.
+ */
+class TaskScheduler
+{
+public:
+    using Task = std::function<void()>;
+
+    /// Utilization counters of a worker since the last reset
+    struct WorkerStats
+    {
+        long tasksExecuted;  /**< Number of tasks executed by the worker */
+        long tasksStolen;    /**< Number of tasks stolen from other workers */
+        double busySeconds;  /**< Time spent executing tasks */
+        double utilization;  /**< Fraction of the elapsed time spent executing tasks */
+    };
+
+    /// Returns the process-wide scheduler
+    static TaskScheduler &Instance();
+
+    /// Destructor: stops and joins the workers
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    /**
+     * \brief Sets the number of workers (including the calling thread).
+     *
+     * Must not be called while tasks are running.
+     *
+     * \param workers The number of workers. A value of 0 selects all available cores.
+     */
+    void SetNumWorkers(int workers);
+
+    /// Returns the number of workers (including the calling thread)
+    int GetNumWorkers() const { return static_cast<int>(workers.size()); }
+
+    /**
+     * \brief Submits a task to the deque of the calling worker.
+     *
+     * Exceptions thrown by the task are ignored: use a `TaskGroup` or `ParallelFor`
+     * to propagate them.
+     *
+     * \param task The function to execute.
+     * \param owner Tag of the task, for the threads waiting for the tasks of this owner (see `RunPendingTask`).
+     */
+    void Submit(Task task, const void *owner = nullptr);
+
+    /**
+     * \brief Executes one pending task (from the own deque or stolen), if any.
+     *
+     * \param owner If not null, only a task submitted with this owner is executed.
+     * \return True if a task was executed.
+     */
+    bool RunPendingTask(const void *owner = nullptr);
+
+    /**
+     * \brief Executes `body(chunkBegin, chunkEnd)` on chunks of the range [begin, end) in parallel.
+     *
+     * Returns when all the chunks are done. The first exception thrown by a chunk is rethrown.
+     *
+     * \param begin First index of the range.
+     * \param end One past the last index of the range.
+     * \param grain Size of the chunks. A value of 0 selects a size giving a few chunks per worker.
+     * \param body The function to execute on each chunk.
+     */
+    template <typename F>
+    void ParallelFor(int begin, int end, int grain, F &&body)
+    {
+        if (end <= begin)
+            return;
+        if (GetNumWorkers() == 1 || (grain > 0 && end - begin <= grain))
+        {
+            body(begin, end); // Nothing to share: run inline
+            return;
+        }
+        ParallelForImpl(begin, end, grain, std::function<void(int, int)>(std::ref(body)));
+    }
+
+    /**
+     * \brief Executes `body(part)` for each part in [0, parts), part p on the worker p modulo the number of workers.
+     *
+     * Unlike the chunks of `ParallelFor`, the parts are never stolen: a part runs on the same thread at each call,
+     * so that the data initialized by a part (e.g. the memory pages of a block of rows, placed on the NUMA node of
+     * the thread that touches them first) are later used by the same thread. The parts of the first worker run on
+     * the calling thread. Called from a task, the parts are shared like the chunks of `ParallelFor`, since the
+     * other workers may be waiting for this task. The first exception thrown by a part is rethrown.
+     *
+     * \param parts The number of parts.
+     * \param body The function to execute on each part.
+     */
+    template <typename F>
+    void ParallelForParts(int parts, F &&body)
+    {
+        if (GetNumWorkers() == 1 || parts <= 1)
+        {
+            for (int part = 0; part < parts; ++part)
+                body(part); // Nothing to share: run inline
+            return;
+        }
+        ParallelForPartsImpl(parts, std::function<void(int)>(std::ref(body)));
+    }
+
+    /**
+     * \brief Reduces `body(chunkBegin, chunkEnd)` over chunks of the range [begin, end) in parallel.
+     *
+     * The partial results are combined with `reduce` in the order of the chunks, so that
+     * the result does not depend on the scheduling.
+     *
+     * \param begin First index of the range.
+     * \param end One past the last index of the range.
+     * \param grain Size of the chunks. A value of 0 selects a size giving a few chunks per worker.
+     * \param identity The neutral element of the reduction.
+     * \param body The function returning the partial result of a chunk.
+     * \param reduce The function combining two partial results.
+     * \return The reduced value.
+     */
+    template <typename V, typename F, typename R>
+    V ParallelReduce(int begin, int end, int grain, V identity, F &&body, R &&reduce)
+    {
+        if (end <= begin)
+            return identity;
+        const int chunkSize = ChunkSize(end - begin, grain);
+        const int chunks = (end - begin + chunkSize - 1) / chunkSize;
+        std::vector<V> partials(chunks, identity);
+        ParallelFor(0, chunks, 1, [&](int firstChunk, int lastChunk)
+                    {
+                        for (int chunk = firstChunk; chunk < lastChunk; ++chunk)
+                        {
+                            int chunkBegin = begin + chunk * chunkSize;
+                            partials[chunk] = body(chunkBegin, std::min(end, chunkBegin + chunkSize));
+                        } });
+        V result = identity;
+        for (const V &partial : partials)
+            result = reduce(result, partial);
+        return result;
+    }
+
+    /// Returns the utilization counters of each worker (the first one is the calling thread)
+    std::vector<WorkerStats> GetWorkerStats() const;
+
+    /// Resets the utilization counters
+    void ResetStats();
+
+    /// Prints the utilization counters of each worker and the load imbalance
+    void PrintUtilization() const;
+
+private:
+    /// Constructor: the scheduler starts with a single worker (the calling thread)
+    TaskScheduler();
+
+    /// A task waiting in a deque, with the tag given to `Submit`
+    struct PendingTask
+    {
+        Task task;
+        const void *owner;
+    };
+
+    /// Deque of tasks in a ring buffer, which keeps its capacity: once it has grown to the largest
+    /// number of pending tasks, submitting a task does not allocate memory
+    class TaskDeque
+    {
+    public:
+        /// Adds a task at the back
+        void PushBack(PendingTask &&task);
+        /// Removes the most recent task of the owner (of any owner if null), if any
+        bool PopBack(const void *owner, Task &task);
+        /// Removes the oldest task of the owner (of any owner if null), if any
+        bool PopFront(const void *owner, Task &task);
+
+    private:
+        PendingTask &At(size_t index) { return buffer[(first + index) % buffer.size()]; }
+        void Remove(size_t index);
+
+        std::vector<PendingTask> buffer; /**< Storage of the ring */
+        size_t first = 0;                /**< Position of the oldest task in the buffer */
+        size_t count = 0;                /**< Number of tasks */
+    };
+
+    /// Deques of tasks and counters of a worker
+    struct Worker
+    {
+        std::mutex mutex;
+        TaskDeque tasks;                  /**< Tasks of the worker, which the other workers can steal */
+        TaskDeque pinnedTasks;            /**< Parts of a `ParallelForParts`, only executed by this worker */
+        std::atomic<int> pinnedCount{0};  /**< Number of tasks in `pinnedTasks` */
+        std::atomic<long> tasksExecuted{0};
+        std::atomic<long> tasksStolen{0};
+        std::atomic<long> busyNanoseconds{0};
+    };
+
+    void ParallelForImpl(int begin, int end, int grain, const std::function<void(int, int)> &body);
+    void ParallelForPartsImpl(int parts, const std::function<void(int)> &body);
+    int ChunkSize(int size, int grain) const;
+    void StartWorkers(int count);
+    void StopWorkers();
+    void WorkerLoop(int index);
+    bool PopTask(int index, const void *owner, Task &task, bool &stolen);
+    int CurrentWorker() const;
+
+    std::vector<std::unique_ptr<Worker>> workers; /**< Deques and counters (index 0: threads outside the pool) */
+    std::vector<std::thread> threads;             /**< Threads of the pool */
+    std::mutex sleepMutex;                        /**< Protects the sleep of idle workers */
+    std::condition_variable sleepCondition;       /**< Wakes up idle workers */
+    std::atomic<int> pendingTasks{0};             /**< Number of tasks waiting in the deques */
+    std::atomic<bool> stopping{false};            /**< Requests the workers to stop */
+    long statsStart;                              /**< Time of the last reset of the counters (ns) */
+};
+
+/**
+ * \brief Group of tasks with dependencies, executed by the `TaskScheduler`.
+ *
+ * A task is started as soon as all the tasks it depends on are done, so independent
+ * tasks run out of order. Dependencies must refer to tasks already added to the group,
+ * which guarantees that the graph of tasks is acyclic. A group can be executed again with
+ * `Rerun`.
+ */
+class TaskGroup
+{
+public:
+    using TaskId = int;
+
+    /// Constructor
+    TaskGroup(TaskScheduler &scheduler = TaskScheduler::Instance()) : scheduler(scheduler) {};
+    /// Destructor: waits for the tasks of the group
+    ~TaskGroup();
+
+    /**
+     * \brief Adds a task to the group.
+     *
+     * \param task The function to execute.
+     * \param dependencies The tasks that must be done before this task starts.
+     * \return The identifier of the task.
+     */
+    TaskId Add(std::function<void()> task, const std::vector<TaskId> &dependencies = {});
+
+    /**
+     * \brief Waits until all the tasks of the group are done. The calling thread executes
+     * the pending tasks of the group while waiting. The first exception thrown by a task is rethrown.
+     */
+    void Wait();
+
+    /**
+     * \brief Executes all the tasks of the group again, with the same dependencies.
+     *
+     * Must be called once the tasks are done (after `Wait`). A graph built once can be executed
+     * at each iteration of a solver without allocating memory. Call `Wait` for the results.
+     */
+    void Rerun();
+
+private:
+    /// A task and its position in the graph
+    struct Node
+    {
+        std::function<void()> task;
+        int dependencies;
+        int remainingDependencies;
+        std::vector<TaskId> successors;
+        bool done;
+    };
+
+    void Schedule(TaskId id);
+    void Complete(TaskId id);
+
+    TaskScheduler &scheduler;     /**< Scheduler executing the tasks */
+    std::mutex mutex;             /**< Protects the graph */
+    std::deque<Node> nodes;       /**< Tasks of the group */
+    std::atomic<int> unfinished{0}; /**< Number of tasks not done yet */
+    std::exception_ptr exception; /**< First exception thrown by a task */
+};
+
+#endif
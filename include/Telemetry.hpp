@@ -0,0 +1,84 @@
+#ifndef __TELEMETRY_HPP__
+#define __TELEMETRY_HPP__
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "constants.hpp"
+
+// Set to 0 (CMake option TELEMETRY=OFF) to compile the recording out of the solvers
+#ifndef SOLVER_TELEMETRY
+#define SOLVER_TELEMETRY 1
+#endif
+
+namespace Telemetry
+{
+    /// Whether the solvers contain the recording code (see `ConvergenceMonitor::Record`)
+    constexpr bool ENABLED = SOLVER_TELEMETRY != 0;
+}
+
+/**
+ * \brief Per-iteration history of a solve: eigenvalue estimate, error and elapsed time.
+ *
+ * The samples are stored in a ring buffer allocated once: recording never allocates, and a
+ * long solve keeps its last `capacity` iterations. The solvers record through their
+ * `ConvergenceMonitor`, only when a telemetry is attached to it; with `Telemetry::ENABLED`
+ * false, the recording is compiled out.
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+class ConvergenceTelemetry
+{
+public:
+    /// State of the solve after an iteration
+    struct Sample
+    {
+        int iteration;  /**< Iteration (dimension of the Krylov space for the Lanczos method) */
+        T estimate;     /**< Eigenvalue estimate */
+        double error;   /**< Error of the last convergence check (infinite before the first one) */
+        double seconds; /**< Time elapsed since the start of the solve */
+    };
+
+    /// Constructor: allocates the buffer for `capacity` samples
+    explicit ConvergenceTelemetry(int capacity = DefaultOptions::TELEMETRY_CAPACITY);
+
+    /// Forgets the samples and restarts the clock (start of a solve)
+    void Start();
+    /// Records a sample, overwriting the oldest one when the buffer is full
+    void Record(int iteration, T estimate, double error)
+    {
+        samples[next] = {iteration, estimate, error, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+        next = next + 1 == static_cast<int>(samples.size()) ? 0 : next + 1;
+        ++recorded;
+    }
+
+    /// Returns the number of samples kept
+    int Size() const { return recorded < static_cast<long>(samples.size()) ? static_cast<int>(recorded) : static_cast<int>(samples.size()); }
+    /// Returns the number of samples recorded since the start, kept or not
+    long Recorded() const { return recorded; }
+    /// Returns the i-th oldest sample kept
+    const Sample &Get(int i) const;
+
+    /// Writes the samples as CSV (header line, one line per sample)
+    void WriteCsv(std::ostream &out) const;
+    /// Writes the samples as JSON (name of the solver, numbers of samples, array of samples)
+    void WriteJson(std::ostream &out, const std::string &solverName) const;
+    /**
+     * \brief Saves the samples in the output folder, as CSV or JSON depending on the extension.
+     *
+     * \throws std::invalid_argument If the extension is neither csv nor json.
+     * \throws FileException If the file can not be written.
+     */
+    void Save(const std::string &fileName, const std::string &solverName) const;
+
+private:
+    std::vector<Sample> samples;                 /**< Ring buffer */
+    int next = 0;                                /**< Position of the next sample in the buffer */
+    long recorded = 0;                           /**< Number of samples recorded since the start */
+    std::chrono::steady_clock::time_point start; /**< Start of the solve */
+};
+
+#endif
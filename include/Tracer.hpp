@@ -0,0 +1,121 @@
+#ifndef __TRACER_HPP__
+#define __TRACER_HPP__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Process-wide recorder of timed spans (phases of the run, kernels of the solvers), saved as a Chrome trace.
+ *
+ * Each thread appends its spans to its own buffer, registered once at its first span: recording
+ * takes no lock, and the spans of the workers of the `TaskScheduler` appear in separate lanes
+ * when the trace is opened in Perfetto (https://ui.perfetto.dev) or `chrome://tracing`.
+ * When the tracer is disabled (the default), a span only reads an atomic flag.
+ *
+ * The buffers are read by `WriteChromeTrace` and cleared by `Clear`: these must not be called
+ * while other threads record spans.
+ */
+class Tracer
+{
+public:
+    /// Span recorded by a thread
+    struct Event
+    {
+        const char *name;     /**< Name of the span (string literal) */
+        const char *category; /**< Category of the span (string literal): main, input, solver, scheduler... */
+        long start;           /**< Start time (ns since the creation of the tracer) */
+        long duration;        /**< Duration (ns) */
+    };
+
+    /// Returns the process-wide tracer
+    static Tracer &Instance();
+
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+
+    /// Starts or stops the recording of the spans
+    void SetEnabled(bool enable) { enabled.store(enable, std::memory_order_relaxed); }
+    /// Returns whether the spans are recorded
+    bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /// Returns the time elapsed since the creation of the tracer (ns)
+    long Now() const;
+    /// Records a span of the calling thread, between two times given by `Now`
+    void Record(const char *name, const char *category, long start, long end);
+    /// Names the lane of the calling thread in the trace (by default, "thread <number>")
+    void NameThread(const std::string &name);
+
+    /// Returns the number of spans recorded by all the threads
+    long EventCount() const;
+    /// Returns the spans recorded by the calling thread
+    const std::vector<Event> &ThreadEvents();
+    /// Forgets the recorded spans (the lanes are kept)
+    void Clear();
+
+    /// Writes the spans in the JSON format of the Chrome trace events (complete events, one lane per thread)
+    void WriteChromeTrace(std::ostream &out) const;
+    /**
+     * \brief Saves the spans as a Chrome trace in the output folder.
+     *
+     * \throws FileException If the file can not be written.
+     */
+    void Save(const std::string &fileName) const;
+
+private:
+    /// Spans of a thread, and the name of its lane
+    struct ThreadBuffer
+    {
+        int id;
+        std::string name;
+        std::vector<Event> events;
+    };
+
+    /// Constructor: the tracer starts disabled
+    Tracer();
+    /// Returns the buffer of the calling thread, registered at its first call
+    ThreadBuffer &LocalBuffer();
+
+    std::atomic<bool> enabled{false};                   /**< Whether the spans are recorded */
+    long origin;                                        /**< Creation time of the tracer (steady clock, ns) */
+    mutable std::mutex mutex;                           /**< Protects the list of buffers (registration only) */
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers; /**< Buffers of the threads, kept after their end */
+    static thread_local ThreadBuffer *localBuffer;      /**< Buffer of the calling thread (null before its first span) */
+};
+
+/**
+ * \brief Scoped span: records the time between its construction and its destruction.
+ *
+ * Usage: `TraceSpan span("factorization", "solver");` at the start of a block. The name and
+ * category must be string literals (they are stored as pointers).
+ */
+class TraceSpan
+{
+public:
+    /// Constructor: starts the span if the tracer is enabled
+    TraceSpan(const char *name, const char *category)
+        : name(name), category(category), start(Tracer::Instance().IsEnabled() ? Tracer::Instance().Now() : -1) {}
+    /// Destructor: records the span, unless it was ended before
+    ~TraceSpan() { End(); }
+
+    /// Records the span now (for a span ending before its block)
+    void End()
+    {
+        if (start >= 0)
+            Tracer::Instance().Record(name, category, start, Tracer::Instance().Now());
+        start = -1;
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *name;     /**< Name of the span */
+    const char *category; /**< Category of the span */
+    long start;           /**< Start time, negative if the tracer was disabled or the span ended */
+};
+
+#endif
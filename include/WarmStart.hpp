@@ -0,0 +1,55 @@
+#ifndef __WARM_START_HPP__
+#define __WARM_START_HPP__
+
+#include <string>
+
+#include "constants.hpp"
+
+/**
+ * \brief Eigenvalue estimates and vectors of a previous solve, to start a new solve from.
+ *
+ * The solvers export their final vectors in this form (see `AbstractIterativeSolver::GetWarmStart`)
+ * and accept it as initial guess (see `AbstractIterativeSolver::SetWarmStart`): when the matrix
+ * only changed slightly since the previous solve, the iterations start close to the solution.
+ * - Power, inverse power and Lanczos methods: the sum of the vectors is the initial vector
+ *   (the Krylov space of the Lanczos method then contains approximations of all of them).
+ * - QR method: the n vectors (an orthonormal basis, e.g. the Schur vectors of a previous
+ *   solve) transform the matrix before the iterations, \f$ A_0 = V^T A V \f$.
+ *
+ * The eigenvalue estimates are compared with the new eigenvalues, which measures how much
+ * the problem changed since the previous solve (see `SolverReport::warmStartChange`).
+ *
+ * \tparam T The data type of the matrix elements (e.g. float, double).
+ */
+template <typename T>
+struct WarmStart
+{
+    Vector<T> eigenvalues;  /**< Eigenvalue estimates (may be empty) */
+    Matrix<T> eigenvectors; /**< Vectors, one per column (may be empty) */
+
+    /// Returns whether there is no vector to start from
+    bool Empty() const { return eigenvectors.cols() == 0; }
+};
+
+/**
+ * \brief Writes a warm start to a text file, in the output folder.
+ *
+ * Format: a line with the number of rows n and of vectors k, a line with the eigenvalue
+ * estimates, then the n rows of the vectors. The values are written with all their digits.
+ *
+ * \throws FileException If the file can not be written.
+ */
+template <typename T>
+void SaveWarmStart(const std::string &fileName, const WarmStart<T> &warmStart);
+
+/**
+ * \brief Reads a warm start written by `SaveWarmStart`, from the input folder.
+ *
+ * The file may have been written with another data type.
+ *
+ * \throws FileException If the file can not be read or is not a warm start file.
+ */
+template <typename T>
+WarmStart<T> LoadWarmStart(const std::string &fileName);
+
+#endif
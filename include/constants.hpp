@@ -55,17 +55,87 @@ namespace SupportedArguments
     const std::set<std::string> SUPPORTED_METHODS = {
         "power_method",
         "inverse_power_method",
-        "QR_method"};
+        "QR_method",
+        "lanczos_method",
+        "jacobi_method"};
+
+    /// Supported acceleration modes of the power method
+    const std::set<std::string> SUPPORTED_ACCELERATIONS = {
+        "none",
+        "chebyshev",
+        "aitken"};
+
+    /// Supported factorizations of the inverse power method (mixed: float factorization with iterative refinement)
+    const std::set<std::string> SUPPORTED_FACTORIZATIONS = {
+        "full",
+        "mixed"};
 
     /// Supported input types
     const std::set<std::string> SUPPORTED_INPUT_TYPES = {
         "file",
-        "function"};
+        "function",
+        "tiled_file",
+        "sweep",
+        "batch"};
+
+    /// Supported kinds of the matrices of a batch (auto: symmetric if all the matrices are)
+    const std::set<std::string> SUPPORTED_BATCH_KINDS = {
+        "auto",
+        "symmetric",
+        "general"};
+
+    /// Supported functions of the input type function (see FunctionManager)
+    const std::set<std::string> SUPPORTED_FUNCTIONS = {
+        "identity",
+        "hilbert",
+        "laplacian",
+        "random",
+        "random_symmetric"};
+
+    /// Supported storage types of the matrix (full: same type as the computations)
+    const std::set<std::string> SUPPORTED_STORAGE_TYPES = {
+        "full",
+        "float",
+        "bfloat16",
+        "half"};
+
+    /// Supported stopping criteria of the iterative solvers (see ConvergenceMonitor)
+    const std::set<std::string> SUPPORTED_STOPPING_CRITERIA = {
+        "change",
+        "residual"};
+
+    /// Supported instruction sets of the vector kernels (auto: the widest one supported by the processor)
+    const std::set<std::string> SUPPORTED_SIMD = {
+        "auto",
+        "scalar",
+        "avx2",
+        "avx512",
+        "neon"};
 
     /// Supported output actions
     const std::set<std::string> SUPPORTED_OUTPUT_TYPES = {
         "print",
         "save"};
+
+    /// Supported execution options
+    const std::set<std::string> SUPPORTED_OPTIONS = {
+        "threads",
+        "utilization_report",
+        "solver_report",
+        "in_place",
+        "memory_report",
+        "storage",
+        "accuracy_report",
+        "simd",
+        "stopping_criterion",
+        "check_interval",
+        "warm_start",
+        "export_vectors",
+        "sweep_segments",
+        "telemetry",
+        "trace",
+        "hardware_counters",
+        "roofline_report"};
 }
 
 /**
@@ -80,6 +150,15 @@ namespace DefaultSolverArgs
     const double TOLERANCE = 1e-6;
     const int MAX_ITER = 10000;
     const float SHIFT = 0.0;
+    const int TILE_SIZE = 64; // Size of the tiles of the tiled QR decomposition
+    const std::string ACCELERATION = "none"; // Acceleration mode of the power method
+    const int BOUND_ESTIMATION_STEPS = 20;   // Lanczos steps estimating the spectral bounds (Chebyshev acceleration)
+    const std::string FACTORIZATION = "full"; // Factorization of the inverse power method
+    const int MAX_REFINEMENT_STEPS = 10;      // Iterative refinement steps of an inner solve before falling back to double
+    const std::string STOPPING_CRITERION = "change"; // Stopping test of the power and inverse power methods
+    const int CHECK_INTERVAL = 1;                    // Iterations between two expensive convergence checks
+    const std::string BATCH_KIND = "auto";           // Kind of the matrices of a batch (kernel: Jacobi if symmetric, QR otherwise)
+    const int MAX_FIXED_SIZE = 16;                   // Largest matrices solved by the fixed-size solvers (see SolverFactory)
 }
 
 /**
@@ -93,4 +172,32 @@ namespace DefaultOutputArgs
 {
     const std::string FILENAME = "output.txt";
 }
-#endif
+
+/**
+ * \brief Namespace for default values of the execution options.
+ *
+ * These values are used when the optional `options` section of the config
+ * file is absent or does not specify the corresponding option.
+ */
+namespace DefaultOptions
+{
+    const int THREADS = 0; // 0: use all available cores
+    const bool UTILIZATION_REPORT = false;
+    const bool SOLVER_REPORT = false;
+    const bool IN_PLACE = false; // Hand the matrix over to the solver, which may overwrite it
+    const bool MEMORY_REPORT = false;
+    const std::string STORAGE = "full"; // Storage type of the matrix (see SUPPORTED_STORAGE_TYPES)
+    const bool ACCURACY_REPORT = false;
+    const std::string SIMD = "auto"; // Instruction set of the vector kernels (see SUPPORTED_SIMD)
+    const std::string STOPPING_CRITERION = DefaultSolverArgs::STOPPING_CRITERION;
+    const int CHECK_INTERVAL = DefaultSolverArgs::CHECK_INTERVAL;
+    const std::string WARM_START = "";     // File of a previous run to start the solve from (input folder), none if empty
+    const std::string EXPORT_VECTORS = ""; // File the final vectors are saved to (output folder), none if empty
+    const int SWEEP_SEGMENTS = 0;          // Segments of a parameter sweep solved in parallel (0: one per thread)
+    const std::string TELEMETRY = "";      // File of the per-iteration history of the solve (output folder, csv or json), none if empty
+    const int TELEMETRY_CAPACITY = 100000; // Iterations kept by the telemetry (the last ones)
+    const std::string TRACE = "";          // File of the Chrome trace of the run (output folder, json), none if empty
+    const bool HARDWARE_COUNTERS = false;  // Print the hardware counters (perf_event) of the kernels
+    const bool ROOFLINE_REPORT = false;    // Print the flops and bytes of the kernels against the peaks of the machine
+}
+#endif
\ No newline at end of file
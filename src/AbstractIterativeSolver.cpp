@@ -1,6 +1,10 @@
 #include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
 
 #include "AbstractIterativeSolver.hpp"
+#include "DenseOperator.hpp"
 
 template <typename T>
 AbstractIterativeSolver<T>::~AbstractIterativeSolver() {}
@@ -13,6 +17,108 @@ void AbstractIterativeSolver<T>::SetMatrix(MatrixPointer<T> matrix)
         throw SolverException("The provided matrix must be square. Rows and columns are not equal.");
     }
     matrixPointer = matrix;
+    operatorPointer = std::make_shared<DenseOperator<T>>(matrix);
+    ownsMatrix = false;
+    workspace.SetSize(matrix->rows());
+}
+
+template <typename T>
+void AbstractIterativeSolver<T>::TakeMatrix(MatrixPointer<T> &&matrix)
+{
+    if (matrix == nullptr)
+    {
+        throw std::runtime_error("Matrix is not initialized (AbstractIterativeSolver)");
+    }
+    // The matrix is overwritten by the solve: nobody else may still be reading it
+    if (matrix.use_count() != 1)
+    {
+        throw std::invalid_argument("The solver must be the only owner of a matrix it takes (" +
+                                    std::to_string(matrix.use_count()) + " owners)");
+    }
+    SetMatrix(std::move(matrix));
+    ownsMatrix = true;
+}
+
+template <typename T>
+void AbstractIterativeSolver<T>::ReleaseMatrix()
+{
+    matrixPointer.reset();
+    operatorPointer.reset();
+    ownsMatrix = false;
+}
+
+template <typename T>
+void AbstractIterativeSolver<T>::RecordConvergence(const std::string &stoppingCriterion)
+{
+    report.stoppingCriterion = stoppingCriterion;
+    report.checkInterval = stoppingCriterion == "change" ? 1 : monitor.GetCheckInterval(); // The change is tested at every iteration
+    report.convergenceChecks = monitor.GetChecks();
+    report.finalError = monitor.GetError();
+}
+
+template <typename T>
+void AbstractIterativeSolver<T>::EnableTelemetry(int capacity)
+{
+    telemetry = std::make_unique<ConvergenceTelemetry<T>>(capacity);
+    monitor.AttachTelemetry(telemetry.get());
+}
+
+template <typename T>
+const Matrix<T> &AbstractIterativeSolver<T>::WarmStartVectors(int rows) const
+{
+    if (initialGuess.eigenvectors.rows() != rows)
+    {
+        throw std::invalid_argument("The vectors of the warm start have " + std::to_string(initialGuess.eigenvectors.rows()) +
+                                    " rows instead of " + std::to_string(rows));
+    }
+    return initialGuess.eigenvectors;
+}
+
+template <typename T>
+bool AbstractIterativeSolver<T>::InitialVector(Vector<T> &x)
+{
+    if (!HasWarmStart())
+        return false;
+    std::shared_ptr<LinearOperator<T>> A = GetOperator();
+    const Matrix<T> &vectors = WarmStartVectors(A->GetSize());
+    x = vectors.middleRows(A->GetFirstRow(), A->GetLocalRows()).rowwise().sum();
+    report.warmStarted = true;
+    return true;
+}
+
+template <typename T>
+void AbstractIterativeSolver<T>::RecordResult(const Vector<T> &eigenvalues, const Matrix<T> &vectors)
+{
+    finalVectors.eigenvalues = eigenvalues;
+    if (exportVectors)
+        finalVectors.eigenvectors = vectors;
+    else
+        finalVectors.eigenvectors.resize(0, 0);
+
+    // The estimates and the eigenvalues are in the same order when they come from the same solver
+    const int count = std::min(eigenvalues.size(), initialGuess.eigenvalues.size());
+    report.warmStartChange = 0.0;
+    for (int i = 0; i < count; ++i)
+    {
+        double change = std::abs(eigenvalues(i) - initialGuess.eigenvalues(i)) / std::abs(eigenvalues(i));
+        report.warmStartChange = std::max(report.warmStartChange, change);
+    }
+}
+
+template <typename T>
+void AbstractIterativeSolver<T>::SetOperator(std::shared_ptr<LinearOperator<T>> linearOperator)
+{
+    if (linearOperator == nullptr)
+    {
+        throw std::runtime_error("Operator is not initialized (AbstractIterativeSolver)");
+    }
+    // A matrix set before is no longer the one solved for, unless the operator applies it
+    auto denseOperator = std::dynamic_pointer_cast<DenseOperator<T>>(linearOperator);
+    if (denseOperator == nullptr || denseOperator->GetMatrix() != matrixPointer)
+        matrixPointer.reset();
+    operatorPointer = linearOperator;
+    ownsMatrix = false;
+    workspace.SetSize(linearOperator->GetLocalRows());
 }
 
 template <typename T>
@@ -26,6 +132,49 @@ MatrixPointer<T> AbstractIterativeSolver<T>::GetMatrix() const
     return matrixPointer;
 }
 
+template <typename T>
+std::shared_ptr<LinearOperator<T>> AbstractIterativeSolver<T>::GetOperator() const
+{
+    // Check that the pointer was assigned to an operator (directly or with SetMatrix)
+    if (operatorPointer == nullptr)
+    {
+        throw std::runtime_error("Operator is not initialized (AbstractIterativeSolver)");
+    }
+    return operatorPointer;
+}
+
+template <typename T>
+void AbstractIterativeSolver<T>::PrintReport() const
+{
+    std::cout << "==== SOLVER REPORT ====" << std::endl;
+    std::cout << "Iterations: " << report.iterations << (report.converged ? " (converged)" : " (not converged)") << std::endl;
+    std::cout << "Acceleration: " << report.acceleration << std::endl;
+    if (!report.factorization.empty())
+    {
+        std::cout << "Factorization: " << report.factorization << " (" << std::fixed << std::setprecision(3)
+                  << report.factorizationSeconds << " s)" << std::defaultfloat << std::setprecision(6) << std::endl;
+        if (report.factorization.rfind("mixed", 0) == 0)
+            std::cout << "Refinement steps: " << report.refinementSteps << " (" << std::setprecision(2)
+                      << (report.iterations > 0 ? static_cast<double>(report.refinementSteps) / report.iterations : 0.0)
+                      << " per solve)" << std::setprecision(6) << std::endl;
+    }
+    if (!report.stoppingCriterion.empty())
+        std::cout << "Stopping test: " << report.stoppingCriterion << ", " << report.convergenceChecks << " checks (every "
+                  << report.checkInterval << " iterations), last error " << std::scientific << std::setprecision(2)
+                  << report.finalError << std::defaultfloat << std::setprecision(6) << std::endl;
+    if (report.warmStarted)
+        std::cout << "Warm start: yes (largest relative change of the eigenvalues: " << std::scientific << std::setprecision(2)
+                  << report.warmStartChange << ")" << std::defaultfloat << std::setprecision(6) << std::endl;
+    if (report.extraProducts > 0)
+        std::cout << "Products for the spectral bounds: " << report.extraProducts << std::endl;
+    if (report.acceleration != "none")
+        std::cout << "Iterations saved (estimated): " << report.iterationsSaved << std::endl;
+    if (report.convergenceRate > 0.0)
+        std::cout << "Convergence rate (estimated): " << std::setprecision(4) << report.convergenceRate
+                  << " per iteration" << std::defaultfloat << std::setprecision(6) << std::endl;
+    std::cout << "=======================" << std::endl;
+}
+
 // Explicit instantiations
 template class AbstractIterativeSolver<float>;
 template class AbstractIterativeSolver<double>;
\ No newline at end of file
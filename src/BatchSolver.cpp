@@ -0,0 +1,592 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "BatchSolver.hpp"
+#include "FileReader.hpp"
+#include "HardwareCounters.hpp"
+#include "SimdKernels.hpp"
+#include "TaskScheduler.hpp"
+#include "Tracer.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BATCH_KERNELS_X86 1
+#endif
+
+namespace
+{
+    // The kernels below work on a group of L matrices of size n in structure-of-arrays layout: entry (i, j)
+    // of matrix l is a[(i * n + j) * L + l]. The loops over the lanes have no dependency between the
+    // lanes: the compiler turns them into vector instructions, one lane per matrix. The square roots
+    // and divisions of the rotations and reflectors are computed lane by lane (scalar loops, O(1) per
+    // rotation), the updates of the rows and columns (O(n) per rotation) are vectorized.
+
+    // Signature of the kernels of a group: matrices, workspace, size, tolerance, maximum iterations,
+    // iterations and convergence of each lane (outputs)
+    template <typename T>
+    using GroupKernel = void (*)(T *, T *, int, T, int, int *, char *);
+
+    // Lanes not converged yet are checked: converged when the measure of their off-diagonal part is at
+    // most the threshold. Returns whether all the lanes converged.
+    template <typename T, int L>
+    inline bool CheckLanes(const T *offPart, const T *threshold, int iteration, int *iterations, char *converged)
+    {
+        bool all = true;
+        for (int l = 0; l < L; ++l)
+        {
+            if (!converged[l] && offPart[l] <= threshold[l])
+            {
+                converged[l] = 1;
+                iterations[l] = iteration;
+            }
+            all = all && converged[l];
+        }
+        return all;
+    }
+
+    // Cyclic Jacobi method on a group of symmetric matrices: the rotations zero the off-diagonal entries
+    // one by one, row by row, until the off-diagonal part is small. The eigenvalues are left on the diagonal.
+    template <typename T, int L>
+    inline void JacobiGroup(T *a, T *, int n, T tolerance, int maxIter, int *iterations, char *converged)
+    {
+        auto at = [a, n](int i, int j)
+        { return a + (i * n + j) * L; };
+
+        // Threshold of the squared off-diagonal part: the Frobenius norm does not change with the rotations.
+        // Entries below the rounding errors are not rotated but set to zero, as in the QR kernel.
+        T threshold[L] = {};
+        T negligible[L];
+        for (int e = 0; e < n * n; ++e)
+            for (int l = 0; l < L; ++l)
+                threshold[l] += a[e * L + l] * a[e * L + l];
+        for (int l = 0; l < L; ++l)
+        {
+            negligible[l] = std::numeric_limits<T>::epsilon() * std::sqrt(threshold[l]);
+            threshold[l] *= tolerance * tolerance;
+            iterations[l] = maxIter;
+            converged[l] = 0;
+        }
+        auto check = [&](int sweep)
+        {
+            T offPart[L] = {};
+            for (int i = 0; i < n; ++i)
+                for (int j = 0; j < n; ++j)
+                {
+                    if (i == j)
+                        continue;
+                    const T *entry = at(i, j);
+                    for (int l = 0; l < L; ++l)
+                        offPart[l] += entry[l] * entry[l];
+                }
+            return CheckLanes<T, L>(offPart, threshold, sweep, iterations, converged);
+        };
+
+        T c[L];
+        T s[L];
+        bool done = check(0);
+        for (int sweep = 1; !done && sweep <= maxIter; ++sweep)
+        {
+            for (int p = 0; p < n - 1; ++p)
+            {
+                for (int q = p + 1; q < n; ++q)
+                {
+                    // Rotation zeroing entry (p, q): t = tan(angle) is the smallest root of t^2 + 2 t theta - 1 = 0
+                    // (the identity if the entry is negligible: it is set to zero below)
+                    const T *app = at(p, p);
+                    const T *aqq = at(q, q);
+                    T *apq = at(p, q);
+                    bool any = false;
+                    for (int l = 0; l < L; ++l)
+                    {
+                        if (std::abs(apq[l]) <= negligible[l])
+                        {
+                            c[l] = 1;
+                            s[l] = 0;
+                            continue;
+                        }
+                        any = true;
+                        const T theta = (aqq[l] - app[l]) / (2 * apq[l]);
+                        const T t = (theta < 0 ? T(-1) : T(1)) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                        c[l] = 1 / std::sqrt(t * t + 1);
+                        s[l] = t * c[l];
+                    }
+                    if (!any)
+                        continue;
+
+                    // A = J^T A J: columns p and q, then rows p and q
+                    for (int k = 0; k < n; ++k)
+                    {
+                        T *x = at(k, p);
+                        T *y = at(k, q);
+                        for (int l = 0; l < L; ++l)
+                        {
+                            const T u = x[l];
+                            const T v = y[l];
+                            x[l] = c[l] * u - s[l] * v;
+                            y[l] = s[l] * u + c[l] * v;
+                        }
+                    }
+                    for (int k = 0; k < n; ++k)
+                    {
+                        T *x = at(p, k);
+                        T *y = at(q, k);
+                        for (int l = 0; l < L; ++l)
+                        {
+                            const T u = x[l];
+                            const T v = y[l];
+                            x[l] = c[l] * u - s[l] * v;
+                            y[l] = s[l] * u + c[l] * v;
+                        }
+                    }
+                    T *aqp = at(q, p);
+                    for (int l = 0; l < L; ++l)
+                    {
+                        apq[l] = 0;
+                        aqp[l] = 0;
+                    }
+                }
+            }
+            done = check(sweep);
+        }
+    }
+
+    // QR method on a group of general matrices: Householder factorization A = QR, then A = RQ, until the
+    // strictly lower part is small. The workspace holds Q, the product RQ and a reflector (2 n^2 + n entries per lane).
+    template <typename T, int L>
+    inline void QrGroup(T *a, T *work, int n, T tolerance, int maxIter, int *iterations, char *converged)
+    {
+        T *q = work;
+        T *product = work + n * n * L;
+        T *v = work + 2 * n * n * L;
+        auto at = [n](T *matrix, int i, int j)
+        { return matrix + (i * n + j) * L; };
+
+        // Threshold of the sum of the absolute values of the lower part: tolerance times the Frobenius norm.
+        // Lower entries below the rounding errors (machine epsilon times the norm) are set to zero: they
+        // would otherwise decay into subnormal numbers, which are very slow (in float after a few tens of iterations).
+        T threshold[L] = {};
+        T negligible[L];
+        for (int e = 0; e < n * n; ++e)
+            for (int l = 0; l < L; ++l)
+                threshold[l] += a[e * L + l] * a[e * L + l];
+        for (int l = 0; l < L; ++l)
+        {
+            negligible[l] = std::numeric_limits<T>::epsilon() * std::sqrt(threshold[l]);
+            threshold[l] = tolerance * std::sqrt(threshold[l]);
+            iterations[l] = maxIter;
+            converged[l] = 0;
+        }
+        auto check = [&](int iteration)
+        {
+            T lowerPart[L] = {};
+            for (int i = 1; i < n; ++i)
+                for (int j = 0; j < i; ++j)
+                {
+                    const T *entry = at(a, i, j);
+                    for (int l = 0; l < L; ++l)
+                        lowerPart[l] += std::abs(entry[l]);
+                }
+            return CheckLanes<T, L>(lowerPart, threshold, iteration, iterations, converged);
+        };
+
+        T beta[L];
+        T w[L];
+        bool done = check(0);
+        for (int iteration = 1; !done && iteration <= maxIter; ++iteration)
+        {
+            for (int e = 0; e < n * n; ++e)
+                for (int l = 0; l < L; ++l)
+                    q[e * L + l] = (e % (n + 1) == 0) ? T(1) : T(0);
+
+            for (int k = 0; k + 1 < n; ++k)
+            {
+                // Reflector v = x - alpha e_1 of the column below the diagonal, alpha = -sign(x_0) ||x||
+                T squaredNorm[L] = {};
+                for (int i = k; i < n; ++i)
+                {
+                    const T *entry = at(a, i, k);
+                    T *vi = v + i * L;
+                    for (int l = 0; l < L; ++l)
+                    {
+                        vi[l] = entry[l];
+                        squaredNorm[l] += entry[l] * entry[l];
+                    }
+                }
+                T *vk = v + k * L;
+                for (int l = 0; l < L; ++l)
+                {
+                    const T x0 = vk[l];
+                    const T alpha = (x0 >= 0 ? T(-1) : T(1)) * std::sqrt(squaredNorm[l]);
+                    vk[l] = x0 - alpha;
+                    const T vNorm = squaredNorm[l] - x0 * x0 + vk[l] * vk[l];
+                    beta[l] = vNorm > 0 ? 2 / vNorm : T(0);
+                }
+
+                // R = H R on the columns k to n - 1
+                for (int j = k; j < n; ++j)
+                {
+                    std::fill_n(w, L, T(0));
+                    for (int i = k; i < n; ++i)
+                    {
+                        const T *entry = at(a, i, j);
+                        const T *vi = v + i * L;
+                        for (int l = 0; l < L; ++l)
+                            w[l] += vi[l] * entry[l];
+                    }
+                    for (int l = 0; l < L; ++l)
+                        w[l] *= beta[l];
+                    for (int i = k; i < n; ++i)
+                    {
+                        T *entry = at(a, i, j);
+                        const T *vi = v + i * L;
+                        for (int l = 0; l < L; ++l)
+                            entry[l] -= w[l] * vi[l];
+                    }
+                }
+
+                // Q = Q H on the columns k to n - 1
+                for (int i = 0; i < n; ++i)
+                {
+                    std::fill_n(w, L, T(0));
+                    for (int j = k; j < n; ++j)
+                    {
+                        const T *entry = at(q, i, j);
+                        const T *vj = v + j * L;
+                        for (int l = 0; l < L; ++l)
+                            w[l] += entry[l] * vj[l];
+                    }
+                    for (int l = 0; l < L; ++l)
+                        w[l] *= beta[l];
+                    for (int j = k; j < n; ++j)
+                    {
+                        T *entry = at(q, i, j);
+                        const T *vj = v + j * L;
+                        for (int l = 0; l < L; ++l)
+                            entry[l] -= w[l] * vj[l];
+                    }
+                }
+            }
+
+            // A = R Q (R is the upper triangle of a)
+            for (int i = 0; i < n; ++i)
+                for (int k = 0; k < n; ++k)
+                {
+                    T *entry = at(product, i, k);
+                    std::fill_n(entry, L, T(0));
+                    for (int j = i; j < n; ++j)
+                    {
+                        const T *r = at(a, i, j);
+                        const T *qjk = at(q, j, k);
+                        for (int l = 0; l < L; ++l)
+                            entry[l] += r[l] * qjk[l];
+                    }
+                }
+            std::copy_n(product, n * n * L, a);
+            for (int i = 1; i < n; ++i)
+                for (int j = 0; j < i; ++j)
+                {
+                    T *entry = at(a, i, j);
+                    for (int l = 0; l < L; ++l)
+                        entry[l] = std::abs(entry[l]) < negligible[l] ? T(0) : entry[l];
+                }
+            done = check(iteration);
+        }
+    }
+
+    // *******************************************************************************************
+    // Instances of the kernels: one matrix per group (scalar reference), one matrix per lane of the
+    // 16-byte vectors (portable: SSE2 on x86-64, NEON on ARM64), of AVX2 and of AVX-512. The kernels
+    // are inlined in each instance (flatten), so that they are vectorized for its instruction set.
+    // *******************************************************************************************
+
+    template <typename T>
+    void JacobiScalar(T *a, T *work, int n, T tolerance, int maxIter, int *iterations, char *converged)
+    {
+        JacobiGroup<T, 1>(a, work, n, tolerance, maxIter, iterations, converged);
+    }
+
+    template <typename T>
+    void QrScalar(T *a, T *work, int n, T tolerance, int maxIter, int *iterations, char *converged)
+    {
+        QrGroup<T, 1>(a, work, n, tolerance, maxIter, iterations, converged);
+    }
+
+    template <typename T>
+    __attribute__((flatten)) void JacobiPortable(T *a, T *work, int n, T tolerance, int maxIter, int *iterations, char *converged)
+    {
+        JacobiGroup<T, 16 / sizeof(T)>(a, work, n, tolerance, maxIter, iterations, converged);
+    }
+
+    template <typename T>
+    __attribute__((flatten)) void QrPortable(T *a, T *work, int n, T tolerance, int maxIter, int *iterations, char *converged)
+    {
+        QrGroup<T, 16 / sizeof(T)>(a, work, n, tolerance, maxIter, iterations, converged);
+    }
+
+#ifdef BATCH_KERNELS_X86
+    template <typename T>
+    __attribute__((target("avx2,fma"), flatten)) void JacobiAvx2(T *a, T *work, int n, T tolerance, int maxIter, int *iterations, char *converged)
+    {
+        JacobiGroup<T, 32 / sizeof(T)>(a, work, n, tolerance, maxIter, iterations, converged);
+    }
+
+    template <typename T>
+    __attribute__((target("avx2,fma"), flatten)) void QrAvx2(T *a, T *work, int n, T tolerance, int maxIter, int *iterations, char *converged)
+    {
+        QrGroup<T, 32 / sizeof(T)>(a, work, n, tolerance, maxIter, iterations, converged);
+    }
+
+    template <typename T>
+    __attribute__((target("avx512f"), flatten)) void JacobiAvx512(T *a, T *work, int n, T tolerance, int maxIter, int *iterations, char *converged)
+    {
+        JacobiGroup<T, 64 / sizeof(T)>(a, work, n, tolerance, maxIter, iterations, converged);
+    }
+
+    template <typename T>
+    __attribute__((target("avx512f"), flatten)) void QrAvx512(T *a, T *work, int n, T tolerance, int maxIter, int *iterations, char *converged)
+    {
+        QrGroup<T, 64 / sizeof(T)>(a, work, n, tolerance, maxIter, iterations, converged);
+    }
+#endif
+
+    // Kernels of an instruction set, for one data type
+    template <typename T>
+    struct GroupKernels
+    {
+        int lanes;
+        GroupKernel<T> jacobi;
+        GroupKernel<T> qr;
+    };
+
+    template <typename T>
+    GroupKernels<T> KernelsFor(SimdKernels::Isa isa)
+    {
+        constexpr int size = static_cast<int>(sizeof(T));
+        switch (isa)
+        {
+        case SimdKernels::Isa::SCALAR:
+            return {1, JacobiScalar<T>, QrScalar<T>};
+#ifdef BATCH_KERNELS_X86
+        case SimdKernels::Isa::AVX2:
+            return {32 / size, JacobiAvx2<T>, QrAvx2<T>};
+        case SimdKernels::Isa::AVX512:
+            return {64 / size, JacobiAvx512<T>, QrAvx512<T>};
+#endif
+        default:
+            return {16 / size, JacobiPortable<T>, QrPortable<T>};
+        }
+    }
+}
+
+template <typename T>
+bool MatrixBatch<T>::IsSymmetric() const
+{
+    for (int k = 0; k < count; ++k)
+    {
+        const T *matrix = Data(k);
+        for (int i = 0; i < size; ++i)
+            for (int j = 0; j < i; ++j)
+                if (matrix[i * size + j] != matrix[j * size + i])
+                    return false;
+    }
+    return true;
+}
+
+template <typename T>
+MatrixBatch<T> MatrixBatch<T>::FromFile(const std::string &fileName)
+{
+    TraceSpan span("read batch file", "input");
+    CounterRegion region("read batch file");
+    std::ifstream file(std::string(Paths::PATH_MATRICES).append(fileName));
+    if (!file.is_open())
+        throw FileException("Failed to open batch file: " + fileName);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    const std::string text = contents.str();
+
+    // Numbers one after the other, skipping the whitespace and the comment lines
+    const char *position = text.c_str();
+    auto nextNumber = [&]() -> const char *
+    {
+        while (*position != '\0')
+        {
+            if (*position == '#' || *position == '%')
+            {
+                while (*position != '\0' && *position != '\n')
+                    ++position;
+            }
+            else if (std::isspace(static_cast<unsigned char>(*position)))
+                ++position;
+            else
+                return position;
+        }
+        return nullptr;
+    };
+
+    long header[2] = {0, 0};
+    for (long &value : header)
+    {
+        char *end = nullptr;
+        if (nextNumber() != nullptr)
+            value = std::strtol(position, &end, 10);
+        if (end == nullptr || end == position || value <= 0)
+            throw FileException("Invalid batch file " + fileName + ": expected the number of matrices and their size (positive integers)");
+        position = end;
+    }
+    if (header[0] > std::numeric_limits<int>::max() || header[1] > std::numeric_limits<int>::max())
+        throw FileException("Invalid batch file " + fileName + ": too many matrices or too large matrices");
+
+    MatrixBatch<T> batch(static_cast<int>(header[0]), static_cast<int>(header[1]));
+    for (size_t e = 0; e < batch.entries.size(); ++e)
+    {
+        char *end = nullptr;
+        if (nextNumber() != nullptr)
+        {
+            if constexpr (std::is_same_v<T, float>)
+                batch.entries[e] = std::strtof(position, &end);
+            else
+                batch.entries[e] = std::strtod(position, &end);
+        }
+        if (end == nullptr || end == position)
+            throw FileException("Invalid batch file " + fileName + ": expected " + std::to_string(batch.entries.size()) +
+                                " entries, found " + std::to_string(e) + " (or an invalid entry)");
+        position = end;
+    }
+    if (nextNumber() != nullptr)
+        throw FileException("Invalid batch file " + fileName + ": more entries than " + std::to_string(batch.count) +
+                            " matrices of size " + std::to_string(batch.size));
+    return batch;
+}
+
+template <typename T>
+int BatchResult<T>::Unconverged() const
+{
+    return static_cast<int>(std::count(converged.begin(), converged.end(), 0));
+}
+
+template <typename T>
+void BatchResult<T>::WriteTable(std::ostream &out) const
+{
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision(std::numeric_limits<T>::digits10);
+    out << "# matrix iterations converged";
+    for (int j = 0; j < eigenvalues.cols(); ++j)
+        out << " lambda_" << j + 1;
+    out << "\n";
+    for (int i = 0; i < eigenvalues.rows(); ++i)
+    {
+        out << i << " " << iterations[i] << " " << static_cast<int>(converged[i]);
+        for (int j = 0; j < eigenvalues.cols(); ++j)
+            out << " " << eigenvalues(i, j);
+        out << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+template <typename T>
+BatchSolver<T>::BatchSolver(double tolerance, int maxIter, const std::string &kind)
+    : tolerance(tolerance), maxIter(maxIter), kind(kind)
+{
+    if (tolerance <= 0.0)
+        throw std::invalid_argument("The tolerance of the batch solver must be a positive number (" + std::to_string(tolerance) + ")");
+    if (maxIter <= 0)
+        throw std::invalid_argument("The maximum number of iterations of the batch solver must be positive (" + std::to_string(maxIter) + ")");
+    if (SupportedArguments::SUPPORTED_BATCH_KINDS.find(kind) == SupportedArguments::SUPPORTED_BATCH_KINDS.end())
+        throw std::invalid_argument("unsupported kind of matrices for a batch (" + kind + ")");
+}
+
+template <typename T>
+BatchSolver<T> BatchSolver<T>::FromArgs(const std::vector<std::string> &methodArgs, const std::vector<std::string> &inputArgs)
+{
+    if (inputArgs.empty() || inputArgs.size() > 2)
+        throw std::invalid_argument("Expected 1 or 2 arguments for a batch (file and kind of the matrices), but got " + std::to_string(inputArgs.size()));
+    double tolerance = DefaultSolverArgs::TOLERANCE;
+    int maxIter = DefaultSolverArgs::MAX_ITER;
+    try
+    {
+        if (methodArgs.size() > 0)
+            tolerance = std::stod(methodArgs[0]);
+        if (methodArgs.size() > 1)
+            maxIter = std::stoi(methodArgs[1]);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::invalid_argument("Failed to convert the tolerance or the maximum number of iterations of the batch solver: " + std::string(e.what()));
+    }
+    return BatchSolver<T>(tolerance, maxIter, inputArgs.size() > 1 ? inputArgs[1] : DefaultSolverArgs::BATCH_KIND);
+}
+
+template <typename T>
+int BatchSolver<T>::Lanes()
+{
+    return KernelsFor<T>(SimdKernels::GetIsa()).lanes;
+}
+
+template <typename T>
+BatchResult<T> BatchSolver<T>::Solve(const MatrixBatch<T> &batch) const
+{
+    TraceSpan span("batch solve", "solver");
+    CounterRegion region("batch solve");
+    const bool symmetric = kind == "symmetric" || (kind == "auto" && batch.IsSymmetric());
+    const GroupKernels<T> kernels = KernelsFor<T>(SimdKernels::GetIsa());
+    const GroupKernel<T> kernel = symmetric ? kernels.jacobi : kernels.qr;
+    const int lanes = kernels.lanes;
+    const int n = batch.size;
+    const int groups = (batch.count + lanes - 1) / lanes;
+
+    BatchResult<T> result;
+    result.kernel = symmetric ? "jacobi" : "qr";
+    result.lanes = lanes;
+    result.eigenvalues.resize(batch.count, n);
+    result.iterations.resize(batch.count);
+    result.converged.resize(batch.count);
+
+    TaskScheduler::Instance().ParallelFor(0, groups, 0, [&](int firstGroup, int lastGroup)
+                                          {
+        // Buffers of the chunk of groups: no allocation per matrix
+        const size_t entries = static_cast<size_t>(n) * n * lanes;
+        std::vector<T> group(entries);
+        std::vector<T> work(symmetric ? 0 : 2 * entries + static_cast<size_t>(n) * lanes);
+        std::vector<int> iterations(lanes);
+        std::vector<char> converged(lanes);
+        std::vector<T> diagonal(n);
+        for (int g = firstGroup; g < lastGroup; ++g)
+        {
+            // Interleave the matrices of the group (the missing ones of the last group are identities)
+            for (int l = 0; l < lanes; ++l)
+            {
+                const int matrix = g * lanes + l;
+                for (int e = 0; e < n * n; ++e)
+                    group[e * lanes + l] = matrix < batch.count ? batch.Data(matrix)[e] : (e % (n + 1) == 0 ? T(1) : T(0));
+            }
+            kernel(group.data(), work.data(), n, static_cast<T>(tolerance), maxIter, iterations.data(), converged.data());
+            for (int l = 0; l < lanes && g * lanes + l < batch.count; ++l)
+            {
+                const int matrix = g * lanes + l;
+                for (int i = 0; i < n; ++i)
+                    diagonal[i] = group[(i * n + i) * lanes + l];
+                std::sort(diagonal.begin(), diagonal.end(), std::greater<T>());
+                for (int i = 0; i < n; ++i)
+                    result.eigenvalues(matrix, i) = diagonal[i];
+                result.iterations[matrix] = iterations[l];
+                result.converged[matrix] = converged[l];
+            }
+        } });
+    return result;
+}
+
+// Explicit instantiations
+template struct MatrixBatch<float>;
+template struct MatrixBatch<double>;
+template struct BatchResult<float>;
+template struct BatchResult<double>;
+template class BatchSolver<float>;
+template class BatchSolver<double>;
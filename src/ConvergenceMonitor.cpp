@@ -0,0 +1,129 @@
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "ConvergenceMonitor.hpp"
+#include "SimdKernels.hpp"
+#include "Tracer.hpp"
+
+template <typename T>
+ConvergenceMonitor<T>::ConvergenceMonitor(double tolerance, const std::string &criterion, int checkInterval)
+    : tolerance(tolerance)
+{
+    SetCriterion(criterion);
+    SetCheckInterval(checkInterval);
+    Reset();
+}
+
+template <typename T>
+void ConvergenceMonitor<T>::SetCriterion(const std::string &newCriterion)
+{
+    if (SupportedArguments::SUPPORTED_STOPPING_CRITERIA.find(newCriterion) == SupportedArguments::SUPPORTED_STOPPING_CRITERIA.end())
+        throw std::invalid_argument("unsupported stopping criterion (" + newCriterion + ")");
+    criterion = newCriterion;
+}
+
+template <typename T>
+void ConvergenceMonitor<T>::SetCheckInterval(int interval)
+{
+    if (interval <= 0)
+        throw std::invalid_argument("The check interval must be positive (" + std::to_string(interval) + ")");
+    checkInterval = interval;
+}
+
+template <typename T>
+void ConvergenceMonitor<T>::Reset()
+{
+    error = std::numeric_limits<double>::infinity();
+    checks = 0;
+    if (telemetry != nullptr)
+        telemetry->Start();
+}
+
+template <typename T>
+bool ConvergenceMonitor<T>::Check(double newError)
+{
+    error = newError;
+    ++checks;
+    return Converged();
+}
+
+template <typename T>
+bool ConvergenceMonitor<T>::CheckChange(T newValue, T oldValue, T scale)
+{
+    return Check(std::abs(newValue - oldValue) / std::abs(scale));
+}
+
+template <typename T>
+bool ConvergenceMonitor<T>::CheckResidual(const Vector<T> &x, const Vector<T> &Ax, T lambda, T scale, LinearOperator<T> *reduction)
+{
+    TraceSpan span("convergence check", "solver");
+    T residualNorm = 0;
+    T xNorm = 0;
+    const T *xData = x.data();
+    const T *AxData = Ax.data();
+    for (int i = 0; i < x.size(); ++i)
+    {
+        T r = AxData[i] - lambda * xData[i];
+        residualNorm += r * r;
+        xNorm += xData[i] * xData[i];
+    }
+    normsBuffer << residualNorm, xNorm;
+    if (reduction != nullptr)
+        reduction->Reduce(normsBuffer);
+    return Check(std::sqrt(normsBuffer(0) / normsBuffer(1)) / std::abs(scale));
+}
+
+template <typename T>
+bool ConvergenceMonitor<T>::CheckLowerPart(const Matrix<T> &A, bool hessenberg)
+{
+    TraceSpan span("convergence check", "solver");
+    return Check(hessenberg ? SubdiagonalSum(A) : LowerTriangleSum(A));
+}
+
+template <typename T>
+T ConvergenceMonitor<T>::LowerTriangleSum(const Matrix<T> &A)
+{
+    // Column by column: the below-diagonal part of a column is contiguous
+    T sum = 0;
+    const int rows = A.rows();
+    for (int j = 0; j + 1 < rows; ++j)
+        sum += SimdKernels::AbsSum<T>(A.col(j).data() + j + 1, rows - j - 1);
+    return sum;
+}
+
+template <typename T>
+T ConvergenceMonitor<T>::SubdiagonalSum(const Matrix<T> &A)
+{
+    T sum = 0;
+    for (int j = 0; j + 1 < A.rows(); ++j)
+        sum += std::abs(A(j + 1, j));
+    return sum;
+}
+
+template <typename T>
+bool ConvergenceMonitor<T>::IsHessenberg(const Matrix<T> &A)
+{
+    const int rows = A.rows();
+    for (int j = 0; j + 2 < rows; ++j)
+    {
+        if (SimdKernels::AbsSum<T>(A.col(j).data() + j + 2, rows - j - 2) != 0)
+            return false;
+    }
+    return true;
+}
+
+template <typename T>
+Vector<T> ConvergenceMonitor<T>::ResidualNorms(const Matrix<T> &A, const Vector<T> &eigenvalues, const Matrix<T> &eigenvectors)
+{
+    if (eigenvectors.cols() != eigenvalues.size() || eigenvectors.rows() != A.cols())
+        throw std::invalid_argument("The eigenvectors do not match the matrix and the eigenvalues");
+    Vector<T> norms(eigenvalues.size());
+    for (int i = 0; i < eigenvalues.size(); ++i)
+        norms(i) = (A * eigenvectors.col(i) - eigenvalues(i) * eigenvectors.col(i)).norm() / eigenvectors.col(i).norm();
+    return norms;
+}
+
+// Explicit instantiation
+template class ConvergenceMonitor<float>;
+template class ConvergenceMonitor<double>;
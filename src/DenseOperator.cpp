@@ -0,0 +1,31 @@
+#include "DenseOperator.hpp"
+#include "ParallelKernels.hpp"
+#include "HardwareCounters.hpp"
+#include "Tracer.hpp"
+
+template <typename T>
+DenseOperator<T>::DenseOperator(MatrixPointer<T> matrix) : matrix(matrix)
+{
+    if (matrix == nullptr)
+        throw std::runtime_error("Matrix is not initialized (DenseOperator)");
+}
+
+template <typename T>
+void DenseOperator<T>::Apply(const Vector<T> &x, Vector<T> &y)
+{
+    TraceSpan span("matvec", "solver");
+    CounterRegion region("matvec");
+    ParallelKernels::MatVec(*matrix, x, y);
+}
+
+template <typename T>
+void DenseOperator<T>::ApplyWithDots(const Vector<T> &x, T shift, Vector<T> &y, T &xDotY, T &yDotY)
+{
+    TraceSpan span("matvec", "solver");
+    CounterRegion region("matvec");
+    ParallelKernels::MatVecDots(*matrix, x, shift, y, xDotY, yDotY);
+}
+
+// Explicit instantiations
+template class DenseOperator<float>;
+template class DenseOperator<double>;
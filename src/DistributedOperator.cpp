@@ -0,0 +1,189 @@
+#include <iostream>
+#include <iomanip>
+#include <numeric>
+
+#include "DistributedOperator.hpp"
+#include "ParallelKernels.hpp"
+#include "HardwareCounters.hpp"
+#include "Tracer.hpp"
+
+namespace
+{
+    // MPI datatype matching the type of the matrix elements
+    template <typename T>
+    MPI_Datatype MpiType();
+
+    template <>
+    MPI_Datatype MpiType<float>() { return MPI_FLOAT; }
+
+    template <>
+    MPI_Datatype MpiType<double>() { return MPI_DOUBLE; }
+
+    // Offsets of consecutive segments of the given sizes
+    std::vector<int> Offsets(const std::vector<int> &counts)
+    {
+        std::vector<int> offsets(counts.size(), 0);
+        std::partial_sum(counts.begin(), counts.end() - 1, offsets.begin() + 1);
+        return offsets;
+    }
+}
+
+template <typename T>
+DistributedOperator<T>::DistributedOperator(MatrixPointer<T> localBlock, int firstRow, MPI_Comm communicator)
+    : communicator(communicator), firstRow(firstRow)
+{
+    if (localBlock == nullptr)
+        throw std::runtime_error("Matrix is not initialized (DistributedOperator)");
+    MPI_Comm_rank(communicator, &rank);
+    MPI_Comm_size(communicator, &processes);
+    localRows = localBlock->rows();
+    size = localBlock->cols();
+
+    // Blocks of rows of all the processes
+    std::vector<int> firstRows(processes + 1, size);
+    std::vector<int> blockRows(processes);
+    MPI_Allgather(&firstRow, 1, MPI_INT, firstRows.data(), 1, MPI_INT, communicator);
+    MPI_Allgather(&localRows, 1, MPI_INT, blockRows.data(), 1, MPI_INT, communicator);
+    for (int p = 0; p < processes; ++p)
+    {
+        if (firstRows[p] + blockRows[p] != firstRows[p + 1]) // Same check on all the processes
+            throw std::invalid_argument("The blocks of rows of the processes are not consecutive or do not cover the matrix (DistributedOperator)");
+    }
+
+    // Columns of the block with at least one nonzero entry: the entries of x needed for the product.
+    // They are sorted, hence grouped by the process storing them.
+    std::vector<int> neededColumns;
+    receiveCounts.assign(processes, 0);
+    int owner = 0;
+    for (int j = 0; j < size; ++j)
+    {
+        if ((localBlock->col(j).array() != static_cast<T>(0)).any())
+        {
+            while (j >= firstRows[owner + 1])
+                ++owner;
+            neededColumns.push_back(j);
+            ++receiveCounts[owner];
+        }
+    }
+    receiveOffsets = Offsets(receiveCounts);
+
+    // Tell each process which of its entries are needed
+    sendCounts.assign(processes, 0);
+    MPI_Alltoall(receiveCounts.data(), 1, MPI_INT, sendCounts.data(), 1, MPI_INT, communicator);
+    sendOffsets = Offsets(sendCounts);
+    sendIndices.resize(std::accumulate(sendCounts.begin(), sendCounts.end(), 0));
+    MPI_Alltoallv(neededColumns.data(), receiveCounts.data(), receiveOffsets.data(), MPI_INT,
+                  sendIndices.data(), sendCounts.data(), sendOffsets.data(), MPI_INT, communicator);
+    for (int &index : sendIndices)
+        index -= firstRow; // Global to local index
+
+    // Keep only the needed columns of the block
+    compressedBlock.resize(localRows, neededColumns.size());
+    for (size_t k = 0; k < neededColumns.size(); ++k)
+        compressedBlock.col(k) = localBlock->col(neededColumns[k]);
+    sendBuffer.resize(sendIndices.size());
+    neededEntries.resize(neededColumns.size());
+}
+
+template <typename T>
+void DistributedOperator<T>::Partition(int size, int rank, int processes, int &firstRow, int &lastRow)
+{
+    ParallelKernels::Partition(size, processes, 1, rank, firstRow, lastRow);
+}
+
+template <typename T>
+void DistributedOperator<T>::Apply(const Vector<T> &x, Vector<T> &y)
+{
+    if (x.size() != localRows)
+        throw std::invalid_argument("The vector does not match the local rows of the matrix (DistributedOperator)");
+
+    // Exchange the needed entries with the processes storing them only
+    TraceSpan exchangeSpan("halo exchange", "mpi");
+    double start = MPI_Wtime();
+    for (size_t k = 0; k < sendIndices.size(); ++k)
+        sendBuffer[k] = x(sendIndices[k]);
+    std::vector<MPI_Request> requests;
+    for (int p = 0; p < processes; ++p)
+    {
+        if (p == rank)
+        {
+            std::copy_n(sendBuffer.data() + sendOffsets[p], sendCounts[p], neededEntries.data() + receiveOffsets[p]);
+            continue;
+        }
+        if (receiveCounts[p] > 0)
+        {
+            requests.emplace_back();
+            MPI_Irecv(neededEntries.data() + receiveOffsets[p], receiveCounts[p], MpiType<T>(), p, 0, communicator, &requests.back());
+        }
+        if (sendCounts[p] > 0)
+        {
+            requests.emplace_back();
+            MPI_Isend(sendBuffer.data() + sendOffsets[p], sendCounts[p], MpiType<T>(), p, 0, communicator, &requests.back());
+        }
+    }
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    double exchanged = MPI_Wtime();
+    exchangeSpan.End();
+
+    // Local product with the compressed block
+    TraceSpan productSpan("matvec", "solver");
+    CounterRegion productRegion("matvec");
+    ParallelKernels::MatVec(compressedBlock, neededEntries, y);
+    double computed = MPI_Wtime();
+
+    communicationSeconds += exchanged - start;
+    computeSeconds += computed - exchanged;
+    ++products;
+}
+
+template <typename T>
+void DistributedOperator<T>::Reduce(Vector<T> &values)
+{
+    TraceSpan span("allreduce", "mpi");
+    double start = MPI_Wtime();
+    MPI_Allreduce(MPI_IN_PLACE, values.data(), values.size(), MpiType<T>(), MPI_SUM, communicator);
+    communicationSeconds += MPI_Wtime() - start;
+}
+
+template <typename T>
+typename DistributedOperator<T>::Timings DistributedOperator<T>::GetTimings() const
+{
+    long exchangedEntries = std::accumulate(receiveCounts.begin(), receiveCounts.end(), 0L) - receiveCounts[rank];
+    return {computeSeconds, communicationSeconds, products, exchangedEntries};
+}
+
+template <typename T>
+void DistributedOperator<T>::ResetTimings()
+{
+    computeSeconds = 0.0;
+    communicationSeconds = 0.0;
+    products = 0;
+}
+
+template <typename T>
+void DistributedOperator<T>::PrintTimings() const
+{
+    Timings timings = GetTimings();
+    double local[2] = {timings.computeSeconds, timings.communicationSeconds};
+    double maximum[2];
+    long exchangedEntries;
+    MPI_Reduce(local, maximum, 2, MPI_DOUBLE, MPI_MAX, 0, communicator);
+    MPI_Reduce(&timings.exchangedEntries, &exchangedEntries, 1, MPI_LONG, MPI_SUM, 0, communicator);
+    if (rank != 0)
+        return;
+
+    double total = maximum[0] + maximum[1];
+    std::cout << "==== DISTRIBUTED TIMINGS ====" << std::endl;
+    std::cout << "Processes: " << processes << std::endl;
+    std::cout << "Matrix-vector products: " << timings.products << std::endl;
+    std::cout << "Vector entries exchanged per product (all processes): " << exchangedEntries << std::endl;
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "Compute time (max over processes): " << maximum[0] << " s" << std::endl;
+    std::cout << "Communication time (max over processes): " << maximum[1] << " s" << std::endl;
+    std::cout << std::setprecision(1) << "Communication fraction: " << (total > 0.0 ? 100.0 * maximum[1] / total : 0.0) << "%" << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+// Explicit instantiations
+template class DistributedOperator<float>;
+template class DistributedOperator<double>;
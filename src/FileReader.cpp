@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+#include "FileReader.hpp"
+#include "TaskScheduler.hpp"
+
+namespace
+{
+    // Number of ranges of lines per worker (for load balancing), and minimum size of a range in bytes
+    const int RANGES_PER_WORKER = 4;
+    const size_t MIN_RANGE_BYTES = 1 << 16;
+
+    // Returns the end of the line starting at begin: its newline, or end if there is none
+    const char *LineEnd(const char *begin, const char *end)
+    {
+        const void *newline = std::memchr(begin, '\n', end - begin);
+        return newline != nullptr ? static_cast<const char *>(newline) : end;
+    }
+
+    // Returns the end of the field starting at begin: its separator, or the end of the line
+    const char *FieldEnd(const char *begin, const char *lineEnd, char separator)
+    {
+        const void *found = std::memchr(begin, separator, lineEnd - begin);
+        return found != nullptr ? static_cast<const char *>(found) : lineEnd;
+    }
+}
+
+template <typename T>
+std::string FileReader<T>::ReadRemaining(std::ifstream &file)
+{
+    const std::streampos start = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streampos end = file.tellg();
+    file.seekg(start);
+    std::string contents(static_cast<size_t>(end - start), '\0');
+    file.read(contents.data(), contents.size());
+    contents.resize(static_cast<size_t>(file.gcount()));
+    return contents;
+}
+
+template <typename T>
+std::vector<typename FileReader<T>::LineRange> FileReader<T>::SplitLines(const std::string &contents, size_t &numLines)
+{
+    const size_t size = contents.size();
+    const char *data = contents.data();
+    const size_t count = std::max<size_t>(1, std::min<size_t>(RANGES_PER_WORKER * TaskScheduler::Instance().GetNumWorkers(), size / MIN_RANGE_BYTES));
+
+    // Equal ranges, each boundary moved after the next newline
+    std::vector<LineRange> ranges(count);
+    size_t begin = 0;
+    for (size_t range = 0; range < count; ++range)
+    {
+        size_t end = size;
+        if (range + 1 < count)
+            end = std::min(size, static_cast<size_t>(LineEnd(data + std::max(begin, (range + 1) * (size / count)), data + size) - data) + 1);
+        ranges[range] = {begin, end, 0};
+        begin = end;
+    }
+
+    // Count the lines of each range in parallel, then number them
+    std::vector<size_t> lines(count);
+    TaskScheduler::Instance().ParallelFor(0, static_cast<int>(count), 1, [&](int firstRange, int lastRange)
+                                          {
+        for (int range = firstRange; range < lastRange; ++range)
+            lines[range] = std::count(data + ranges[range].begin, data + ranges[range].end, '\n'); });
+    numLines = 0;
+    for (size_t range = 0; range < count; ++range)
+    {
+        ranges[range].firstLine = numLines;
+        numLines += lines[range];
+    }
+    if (size > 0 && data[size - 1] != '\n')
+        ++numLines;
+    return ranges;
+}
+
+template <typename T>
+bool FileReader<T>::ParseValue(const char *begin, const char *end, T &value, const char *&next)
+{
+    char *stop;
+    errno = 0;
+    if constexpr (std::is_same_v<T, float>)
+        value = std::strtof(begin, &stop);
+    else
+        value = static_cast<T>(std::strtod(begin, &stop));
+    next = stop;
+    // The value must not run into the next field (e.g. an empty field followed by spaces)
+    return stop != begin && stop <= end && errno != ERANGE;
+}
+
+template <typename T>
+MatrixPointer<T> FileReader<T>::ReadDelimited(char separator, const std::string &format)
+{
+    std::ifstream file(std::string(Paths::PATH_MATRICES).append(fileName), std::ios::binary);
+    if (!file.is_open()) // We make sure the file exists, otherwise throw an error
+        throw FileException("Failed to open " + format + " file: " + fileName);
+    const std::string contents = ReadRemaining(file);
+    file.close();
+    const char *data = contents.data();
+    const char *dataEnd = data + contents.size();
+
+    // The number of rows is the number of lines, the number of columns the number of values of the first line
+    size_t numRows = 0;
+    std::vector<LineRange> ranges = SplitLines(contents, numRows);
+    if (numRows == 0)
+        throw FileException(format + " file is empty: " + fileName);
+    size_t numCols = 0;
+    const char *firstLineEnd = LineEnd(data, dataEnd);
+    for (const char *field = data; field < firstLineEnd; field = FieldEnd(field, firstLineEnd, separator) + 1)
+        ++numCols;
+
+    // Now we allocate the matrix, and parse the ranges of lines in parallel: each line is independent
+    auto matrixPointer = std::make_shared<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(numRows, numCols);
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> &matrix = *matrixPointer;
+    TaskScheduler::Instance().ParallelFor(0, static_cast<int>(ranges.size()), 1, [&](int firstRange, int lastRange)
+                                          {
+        for (int range = firstRange; range < lastRange; ++range)
+        {
+            size_t row = ranges[range].firstLine;
+            const char *rangeEnd = data + ranges[range].end;
+            for (const char *line = data + ranges[range].begin; line < rangeEnd; ++row)
+            {
+                const char *lineEnd = LineEnd(line, rangeEnd);
+                size_t col = 0;
+                for (const char *field = line; field < lineEnd; ++col)
+                {
+                    const char *fieldEnd = FieldEnd(field, lineEnd, separator);
+                    const char *next;
+                    if (col == numCols)
+                        throw FileException("Inconsistent number of columns in " + format + " file: " + fileName);
+                    if (!ParseValue(field, fieldEnd, matrix(row, col), next))
+                        throw FileException("Error parsing the " + format + " file " + fileName + " (line " + std::to_string(row + 1) + ": " + std::string(line, lineEnd) + ")");
+                    field = fieldEnd + 1;
+                }
+                if (col != numCols)
+                    throw FileException("Inconsistent number of columns in " + format + " file: " + fileName);
+                line = lineEnd + 1;
+            }
+        } });
+    return matrixPointer;
+}
+
+// Explicit instantiations
+template class FileReader<float>;
+template class FileReader<double>;
@@ -1,8 +1,14 @@
-#include <iostream>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <string>
 
 #include "FileReaderMTX.hpp"
+#include "TaskScheduler.hpp"
+#include "HardwareCounters.hpp"
+#include "Tracer.hpp"
 
 template <typename T>
 FileReaderMTX<T>::FileReaderMTX(const std::string &fileName) : FileReader<T>(fileName) {} // Calls the parent constructor
@@ -11,16 +17,13 @@ template <typename T>
 FileReaderMTX<T>::~FileReaderMTX() {}
 
 template <typename T>
-MatrixPointer<T> FileReaderMTX<T>::ReadFile()
+void FileReaderMTX<T>::OpenFile(std::ifstream &file, size_t &numRows, size_t &numCols)
 {
-    std::ifstream file(std::string(Paths::PATH_MATRICES).append(this->fileName));
+    file.open(std::string(Paths::PATH_MATRICES).append(this->fileName));
     if (!file.is_open()) // We make sure the file exists, otherwise throw an error
         throw FileException("Failed to open MTX file: " + this->fileName);
 
-    size_t numRows = 0;
-    size_t numCols = 0;
     std::string line;
-    T value;
 
     // First we skip the headers
     std::getline(file, line);
@@ -34,39 +37,117 @@ MatrixPointer<T> FileReaderMTX<T>::ReadFile()
     // We do another check to check that the file is not empty
     if (numRows == 0 || numCols == 0)
         throw FileException("MTX file is empty: " + this->fileName);
+}
+
+template <typename T>
+MatrixPointer<T> FileReaderMTX<T>::ReadFile()
+{
+    TraceSpan span("read mtx file", "input");
+    CounterRegion region("read mtx file");
+    std::ifstream file;
+    size_t numRows = 0;
+    size_t numCols = 0;
+    OpenFile(file, numRows, numCols);
 
     // Now we process with reading the file
     auto matrixPointer = std::make_shared<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(numRows, numCols);
     matrixPointer->setZero(); // Initialize matrix with zeros!
+    Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> &matrix = *matrixPointer;
 
-    while (std::getline(file, line))
-    {
-        std::istringstream lineStream(line);
-        size_t rowIdx;
-        size_t colIdx;
+    // The entries are read in a single buffer, and then parsed in parallel by ranges of lines
+    const std::string contents = this->ReadRemaining(file);
+    file.close();
+    const char *data = contents.data();
+    size_t numLines = 0;
+    const std::vector<typename FileReader<T>::LineRange> ranges = this->SplitLines(contents, numLines);
 
-        try
+    // One bit per entry marks the entries already set. When an entry appears on several lines, the parallel
+    // writes race: the entries are then applied again in the order of the file, so that the last one wins.
+    const size_t entries = numRows * numCols;
+    std::vector<std::atomic<std::uint64_t>> written((entries + 63) / 64);
+    std::atomic<bool> duplicates(false);
+    auto parseRange = [&](const typename FileReader<T>::LineRange &range, bool mark)
+    {
+        const char *rangeEnd = data + range.end;
+        for (const char *line = data + range.begin; line < rangeEnd;)
         {
-            lineStream >> rowIdx >> colIdx >> value;
-            if (lineStream.fail()) // If reading fails, throw an exception
+            const void *newline = std::memchr(line, '\n', rangeEnd - line);
+            const char *lineEnd = newline != nullptr ? static_cast<const char *>(newline) : rangeEnd;
+            char *stop;
+            const long rowIdx = std::strtol(line, &stop, 10) - 1; // Go to 0-based indexing in cpp
+            const char *next = stop;
+            const long colIdx = std::strtol(next, &stop, 10) - 1;
+            T value;
+            if (next == line || stop == next || stop > lineEnd || !this->ParseValue(stop, lineEnd, value, next))
+                throw FileException("Invalid value encountered in MTX file: " + this->fileName + " (line: " + std::string(line, lineEnd) + ")");
+            if (rowIdx < 0 || rowIdx >= static_cast<long>(numRows) || colIdx < 0 || colIdx >= static_cast<long>(numCols))
+                throw FileException("Invalid indices in MTX file: " + this->fileName);
+            matrix(rowIdx, colIdx) = value;
+            if (mark)
             {
-                throw FileException("Invalid value encountered in MTX file: " + this->fileName + " (line: " + line + ")");
+                const size_t entry = static_cast<size_t>(colIdx) * numRows + rowIdx;
+                const std::uint64_t bit = std::uint64_t(1) << (entry % 64);
+                if (written[entry / 64].fetch_or(bit, std::memory_order_relaxed) & bit)
+                    duplicates = true;
             }
+            line = lineEnd + 1;
         }
-        catch (const std::exception &e)
-        {
-            throw FileException("Error parsing value in MTX file: " + this->fileName + " (" + e.what() + ")");
-        }
+    };
+    TaskScheduler::Instance().ParallelFor(0, static_cast<int>(ranges.size()), 1, [&](int firstRange, int lastRange)
+                                          {
+        for (int range = firstRange; range < lastRange; ++range)
+            parseRange(ranges[range], true); });
+    if (duplicates)
+    {
+        for (const auto &range : ranges)
+            parseRange(range, false);
+    }
+
+    return matrixPointer;
+}
+
+template <typename T>
+void FileReaderMTX<T>::ReadDimensions(size_t &numRows, size_t &numCols)
+{
+    std::ifstream file;
+    OpenFile(file, numRows, numCols);
+}
+
+template <typename T>
+MatrixPointer<T> FileReaderMTX<T>::ReadRowBlock(size_t firstRow, size_t lastRow)
+{
+    TraceSpan span("read mtx rows", "input");
+    CounterRegion region("read mtx rows");
+    std::ifstream file;
+    size_t numRows = 0;
+    size_t numCols = 0;
+    OpenFile(file, numRows, numCols);
+    if (firstRow > lastRow || lastRow > numRows)
+        throw FileException("Invalid block of rows [" + std::to_string(firstRow) + ", " + std::to_string(lastRow) + ") in MTX file: " + this->fileName);
+
+    auto matrixPointer = std::make_shared<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(lastRow - firstRow, numCols);
+    matrixPointer->setZero(); // Initialize matrix with zeros!
+
+    // Stream the entries and only keep the ones of the block
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream lineStream(line);
+        size_t rowIdx;
+        size_t colIdx;
+        T value;
+        lineStream >> rowIdx >> colIdx >> value;
+        if (lineStream.fail()) // If reading fails, throw an exception
+            throw FileException("Invalid value encountered in MTX file: " + this->fileName + " (line: " + line + ")");
 
         rowIdx--; // Go to 0-based indexing in cpp
         colIdx--;
 
-        if (rowIdx < 0 || rowIdx >= numRows || colIdx < 0 || colIdx >= numCols)
+        if (rowIdx >= numRows || colIdx >= numCols)
             throw FileException("Invalid indices in MTX file: " + this->fileName);
-        (*matrixPointer)(rowIdx, colIdx) = value;
+        if (rowIdx >= firstRow && rowIdx < lastRow)
+            (*matrixPointer)(rowIdx - firstRow, colIdx) = value;
     }
-
-    file.close();
     return matrixPointer;
 }
 
@@ -0,0 +1,288 @@
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+#include "FixedSizeSolver.hpp"
+#include "Tracer.hpp"
+
+namespace
+{
+    // Slots of the buffers in the workspace of the solvers (only used at the start and the end of a solve)
+    enum WorkspaceSlot
+    {
+        ITERATE
+    };
+
+    template <typename T, int N>
+    using MatrixN = Eigen::Matrix<T, N, N>;
+    template <typename T, int N>
+    using VectorN = Eigen::Matrix<T, N, 1>;
+
+    // Checks that the solver has a matrix in memory of size N
+    template <typename T, int N>
+    void CheckSize(const AbstractIterativeSolver<T> &solver)
+    {
+        if (!solver.HasMatrix())
+            throw std::invalid_argument("The fixed-size solvers need a matrix stored in memory");
+        if (solver.GetMatrix()->rows() != N || solver.GetMatrix()->cols() != N)
+            throw std::invalid_argument("The fixed-size solver of size " + std::to_string(N) + " got a matrix of size " +
+                                        std::to_string(solver.GetMatrix()->rows()) + "x" + std::to_string(solver.GetMatrix()->cols()));
+    }
+
+    // Householder QR decomposition, R overwriting the matrix. Reflector H = I - beta v v^T of the column k
+    // below the diagonal, v = x + sign(x_0) ||x|| e_1 (a zero column is skipped). The last reflector only
+    // changes the signs of the last row of R and of the last column of Q, which cancel in RQ: it is skipped.
+    template <typename T, int N>
+    void HouseholderQr(MatrixN<T, N> &R, MatrixN<T, N> &Q)
+    {
+        Q.setIdentity();
+        VectorN<T, N> v;
+        VectorN<T, N> w;
+        for (int k = 0; k < N - 1; ++k)
+        {
+            T squaredNorm = 0;
+            for (int i = k; i < N; ++i)
+            {
+                v(i) = R(i, k);
+                squaredNorm += v(i) * v(i);
+            }
+            if (squaredNorm == T(0))
+                continue;
+            const T x0 = v(k);
+            v(k) += x0 >= 0 ? std::sqrt(squaredNorm) : -std::sqrt(squaredNorm);
+            const T beta = 2 / (squaredNorm - x0 * x0 + v(k) * v(k));
+
+            // R = H R on the columns k to N - 1
+            for (int j = k; j < N; ++j)
+            {
+                T dot = 0;
+                for (int i = k; i < N; ++i)
+                    dot += v(i) * R(i, j);
+                dot *= beta;
+                for (int i = k; i < N; ++i)
+                    R(i, j) -= dot * v(i);
+            }
+
+            // Q = Q H: w = beta Q v, then Q -= w v^T (column by column)
+            w.setZero();
+            for (int j = k; j < N; ++j)
+                for (int i = 0; i < N; ++i)
+                    w(i) += Q(i, j) * v(j);
+            w *= beta;
+            for (int j = k; j < N; ++j)
+                for (int i = 0; i < N; ++i)
+                    Q(i, j) -= w(i) * v(j);
+        }
+    }
+
+    // P = R Q, with R the upper triangular part of the matrix (its lower part is not read)
+    template <typename T, int N>
+    void UpperTimes(const MatrixN<T, N> &R, const MatrixN<T, N> &Q, MatrixN<T, N> &P)
+    {
+        for (int j = 0; j < N; ++j)
+            for (int i = 0; i < N; ++i)
+            {
+                T sum = 0;
+                for (int k = i; k < N; ++k)
+                    sum += R(i, k) * Q(k, j);
+                P(i, j) = sum;
+            }
+    }
+
+    // Returns whether the entries below the subdiagonal are zero
+    template <typename T, int N>
+    bool IsHessenberg(const MatrixN<T, N> &A)
+    {
+        for (int j = 0; j + 2 < N; ++j)
+            for (int i = j + 2; i < N; ++i)
+                if (A(i, j) != T(0))
+                    return false;
+        return true;
+    }
+
+    // Sum of the absolute values below the diagonal (only the subdiagonal for a Hessenberg matrix)
+    template <typename T, int N>
+    T LowerPartSum(const MatrixN<T, N> &A, bool hessenberg)
+    {
+        T sum = 0;
+        for (int j = 0; j + 1 < N; ++j)
+        {
+            const int last = hessenberg ? j + 2 : N;
+            for (int i = j + 1; i < last; ++i)
+                sum += std::abs(A(i, j));
+        }
+        return sum;
+    }
+
+    // Factory of the fixed-size solvers of a size
+    template <typename T, int N>
+    std::unique_ptr<AbstractIterativeSolver<T>> CreateSolver(const std::string &methodName, double tolerance, int maxIter, double shift)
+    {
+        if (methodName == "QR_method")
+            return std::make_unique<FixedSizeQrSolver<T, N>>(tolerance, maxIter);
+        return std::make_unique<FixedSizePowerSolver<T, N>>(tolerance, maxIter, shift);
+    }
+
+    // Table of the factories of the sizes 2 to MAX_FIXED_SIZE
+    template <typename T, int... Sizes>
+    constexpr auto MakeCreators(std::integer_sequence<int, Sizes...>)
+    {
+        using Creator = std::unique_ptr<AbstractIterativeSolver<T>> (*)(const std::string &, double, int, double);
+        return std::array<Creator, sizeof...(Sizes)>{&CreateSolver<T, Sizes + 2>...};
+    }
+}
+
+template <typename T, int N>
+Vector<T> FixedSizeQrSolver<T, N>::FindEigenvalues()
+{
+    TraceSpan span("qr method (fixed size)", "solver");
+    CheckSize<T, N>(*this);
+    int maxIter = this->GetMaxIter();
+    int iterCount = 0;
+    this->report = SolverReport();
+    this->monitor.Reset();
+
+    // The iterate, its factors and the Schur vectors are on the stack
+    MatrixN<T, N> A = *this->GetMatrix();
+    MatrixN<T, N> Q;
+    MatrixN<T, N> product;
+    MatrixN<T, N> Z;
+
+    // Warm start: A_0 = Z^T A Z, with Z the orthonormalized vectors (see QrMethodSolver)
+    const bool exportVectors = this->ExportsVectors();
+    if (this->HasWarmStart())
+    {
+        const Matrix<T> &V = this->WarmStartVectors(N);
+        if (V.cols() != N)
+            throw std::invalid_argument("The warm start of the QR method needs " + std::to_string(N) + " vectors (" +
+                                        std::to_string(V.cols()) + " given)");
+        // Once per solve: the dynamic-size decomposition (instantiated once, not for each size) is enough
+        Z = Matrix<T>(Eigen::HouseholderQR<Matrix<T>>(V).householderQ());
+        product.noalias() = Z.transpose() * A;
+        A.noalias() = product * Z;
+        this->report.warmStarted = true;
+    }
+    else if (exportVectors)
+        Z.setIdentity();
+
+    const bool hessenberg = IsHessenberg<T, N>(A);
+    while (!this->monitor.Converged() && iterCount < maxIter)
+    {
+        // A = QR (R overwrites A), then A = RQ
+        HouseholderQr<T, N>(A, Q);
+        UpperTimes<T, N>(A, Q, product);
+        A = product;
+        if (exportVectors)
+        {
+            product.noalias() = Z * Q;
+            Z = product;
+        }
+        ++iterCount;
+
+        if (this->monitor.IsCheckDue(iterCount) || iterCount == maxIter)
+            this->monitor.Check(LowerPartSum<T, N>(A, hessenberg));
+        this->monitor.Record(iterCount, A(0, 0));
+    }
+    if (iterCount >= maxIter)
+    {
+        std::cerr << "[WARNING] Maximum number of iterations reached.\n"
+                  << "          Consider using a higher number for the maximum number of iterations."
+                  << std::endl;
+    }
+    this->report.iterations = iterCount;
+    this->report.converged = this->monitor.Converged();
+    this->RecordConvergence(hessenberg ? "subdiagonal" : "lower_part");
+    std::cout << "Total number of iterations: " << iterCount << std::endl;
+    Vector<T> eigenvalues = A.diagonal();
+    this->RecordResult(eigenvalues, exportVectors ? Matrix<T>(Z) : Matrix<T>());
+    if (this->OwnsMatrix())
+        this->ReleaseMatrix();
+    return eigenvalues;
+}
+
+template <typename T, int N>
+Vector<T> FixedSizePowerSolver<T, N>::FindEigenvalues()
+{
+    TraceSpan span("power method (fixed size)", "solver");
+    CheckSize<T, N>(*this);
+    int maxIter = this->GetMaxIter();
+    int iterCount = 0;
+    this->report = SolverReport();
+    this->monitor.Reset();
+    const T shiftValue = static_cast<T>(shift);
+
+    const MatrixN<T, N> A = *this->GetMatrix();
+    VectorN<T, N> x;
+    VectorN<T, N> y;
+    Vector<T> &initial = this->workspace.GetVector(ITERATE);
+    if (this->InitialVector(initial))
+        x = initial;
+    else
+        x.setOnes();
+    x.normalize();
+
+    // y = (A - shift I) x, with the Rayleigh quotient x^T y (x is normalized), as in PowerMethodSolver
+    y.noalias() = A * x - shiftValue * x;
+    T xDotY = x.dot(y);
+    T lambdaOld = xDotY;
+    T lambdaNew = lambdaOld;
+    T lambdaOlder = lambdaOld;
+    double rate = 0.0;
+
+    while (!this->monitor.Converged() && iterCount < maxIter)
+    {
+        x = y / y.norm();
+        y.noalias() = A * x - shiftValue * x;
+        xDotY = x.dot(y);
+        lambdaNew = xDotY;
+        ++iterCount;
+
+        if (iterCount >= 2 && lambdaOld != lambdaOlder)
+            rate = std::abs((lambdaNew - lambdaOld) / (lambdaOld - lambdaOlder));
+
+        if (this->monitor.UsesResidual())
+        {
+            // Residual of the pair (x, x^T A x): y holds (A - shift I) x, and x is normalized
+            if (this->monitor.IsCheckDue(iterCount))
+                this->monitor.Check((y - xDotY * x).norm() / std::abs(lambdaNew + shiftValue));
+        }
+        else
+            this->monitor.CheckChange(lambdaNew, lambdaOld);
+        this->monitor.Record(iterCount, lambdaNew + shiftValue);
+
+        lambdaOlder = lambdaOld;
+        lambdaOld = lambdaNew;
+    }
+
+    this->report.iterations = iterCount;
+    this->report.convergenceRate = rate;
+    this->report.converged = this->monitor.Converged();
+    this->RecordConvergence(this->monitor.GetCriterion());
+    if (!this->report.converged)
+    {
+        std::cerr << "[WARNING] Maximum number of iterations reached.\n"
+                  << "          Consider using a higher number for the maximum number of iterations."
+                  << std::endl;
+    }
+    std::cout << "Total number of iterations: " << iterCount << std::endl;
+
+    Vector<T> result(1);
+    result(0) = lambdaNew + shiftValue;
+    initial = x;
+    this->RecordResult(result, initial);
+    return result;
+}
+
+template <typename T>
+std::unique_ptr<AbstractIterativeSolver<T>> CreateFixedSizeSolver(const std::string &methodName, int size, double tolerance, int maxIter, double shift)
+{
+    static constexpr auto creators = MakeCreators<T>(std::make_integer_sequence<int, DefaultSolverArgs::MAX_FIXED_SIZE - 1>());
+    if ((methodName != "QR_method" && methodName != "power_method") || size < 2 || size > DefaultSolverArgs::MAX_FIXED_SIZE)
+        return nullptr;
+    return creators[size - 2](methodName, tolerance, maxIter, shift);
+}
+
+// Explicit instantiations (the solvers of each size are instantiated by the table of the factories)
+template std::unique_ptr<AbstractIterativeSolver<float>> CreateFixedSizeSolver<float>(const std::string &, int, double, int, double);
+template std::unique_ptr<AbstractIterativeSolver<double>> CreateFixedSizeSolver<double>(const std::string &, int, double, int, double);
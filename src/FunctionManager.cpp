@@ -1,8 +1,26 @@
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <string>
 
 #include "FunctionManager.hpp"
 
+namespace
+{
+    // Seed of the random matrices: the same matrices in every run
+    const std::uint64_t RANDOM_SEED = 20240917;
+
+    // Number uniform in [-1, 1) depending only on the indices (SplitMix64 hash of the seed and the indices)
+    double HashUniform(int row, int col)
+    {
+        std::uint64_t z = RANDOM_SEED + ((static_cast<std::uint64_t>(row) << 32) | static_cast<std::uint32_t>(col)) * 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z ^= z >> 31;
+        return static_cast<double>(z >> 11) * 0x1.0p-52 - 1.0; // 53 random bits
+    }
+}
+
 template <typename T>
 FunctionManager<T>::FunctionManager(const std::string &functionName)
 {
@@ -12,6 +30,15 @@ FunctionManager<T>::FunctionManager(const std::string &functionName)
     else if (functionName == "hilbert")
         selectedFunction = [this](int row, int col)
         { return FunctionManager::HilbertMatrix(row, col); };
+    else if (functionName == "laplacian")
+        selectedFunction = [this](int row, int col)
+        { return FunctionManager::LaplacianMatrix(row, col); };
+    else if (functionName == "random")
+        selectedFunction = [this](int row, int col)
+        { return FunctionManager::RandomMatrix(row, col); };
+    else if (functionName == "random_symmetric")
+        selectedFunction = [this](int row, int col)
+        { return FunctionManager::RandomSymmetricMatrix(row, col); };
     else
         throw std::invalid_argument("Unknown function name (" + functionName + ") during matrix initialization");
 }
@@ -43,6 +70,26 @@ T FunctionManager<T>::HilbertMatrix(int row, int col)
     return returnValue;
 }
 
+template <typename T>
+T FunctionManager<T>::LaplacianMatrix(int row, int col)
+{
+    if (row == col)
+        return static_cast<T>(2.0);
+    return std::abs(row - col) == 1 ? static_cast<T>(-1.0) : static_cast<T>(0.0);
+}
+
+template <typename T>
+T FunctionManager<T>::RandomMatrix(int row, int col)
+{
+    return static_cast<T>(HashUniform(row, col));
+}
+
+template <typename T>
+T FunctionManager<T>::RandomSymmetricMatrix(int row, int col)
+{
+    return static_cast<T>(HashUniform(std::min(row, col), std::max(row, col)));
+}
+
 // Explicit instantiations
 template class FunctionManager<float>;
 template class FunctionManager<double>;
\ No newline at end of file
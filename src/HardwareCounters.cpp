@@ -0,0 +1,195 @@
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "HardwareCounters.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Bytes moved between the memory and the last-level cache per miss (one cache line)
+    const double CACHE_LINE_BYTES = 64.0;
+
+#ifdef __linux__
+    // Type and configuration of the perf event of each counter
+    const std::array<std::pair<unsigned, unsigned long>, HardwareCounters::NUM_COUNTERS> EVENTS = {{
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    }};
+
+    // Opens a counter of a thread (user space only), returns -1 if it is not available
+    int OpenCounter(int counter, int threadId)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = EVENTS[counter].first;
+        attributes.config = EVENTS[counter].second;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, threadId, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    // Reads a counter, scaled by the fraction of time it was scheduled
+    double ReadCounter(int descriptor)
+    {
+        unsigned long values[3] = {0, 0, 0}; // Value, time enabled, time running
+        if (read(descriptor, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) || values[2] == 0)
+            return 0.0;
+        return static_cast<double>(values[0]) * values[1] / values[2];
+    }
+#endif
+
+    // Formats a count with a metric suffix
+    std::string FormatCount(double count)
+    {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(2);
+        if (count >= 1e9)
+            text << count * 1e-9 << " G";
+        else if (count >= 1e6)
+            text << count * 1e-6 << " M";
+        else if (count >= 1e3)
+            text << count * 1e-3 << " k";
+        else
+            text << std::setprecision(0) << count;
+        return text.str();
+    }
+}
+
+HardwareCounters &HardwareCounters::Instance()
+{
+    static HardwareCounters counters;
+    return counters;
+}
+
+HardwareCounters::~HardwareCounters()
+{
+    Disable();
+}
+
+bool HardwareCounters::Enable()
+{
+    Disable();
+    available.fill(false);
+#ifdef __linux__
+    // One set of counters per thread of the process (main thread and workers)
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator("/proc/self/task", error))
+    {
+        const int threadId = std::stoi(entry.path().filename().string());
+        std::array<int, NUM_COUNTERS> threadDescriptors;
+        for (int counter = 0; counter < NUM_COUNTERS; ++counter)
+        {
+            threadDescriptors[counter] = OpenCounter(counter, threadId);
+            available[counter] = available[counter] || threadDescriptors[counter] >= 0;
+        }
+        descriptors.push_back(threadDescriptors);
+    }
+#endif
+    bool any = false;
+    for (bool counterAvailable : available)
+        any = any || counterAvailable;
+    if (!any)
+        Disable();
+    enabled.store(any, std::memory_order_relaxed);
+    return any;
+}
+
+void HardwareCounters::Disable()
+{
+    enabled.store(false, std::memory_order_relaxed);
+#ifdef __linux__
+    for (const auto &threadDescriptors : descriptors)
+        for (int descriptor : threadDescriptors)
+            if (descriptor >= 0)
+                close(descriptor);
+#endif
+    descriptors.clear();
+}
+
+HardwareCounters::Sample HardwareCounters::Read() const
+{
+    Sample sample{};
+#ifdef __linux__
+    for (const auto &threadDescriptors : descriptors)
+        for (int counter = 0; counter < NUM_COUNTERS; ++counter)
+            if (threadDescriptors[counter] >= 0)
+                sample[counter] += ReadCounter(threadDescriptors[counter]);
+#endif
+    return sample;
+}
+
+void HardwareCounters::AddRegion(const char *name, const Sample &start, const Sample &end, double seconds)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Region &region = regions[name];
+    ++region.calls;
+    region.seconds += seconds;
+    for (int counter = 0; counter < NUM_COUNTERS; ++counter)
+        region.counts[counter] += end[counter] - start[counter];
+}
+
+std::map<std::string, HardwareCounters::Region> HardwareCounters::GetRegions() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return regions;
+}
+
+void HardwareCounters::Reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    regions.clear();
+}
+
+void HardwareCounters::PrintReport() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::cout << "==== HARDWARE COUNTERS ====" << std::endl;
+    if (!available[CYCLES] || !available[INSTRUCTIONS] || !available[LLC_MISSES])
+        std::cout << "Counters not provided by the system are shown as n/a (see /proc/sys/kernel/perf_event_paranoid)" << std::endl;
+    std::cout << std::left << std::setw(28) << "Region" << std::right << std::setw(8) << "Calls" << std::setw(12) << "Time (ms)"
+              << std::setw(12) << "CPU (ms)" << std::setw(12) << "Cycles" << std::setw(12) << "Instr." << std::setw(8) << "IPC"
+              << std::setw(12) << "LLC miss" << std::setw(10) << "GB/s" << std::setw(12) << "Instr./B" << std::endl;
+
+    auto column = [](bool shown, const std::string &text, int width)
+    {
+        std::cout << std::setw(width) << (shown ? text : "n/a");
+    };
+    for (const auto &[name, region] : regions)
+    {
+        const Sample &counts = region.counts;
+        const double bytes = counts[LLC_MISSES] * CACHE_LINE_BYTES;
+        std::ostringstream time;
+        std::ostringstream cpuTime;
+        std::ostringstream ipc;
+        std::ostringstream bandwidth;
+        std::ostringstream intensity;
+        time << std::fixed << std::setprecision(3) << region.seconds * 1e3;
+        cpuTime << std::fixed << std::setprecision(3) << counts[CPU_TIME] * 1e-6;
+        ipc << std::fixed << std::setprecision(2) << (counts[CYCLES] > 0 ? counts[INSTRUCTIONS] / counts[CYCLES] : 0.0);
+        bandwidth << std::fixed << std::setprecision(2) << (region.seconds > 0 ? bytes / region.seconds * 1e-9 : 0.0);
+        intensity << std::fixed << std::setprecision(2) << (bytes > 0 ? counts[INSTRUCTIONS] / bytes : 0.0);
+
+        std::cout << std::left << std::setw(28) << name << std::right << std::setw(8) << region.calls << std::setw(12) << time.str();
+        column(available[CPU_TIME], cpuTime.str(), 12);
+        column(available[CYCLES], FormatCount(counts[CYCLES]), 12);
+        column(available[INSTRUCTIONS], FormatCount(counts[INSTRUCTIONS]), 12);
+        column(available[CYCLES] && available[INSTRUCTIONS], ipc.str(), 8);
+        column(available[LLC_MISSES], FormatCount(counts[LLC_MISSES]), 12);
+        column(available[LLC_MISSES], bandwidth.str(), 10);
+        column(available[INSTRUCTIONS] && available[LLC_MISSES], intensity.str(), 12);
+        std::cout << std::endl;
+    }
+    std::cout << "(counters summed over the threads; memory traffic estimated as 64 bytes per last-level cache miss)" << std::endl;
+}
@@ -1,66 +1,337 @@
+#include <chrono>
 #include <iostream>
+#include <limits>
+#include <type_traits>
 
 #include "InversePowerMethodSolver.hpp"
+#include "ParallelKernels.hpp"
+#include "HardwareCounters.hpp"
+#include "Roofline.hpp"
+#include "Tracer.hpp"
+
+namespace
+{
+    // Slots of the buffers of the iterations in the workspace of the solver
+    enum WorkspaceSlot
+    {
+        ITERATE,
+        NEXT_ITERATE,
+        RIGHT_HAND_SIDE,
+        PRODUCT,
+        RESIDUAL
+    };
+    const int SHIFTED_MATRIX = 0;
+
+    // The refinement stagnates when a step reduces the residual by less than this factor
+    const double STAGNATION_RATIO = 0.5;
+    // The iterates have unit norm: a solve whose residual exceeds this value leaves most of its right-hand side in the
+    // numerical null space of the shifted matrix, which is then too badly conditioned
+    const double MAX_SOLVE_RESIDUAL = 0.5;
+
+    // Returns the time elapsed since start, in seconds
+    double SecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
 
 template <typename T>
-InversePowerMethodSolver<T>::InversePowerMethodSolver(double tolerance, int maxIter, double shift)
-    : AbstractIterativeSolver<T>(tolerance, maxIter), shift(shift) {}
+InversePowerMethodSolver<T>::InversePowerMethodSolver(double tolerance, int maxIter, double shift, const std::string &factorization)
+    : AbstractIterativeSolver<T>(tolerance, maxIter), shift(shift), factorizationMode(factorization)
+{
+    if (SupportedArguments::SUPPORTED_FACTORIZATIONS.find(factorization) == SupportedArguments::SUPPORTED_FACTORIZATIONS.end())
+        throw std::invalid_argument("unsupported factorization for the inverse power method (" + factorization + ")");
+}
 
 template <typename T>
 InversePowerMethodSolver<T>::~InversePowerMethodSolver() {}
 
+template <typename T>
+template <typename Decomposition, typename VectorType>
+void InversePowerMethodSolver<T>::ApplyQTranspose(const Decomposition &qr, VectorType &c)
+{
+    // Q = H_0 H_1 ... H_{m-1}, with H_k = I - tau_k v_k v_k^T and v_k = [0, ..., 0, 1, essential part]:
+    // the reflectors are applied one by one, which needs no temporary
+    using Scalar = typename VectorType::Scalar;
+    const auto &reflectors = qr.matrixQR();
+    const auto &tau = qr.hCoeffs();
+    const int n = c.size();
+    const double size = n, reflectorCount = qr.nonzeroPivots();
+    RooflineRegion region("apply q^t", 4 * reflectorCount * size - 2 * reflectorCount * reflectorCount,
+                          sizeof(Scalar) * (reflectorCount * size - reflectorCount * reflectorCount / 2 + 2 * size));
+    for (int k = 0; k < qr.nonzeroPivots(); ++k)
+    {
+        auto essential = reflectors.col(k).tail(n - k - 1);
+        Scalar projection = c(k) + essential.dot(c.tail(n - k - 1));
+        c(k) -= tau(k) * projection;
+        c.tail(n - k - 1) -= (tau(k) * projection) * essential;
+    }
+}
+
+template <typename T>
+template <typename Decomposition, typename VectorType>
+void InversePowerMethodSolver<T>::ApplyQ(const Decomposition &qr, VectorType &c)
+{
+    // Same reflectors as ApplyQTranspose, in the reverse order
+    using Scalar = typename VectorType::Scalar;
+    const auto &reflectors = qr.matrixQR();
+    const auto &tau = qr.hCoeffs();
+    const int n = c.size();
+    const double size = n, reflectorCount = qr.nonzeroPivots();
+    RooflineRegion region("apply q", 4 * reflectorCount * size - 2 * reflectorCount * reflectorCount,
+                          sizeof(Scalar) * (reflectorCount * size - reflectorCount * reflectorCount / 2 + 2 * size));
+    for (int k = qr.nonzeroPivots() - 1; k >= 0; --k)
+    {
+        auto essential = reflectors.col(k).tail(n - k - 1);
+        Scalar projection = c(k) + essential.dot(c.tail(n - k - 1));
+        c(k) -= tau(k) * projection;
+        c.tail(n - k - 1) -= (tau(k) * projection) * essential;
+    }
+}
+
+template <typename T>
+template <typename Decomposition, typename VectorType>
+void InversePowerMethodSolver<T>::SolveFactorized(const Decomposition &qr, VectorType &c, VectorType &x)
+{
+    // x = P R^-1 Q^T c (only the first rank columns of R are used)
+    using Scalar = typename VectorType::Scalar;
+    const int n = c.size();
+    const int rank = qr.rank();
+    ApplyQTranspose(qr, c);
+    c.tail(n - rank).setZero();
+    ParallelKernels::SolveUpperTriangular<Scalar>(qr.matrixQR().topLeftCorner(rank, rank), c.head(rank));
+    x.noalias() = qr.colsPermutation() * c;
+}
+
+template <typename T>
+void InversePowerMethodSolver<T>::FactorizeFull(const Matrix<T> &A)
+{
+    TraceSpan span("factorization", "solver");
+    CounterRegion region("factorization");
+    const int n = A.rows();
+    const double size = n;
+    RooflineRegion roofline("factorization", 4.0 / 3.0 * size * size * size, sizeof(T) * 3 * size * size);
+    Matrix<T> &A_shifted = this->workspace.GetMatrix(SHIFTED_MATRIX, n, n);
+    A_shifted = A;
+    A_shifted.diagonal().array() -= static_cast<T>(shift);
+    factorization.compute(A_shifted);
+}
+
+template <typename T>
+void InversePowerMethodSolver<T>::SolveWithRefinement(const Matrix<T> &A, const Vector<T> &b, Vector<T> &x)
+{
+    TraceSpan span("refined solve", "solver");
+    CounterRegion region("refined solve");
+    Vector<T> &c = this->workspace.GetVector(RIGHT_HAND_SIDE);
+    if (fellBack)
+    {
+        c = b;
+        SolveFactorized(factorization, c, x);
+        return;
+    }
+
+    // First solution in float
+    lowRightHandSide = b.template cast<float>();
+    SolveFactorized(lowFactorization, lowRightHandSide, lowSolution);
+    x = lowSolution.template cast<T>();
+
+    // Refine until the residual is at the level of the rounding errors of T (backward stable solve)
+    Vector<T> &residual = this->workspace.GetVector(RESIDUAL);
+    const T rhsNorm = b.norm();
+    const T roundoff = std::sqrt(static_cast<T>(b.size())) * std::numeric_limits<T>::epsilon();
+    T previousNorm = std::numeric_limits<T>::infinity();
+    for (int step = 0;; ++step)
+    {
+        // r = b - (A - shift I) x, in T
+        ParallelKernels::MatVec(A, x, residual);
+        residual = b - residual + static_cast<T>(shift) * x;
+        const T residualNorm = residual.norm();
+        if (residualNorm <= roundoff * (matrixNorm * x.norm() + rhsNorm))
+            return;
+
+        if (step == DefaultSolverArgs::MAX_REFINEMENT_STEPS || residualNorm > STAGNATION_RATIO * previousNorm)
+        {
+            // The float factorization is not accurate enough: factorize in T and solve again
+            std::cerr << "[WARNING] The iterative refinement stagnates: falling back to a " << (sizeof(T) == 8 ? "double" : "full")
+                      << " factorization." << std::endl;
+            auto start = std::chrono::steady_clock::now();
+            FactorizeFull(A);
+            this->report.factorizationSeconds += SecondsSince(start);
+            this->report.factorization = "mixed, fell back to full";
+            fellBack = true;
+            c = b;
+            SolveFactorized(factorization, c, x);
+            return;
+        }
+        previousNorm = residualNorm;
+
+        // Correction in float
+        lowRightHandSide = residual.template cast<float>();
+        SolveFactorized(lowFactorization, lowRightHandSide, lowSolution);
+        x += lowSolution.template cast<T>();
+        ++this->report.refinementSteps;
+    }
+}
+
 template <typename T>
 Vector<T> InversePowerMethodSolver<T>::FindEigenvalues()
 {
+    TraceSpan span("inverse power method", "solver");
+    MatrixPointer<T> A_ptr = this->GetMatrix();
+    const int n = A_ptr->rows();
+    Vector<T> &c = this->workspace.GetVector(RIGHT_HAND_SIDE);
+    const T shiftValue = static_cast<T>(shift);
+    T lambda;
+
+    this->report = SolverReport();
+    this->monitor.Reset();
+    auto start = std::chrono::steady_clock::now();
+    // A float factorization of a float matrix is the full factorization
+    if (factorizationMode == "mixed" && !std::is_same_v<T, float>)
+    {
+        // Float factorization of the shifted matrix: the original matrix is kept for the residuals
+        const Matrix<T> &A = *A_ptr;
+        TraceSpan factorizationSpan("factorization (float)", "solver");
+        CounterRegion factorizationRegion("factorization (float)");
+        const double size = n;
+        RooflineRegion factorizationRoofline("factorization (float)", 4.0 / 3.0 * size * size * size, (sizeof(T) + 2 * sizeof(float)) * size * size);
+        Matrix<float> lowMatrix = A.template cast<float>();
+        lowMatrix.diagonal().array() -= static_cast<float>(shift);
+        lowFactorization.compute(lowMatrix);
+        lowMatrix.resize(0, 0);
+        factorizationSpan.End();
+        factorizationRegion.End();
+        factorizationRoofline.End();
+        matrixNorm = std::sqrt(std::max(T(0), A.squaredNorm() - 2 * shiftValue * A.trace() + n * shiftValue * shiftValue));
+        fellBack = false;
+        this->report.factorization = "mixed";
+        this->report.factorizationSeconds = SecondsSince(start);
+
+        lambda = InverseIteration([&](const Vector<T> &b, Vector<T> &x)
+                                  { SolveWithRefinement(A, b, x); },
+                                  [&](const Vector<T> &x, Vector<T> &y)
+                                  { ParallelKernels::MatVec(A, x, y); y -= shiftValue * x; });
+        if (this->OwnsMatrix())
+            this->ReleaseMatrix();
+    }
+    else if (this->OwnsMatrix())
+    {
+        // The matrix is consumed: shift it and factorize it in its own storage (A P = Q R)
+        TraceSpan factorizationSpan("factorization (in place)", "solver");
+        CounterRegion factorizationRegion("factorization (in place)");
+        const double size = n;
+        RooflineRegion factorizationRoofline("factorization (in place)", 4.0 / 3.0 * size * size * size, sizeof(T) * 2 * size * size);
+        A_ptr->diagonal().array() -= shiftValue;
+        Eigen::ColPivHouseholderQR<Eigen::Ref<Matrix<T>>> inPlaceFactorization(*A_ptr);
+        factorizationSpan.End();
+        factorizationRegion.End();
+        factorizationRoofline.End();
+        this->report.factorization = "full";
+        this->report.factorizationSeconds = SecondsSince(start);
 
+        // Products with the shifted matrix from its factors: Q R P^T x
+        Vector<T> &permuted = this->workspace.GetVector(RESIDUAL);
+        lambda = InverseIteration([&](const Vector<T> &b, Vector<T> &x)
+                                  { c = b; SolveFactorized(inPlaceFactorization, c, x); },
+                                  [&](const Vector<T> &x, Vector<T> &y)
+                                  {
+                                      permuted.noalias() = inPlaceFactorization.colsPermutation().transpose() * x;
+                                      y.noalias() = inPlaceFactorization.matrixQR().template triangularView<Eigen::Upper>() * permuted;
+                                      ApplyQ(inPlaceFactorization, y); });
+        this->ReleaseMatrix();
+    }
+    else
+    {
+        // The shifted matrix does not change: factorize it once (A P = Q R)
+        FactorizeFull(*A_ptr);
+        this->report.factorization = "full";
+        this->report.factorizationSeconds = SecondsSince(start);
+
+        const Matrix<T> &A_shifted = this->workspace.GetMatrix(SHIFTED_MATRIX, n, n);
+        lambda = InverseIteration([&](const Vector<T> &b, Vector<T> &x)
+                                  { c = b; SolveFactorized(factorization, c, x); },
+                                  [&](const Vector<T> &x, Vector<T> &y)
+                                  { ParallelKernels::MatVec(A_shifted, x, y); });
+    }
+
+    if (this->report.iterations >= this->GetMaxIter())
+    {
+        std::cerr << "[WARNING] Maximum number of iterations reached.\n"
+                  << "          Consider using a higher number for the maximum number of iterations."
+                  << std::endl;
+    }
+    std::cout << "Total number of iterations: " << this->report.iterations << std::endl;
+
+    Vector<T> result(1);
+    result(0) = lambda + shift;
+    const Vector<T> &x = this->workspace.GetVector(ITERATE);
+    this->RecordResult(result, x / x.norm());
+    return result;
+}
+
+template <typename T>
+template <typename Solve, typename Multiply>
+T InversePowerMethodSolver<T>::InverseIteration(Solve &&solve, Multiply &&multiply)
+{
     // Get parameters from abstract class
-    double tolerance = this->GetTolerance();
     int maxIter = this->GetMaxIter();
-    double error = tolerance + 1.0;
     int iterCount = 0;
 
-    MatrixPointer<T> A_ptr = this->GetMatrix();
-    Matrix<T> A_shifted = *A_ptr - shift * Matrix<T>::Identity((*A_ptr).rows(), (*A_ptr).cols());
+    // The iterates live in the workspace: no allocation in the iteration loop
+    Vector<T> &x_ini = this->workspace.GetVector(ITERATE);
+    Vector<T> &x_new = this->workspace.GetVector(NEXT_ITERATE);
+    Vector<T> &Ax = this->workspace.GetVector(PRODUCT);
 
     // Declare initial guess
-    Vector<T> x_ini = Vector<T>::Ones(A_shifted.rows());
+    if (!this->InitialVector(x_ini))
+        x_ini.setOnes();
+    x_ini /= x_ini.norm();
 
-    T lambdaOld = (x_ini.transpose() * (A_shifted * x_ini)).value() / (x_ini.transpose() * x_ini).value();
-    T lambdaNew;
+    multiply(x_ini, Ax);
+    T lambdaOld = x_ini.dot(Ax) / x_ini.dot(x_ini);
+    T lambdaNew = lambdaOld;
 
-    while (error > tolerance && iterCount < maxIter)
+    while (!this->monitor.Converged() && iterCount < maxIter)
     {
-        Vector<T> x_new = A_shifted.colPivHouseholderQr().solve(x_ini);
-        Vector<T> solverError = (A_shifted * x_new) - x_ini;
+        // Solve A x_new = x_ini
+        TraceSpan solveSpan("solve", "solver");
+        CounterRegion solveRegion("solve");
+        solve(x_ini, x_new);
+        solveSpan.End();
+        solveRegion.End();
 
-        if (solverError.norm() > 1e16)
+        multiply(x_new, Ax);
+        if ((Ax - x_ini).norm() > MAX_SOLVE_RESIDUAL)
             throw SolverException("No solution: matrix is too badly conditioned. This method is unsuitable for eigenvalue computation in such cases.");
 
+        // Normalize the iterate, which otherwise grows by the inverse of the distance of the shift to the nearest
+        // eigenvalue at each iteration
+        const T scale = 1 / x_new.norm();
+        x_new *= scale;
+        Ax *= scale;
+
         // Compute eigenvalue lambda using Rayleigh quotient
-        lambdaNew = (x_new.transpose() * (A_shifted * x_new)).value() / (x_new.transpose() * x_new).value();
+        lambdaNew = x_new.dot(Ax) / x_new.dot(x_new);
 
-        // Compute error as abs(lambdaOld - lambdaNew)
-        error = std::abs(lambdaNew - lambdaOld) / std::abs(lambdaNew);
+        // Relative change of lambda, or residual of the eigenpair of the original matrix
+        if (!this->monitor.UsesResidual())
+            this->monitor.CheckChange(lambdaNew, lambdaOld);
+        else if (this->monitor.IsCheckDue(iterCount + 1))
+            this->monitor.CheckResidual(x_new, Ax, lambdaNew, lambdaNew + static_cast<T>(shift));
+        this->monitor.Record(iterCount + 1, lambdaNew + static_cast<T>(shift));
 
-        // Increment iteration count, and update values of x and lambda
+        // Increment iteration count, and update values of x and lambda (the buffers are swapped instead of copied)
         lambdaOld = lambdaNew;
-        x_ini = x_new;
+        x_ini.swap(x_new);
         ++iterCount;
     }
 
-    if (iterCount >= maxIter)
-    {
-        std::cerr << "[WARNING] Maximum number of iterations reached.\n"
-                  << "          Consider using a higher number for the maximum number of iterations."
-                  << std::endl;
-    }
-    std::cout << "Total number of iterations: " << iterCount << std::endl;
-
-    Vector<T> result(1);
-    result(0) = lambdaNew + shift;
-    return result;
+    this->report.iterations = iterCount;
+    this->report.converged = this->monitor.Converged();
+    this->RecordConvergence(this->monitor.GetCriterion());
+    return lambdaNew;
 }
 
 // Explicit instantation
 template class InversePowerMethodSolver<float>;
-template class InversePowerMethodSolver<double>;
\ No newline at end of file
+template class InversePowerMethodSolver<double>;
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+#include "JacobiSolver.hpp"
+#include "TaskScheduler.hpp"
+#include "HardwareCounters.hpp"
+#include "Roofline.hpp"
+#include "Tracer.hpp"
+
+namespace
+{
+    // Slots of the buffers in the workspace of the solver
+    enum WorkspaceSlot
+    {
+        COSINES,
+        SINES,
+        DIAGONAL_P,
+        DIAGONAL_Q
+    };
+    enum WorkspaceMatrixSlot
+    {
+        ITERATE,
+        EIGENVECTORS
+    };
+
+    // Below this number of updated matrix entries, the rotations of a round are applied on a single thread
+    const long MIN_PARALLEL_WORK = 1L << 15;
+
+    // Grain of a parallel loop over `count` items of `work` entries each: the whole range (run inline) if the work is small
+    int GrainFor(int count, long work)
+    {
+        return static_cast<long>(count) * work < MIN_PARALLEL_WORK ? count : 0;
+    }
+}
+
+template <typename T>
+JacobiSolver<T>::JacobiSolver(double tolerance, int maxIter)
+    : AbstractIterativeSolver<T>(std::max(tolerance, static_cast<double>(std::numeric_limits<T>::epsilon())), maxIter) {}
+
+template <typename T>
+JacobiSolver<T>::~JacobiSolver() {}
+
+template <typename T>
+std::vector<std::vector<std::pair<int, int>>> JacobiSolver<T>::RoundRobinPairs(int n)
+{
+    // Circle method: the last player stays in place while the others turn. With an odd number of indices,
+    // a dummy index n is added, and its pairs are dropped (the index plays no rotation in that round).
+    const int players = n % 2 == 0 ? n : n + 1;
+    std::vector<std::vector<std::pair<int, int>>> rounds(std::max(players - 1, 0));
+    for (int round = 0; round < players - 1; ++round)
+    {
+        for (int k = 0; k < players / 2; ++k)
+        {
+            int p = (round + k) % (players - 1);
+            int q = k == 0 ? players - 1 : (round - k + players - 1) % (players - 1);
+            if (p > q)
+                std::swap(p, q);
+            if (q < n)
+                rounds[round].emplace_back(p, q);
+        }
+        std::sort(rounds[round].begin(), rounds[round].end()); // Columns in increasing order
+    }
+    return rounds;
+}
+
+template <typename T>
+T JacobiSolver<T>::Sweep(Matrix<T> &A, Matrix<T> *V)
+{
+    TraceSpan span("jacobi sweep", "solver");
+    CounterRegion region("jacobi sweep");
+    const T tolerance = static_cast<T>(this->GetTolerance());
+    const int n = A.rows();
+
+    // Rotations of the current round: cosine, sine and new diagonal entries of each pair (the rounds hold at
+    // most n / 2 pairs), and the pairs that are rotated
+    if (roundsSize != n)
+    {
+        rounds = RoundRobinPairs(n);
+        roundsSize = n;
+    }
+    if (this->workspace.GetSize() != n)
+        this->workspace.SetSize(n);
+    Vector<T> &cosines = this->workspace.GetVector(COSINES);
+    Vector<T> &sines = this->workspace.GetVector(SINES);
+    Vector<T> &diagonalP = this->workspace.GetVector(DIAGONAL_P);
+    Vector<T> &diagonalQ = this->workspace.GetVector(DIAGONAL_Q);
+    active.reserve(n / 2);
+    TaskScheduler &scheduler = TaskScheduler::Instance();
+
+    T largestRatio = 0;
+    for (const std::vector<std::pair<int, int>> &pairs : rounds)
+    {
+        // Rotation of each pair, from the entries of the 2 x 2 block: the pairs have no common index, so the
+        // blocks do not change until the rotations of the round are applied. t = tan(angle) is the smallest
+        // root of t^2 + 2 t theta - 1 = 0. The entry is skipped if it is small relative to the diagonal.
+        active.clear();
+        for (int k = 0; k < static_cast<int>(pairs.size()); ++k)
+        {
+            const auto [p, q] = pairs[k];
+            const T apq = A(p, q);
+            if (apq == T(0))
+                continue;
+            const T ratio = std::abs(apq) / (std::sqrt(std::abs(A(p, p))) * std::sqrt(std::abs(A(q, q))));
+            largestRatio = std::max(largestRatio, ratio);
+            if (ratio <= tolerance)
+                continue;
+            const T theta = (A(q, q) - A(p, p)) / (2 * apq);
+            const T t = (theta < 0 ? T(-1) : T(1)) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+            cosines(k) = 1 / std::sqrt(t * t + 1);
+            sines(k) = t * cosines(k);
+            diagonalP(k) = A(p, p) - t * apq;
+            diagonalQ(k) = A(q, q) + t * apq;
+            active.push_back(k);
+        }
+        if (active.empty())
+            continue;
+        const int count = active.size();
+
+        // A = A J, and V = V J: columns p and q of each pair (contiguous), distributed among the threads by pairs
+        RooflineRegion roofline("jacobi round", 12.0 * count * n, sizeof(T) * 8.0 * count * n);
+        scheduler.ParallelFor(0, count, GrainFor(count, V != nullptr ? 4L * n : 2L * n), [&](int first, int last)
+                              {
+            for (int a = first; a < last; ++a)
+            {
+                const int k = active[a];
+                const auto [p, q] = pairs[k];
+                const T c = cosines(k);
+                const T s = sines(k);
+                auto rotate = [c, s](T *x, T *y, int size)
+                {
+                    for (int i = 0; i < size; ++i)
+                    {
+                        const T u = x[i];
+                        const T v = y[i];
+                        x[i] = c * u - s * v;
+                        y[i] = s * u + c * v;
+                    }
+                };
+                rotate(A.col(p).data(), A.col(q).data(), n);
+                if (V != nullptr)
+                    rotate(V->col(p).data(), V->col(q).data(), n);
+            } });
+
+        // A = J^T A: rows p and q of each pair, column by column (each column stays in cache), distributed by columns
+        scheduler.ParallelFor(0, n, GrainFor(n, 2L * count), [&](int first, int last)
+                              {
+            for (int j = first; j < last; ++j)
+            {
+                T *column = A.col(j).data();
+                for (int k : active)
+                {
+                    const auto [p, q] = pairs[k];
+                    const T u = column[p];
+                    const T v = column[q];
+                    column[p] = cosines(k) * u - sines(k) * v;
+                    column[q] = sines(k) * u + cosines(k) * v;
+                }
+            } });
+
+        // The 2 x 2 blocks of the pairs only depend on their own rotation: the rotated entries are set to zero,
+        // and the diagonal entries to a_pp - t a_pq and a_qq + t a_pq, which have smaller rounding errors than the products
+        for (int k : active)
+        {
+            const auto [p, q] = pairs[k];
+            A(p, q) = 0;
+            A(q, p) = 0;
+            A(p, p) = diagonalP(k);
+            A(q, q) = diagonalQ(k);
+        }
+    }
+    return largestRatio;
+}
+
+template <typename T>
+Vector<T> JacobiSolver<T>::FindEigenvalues()
+{
+    TraceSpan span("jacobi method", "solver");
+
+    // Get parameters from parent abstract class
+    int maxIter = this->GetMaxIter();
+    int iterCount = 0;
+    this->report = SolverReport();
+    this->monitor.Reset();
+
+    // Retrieve pointer to matrix: the method only applies to symmetric matrices
+    MatrixPointer<T> A_ptr = this->GetMatrix();
+    int n = A_ptr->rows();
+    if (!A_ptr->isApprox(A_ptr->transpose()))
+        throw SolverException("The Jacobi method needs a symmetric matrix.");
+
+    // The iterate lives in the workspace, reused by successive solves. When the solver owns the matrix,
+    // the rotations are applied in its storage.
+    const bool inPlace = this->OwnsMatrix();
+    Matrix<T> &A = inPlace ? *A_ptr : this->workspace.GetMatrix(ITERATE, n, n);
+    if (!inPlace)
+        A = *A_ptr;
+
+    // A warm start transforms the matrix with an orthonormal basis V: V^T A V is nearly diagonal when V holds
+    // the eigenvectors of a nearby matrix. V then accumulates the rotations (A = V D V^T).
+    const bool exportVectors = this->ExportsVectors();
+    const bool accumulate = this->HasWarmStart() || exportVectors;
+    Matrix<T> *V = accumulate ? &this->workspace.GetMatrix(EIGENVECTORS, n, n) : nullptr;
+    if (this->HasWarmStart())
+    {
+        const Matrix<T> &W = this->WarmStartVectors(n);
+        if (W.cols() != n)
+            throw std::invalid_argument("The warm start of the Jacobi method needs " + std::to_string(n) + " vectors (" +
+                                        std::to_string(W.cols()) + " given)");
+        // Orthonormalize the vectors (they are only orthonormal up to the precision of the file)
+        *V = Eigen::HouseholderQR<Matrix<T>>(W).householderQ();
+        Matrix<T> product = V->transpose() * A;
+        A.noalias() = product * (*V);
+        A = (A + A.transpose()) / 2; // Symmetric again, despite the rounding errors of the products
+        this->report.warmStarted = true;
+    }
+    else if (accumulate)
+        V->setIdentity();
+
+    while (!this->monitor.Converged() && iterCount < maxIter)
+    {
+        const T largestRatio = Sweep(A, V);
+        ++iterCount;
+
+        // The largest ratio of the sweep: below the tolerance, no rotation was applied and the matrix is diagonal
+        this->monitor.Check(largestRatio);
+        this->monitor.Record(iterCount, A.diagonal().maxCoeff());
+    }
+    if (iterCount >= maxIter && !this->monitor.Converged())
+    {
+        std::cerr << "[WARNING] Maximum number of iterations reached.\n"
+                  << "          Consider using a higher number for the maximum number of iterations."
+                  << std::endl;
+    }
+    this->report.iterations = iterCount;
+    this->report.converged = this->monitor.Converged();
+    this->RecordConvergence("relative_offdiagonal");
+    std::cout << "Total number of iterations: " << iterCount << std::endl;
+
+    // Eigenvalues in decreasing order, with their vectors
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&A](int i, int j)
+                     { return A(i, i) > A(j, j); });
+    Vector<T> eigenvalues(n);
+    Matrix<T> vectors(exportVectors ? n : 0, exportVectors ? n : 0);
+    for (int i = 0; i < n; ++i)
+    {
+        eigenvalues(i) = A(order[i], order[i]);
+        if (exportVectors)
+            vectors.col(i) = V->col(order[i]);
+    }
+    this->RecordResult(eigenvalues, vectors);
+    if (inPlace)
+        this->ReleaseMatrix();
+    return eigenvalues;
+}
+
+// Explicit instantiation
+template class JacobiSolver<float>;
+template class JacobiSolver<double>;
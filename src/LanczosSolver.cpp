@@ -0,0 +1,187 @@
+#include <iostream>
+#include <limits>
+
+#include "LanczosSolver.hpp"
+#include "HardwareCounters.hpp"
+#include "Roofline.hpp"
+#include "Tracer.hpp"
+
+template <typename T>
+LanczosSolver<T>::LanczosSolver(double tolerance, int maxIter) : AbstractIterativeSolver<T>(tolerance, maxIter) {}
+
+template <typename T>
+LanczosSolver<T>::~LanczosSolver() {}
+
+template <typename T>
+Vector<T> LanczosSolver<T>::FindEigenvalues()
+{
+    TraceSpan span("lanczos method", "solver");
+    // Get parameters from parent abstract class
+    double tolerance = this->GetTolerance();
+    int maxIter = this->GetMaxIter();
+    this->report = SolverReport();
+    this->monitor.Reset();
+
+    // Retrieve the operator: the vectors only hold the entries stored by this process
+    std::shared_ptr<LinearOperator<T>> A = this->GetOperator();
+    const int localRows = A->GetLocalRows();
+    const int maxDimension = std::min(maxIter, A->GetSize());
+
+    // Initial vector: only depends on the global row index, so that the result does not
+    // depend on the distribution of the matrix (a constant vector is an eigenvector too often).
+    // A warm start replaces it with the sum of its vectors.
+    Vector<T> v(localRows);
+    if (!this->InitialVector(v))
+    {
+        for (int i = 0; i < localRows; ++i)
+            v(i) = static_cast<T>(1.0 + 0.5 * std::sin(A->GetFirstRow() + i + 1.0));
+    }
+    v /= A->Norm(v);
+
+    Matrix<T> V(localRows, maxDimension); // Orthonormal basis of the Krylov space (local rows)
+    Vector<T> alpha(maxDimension);        // Diagonal of the tridiagonal matrix
+    Vector<T> beta(maxDimension);         // Subdiagonal of the tridiagonal matrix
+    Vector<T> w;
+    Eigen::SelfAdjointEigenSolver<Matrix<T>> tridiagonalSolver;
+    Vector<T> residuals;
+    T threshold = 0.0;
+    bool invariant = false;
+    bool converged = false;
+    int dimension = 0;
+
+    while (!converged && dimension < maxDimension)
+    {
+        V.col(dimension) = v;
+        A->Apply(v, w);
+        ++dimension;
+
+        // Orthogonalize against the whole basis (classical Gram-Schmidt, applied twice for stability)
+        TraceSpan orthogonalizationSpan("orthogonalization", "solver");
+        CounterRegion orthogonalizationRegion("orthogonalization");
+        const double basisEntries = static_cast<double>(localRows) * dimension;
+        RooflineRegion orthogonalizationRoofline("orthogonalization", 8 * basisEntries + 2.0 * localRows, sizeof(T) * (4 * basisEntries + 4.0 * localRows));
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            Vector<T> coefficients = V.leftCols(dimension).transpose() * w;
+            A->Reduce(coefficients);
+            w.noalias() -= V.leftCols(dimension) * coefficients;
+            if (pass == 0)
+                alpha(dimension - 1) = coefficients(dimension - 1);
+        }
+        beta(dimension - 1) = A->Norm(w);
+        orthogonalizationSpan.End();
+        orthogonalizationRegion.End();
+        orthogonalizationRoofline.End();
+
+        // The Ritz values cost an eigendecomposition of the tridiagonal matrix: they are only computed every
+        // few steps, at the last one, or when the Krylov space may be invariant (beta small compared with a
+        // bound of the norm of the tridiagonal matrix)
+        T normBound = alpha.head(dimension).cwiseAbs().maxCoeff() + 2 * beta.head(dimension).maxCoeff();
+        bool mayBeInvariant = beta(dimension - 1) <= 10 * std::numeric_limits<T>::epsilon() * normBound || dimension == A->GetSize();
+        if (mayBeInvariant || dimension == maxDimension || this->monitor.IsCheckDue(dimension))
+        {
+            // Eigenvalues of the tridiagonal matrix, and their residuals: beta times the last entry of the eigenvectors
+            TraceSpan ritzSpan("ritz values", "solver");
+            Vector<T> subdiagonal = beta.head(dimension - 1);
+            tridiagonalSolver.computeFromTridiagonal(alpha.head(dimension), subdiagonal, Eigen::ComputeEigenvectors);
+            residuals = (beta(dimension - 1) * tridiagonalSolver.eigenvectors().row(dimension - 1).transpose()).cwiseAbs();
+            T scale = tridiagonalSolver.eigenvalues().cwiseAbs().maxCoeff();
+            threshold = static_cast<T>(tolerance) * scale;
+
+            // The Krylov space is invariant: all the eigenvalues of the tridiagonal matrix are exact
+            invariant = beta(dimension - 1) <= 10 * std::numeric_limits<T>::epsilon() * scale || dimension == A->GetSize();
+            // The extreme Ritz values converge first
+            bool extremesConverged = this->monitor.Check(std::max(residuals(0), residuals(dimension - 1)) / scale);
+            converged = invariant || extremesConverged;
+            this->monitor.Record(dimension, tridiagonalSolver.eigenvalues()(dimension - 1));
+        }
+
+        if (!converged)
+            v = w / beta(dimension - 1);
+    }
+
+    if (!converged)
+    {
+        std::cerr << "[WARNING] Maximum number of iterations reached.\n"
+                  << "          Consider using a higher number for the maximum number of iterations."
+                  << std::endl;
+    }
+    this->report.iterations = dimension;
+    this->report.converged = converged;
+    this->RecordConvergence("ritz_residual");
+    std::cout << "Total number of iterations: " << dimension << std::endl;
+
+    // Keep the converged eigenvalues, in decreasing order
+    std::vector<T> eigenvalues;
+    std::vector<int> kept;
+    for (int i = dimension - 1; i >= 0; --i)
+    {
+        if (invariant || residuals(i) <= threshold)
+        {
+            eigenvalues.push_back(tridiagonalSolver.eigenvalues()(i));
+            kept.push_back(i);
+        }
+    }
+    Vector<T> result = Eigen::Map<Vector<T>>(eigenvalues.data(), eigenvalues.size());
+
+    // Ritz vectors of the converged eigenvalues: the basis times the eigenvectors of the tridiagonal matrix
+    Matrix<T> ritzVectors;
+    if (this->ExportsVectors())
+    {
+        ritzVectors.resize(localRows, kept.size());
+        for (std::size_t j = 0; j < kept.size(); ++j)
+            ritzVectors.col(j).noalias() = V.leftCols(dimension) * tridiagonalSolver.eigenvectors().col(kept[j]);
+    }
+    this->RecordResult(result, ritzVectors);
+    return result;
+}
+
+template <typename T>
+Vector<T> LanczosSolver<T>::RitzValues(LinearOperator<T> &A, int steps, Vector<T> &residuals)
+{
+    const int localRows = A.GetLocalRows();
+    const int maxDimension = std::min(steps, A.GetSize());
+
+    // Same initial vector as FindEigenvalues
+    Vector<T> v(localRows);
+    for (int i = 0; i < localRows; ++i)
+        v(i) = static_cast<T>(1.0 + 0.5 * std::sin(A.GetFirstRow() + i + 1.0));
+    v /= A.Norm(v);
+
+    Matrix<T> V(localRows, maxDimension);
+    Vector<T> alpha(maxDimension);
+    Vector<T> beta(maxDimension);
+    Vector<T> w;
+    int dimension = 0;
+    bool invariant = false;
+
+    while (!invariant && dimension < maxDimension)
+    {
+        V.col(dimension) = v;
+        A.Apply(v, w);
+        ++dimension;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            Vector<T> coefficients = V.leftCols(dimension).transpose() * w;
+            A.Reduce(coefficients);
+            w.noalias() -= V.leftCols(dimension) * coefficients;
+            if (pass == 0)
+                alpha(dimension - 1) = coefficients(dimension - 1);
+        }
+        beta(dimension - 1) = A.Norm(w);
+        T scale = alpha.head(dimension).cwiseAbs().maxCoeff() + beta.head(dimension).maxCoeff();
+        invariant = beta(dimension - 1) <= 10 * std::numeric_limits<T>::epsilon() * scale;
+        if (!invariant)
+            v = w / beta(dimension - 1);
+    }
+
+    Vector<T> subdiagonal = beta.head(dimension - 1);
+    Eigen::SelfAdjointEigenSolver<Matrix<T>> tridiagonalSolver;
+    tridiagonalSolver.computeFromTridiagonal(alpha.head(dimension), subdiagonal, Eigen::ComputeEigenvectors);
+    residuals = (beta(dimension - 1) * tridiagonalSolver.eigenvectors().row(dimension - 1).transpose()).cwiseAbs();
+    return tridiagonalSolver.eigenvalues();
+}
+
+// Explicit instantiation
+template class LanczosSolver<float>;
+template class LanczosSolver<double>;
@@ -77,7 +77,7 @@ std::unique_ptr<MatrixGeneratorFromFunction<T>> MatrixGeneratorFactory<T>::Choos
         throw std::invalid_argument("Failed to convert rows or columns to integers during matrix initialization: " + std::string(e.what()));
     }
 
-    if (functionName == "identity" || functionName == "hilbert")
+    if (SupportedArguments::SUPPORTED_FUNCTIONS.find(functionName) != SupportedArguments::SUPPORTED_FUNCTIONS.end())
     {
         auto function = std::make_unique<FunctionManager<T>>(functionName);
         return std::make_unique<MatrixGeneratorFromFunction<T>>(std::move(function), nbRows, nbCols);
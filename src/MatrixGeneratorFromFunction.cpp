@@ -2,24 +2,58 @@
 
 #include "MatrixGeneratorFromFunction.hpp"
 #include "FunctionManager.hpp"
+#include "ParallelKernels.hpp"
+#include "TaskScheduler.hpp"
+#include "Tracer.hpp"
 
 // Function to generate the matrix
 template <typename T>
 MatrixPointer<T> MatrixGeneratorFromFunction<T>::GenerateMatrix()
 {
+    TraceSpan span("generate from function", "input");
     auto matrix = std::make_shared<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(nbRows, nbCols);
 
-    // Populate the matrix using the selected function
-    for (int i = 0; i < nbRows; ++i)
-    {
+    // Populate the matrix using the selected function, in parallel over the same blocks of rows and on the same
+    // workers as the solver kernels, so that the memory pages of a block are placed on the NUMA node of the thread
+    // that uses them (first touch)
+    const int threads = ParallelKernels::GetNumThreads();
+    const int align = ParallelKernels::RowAlignment<T>(nbRows);
+    TaskScheduler::Instance().ParallelForParts(threads, [&](int part)
+                                          {
+        int begin, end;
+        ParallelKernels::Partition(nbRows, threads, align, part, begin, end);
         for (int j = 0; j < nbCols; ++j)
         {
-            (*matrix)(i, j) = (*function)(i, j); // Call the functor with the row and column indices
-        }
-    }
+            for (int i = begin; i < end; ++i)
+            {
+                (*matrix)(i, j) = (*function)(i, j); // Call the functor with the row and column indices
+            }
+        } });
     return matrix;
 }
 
+// Function to generate a block of rows of the matrix
+template <typename T>
+MatrixPointer<T> MatrixGeneratorFromFunction<T>::GenerateRowBlock(int firstRow, int lastRow)
+{
+    if (firstRow < 0 || lastRow > nbRows || firstRow > lastRow)
+        throw std::invalid_argument("Invalid block of rows [" + std::to_string(firstRow) + ", " + std::to_string(lastRow) + ") during matrix initialization");
+
+    TraceSpan span("generate rows from function", "input");
+    const int blockRows = lastRow - firstRow;
+    auto block = std::make_shared<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(blockRows, nbCols);
+    TaskScheduler::Instance().ParallelFor(0, blockRows, 0, [&](int begin, int end)
+                                          {
+        for (int j = 0; j < nbCols; ++j)
+        {
+            for (int i = begin; i < end; ++i)
+            {
+                (*block)(i, j) = (*function)(firstRow + i, j); // Global row index for the functor
+            }
+        } });
+    return block;
+}
+
 // Explicit instantiations
 template class MatrixGeneratorFromFunction<float>;
 template class MatrixGeneratorFromFunction<double>;
\ No newline at end of file
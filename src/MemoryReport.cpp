@@ -0,0 +1,92 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "MemoryReport.hpp"
+
+namespace
+{
+    // Returns the value of a field of /proc/self/status given in kB, in bytes (0 if unavailable)
+    long ReadStatusField(const std::string &field)
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            if (line.compare(0, field.size() + 1, field + ":") == 0)
+            {
+                std::istringstream values(line.substr(field.size() + 1));
+                long kilobytes = 0;
+                values >> kilobytes;
+                return kilobytes * 1024;
+            }
+        }
+        return 0;
+    }
+
+    // Formats a number of bytes in MB
+    std::string Megabytes(long bytes)
+    {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << bytes * 1e-6 << " MB";
+        return text.str();
+    }
+}
+
+long MemoryReport::ResidentBytes()
+{
+    return ReadStatusField("VmRSS");
+}
+
+long MemoryReport::PeakResidentBytes()
+{
+    return ReadStatusField("VmHWM");
+}
+
+bool MemoryReport::ResetPeak()
+{
+    // Writing 5 to clear_refs resets the peak resident set size of the process (Linux 4.0 and later)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (!clearRefs)
+        return false;
+    clearRefs << "5";
+    clearRefs.flush();
+    return static_cast<bool>(clearRefs);
+}
+
+void MemoryReport::StartPhase(const std::string &name)
+{
+    EndPhase();
+    Phase phase;
+    phase.name = name;
+    phase.peakReset = ResetPeak();
+    phase.startBytes = ResidentBytes();
+    phases.push_back(phase);
+    running = true;
+}
+
+void MemoryReport::EndPhase()
+{
+    if (!running)
+        return;
+    Phase &phase = phases.back();
+    phase.endBytes = ResidentBytes();
+    phase.peakBytes = PeakResidentBytes();
+    running = false;
+}
+
+void MemoryReport::Print() const
+{
+    std::cout << "==== MEMORY REPORT ====" << std::endl;
+    bool allReset = true;
+    for (const Phase &phase : phases)
+    {
+        std::cout << phase.name << ": peak " << Megabytes(phase.peakBytes) << (phase.peakReset ? "" : " (*)")
+                  << ", resident " << Megabytes(phase.startBytes) << " -> " << Megabytes(phase.endBytes) << std::endl;
+        allReset = allReset && phase.peakReset;
+    }
+    if (!allReset)
+        std::cout << "(*) Peak of the process since its start: the peak could not be reset" << std::endl;
+    std::cout << "=======================" << std::endl;
+}
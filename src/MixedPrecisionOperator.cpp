@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "MixedPrecisionOperator.hpp"
+#include "DenseOperator.hpp"
+#include "ParallelKernels.hpp"
+#include "TaskScheduler.hpp"
+#include "HardwareCounters.hpp"
+#include "Tracer.hpp"
+
+template <typename T, typename S>
+MixedPrecisionOperator<T, S>::MixedPrecisionOperator(const Matrix<T> &fullMatrix) : matrix(fullMatrix.rows(), fullMatrix.cols())
+{
+    if (fullMatrix.rows() != fullMatrix.cols())
+        throw std::invalid_argument("The matrix must be square (MixedPrecisionOperator)");
+
+    // Converted by the blocks of rows of the products, on the threads that compute them (first touch)
+    const int rows = matrix.rows();
+    const int threads = ParallelKernels::GetNumThreads();
+    const int align = ParallelKernels::RowAlignment<S>(rows);
+    TaskScheduler::Instance().ParallelForParts(threads, [&](int part)
+                                          {
+        int begin, end;
+        ParallelKernels::Partition(rows, threads, align, part, begin, end);
+        if (end > begin)
+            matrix.middleRows(begin, end - begin) = fullMatrix.middleRows(begin, end - begin).template cast<S>(); });
+}
+
+template <typename T, typename S>
+void MixedPrecisionOperator<T, S>::Apply(const Vector<T> &x, Vector<T> &y)
+{
+    TraceSpan span("matvec", "solver");
+    CounterRegion region("matvec");
+    ParallelKernels::MatVecMixed<T, S>(matrix, x, y);
+}
+
+template <typename T>
+std::shared_ptr<LinearOperator<T>> CreateStorageOperator(MatrixPointer<T> matrix, const std::string &storage)
+{
+    if (SupportedArguments::SUPPORTED_STORAGE_TYPES.find(storage) == SupportedArguments::SUPPORTED_STORAGE_TYPES.end())
+        throw std::invalid_argument("unsupported storage type (" + storage + ")");
+    if (matrix == nullptr)
+        throw std::runtime_error("Matrix is not initialized (CreateStorageOperator)");
+
+    if (storage == "full" || StorageBytes(storage, sizeof(T)) == sizeof(T))
+        return std::make_shared<DenseOperator<T>>(matrix);
+    if (storage == "half")
+        return std::make_shared<MixedPrecisionOperator<T, Eigen::half>>(*matrix);
+    if (storage == "bfloat16")
+        return std::make_shared<MixedPrecisionOperator<T, Eigen::bfloat16>>(*matrix);
+    // Float storage of a double matrix (a float matrix is used as is, see above)
+    if constexpr (std::is_same_v<T, double>)
+        return std::make_shared<MixedPrecisionOperator<T, float>>(*matrix);
+    else
+        return std::make_shared<DenseOperator<T>>(matrix);
+}
+
+int StorageBytes(const std::string &storage, int fullBytes)
+{
+    if (storage == "half" || storage == "bfloat16")
+        return 2;
+    if (storage == "float")
+        return std::min(fullBytes, static_cast<int>(sizeof(float)));
+    return fullBytes;
+}
+
+// Explicit instantiations
+template class MixedPrecisionOperator<float, Eigen::half>;
+template class MixedPrecisionOperator<float, Eigen::bfloat16>;
+template class MixedPrecisionOperator<double, float>;
+template class MixedPrecisionOperator<double, Eigen::half>;
+template class MixedPrecisionOperator<double, Eigen::bfloat16>;
+template std::shared_ptr<LinearOperator<float>> CreateStorageOperator<float>(MatrixPointer<float>, const std::string &);
+template std::shared_ptr<LinearOperator<double>> CreateStorageOperator<double>(MatrixPointer<double>, const std::string &);
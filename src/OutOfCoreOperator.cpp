@@ -0,0 +1,229 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "OutOfCoreOperator.hpp"
+#include "FileReader.hpp"
+#include "HardwareCounters.hpp"
+#include "Tracer.hpp"
+#include "TaskScheduler.hpp"
+
+namespace
+{
+    // Header of the tiled files, followed by the tiles
+    struct TiledFileHeader
+    {
+        char magic[8];            // "EIGTILED"
+        std::int32_t elementSize; // Size of an entry in bytes (4: float, 8: double)
+        std::int32_t reserved;
+        std::int64_t size;     // Number of rows and columns
+        std::int64_t tileSize; // Size of the tiles
+    };
+    const char TILED_MAGIC[8] = {'E', 'I', 'G', 'T', 'I', 'L', 'E', 'D'};
+
+    double SecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+template <typename T>
+OutOfCoreOperator<T>::OutOfCoreOperator(const std::string &fileName) : fileName(fileName)
+{
+    std::string path = std::string(Paths::PATH_MATRICES).append(fileName);
+    fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) // We make sure the file exists, otherwise throw an error
+        throw FileException("Failed to open tiled file: " + fileName);
+
+    TiledFileHeader header;
+    struct stat fileStatus;
+    if (::pread(fileDescriptor, &header, sizeof(header), 0) != sizeof(header) || std::memcmp(header.magic, TILED_MAGIC, sizeof(TILED_MAGIC)) != 0)
+    {
+        ::close(fileDescriptor);
+        throw FileException("Invalid header in tiled file: " + fileName);
+    }
+    if (header.elementSize != sizeof(T))
+    {
+        ::close(fileDescriptor);
+        throw FileException("The tiled file " + fileName + " stores entries of " + std::to_string(header.elementSize) +
+                            " bytes, but the solver uses entries of " + std::to_string(sizeof(T)) + " bytes");
+    }
+    if (header.size <= 0 || header.tileSize <= 0 || ::fstat(fileDescriptor, &fileStatus) != 0 ||
+        fileStatus.st_size != static_cast<off_t>(sizeof(header) + header.size * header.size * sizeof(T)))
+    {
+        ::close(fileDescriptor);
+        throw FileException("Tiled file is empty or truncated: " + fileName);
+    }
+
+    size = header.size;
+    tileSize = header.tileSize;
+    panels = (size + tileSize - 1) / tileSize;
+    for (auto &buffer : buffers)
+        buffer.resize(static_cast<size_t>(tileSize) * size);
+}
+
+template <typename T>
+OutOfCoreOperator<T>::~OutOfCoreOperator()
+{
+    if (pendingRead.valid())
+    {
+        try
+        {
+            pendingRead.get();
+        }
+        catch (...) // Nobody to report to
+        {
+        }
+    }
+    ::close(fileDescriptor);
+}
+
+template <typename T>
+void OutOfCoreOperator<T>::WriteTiledFile(const std::string &fileName, int size, int tileSize,
+                                          const std::function<MatrixPointer<T>(int, int)> &rowBlock)
+{
+    if (size <= 0 || tileSize <= 0)
+        throw std::invalid_argument("The size of the matrix and of the tiles must be positive (tiled file " + fileName + ")");
+
+    std::ofstream file(std::string(Paths::PATH_MATRICES).append(fileName), std::ios::binary);
+    if (!file.is_open())
+        throw FileException("Failed to create tiled file: " + fileName);
+
+    TiledFileHeader header = {};
+    std::memcpy(header.magic, TILED_MAGIC, sizeof(TILED_MAGIC));
+    header.elementSize = sizeof(T);
+    header.size = size;
+    header.tileSize = tileSize;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // One panel of rows in memory at a time
+    Matrix<T> tile;
+    for (int firstRow = 0; firstRow < size; firstRow += tileSize)
+    {
+        int rows = std::min(tileSize, size - firstRow);
+        MatrixPointer<T> panel = rowBlock(firstRow, firstRow + rows);
+        if (panel->rows() != rows || panel->cols() != size)
+            throw std::invalid_argument("Invalid block of rows while writing the tiled file " + fileName);
+        for (int firstCol = 0; firstCol < size; firstCol += tileSize)
+        {
+            tile = panel->block(0, firstCol, rows, std::min(tileSize, size - firstCol)); // Column-major copy of the tile
+            file.write(reinterpret_cast<const char *>(tile.data()), tile.size() * sizeof(T));
+        }
+    }
+    if (!file)
+        throw FileException("Failed to write tiled file: " + fileName);
+}
+
+template <typename T>
+int OutOfCoreOperator<T>::PanelRows(int panel) const
+{
+    return std::min(tileSize, size - panel * tileSize);
+}
+
+template <typename T>
+void OutOfCoreOperator<T>::ReadPanel(int panel, std::vector<T> &buffer)
+{
+    size_t remaining = static_cast<size_t>(PanelRows(panel)) * size * sizeof(T);
+    off_t offset = sizeof(TiledFileHeader) + static_cast<off_t>(panel) * tileSize * size * sizeof(T);
+    char *destination = reinterpret_cast<char *>(buffer.data());
+    while (remaining > 0)
+    {
+        ssize_t bytes = ::pread(fileDescriptor, destination, remaining, offset);
+        if (bytes <= 0)
+            throw FileException("Failed to read panel " + std::to_string(panel) + " of tiled file: " + fileName);
+        destination += bytes;
+        offset += bytes;
+        remaining -= bytes;
+    }
+}
+
+template <typename T>
+void OutOfCoreOperator<T>::Apply(const Vector<T> &x, Vector<T> &y)
+{
+    TraceSpan span("matvec (out-of-core)", "solver");
+    CounterRegion region("matvec (out-of-core)");
+    if (x.size() != size)
+        throw std::invalid_argument("The vector does not match the size of the matrix (OutOfCoreOperator)");
+    auto start = std::chrono::steady_clock::now();
+    y.setZero(size);
+
+    auto readAsync = [this](int panel, std::vector<T> &buffer)
+    {
+        return std::async(std::launch::async, [this, panel, &buffer]()
+                          {
+            auto readStart = std::chrono::steady_clock::now();
+            ReadPanel(panel, buffer);
+            return SecondsSince(readStart); });
+    };
+
+    // The first panel may already have been prefetched at the end of the previous product, in the first buffer
+    if (!pendingRead.valid())
+        pendingRead = readAsync(0, buffers[0]);
+
+    for (int panel = 0; panel < panels; ++panel)
+    {
+        const int current = panel % 2;
+        auto waitStart = std::chrono::steady_clock::now();
+        stats.readSeconds += pendingRead.get();
+        stats.waitSeconds += SecondsSince(waitStart);
+        stats.bytesRead += static_cast<std::uint64_t>(PanelRows(panel)) * size * sizeof(T);
+
+        // Read the next panel while computing with the current one (the first one for the next product)
+        if (panel + 1 < panels)
+            pendingRead = readAsync(panel + 1, buffers[1 - current]);
+        else if (panels % 2 == 0) // Otherwise the first buffer is still in use
+            pendingRead = readAsync(0, buffers[0]);
+
+        // Product with the tiles of the panel: the columns of tiles are distributed among the workers
+        const int rows = PanelRows(panel);
+        const T *data = buffers[current].data();
+        Vector<T> panelProduct = TaskScheduler::Instance().ParallelReduce(
+            0, panels, 0, Vector<T>(Vector<T>::Zero(rows)), [&](int firstTile, int lastTile)
+            {
+                Vector<T> partial = Vector<T>::Zero(rows);
+                for (int tile = firstTile; tile < lastTile; ++tile)
+                {
+                    const int cols = PanelRows(tile);
+                    Eigen::Map<const Matrix<T>> tileMatrix(data + static_cast<size_t>(rows) * tile * tileSize, rows, cols);
+                    partial.noalias() += tileMatrix * x.segment(tile * tileSize, cols);
+                }
+                return partial; },
+            [](const Vector<T> &a, const Vector<T> &b) -> Vector<T>
+            { return a + b; });
+        y.segment(panel * tileSize, rows) = panelProduct;
+    }
+
+    stats.applySeconds += SecondsSince(start);
+    ++stats.products;
+}
+
+template <typename T>
+void OutOfCoreOperator<T>::ResetIoStats()
+{
+    stats = {0, 0.0, 0.0, 0.0, 0};
+}
+
+template <typename T>
+void OutOfCoreOperator<T>::PrintIoReport() const
+{
+    double gigabytes = stats.bytesRead * 1e-9;
+    std::cout << "==== OUT-OF-CORE I/O ====" << std::endl;
+    std::cout << "Matrix-vector products: " << stats.products << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Data read: " << gigabytes << " GB" << std::endl;
+    std::cout << "Window: 2 panels of " << tileSize << " rows (" << 2 * buffers[0].size() * sizeof(T) * 1e-6 << " MB)" << std::endl;
+    std::cout << "Read bandwidth: " << (stats.readSeconds > 0.0 ? gigabytes / stats.readSeconds : 0.0) << " GB/s" << std::endl;
+    std::cout << std::setprecision(1) << "Time waiting for I/O: "
+              << (stats.applySeconds > 0.0 ? 100.0 * stats.waitSeconds / stats.applySeconds : 0.0) << "%" << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+// Explicit instantiations
+template class OutOfCoreOperator<float>;
+template class OutOfCoreOperator<double>;
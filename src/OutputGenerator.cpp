@@ -4,6 +4,7 @@
 
 #include "OutputGenerator.hpp"
 #include "FileReader.hpp"
+#include "Tracer.hpp"
 
 template <typename T>
 OutputGenerator<T>::OutputGenerator(const std::string &outputType, const std::vector<std::string> &args, Vector<T> &data)
@@ -51,6 +52,7 @@ OutputGenerator<T>::OutputGenerator(const std::string &outputType, const std::ve
 template <typename T>
 void OutputGenerator<T>::GenerateOutput()
 {
+    TraceSpan span("write output", "output");
     outputFunction();
 }
 
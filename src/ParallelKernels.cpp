@@ -0,0 +1,368 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ParallelKernels.hpp"
+#include "Roofline.hpp"
+#include "SimdKernels.hpp"
+#include "TaskScheduler.hpp"
+
+namespace
+{
+    // Below this number of matrix entries, a kernel runs on a single thread
+    const long MIN_PARALLEL_WORK = 1L << 15;
+    // Size of the diagonal blocks in the triangular solve
+    const int TRIANGULAR_BLOCK_SIZE = 128;
+    // Size of a memory page in bytes (used to align row blocks)
+    const int PAGE_SIZE = 4096;
+    // Number of rows of the blocks of the in-place matrix-matrix product
+    const int IN_PLACE_BLOCK_ROWS = 64;
+    // Number of rows of the chunks of the mixed-precision product (the chunk of y stays in the L1 cache)
+    const int MIXED_CHUNK_ROWS = 512;
+    // Maximum number of row blocks of the kernels reducing partial results (kept on the stack)
+    const int MAX_REDUCTION_PARTS = 256;
+    // Blocks of the matrix-matrix products. Eigen packs the blocks of the operands of a product on the stack
+    // up to EIGEN_STACK_ALLOCATION_LIMIT (128 kB), on the heap beyond: with these sizes (64 kB per packed
+    // block in double precision), the products do not allocate memory.
+    const int PRODUCT_BLOCK_ROWS = 128;
+    const int PRODUCT_BLOCK_COLS = 128;
+    const int PRODUCT_BLOCK_DEPTH = 64;
+
+    // Converts a stored matrix entry to the type of the computations
+    template <typename T, typename S>
+    inline T ToCompute(S value)
+    {
+        return static_cast<T>(value);
+    }
+
+    // A bfloat16 holds the upper half of the bits of a float: a shift, which the compiler vectorizes
+    template <typename T>
+    inline T ToCompute(Eigen::bfloat16 value)
+    {
+        const std::uint32_t bits = static_cast<std::uint32_t>(Eigen::numext::bit_cast<std::uint16_t>(value)) << 16;
+        return static_cast<T>(Eigen::numext::bit_cast<float>(bits));
+    }
+
+    // Number of threads actually used for a given amount of work
+    int ThreadsFor(long work)
+    {
+        return work < MIN_PARALLEL_WORK ? 1 : TaskScheduler::Instance().GetNumWorkers();
+    }
+
+    // Computes C = A B by blocks of PRODUCT_BLOCK_ROWS x PRODUCT_BLOCK_COLS, summed over the depth by blocks of
+    // PRODUCT_BLOCK_DEPTH
+    template <typename T>
+    void BlockedProduct(const Eigen::Ref<const Matrix<T>> &A, const Eigen::Ref<const Matrix<T>> &B, Eigen::Ref<Matrix<T>> C)
+    {
+        const int depth = A.cols();
+        for (int j = 0; j < C.cols(); j += PRODUCT_BLOCK_COLS)
+        {
+            const int cols = std::min(PRODUCT_BLOCK_COLS, static_cast<int>(C.cols()) - j);
+            for (int i = 0; i < C.rows(); i += PRODUCT_BLOCK_ROWS)
+            {
+                const int rows = std::min(PRODUCT_BLOCK_ROWS, static_cast<int>(C.rows()) - i);
+                auto block = C.block(i, j, rows, cols);
+                if (depth == 0)
+                    block.setZero();
+                for (int p = 0; p < depth; p += PRODUCT_BLOCK_DEPTH)
+                {
+                    const int size = std::min(PRODUCT_BLOCK_DEPTH, depth - p);
+                    if (p == 0)
+                        block.noalias() = A.block(i, p, rows, size) * B.block(p, j, size, cols);
+                    else
+                        block.noalias() += A.block(i, p, rows, size) * B.block(p, j, size, cols);
+                }
+            }
+        }
+    }
+}
+
+namespace ParallelKernels
+{
+    void SetNumThreads(int threads)
+    {
+        TaskScheduler::Instance().SetNumWorkers(threads);
+    }
+
+    int GetNumThreads()
+    {
+        return TaskScheduler::Instance().GetNumWorkers();
+    }
+
+    void Partition(int size, int parts, int align, int part, int &begin, int &end)
+    {
+        int blocks = (size + align - 1) / align; // Number of aligned blocks to distribute
+        int blocksPerPart = blocks / parts;
+        int remainder = blocks % parts;
+        int firstBlock = part * blocksPerPart + std::min(part, remainder);
+        int lastBlock = firstBlock + blocksPerPart + (part < remainder ? 1 : 0);
+        begin = std::min(size, firstBlock * align);
+        end = std::min(size, lastBlock * align);
+    }
+
+    template <typename T>
+    int RowAlignment(int rows)
+    {
+        const int pageElements = PAGE_SIZE / static_cast<int>(sizeof(T));
+        return rows >= 4 * pageElements * GetNumThreads() ? pageElements : 64 / static_cast<int>(sizeof(T));
+    }
+
+    template <typename T>
+    void MatVec(const Matrix<T> &A, const Vector<T> &x, Vector<T> &y)
+    {
+        const int rows = A.rows();
+        const double entries = static_cast<double>(rows) * A.cols();
+        RooflineRegion region("matvec", 2 * entries, sizeof(T) * (entries + rows + A.cols()));
+        y.resize(rows);
+        const int threads = ThreadsFor(static_cast<long>(rows) * A.cols());
+        const int align = RowAlignment<T>(rows);
+
+        TaskScheduler::Instance().ParallelForParts(threads, [&](int part)
+                                             {
+            int begin, end;
+            Partition(rows, threads, align, part, begin, end);
+            if (end > begin)
+                y.segment(begin, end - begin).noalias() = A.middleRows(begin, end - begin) * x; });
+    }
+
+    template <typename T>
+    void MatVecDots(const Matrix<T> &A, const Vector<T> &x, T shift, Vector<T> &y, T &xDotY, T &yDotY)
+    {
+        const int rows = A.rows();
+        const double entries = static_cast<double>(rows) * A.cols();
+        RooflineRegion region("matvec", 2 * entries + 6.0 * rows, sizeof(T) * (entries + rows + A.cols()));
+        y.resize(rows);
+        const int threads = std::min(ThreadsFor(static_cast<long>(rows) * A.cols()), MAX_REDUCTION_PARTS);
+        const int align = RowAlignment<T>(rows);
+        // Partial dot products of the row blocks, on the stack of the call: no allocation per product, and
+        // nothing shared with another call on the same thread
+        std::array<T, MAX_REDUCTION_PARTS> partialXY{};
+        std::array<T, MAX_REDUCTION_PARTS> partialYY{};
+
+        TaskScheduler::Instance().ParallelForParts(threads, [&](int part)
+                                             {
+            int begin, end;
+            Partition(rows, threads, align, part, begin, end);
+            if (end > begin)
+            {
+                auto yBlock = y.segment(begin, end - begin);
+                auto xBlock = x.segment(begin, end - begin);
+                yBlock.noalias() = A.middleRows(begin, end - begin) * x;
+                yBlock -= shift * xBlock;
+                partialXY[part] = SimdKernels::Dot<T>(xBlock.data(), yBlock.data(), end - begin);
+                partialYY[part] = SimdKernels::Dot<T>(yBlock.data(), yBlock.data(), end - begin);
+            } });
+
+        xDotY = 0;
+        yDotY = 0;
+        for (int part = 0; part < threads; ++part)
+        {
+            xDotY += partialXY[part];
+            yDotY += partialYY[part];
+        }
+    }
+
+    template <typename T, typename S>
+    void MatVecMixed(const Matrix<S> &A, const Vector<T> &x, Vector<T> &y)
+    {
+        const int rows = A.rows();
+        const int cols = A.cols();
+        const double entries = static_cast<double>(rows) * cols;
+        RooflineRegion region("matvec (mixed)", 2 * entries, sizeof(S) * entries + sizeof(T) * (rows + cols));
+        y.resize(rows);
+        const int threads = ThreadsFor(static_cast<long>(rows) * cols);
+        const int align = RowAlignment<S>(rows);
+
+        TaskScheduler::Instance().ParallelForParts(threads, [&](int part)
+                                             {
+            int begin, end;
+            Partition(rows, threads, align, part, begin, end);
+            for (int chunk = begin; chunk < end; chunk += MIXED_CHUNK_ROWS)
+            {
+                const int size = std::min(MIXED_CHUNK_ROWS, end - chunk);
+                T *out = y.data() + chunk;
+                std::fill_n(out, size, T(0));
+
+                // Four columns at a time: each entry of y is loaded and stored once per four columns
+                int j = 0;
+                for (; j + 4 <= cols; j += 4)
+                {
+                    const S *a0 = &A(chunk, j);
+                    const S *a1 = a0 + A.outerStride();
+                    const S *a2 = a1 + A.outerStride();
+                    const S *a3 = a2 + A.outerStride();
+                    const T x0 = x(j), x1 = x(j + 1), x2 = x(j + 2), x3 = x(j + 3);
+                    for (int i = 0; i < size; ++i)
+                        out[i] += ToCompute<T>(a0[i]) * x0 + ToCompute<T>(a1[i]) * x1 + ToCompute<T>(a2[i]) * x2 + ToCompute<T>(a3[i]) * x3;
+                }
+                for (; j < cols; ++j)
+                {
+                    const S *a = &A(chunk, j);
+                    const T xj = x(j);
+                    for (int i = 0; i < size; ++i)
+                        out[i] += ToCompute<T>(a[i]) * xj;
+                }
+            } });
+    }
+
+    template <typename T>
+    void MatMul(const Matrix<T> &A, const Matrix<T> &B, Matrix<T> &C)
+    {
+        const double m = A.rows(), k = A.cols(), n = B.cols();
+        RooflineRegion region("matmul", 2 * m * k * n, sizeof(T) * (m * k + k * n + m * n));
+        C.resize(A.rows(), B.cols());
+        const int cols = B.cols();
+        const int threads = ThreadsFor(static_cast<long>(A.rows()) * cols);
+
+        TaskScheduler::Instance().ParallelForParts(threads, [&](int part)
+                                             {
+            int begin, end;
+            Partition(cols, threads, 8, part, begin, end);
+            if (end > begin)
+                BlockedProduct<T>(A, B.middleCols(begin, end - begin), C.middleCols(begin, end - begin)); });
+    }
+
+    template <typename T>
+    void MatMulInPlace(Matrix<T> &A, const Matrix<T> &B)
+    {
+        const double m = A.rows(), k = A.cols(), n = B.cols();
+        RooflineRegion region("matmul", 2 * m * k * n, sizeof(T) * (m * k + k * n + m * n));
+        const int rows = A.rows();
+        const int threads = ThreadsFor(static_cast<long>(rows) * B.cols());
+        const int blocks = (rows + IN_PLACE_BLOCK_ROWS - 1) / IN_PLACE_BLOCK_ROWS;
+
+        TaskScheduler::Instance().ParallelFor(0, blocks, threads == 1 ? blocks : 1, [&](int firstBlock, int lastBlock)
+                                             {
+            // Rows of the product, kept between calls to avoid an allocation per block (the last block of
+            // rows, which may be smaller, uses the top of the buffer)
+            thread_local Matrix<T> buffer;
+            buffer.resize(IN_PLACE_BLOCK_ROWS, B.cols());
+            for (int block = firstBlock; block < lastBlock; ++block)
+            {
+                const int begin = block * IN_PLACE_BLOCK_ROWS;
+                const int size = std::min(IN_PLACE_BLOCK_ROWS, rows - begin);
+                BlockedProduct<T>(A.middleRows(begin, size), B, buffer.topRows(size));
+                A.middleRows(begin, size) = buffer.topRows(size);
+            } });
+    }
+
+    template <typename T>
+    void ApplyReflectorLeft(Eigen::Ref<Matrix<T>> R, const Eigen::Ref<const Vector<T>> &v)
+    {
+        Vector<T> work(R.cols());
+        ApplyReflectorLeft<T>(R, v, work);
+    }
+
+    template <typename T>
+    void ApplyReflectorLeft(Eigen::Ref<Matrix<T>> R, const Eigen::Ref<const Vector<T>> &v, Eigen::Ref<Vector<T>> work)
+    {
+        const int cols = R.cols();
+        const double entries = static_cast<double>(R.rows()) * cols;
+        RooflineRegion region("reflector (left)", 4 * entries, sizeof(T) * (2 * entries + R.rows()));
+        const int threads = ThreadsFor(static_cast<long>(R.rows()) * cols);
+
+        TaskScheduler::Instance().ParallelForParts(threads, [&](int part)
+                                             {
+            int begin, end;
+            Partition(cols, threads, 8, part, begin, end);
+            if (end > begin)
+            {
+                // Column by column: the column is still in the cache for its update
+                for (int j = begin; j < end; ++j)
+                {
+                    T *column = R.col(j).data();
+                    work(j) = SimdKernels::Dot<T>(column, v.data(), R.rows()); // w = R^T v
+                    SimdKernels::Axpy<T>(-2 * work(j), v.data(), column, R.rows());
+                }
+            } });
+    }
+
+    template <typename T>
+    void ApplyReflectorRight(Eigen::Ref<Matrix<T>> Q, const Eigen::Ref<const Vector<T>> &v)
+    {
+        Vector<T> work(Q.rows());
+        ApplyReflectorRight<T>(Q, v, work);
+    }
+
+    template <typename T>
+    void ApplyReflectorRight(Eigen::Ref<Matrix<T>> Q, const Eigen::Ref<const Vector<T>> &v, Eigen::Ref<Vector<T>> work)
+    {
+        const int rows = Q.rows();
+        const double entries = static_cast<double>(rows) * Q.cols();
+        RooflineRegion region("reflector (right)", 4 * entries, sizeof(T) * (2 * entries + Q.cols()));
+        const int threads = ThreadsFor(static_cast<long>(rows) * Q.cols());
+        const int align = RowAlignment<T>(rows);
+
+        TaskScheduler::Instance().ParallelForParts(threads, [&](int part)
+                                             {
+            int begin, end;
+            Partition(rows, threads, align, part, begin, end);
+            if (end > begin)
+            {
+                // The segments of the columns of the block are contiguous: w = Q v, then Q = Q - 2 w v^T
+                const int size = end - begin;
+                T *w = work.data() + begin;
+                std::fill_n(w, size, T(0));
+                for (int j = 0; j < Q.cols(); ++j)
+                    SimdKernels::Axpy<T>(v(j), Q.col(j).data() + begin, w, size);
+                for (int j = 0; j < Q.cols(); ++j)
+                    SimdKernels::Axpy<T>(-2 * v(j), w, Q.col(j).data() + begin, size);
+            } });
+    }
+
+    template <typename T>
+    void SolveUpperTriangular(const Eigen::Ref<const Matrix<T>> &U, Eigen::Ref<Vector<T>> b)
+    {
+        const int n = U.rows();
+        const double size = n;
+        RooflineRegion region("triangular solve", size * size, sizeof(T) * (size * size / 2 + size));
+        for (int end = n; end > 0; end -= TRIANGULAR_BLOCK_SIZE)
+        {
+            const int begin = std::max(0, end - TRIANGULAR_BLOCK_SIZE);
+            const int size = end - begin;
+
+            // Solve the diagonal block
+            U.block(begin, begin, size, size).template triangularView<Eigen::Upper>().solveInPlace(b.segment(begin, size));
+
+            // Update the right-hand side of the rows above the block
+            const int threads = ThreadsFor(static_cast<long>(begin) * size);
+            const int align = RowAlignment<T>(begin);
+            TaskScheduler::Instance().ParallelForParts(threads, [&](int part)
+                                                 {
+                int rowBegin, rowEnd;
+                Partition(begin, threads, align, part, rowBegin, rowEnd);
+                if (rowEnd > rowBegin)
+                    b.segment(rowBegin, rowEnd - rowBegin).noalias() -= U.block(rowBegin, begin, rowEnd - rowBegin, size) * b.segment(begin, size); });
+        }
+    }
+
+    // Explicit instantiations
+    template int RowAlignment<float>(int);
+    template int RowAlignment<double>(int);
+    template int RowAlignment<Eigen::half>(int);
+    template int RowAlignment<Eigen::bfloat16>(int);
+    template void MatVec<float>(const Matrix<float> &, const Vector<float> &, Vector<float> &);
+    template void MatVec<double>(const Matrix<double> &, const Vector<double> &, Vector<double> &);
+    template void MatVecDots<float>(const Matrix<float> &, const Vector<float> &, float, Vector<float> &, float &, float &);
+    template void MatVecDots<double>(const Matrix<double> &, const Vector<double> &, double, Vector<double> &, double &, double &);
+    template void MatVecMixed<float, Eigen::half>(const Matrix<Eigen::half> &, const Vector<float> &, Vector<float> &);
+    template void MatVecMixed<float, Eigen::bfloat16>(const Matrix<Eigen::bfloat16> &, const Vector<float> &, Vector<float> &);
+    template void MatVecMixed<double, float>(const Matrix<float> &, const Vector<double> &, Vector<double> &);
+    template void MatVecMixed<double, Eigen::half>(const Matrix<Eigen::half> &, const Vector<double> &, Vector<double> &);
+    template void MatVecMixed<double, Eigen::bfloat16>(const Matrix<Eigen::bfloat16> &, const Vector<double> &, Vector<double> &);
+    template void MatMul<float>(const Matrix<float> &, const Matrix<float> &, Matrix<float> &);
+    template void MatMul<double>(const Matrix<double> &, const Matrix<double> &, Matrix<double> &);
+    template void MatMulInPlace<float>(Matrix<float> &, const Matrix<float> &);
+    template void MatMulInPlace<double>(Matrix<double> &, const Matrix<double> &);
+    template void ApplyReflectorLeft<float>(Eigen::Ref<Matrix<float>>, const Eigen::Ref<const Vector<float>> &);
+    template void ApplyReflectorLeft<double>(Eigen::Ref<Matrix<double>>, const Eigen::Ref<const Vector<double>> &);
+    template void ApplyReflectorRight<float>(Eigen::Ref<Matrix<float>>, const Eigen::Ref<const Vector<float>> &);
+    template void ApplyReflectorRight<double>(Eigen::Ref<Matrix<double>>, const Eigen::Ref<const Vector<double>> &);
+    template void ApplyReflectorLeft<float>(Eigen::Ref<Matrix<float>>, const Eigen::Ref<const Vector<float>> &, Eigen::Ref<Vector<float>>);
+    template void ApplyReflectorLeft<double>(Eigen::Ref<Matrix<double>>, const Eigen::Ref<const Vector<double>> &, Eigen::Ref<Vector<double>>);
+    template void ApplyReflectorRight<float>(Eigen::Ref<Matrix<float>>, const Eigen::Ref<const Vector<float>> &, Eigen::Ref<Vector<float>>);
+    template void ApplyReflectorRight<double>(Eigen::Ref<Matrix<double>>, const Eigen::Ref<const Vector<double>> &, Eigen::Ref<Vector<double>>);
+    template void SolveUpperTriangular<float>(const Eigen::Ref<const Matrix<float>> &, Eigen::Ref<Vector<float>>);
+    template void SolveUpperTriangular<double>(const Eigen::Ref<const Matrix<double>> &, Eigen::Ref<Vector<double>>);
+}
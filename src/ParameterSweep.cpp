@@ -0,0 +1,152 @@
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+#include "ParameterSweep.hpp"
+#include "InversePowerMethodSolver.hpp"
+#include "MatrixGeneratorFactory.hpp"
+#include "TaskScheduler.hpp"
+
+template <typename T>
+void SweepResult<T>::WriteTable(std::ostream &out) const
+{
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision(std::numeric_limits<T>::digits10);
+    out << "# parameter iterations";
+    for (int j = 0; j < eigenvalues.cols(); ++j)
+        out << " lambda_" << j + 1;
+    out << "\n";
+    for (int i = 0; i < parameters.size(); ++i)
+    {
+        out << parameters(i) << " " << iterations[i];
+        for (int j = 0; j < eigenvalues.cols(); ++j)
+            out << " " << eigenvalues(i, j);
+        out << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+template <typename T>
+ParameterSweep<T>::ParameterSweep(const std::vector<MatrixPointer<T>> &terms, double first, double last, int points)
+    : terms(terms)
+{
+    if (terms.empty())
+        throw std::invalid_argument("A parameter sweep needs at least one matrix");
+    const int n = terms[0]->rows();
+    for (const MatrixPointer<T> &term : terms)
+    {
+        if (term->rows() != n || term->cols() != n)
+            throw std::invalid_argument("The matrices of a parameter sweep must be square and of the same size");
+    }
+    if (points <= 0)
+        throw std::invalid_argument("The grid of a parameter sweep needs at least one point (" + std::to_string(points) + ")");
+    parameters = Vector<T>::LinSpaced(points, static_cast<T>(first), static_cast<T>(last));
+    if (points == 1) // Eigen returns the last value
+        parameters(0) = static_cast<T>(first);
+}
+
+template <typename T>
+ParameterSweep<T> ParameterSweep<T>::FromArgs(const std::vector<std::string> &inputArgs)
+{
+    if (inputArgs.size() < 5)
+        throw std::invalid_argument("Expected at least 5 arguments for a parameter sweep (first and last parameters, number of parameters, "
+                                    "two matrix files or more), but got " + std::to_string(inputArgs.size()));
+    double first;
+    double last;
+    int points;
+    try
+    {
+        first = std::stod(inputArgs[0]);
+        last = std::stod(inputArgs[1]);
+        points = std::stoi(inputArgs[2]);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::invalid_argument("Failed to convert the grid of the parameter sweep: " + std::string(e.what()));
+    }
+
+    std::vector<MatrixPointer<T>> terms;
+    for (std::size_t k = 3; k < inputArgs.size(); ++k)
+    {
+        MatrixGeneratorFactory<T> generatorFactory("file", {inputArgs[k]});
+        terms.push_back(generatorFactory.ChooseGenerator()->GenerateMatrix());
+    }
+    return ParameterSweep<T>(terms, first, last, points);
+}
+
+template <typename T>
+void ParameterSweep<T>::Assemble(T t, Matrix<T> &A) const
+{
+    // Horner's scheme: A = (...(A_m t + A_{m-1}) t + ...) t + A_0
+    A = *terms.back();
+    for (int k = static_cast<int>(terms.size()) - 2; k >= 0; --k)
+        A = t * A + *terms[k];
+}
+
+template <typename T>
+SweepResult<T> ParameterSweep<T>::Run(SolverFactory<T> &factory, int segments, bool continuation) const
+{
+    TaskScheduler &scheduler = TaskScheduler::Instance();
+    const int points = parameters.size();
+    if (segments <= 0)
+        segments = scheduler.GetNumWorkers();
+    segments = std::min(segments, points);
+
+    // One solver per segment, created beforehand (for the size of the matrices): its workspace is reused along the segment
+    std::vector<std::unique_ptr<AbstractIterativeSolver<T>>> solvers;
+    for (int s = 0; s < segments; ++s)
+        solvers.push_back(factory.ChooseSolver(terms[0]->rows()));
+
+    std::vector<Vector<T>> found(points);
+    SweepResult<T> result;
+    result.parameters = parameters;
+    result.iterations.resize(points);
+    result.segments = segments;
+    scheduler.ParallelFor(0, segments, 1, [&](int firstSegment, int lastSegment)
+                          {
+        for (int s = firstSegment; s < lastSegment; ++s)
+        {
+            AbstractIterativeSolver<T> &solver = *solvers[s];
+            auto *inverseSolver = dynamic_cast<InversePowerMethodSolver<T> *>(&solver);
+            solver.SetExportVectors(continuation);
+            auto A = std::make_shared<Matrix<T>>();
+            double shiftOffset = 0.0; // Distance from the shift to the tracked eigenvalue, at the first point
+
+            const int begin = static_cast<int>(static_cast<long>(s) * points / segments);
+            const int end = static_cast<int>(static_cast<long>(s + 1) * points / segments);
+            for (int i = begin; i < end; ++i)
+            {
+                Assemble(parameters(i), *A);
+                solver.SetMatrix(A);
+                found[i] = solver.FindEigenvalues();
+                result.iterations[i] = solver.GetReport().iterations;
+                if (!continuation)
+                    continue;
+
+                // The next solve starts from this one
+                solver.SetWarmStart(solver.GetWarmStart());
+                if (inverseSolver != nullptr)
+                {
+                    if (i == begin)
+                        shiftOffset = inverseSolver->GetShift() - found[i](0);
+                    inverseSolver->SetShift(found[i](0) + shiftOffset);
+                }
+            }
+        } });
+
+    // One row per parameter: the solvers may find different numbers of eigenvalues (Lanczos method)
+    int columns = 0;
+    for (const Vector<T> &eigenvalues : found)
+        columns = std::max(columns, static_cast<int>(eigenvalues.size()));
+    result.eigenvalues = Matrix<T>::Constant(points, columns, std::numeric_limits<T>::quiet_NaN());
+    for (int i = 0; i < points; ++i)
+        result.eigenvalues.row(i).head(found[i].size()) = found[i].transpose();
+    return result;
+}
+
+// Explicit instantiation
+template struct SweepResult<float>;
+template struct SweepResult<double>;
+template class ParameterSweep<float>;
+template class ParameterSweep<double>;
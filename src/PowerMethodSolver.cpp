@@ -1,10 +1,29 @@
 #include <iostream>
+#include <limits>
 
 #include "PowerMethodSolver.hpp"
+#include "LanczosSolver.hpp"
+#include "SimdKernels.hpp"
+#include "Tracer.hpp"
+
+namespace
+{
+    // Slots of the buffers of the iterations in the workspace of the solver
+    enum WorkspaceSlot
+    {
+        ITERATE,
+        PRODUCT,
+        PREVIOUS_ITERATE
+    };
+}
 
 template <typename T>
-PowerMethodSolver<T>::PowerMethodSolver(double tolerance, int maxIter, double shift)
-    : AbstractIterativeSolver<T>(tolerance, maxIter), shift(shift) {}
+PowerMethodSolver<T>::PowerMethodSolver(double tolerance, int maxIter, double shift, const std::string &acceleration)
+    : AbstractIterativeSolver<T>(tolerance, maxIter), shift(shift), acceleration(acceleration)
+{
+    if (SupportedArguments::SUPPORTED_ACCELERATIONS.find(acceleration) == SupportedArguments::SUPPORTED_ACCELERATIONS.end())
+        throw std::invalid_argument("unsupported acceleration mode for the power method (" + acceleration + ")");
+}
 
 template <typename T>
 PowerMethodSolver<T>::~PowerMethodSolver() {}
@@ -12,55 +31,236 @@ PowerMethodSolver<T>::~PowerMethodSolver() {}
 template <typename T>
 Vector<T> PowerMethodSolver<T>::FindEigenvalues()
 {
+    TraceSpan span("power method", "solver");
+    this->report = SolverReport();
+    this->report.acceleration = acceleration;
+    this->monitor.Reset();
+
+    // Retrieve the operator: the vectors only hold the entries stored by this process.
+    // The shift is applied with the products, so that no shifted copy of the matrix is needed.
+    std::shared_ptr<LinearOperator<T>> A = this->GetOperator();
+
+    T lambda;
+    if (acceleration == "chebyshev")
+        lambda = ChebyshevIteration(*A);
+    else
+        lambda = PowerIteration(*A, acceleration == "aitken");
+    this->report.converged = this->monitor.Converged();
+    this->RecordConvergence(this->monitor.GetCriterion());
+
+    if (!this->report.converged)
+    {
+        std::cerr << "[WARNING] Maximum number of iterations reached.\n"
+                  << "          Consider using a higher number for the maximum number of iterations."
+                  << std::endl;
+    }
+    std::cout << "Total number of iterations: " << this->report.iterations << std::endl;
 
+    // The last iterate is normalized: it is the eigenvector estimate
+    Vector<T> result(1);
+    result(0) = lambda;
+    this->RecordResult(result, this->workspace.GetVector(ITERATE));
+    return result;
+}
+
+template <typename T>
+T PowerMethodSolver<T>::PowerIteration(LinearOperator<T> &A, bool aitken)
+{
     // Get parameters from parent abstract class
     double tolerance = this->GetTolerance();
     int maxIter = this->GetMaxIter();
-    double error = tolerance + 1.0;
     int iterCount = 0;
+    const T shiftValue = static_cast<T>(shift);
 
-    // Retrieve pointer to matrix
-    MatrixPointer<T> A_ptr = this->GetMatrix();
-    const Matrix<T> A_shifted = *A_ptr - shift * Matrix<T>::Identity((*A_ptr).rows(), (*A_ptr).cols());
+    // The iterates live in the workspace: no allocation in the iteration loop
+    Vector<T> &x = this->workspace.GetVector(ITERATE);
+    Vector<T> &y = this->workspace.GetVector(PRODUCT);
+    if (!this->InitialVector(x))
+        x.setOnes();
+    x /= A.Norm(x);
 
-    Vector<T> x_ini = Vector<T>::Ones(A_shifted.rows());
-    x_ini.normalize();
+    // y = (A - shift I) x, with the Rayleigh quotient x^T y (x is normalized) and the squared norm of y.
+    // The product of an iteration is reused for the Rayleigh quotient of the next one: one pass over A per iteration.
+    T xDotY;
+    T yDotY;
+    A.ApplyWithDots(x, shiftValue, y, xDotY, yDotY);
+    T lambdaOld = xDotY;
+    T lambdaNew = lambdaOld;
 
-    // Declare eigenvalue related to initial guess
-    T lambdaOld = x_ini.dot(A_shifted * x_ini);
-    T lambdaNew;
+    // Previous Rayleigh quotient and extrapolated value, for the rate estimate and Aitken's extrapolation
+    T lambdaOlder = lambdaOld;
+    T extrapolated = lambdaOld;
+    T extrapolatedOld = lambdaOld;
+    double rate = 0.0;
 
-    while (error > tolerance && iterCount < maxIter)
+    while (!this->monitor.Converged() && iterCount < maxIter)
     {
-        // Multiply A * x_0
-        Vector<T> x_new = A_shifted * x_ini;
-
-        // Normalize x_new inplace
-        x_new.normalize();
+        // Next iterate: normalized y (the buffers are swapped instead of copied)
+        x.swap(y);
+        SimdKernels::Scale<T>(1 / std::sqrt(yDotY), x.data(), x.size());
 
         // Compute eigenvalue lambda using Rayleigh quotient
-        lambdaNew = x_new.dot(A_shifted * x_new);
+        A.ApplyWithDots(x, shiftValue, y, xDotY, yDotY);
+        lambdaNew = xDotY;
+        ++iterCount;
+
+        // The ratio of two successive changes estimates the convergence rate of the eigenvalue
+        if (iterCount >= 2 && lambdaOld != lambdaOlder)
+            rate = std::abs((lambdaNew - lambdaOld) / (lambdaOld - lambdaOlder));
 
-        // Compute error as abs(lambdaOld - lambdaNew)
-        error = std::abs(lambdaNew - lambdaOld) / std::abs(lambdaNew);
+        if (aitken && iterCount >= 2)
+        {
+            // Aitken's delta-squared extrapolation of the last three Rayleigh quotients
+            T denominator = lambdaNew - 2 * lambdaOld + lambdaOlder;
+            if (std::abs(denominator) > std::numeric_limits<T>::epsilon() * std::abs(lambdaNew))
+                extrapolated = lambdaNew - (lambdaNew - lambdaOld) * (lambdaNew - lambdaOld) / denominator;
+            else // The sequence does not change anymore
+                extrapolated = lambdaNew;
+        }
 
-        // Increment iteration count, and update values of x and lambda
+        if (this->monitor.UsesResidual())
+        {
+            // Residual of the pair (x, x^T A x): y holds (A - shift I) x
+            if (this->monitor.IsCheckDue(iterCount))
+                this->monitor.CheckResidual(x, y, xDotY, lambdaNew + shiftValue, &A);
+        }
+        else if (!aitken)
+            this->monitor.CheckChange(lambdaNew, lambdaOld);
+        else if (iterCount >= 3)
+            this->monitor.CheckChange(extrapolated, extrapolatedOld);
+        if (aitken && iterCount >= 2)
+            extrapolatedOld = extrapolated;
+        this->monitor.Record(iterCount, (aitken && iterCount >= 2 ? extrapolated : lambdaNew) + shiftValue);
+
+        // Update values of lambda
+        lambdaOlder = lambdaOld;
         lambdaOld = lambdaNew;
-        x_ini = x_new;
-        ++iterCount;
     }
 
-    if (iterCount >= maxIter)
+    this->report.iterations = iterCount;
+    this->report.convergenceRate = rate;
+    if (!aitken || iterCount < 2)
+        return lambdaNew + shiftValue;
+
+    // Iterations the plain method would still need for the change of the Rayleigh quotient to drop below the tolerance
+    T change = std::abs(lambdaOld - lambdaOlder);
+    if (rate > 0.0 && rate < 1.0 && change > tolerance * std::abs(lambdaNew))
+        this->report.iterationsSaved = static_cast<int>(std::ceil(std::log(tolerance * std::abs(lambdaNew) / change) / std::log(rate)));
+    return extrapolated + shiftValue;
+}
+
+template <typename T>
+T PowerMethodSolver<T>::ChebyshevIteration(LinearOperator<T> &A)
+{
+    // Get parameters from parent abstract class
+    int maxIter = this->GetMaxIter();
+    int iterCount = 0;
+    const T shiftValue = static_cast<T>(shift);
+
+    // Estimate the spectrum with a few Lanczos steps: the Ritz values lie inside the spectrum,
+    // the extreme ones converging first
+    Vector<T> residuals;
+    TraceSpan boundsSpan("spectral bounds", "solver");
+    Vector<T> ritzValues = LanczosSolver<T>::RitzValues(A, DefaultSolverArgs::BOUND_ESTIMATION_STEPS, residuals);
+    const int m = ritzValues.size();
+    this->report.extraProducts = m;
+    T lower = ritzValues(0) - residuals(0);
+    T upper = ritzValues(m - 1) + residuals(m - 1);
+    if (this->HasMatrix()) // The Gershgorin discs enclose the whole spectrum
+    {
+        const Matrix<T> &matrix = *this->GetMatrix();
+        Vector<T> radii = matrix.cwiseAbs().colwise().sum().transpose() - matrix.diagonal().cwiseAbs();
+        lower = (matrix.diagonal() - radii).minCoeff();
+        upper = (matrix.diagonal() + radii).maxCoeff();
+        ++this->report.extraProducts;
+    }
+    boundsSpan.End();
+
+    // The wanted eigenvalue is the one furthest from the shift: the interval [a, b] to damp
+    // covers the rest of the spectrum, from the second Ritz value to the opposite bound
+    const bool largest = m < 2 || std::abs(ritzValues(m - 1) - shiftValue) >= std::abs(ritzValues(0) - shiftValue);
+    const T wanted = largest ? ritzValues(m - 1) : ritzValues(0);
+    const T a = largest ? lower : (m > 1 ? ritzValues(1) : wanted);
+    const T b = largest ? (m > 1 ? ritzValues(m - 2) : wanted) : upper;
+    const T center = (a + b) / 2;
+    const T halfWidth = (b - a) / 2;
+    const T tau = halfWidth > 0 ? std::abs(wanted - center) / halfWidth : 0;
+    const T scale = std::max(std::abs(lower), std::abs(upper));
+    if (m < 2 || halfWidth <= std::numeric_limits<T>::epsilon() * scale || tau <= 1 + std::sqrt(std::numeric_limits<T>::epsilon()))
     {
-        std::cerr << "[WARNING] Maximum number of iterations reached.\n"
-                  << "          Consider using a higher number for the maximum number of iterations."
+        std::cerr << "[WARNING] The spectral bounds can not separate the dominant eigenvalue: Chebyshev acceleration disabled."
                   << std::endl;
+        this->report.acceleration = "none";
+        return PowerIteration(A, false);
     }
-    std::cout << "Total number of iterations: " << iterCount << std::endl;
 
-    Vector<T> result(1);
-    result(0) = lambdaNew + shift;
-    return result;
+    // Error reductions per iteration: the Rayleigh quotient converges twice as fast as the vector (symmetric matrix)
+    const T unwanted = largest ? std::max(std::abs(ritzValues(0) - shiftValue), std::abs(ritzValues(m - 2) - shiftValue))
+                               : std::max(std::abs(ritzValues(1) - shiftValue), std::abs(ritzValues(m - 1) - shiftValue));
+    const double plainRate = std::pow(unwanted / std::abs(wanted - shiftValue), 2);
+    const double chebyshevRate = std::pow(1.0 / (tau + std::sqrt(tau * tau - 1)), 2);
+
+    // x_k = p_k(A) x_0, where p_k(t) = T_k((t - c) / e) / T_k((wanted - c) / e) and T_k is the Chebyshev polynomial of degree k.
+    // Three-term recurrence (sigma_k = T_{k-1} / T_k at the wanted eigenvalue):
+    // x_{k+1} = 2 sigma_{k+1} / e (A - c I) x_k - sigma_k sigma_{k+1} x_{k-1}
+    const T sigma1 = halfWidth / (wanted - center);
+    T sigma = sigma1;
+    Vector<T> &x = this->workspace.GetVector(ITERATE);
+    Vector<T> &xPrevious = this->workspace.GetVector(PREVIOUS_ITERATE);
+    Vector<T> &y = this->workspace.GetVector(PRODUCT);
+    if (!this->InitialVector(x))
+        x.setOnes();
+    xPrevious.setZero();
+    T xDotY;
+    T yDotY;
+    T lambdaOld = 0;
+    T lambdaNew = 0;
+
+    while (true)
+    {
+        // Normalize the last two iterates together (the recurrence is linear)
+        T inverseNorm = 1 / A.Norm(x);
+        SimdKernels::Scale<T>(inverseNorm, x.data(), x.size());
+        SimdKernels::Scale<T>(inverseNorm, xPrevious.data(), xPrevious.size());
+
+        // y = (A - c I) x gives both the Rayleigh quotient and the next iterate
+        A.ApplyWithDots(x, center, y, xDotY, yDotY);
+        lambdaNew = xDotY + center;
+        if (this->monitor.UsesResidual())
+        {
+            if (this->monitor.IsCheckDue(iterCount))
+                this->monitor.CheckResidual(x, y, xDotY, lambdaNew, &A);
+        }
+        else if (iterCount > 0)
+            this->monitor.CheckChange(lambdaNew, lambdaOld, lambdaNew - shiftValue);
+        this->monitor.Record(iterCount, lambdaNew);
+        lambdaOld = lambdaNew;
+        if (this->monitor.Converged() || iterCount >= maxIter)
+            break;
+
+        if (iterCount == 0)
+        {
+            xPrevious = (sigma1 / halfWidth) * y;
+        }
+        else
+        {
+            T sigmaNext = 1 / (2 / sigma1 - sigma);
+            xPrevious = (2 * sigmaNext / halfWidth) * y - (sigma * sigmaNext) * xPrevious;
+            sigma = sigmaNext;
+        }
+        x.swap(xPrevious);
+        ++iterCount;
+    }
+
+    this->report.iterations = iterCount;
+    this->report.convergenceRate = chebyshevRate;
+    if (plainRate > 0.0 && plainRate < 1.0)
+    {
+        // Iterations of the plain method reducing the error as much as the Chebyshev iterations did
+        double plainIterations = iterCount * std::log(chebyshevRate) / std::log(plainRate);
+        this->report.iterationsSaved = static_cast<int>(std::round(plainIterations)) - iterCount - this->report.extraProducts;
+    }
+    return lambdaNew;
 }
 
 // Explicit instantation
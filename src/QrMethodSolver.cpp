@@ -1,9 +1,213 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 #include "QrMethodSolver.hpp"
+#include "ParallelKernels.hpp"
+#include "SimdKernels.hpp"
+#include "TaskScheduler.hpp"
+#include "HardwareCounters.hpp"
+#include "Roofline.hpp"
+#include "Tracer.hpp"
+
+namespace
+{
+    // Slots of the buffers in the workspace of the solver
+    enum WorkspaceSlot
+    {
+        REFLECTOR,
+        REFLECTOR_PRODUCT
+    };
+    enum WorkspaceMatrixSlot
+    {
+        ITERATE,
+        FACTOR_Q,
+        FACTOR_R,
+        SCHUR_VECTORS,
+        TILE_REFLECTORS
+    };
+
+    // Reflectors of the tiled QR decomposition, P = I - 2 v v^T with v normalized, stored in an n x n matrix V.
+    // The reflectors of the diagonal tile k (GEQRT) are the columns of the lower triangle of the diagonal block
+    // (k, k) of V. The reflector j of the stacked tiles (k, k) and (i, k) (TSQRT) has one entry on the row j of
+    // the diagonal tile, stored in the column of block (k, i) above the diagonal, and the entries on the rows of
+    // tile (i, k), stored in the column j of block (i, k) below the diagonal.
+
+    // Replaces the column x of size n by the reflector v that maps it to a multiple of e_1, and x by its image
+    template <typename T>
+    void MakeReflector(T *x, T *v, int n)
+    {
+        const T norm = std::sqrt(SimdKernels::Dot<T>(x, x, n));
+        if (norm == T(0)) // Nothing to eliminate: v = 0 is the identity
+        {
+            std::fill_n(v, n, T(0));
+            return;
+        }
+        const T sign = x[0] >= 0 ? T(1) : T(-1);
+        const T scale = 1 / std::sqrt(2 * norm * (norm + std::abs(x[0]))); // 1 / ||x + sign(x_0) ||x|| e_1||
+        std::copy_n(x, n, v);
+        v[0] += sign * norm;
+        SimdKernels::Scale<T>(scale, v, n);
+        x[0] = -sign * norm;
+        std::fill_n(x + 1, n - 1, T(0));
+    }
+
+    // Applies the reflector v from the left to a column x of size n
+    template <typename T>
+    inline void ApplyReflector(const T *v, T *x, int n)
+    {
+        SimdKernels::Axpy<T>(-2 * SimdKernels::Dot<T>(v, x, n), v, x, n);
+    }
+
+    // Same for a reflector of stacked tiles: one entry vTop for the entry top of the upper tile, n entries for
+    // the column bottom of the lower tile
+    template <typename T>
+    inline void ApplyStackedReflector(T vTop, const T *vBottom, T &top, T *bottom, int n)
+    {
+        const T w = vTop * top + SimdKernels::Dot<T>(vBottom, bottom, n);
+        top -= 2 * w * vTop;
+        SimdKernels::Axpy<T>(-2 * w, vBottom, bottom, n);
+    }
+
+    // Tiles of an n x n matrix: the last ones may be smaller
+    struct Tiling
+    {
+        int n;
+        int b;
+        int Start(int i) const { return i * b; }
+        int Length(int i) const { return std::min(b, n - i * b); }
+    };
+
+    // GEQRT: QR of the diagonal tile k, R stored in the tile
+    template <typename T>
+    void FactorDiagonalTile(Matrix<T> &R, Matrix<T> &V, const Tiling &tiling, int k)
+    {
+        const int s = tiling.Start(k);
+        const int m = tiling.Length(k);
+        for (int j = 0; j < m; ++j)
+        {
+            T *v = &V(s + j, s + j);
+            MakeReflector(&R(s + j, s + j), v, m - j);
+            for (int c = j + 1; c < m; ++c)
+                ApplyReflector(v, &R(s + j, s + c), m - j);
+        }
+    }
+
+    // UNMQR: applies the reflectors of the diagonal tile k to the tile (k, j) on its right
+    template <typename T>
+    void UpdateRowTile(Matrix<T> &R, const Matrix<T> &V, const Tiling &tiling, int k, int j)
+    {
+        const int s = tiling.Start(k);
+        const int m = tiling.Length(k);
+        for (int r = 0; r < m; ++r)
+        {
+            for (int c = tiling.Start(j); c < tiling.Start(j) + tiling.Length(j); ++c)
+                ApplyReflector(&V(s + r, s + r), &R(s + r, c), m - r);
+        }
+    }
+
+    // TSQRT: QR of the triangular diagonal tile k stacked on the tile (i, k) below it, which is eliminated
+    template <typename T>
+    void FactorStackedTiles(Matrix<T> &R, Matrix<T> &V, const Tiling &tiling, int i, int k)
+    {
+        const int s = tiling.Start(k);
+        const int m = tiling.Length(k);
+        const int below = tiling.Start(i);
+        const int p = tiling.Length(i);
+        for (int j = 0; j < m; ++j)
+        {
+            T &top = R(s + j, s + j);
+            T *bottom = &R(below, s + j);
+            T &vTop = V(s + j, below);
+            T *vBottom = &V(below, s + j);
+            const T norm = std::sqrt(top * top + SimdKernels::Dot<T>(bottom, bottom, p));
+            if (norm == T(0))
+            {
+                vTop = 0;
+                std::fill_n(vBottom, p, T(0));
+                continue;
+            }
+            const T sign = top >= 0 ? T(1) : T(-1);
+            const T scale = 1 / std::sqrt(2 * norm * (norm + std::abs(top)));
+            vTop = (top + sign * norm) * scale;
+            std::copy_n(bottom, p, vBottom);
+            SimdKernels::Scale<T>(scale, vBottom, p);
+            top = -sign * norm;
+            std::fill_n(bottom, p, T(0));
+            for (int c = j + 1; c < m; ++c)
+                ApplyStackedReflector(vTop, vBottom, R(s + j, s + c), &R(below, s + c), p);
+        }
+    }
+
+    // TSMQR: applies the reflectors of the stacked tiles (k, k) and (i, k) to the tiles (k, j) and (i, j)
+    template <typename T>
+    void UpdateStackedTiles(Matrix<T> &R, const Matrix<T> &V, const Tiling &tiling, int i, int j, int k)
+    {
+        const int s = tiling.Start(k);
+        const int below = tiling.Start(i);
+        const int p = tiling.Length(i);
+        for (int r = 0; r < tiling.Length(k); ++r)
+        {
+            for (int c = tiling.Start(j); c < tiling.Start(j) + tiling.Length(j); ++c)
+                ApplyStackedReflector(V(s + r, below), &V(below, s + r), R(s + r, c), &R(below, c), p);
+        }
+    }
+
+    // Applies the reflectors of the decomposition from the right to the rows [first, first + rows) of Q,
+    // in the order of the factorization. w is a buffer of `rows` entries.
+    template <typename T>
+    void ApplyReflectorsRight(Matrix<T> &Q, const Matrix<T> &V, const Tiling &tiling, int first, int rows, T *w)
+    {
+        const int tiles = (tiling.n + tiling.b - 1) / tiling.b;
+        auto column = [&](int j)
+        { return Q.col(j).data() + first; };
+        for (int k = 0; k < tiles; ++k)
+        {
+            const int s = tiling.Start(k);
+            const int m = tiling.Length(k);
+            for (int r = 0; r < m; ++r) // Q = Q - 2 (Q v) v^T
+            {
+                const T *v = &V(s + r, s + r);
+                std::fill_n(w, rows, T(0));
+                for (int c = 0; c < m - r; ++c)
+                    SimdKernels::Axpy<T>(v[c], column(s + r + c), w, rows);
+                for (int c = 0; c < m - r; ++c)
+                    SimdKernels::Axpy<T>(-2 * v[c], w, column(s + r + c), rows);
+            }
+            for (int i = k + 1; i < tiles; ++i)
+            {
+                const int below = tiling.Start(i);
+                for (int r = 0; r < m; ++r)
+                {
+                    const T vTop = V(s + r, below);
+                    const T *vBottom = &V(below, s + r);
+                    std::fill_n(w, rows, T(0));
+                    SimdKernels::Axpy<T>(vTop, column(s + r), w, rows);
+                    for (int c = 0; c < tiling.Length(i); ++c)
+                        SimdKernels::Axpy<T>(vBottom[c], column(below + c), w, rows);
+                    SimdKernels::Axpy<T>(-2 * vTop, w, column(s + r), rows);
+                    for (int c = 0; c < tiling.Length(i); ++c)
+                        SimdKernels::Axpy<T>(-2 * vBottom[c], w, column(below + c), rows);
+                }
+            }
+        }
+    }
+}
+
+// Graph of the tasks of a tiled decomposition, for a size and a tile size. The tasks read the matrices through
+// the pointers, set before each run.
+template <typename T>
+struct QrMethodSolver<T>::TiledGraph
+{
+    TaskGroup group;
+    Tiling tiling;
+    Matrix<T> *R = nullptr;          // Matrix being decomposed
+    Matrix<T> *reflectors = nullptr; // Reflectors of the tile kernels
+};
 
 template <typename T>
-QrMethodSolver<T>::QrMethodSolver(double tolerance, int maxIter) : AbstractIterativeSolver<T>(tolerance, maxIter) {}
+QrMethodSolver<T>::QrMethodSolver(double tolerance, int maxIter) : AbstractIterativeSolver<T>(tolerance, maxIter), tileSize(DefaultSolverArgs::TILE_SIZE) {}
 
 template <typename T>
 QrMethodSolver<T>::~QrMethodSolver() {}
@@ -11,70 +215,240 @@ QrMethodSolver<T>::~QrMethodSolver() {}
 template <typename T>
 void QrMethodSolver<T>::QrDecomposition(const Matrix<T> &A_iter, Matrix<T> &Q, Matrix<T> &R)
 {
-    // A_shifted is passed as a const so that it can not be modified
+    // A_iter is passed as a const so that it can not be modified: the factorization works on its copy R
+    R = A_iter;
+    QrDecompositionInPlace(R, Q);
+}
 
-    int n = A_iter.rows(); // Number of rows (same as number of columns)
+template <typename T>
+void QrMethodSolver<T>::QrDecompositionInPlace(Matrix<T> &A, Matrix<T> &Q)
+{
+    TraceSpan span("qr decomposition", "solver");
+    CounterRegion region("qr decomposition");
+    if (A.rows() >= 2 * tileSize)
+        TiledQrInPlace(A, Q);
+    else
+        HouseholderQrInPlace(A, Q);
+}
 
-    // Initialize Q and R
-    Q = Matrix<T>::Identity(n, n);
-    R = A_iter;
+template <typename T>
+void QrMethodSolver<T>::HouseholderQrInPlace(Matrix<T> &R, Matrix<T> &Q)
+{
+    int n = R.rows(); // Number of rows (same as number of columns)
+
+    // Initialize Q
+    Q.setIdentity(n, n);
+
+    // Householder vector and products with it, taken from the workspace: no allocation per column
+    if (this->workspace.GetSize() != n)
+        this->workspace.SetSize(n);
+    Vector<T> &reflector = this->workspace.GetVector(REFLECTOR);
+    Vector<T> &product = this->workspace.GetVector(REFLECTOR_PRODUCT);
 
     for (int k = 0; k < n; k++)
     {
+        auto v = reflector.head(n - k);
+        v = R.block(k, k, n - k, 1);
+        v(0) += (v.norm() * (v(0) >= 0 ? 1 : -1)); // v = x + sign(x_0) * ||x|| * e_1
 
-        Vector<T> x = R.block(k, k, n - k, 1);
-        Vector<T> v = x;
-        v(0) += (x.norm() * (x(0) >= 0 ? 1 : -1)); // v = x + sign(x_0) * ||x|| * e_1
-
-        v = v / v.norm(); // Normalize the vector v
+        v /= v.norm(); // Normalize the vector v
 
         // Apply Householder transformation to the trailing matrix
-        R.block(k, k, n - k, n - k) -= 2 * v * v.transpose() * R.block(k, k, n - k, n - k);
+        ParallelKernels::ApplyReflectorLeft<T>(R.block(k, k, n - k, n - k), v, product.head(n - k));
 
         // Apply Householder transformation to Q
-        Q.block(0, k, n, n - k) -= 2 * Q.block(0, k, n, n - k) * v * v.transpose();
+        ParallelKernels::ApplyReflectorRight<T>(Q.block(0, k, n, n - k), v, product);
+    }
+}
+
+template <typename T>
+void QrMethodSolver<T>::TiledQrDecomposition(const Matrix<T> &A_iter, Matrix<T> &Q, Matrix<T> &R)
+{
+    R = A_iter;
+    TiledQrInPlace(R, Q);
+}
+
+template <typename T>
+void QrMethodSolver<T>::TiledQrInPlace(Matrix<T> &R, Matrix<T> &Q)
+{
+    int n = R.rows();
+    int b = tileSize;
+    // Operations of the unblocked algorithm (R: 4/3 n^3, Q: 2 n^3), R and Q read and written once
+    const double size = n;
+    RooflineRegion region("qr (tiled)", 10.0 / 3.0 * size * size * size, sizeof(T) * 4 * size * size);
+    int tiles = (n + b - 1) / b; // Number of tiles per dimension (the last ones may be smaller)
+
+    // Reflectors and buffer of the products with Q, taken from the workspace
+    if (this->workspace.GetSize() != n)
+        this->workspace.SetSize(n);
+    Matrix<T> &V = this->workspace.GetMatrix(TILE_REFLECTORS, n, n);
+    Vector<T> &product = this->workspace.GetVector(REFLECTOR_PRODUCT);
+
+    if (tiledGraph != nullptr && tiledGraph->tiling.n == n && tiledGraph->tiling.b == b)
+    {
+        // Same sizes: the tasks of the last decomposition are executed again
+        tiledGraph->R = &R;
+        tiledGraph->reflectors = &V;
+        tiledGraph->group.Rerun();
+    }
+    else
+    {
+        tiledGraph = std::make_unique<TiledGraph>();
+        TiledGraph *graph = tiledGraph.get();
+        graph->tiling = {n, b};
+        graph->R = &R;
+        graph->reflectors = &V;
+
+        // Last task writing each tile, to build the dependencies of the next tasks
+        std::vector<TaskGroup::TaskId> lastWriter(tiles * tiles, -1);
+        auto dependencies = [&](std::initializer_list<TaskGroup::TaskId> ids)
+        {
+            std::vector<TaskGroup::TaskId> result;
+            for (TaskGroup::TaskId id : ids)
+            {
+                if (id >= 0)
+                    result.push_back(id);
+            }
+            return result;
+        };
+
+        TaskGroup &group = graph->group;
+        for (int k = 0; k < tiles; ++k)
+        {
+            // GEQRT: QR of the diagonal tile, R is stored in the tile
+            TaskGroup::TaskId geqrt = group.Add([graph, k]()
+                                                { FactorDiagonalTile(*graph->R, *graph->reflectors, graph->tiling, k); },
+                                                dependencies({lastWriter[k * tiles + k]}));
+            lastWriter[k * tiles + k] = geqrt;
+
+            // UNMQR: apply the reflectors of the diagonal tile to the tiles on its right
+            for (int j = k + 1; j < tiles; ++j)
+            {
+                lastWriter[k * tiles + j] = group.Add([graph, k, j]()
+                                                      { UpdateRowTile(*graph->R, *graph->reflectors, graph->tiling, k, j); },
+                                                      dependencies({geqrt, lastWriter[k * tiles + j]}));
+            }
+
+            for (int i = k + 1; i < tiles; ++i)
+            {
+                // TSQRT: QR of the triangular diagonal tile stacked on the tile below it, which is eliminated
+                TaskGroup::TaskId tsqrt = group.Add([graph, i, k]()
+                                                    { FactorStackedTiles(*graph->R, *graph->reflectors, graph->tiling, i, k); },
+                                                    dependencies({lastWriter[k * tiles + k], lastWriter[i * tiles + k]}));
+                lastWriter[k * tiles + k] = tsqrt;
+                lastWriter[i * tiles + k] = tsqrt;
+
+                // TSMQR: apply the same reflectors to the corresponding pairs of tiles on the right
+                for (int j = k + 1; j < tiles; ++j)
+                {
+                    TaskGroup::TaskId tsmqr = group.Add([graph, i, j, k]()
+                                                        { UpdateStackedTiles(*graph->R, *graph->reflectors, graph->tiling, i, j, k); },
+                                                        dependencies({tsqrt, lastWriter[k * tiles + j], lastWriter[i * tiles + j]}));
+                    lastWriter[k * tiles + j] = tsmqr;
+                    lastWriter[i * tiles + j] = tsmqr;
+                }
+            }
+        }
     }
+    tiledGraph->group.Wait();
+
+    // Form Q by applying the reflectors to the identity from the right, in the order of the factorization.
+    // Each row of Q is transformed independently, so the blocks of rows are distributed among the workers.
+    Q.setIdentity(n, n);
+    const Tiling tiling{n, b};
+    TaskScheduler::Instance().ParallelFor(0, tiles, 1, [&](int firstTile, int lastTile)
+                                          {
+        int rowStart = tiling.Start(firstTile);
+        int rows = std::min(n, tiling.Start(lastTile)) - rowStart;
+        ApplyReflectorsRight(Q, V, tiling, rowStart, rows, product.data() + rowStart); });
+}
+
+template <typename T>
+void QrMethodSolver<T>::SetTileSize(int size)
+{
+    if (size <= 0)
+        throw std::invalid_argument("The tile size must be positive (" + std::to_string(size) + ")");
+    tileSize = size;
 }
 
 template <typename T>
 Vector<T> QrMethodSolver<T>::FindEigenvalues()
 {
+    TraceSpan span("qr method", "solver");
 
     // Get parameters from parent abstract class
-    double tolerance = this->GetTolerance();
     int maxIter = this->GetMaxIter();
-    double error = tolerance + 1.0;
     int iterCount = 0;
+    this->report = SolverReport();
+    this->monitor.Reset();
 
     // Retrieve pointer to matrix
     MatrixPointer<T> A_ptr = this->GetMatrix();
-    Matrix<T> A_iter = *A_ptr;
-    int n = A_iter.rows();
+    int n = A_ptr->rows();
 
-    // Initialize Q and R
-    Matrix<T> Q(n, n);
-    Matrix<T> R(n, n);
+    // The iterate and its factors live in the workspace, reused by successive solves.
+    // When the solver owns the matrix, the matrix itself is the iterate and also holds R.
+    const bool inPlace = this->OwnsMatrix();
+    Matrix<T> &Q = this->workspace.GetMatrix(FACTOR_Q, n, n);
+    Matrix<T> &A_iter = inPlace ? *A_ptr : this->workspace.GetMatrix(ITERATE, n, n);
+    Matrix<T> *R = inPlace ? nullptr : &this->workspace.GetMatrix(FACTOR_R, n, n);
+    if (!inPlace)
+        A_iter = *A_ptr;
 
-    while (error > tolerance && iterCount < maxIter)
+    // A warm start transforms the matrix with an orthonormal basis Z: A_0 = Z^T A Z has the same eigenvalues,
+    // and is nearly triangular when Z holds the Schur vectors of a nearby matrix. Z then accumulates the
+    // factors Q of the iterations when the Schur vectors are exported (A = Z A_k Z^T).
+    const bool exportVectors = this->ExportsVectors();
+    Matrix<T> *Z = (this->HasWarmStart() || exportVectors) ? &this->workspace.GetMatrix(SCHUR_VECTORS, n, n) : nullptr;
+    if (this->HasWarmStart())
     {
-        // Perform QR decomposition
-        QrDecomposition(A_iter, Q, R);
+        const Matrix<T> &V = this->WarmStartVectors(n);
+        if (V.cols() != n)
+            throw std::invalid_argument("The warm start of the QR method needs " + std::to_string(n) + " vectors (" +
+                                        std::to_string(V.cols()) + " given)");
+        // Orthonormalize the vectors (they are only orthonormal up to the precision of the file)
+        *Z = Eigen::HouseholderQR<Matrix<T>>(V).householderQ();
+        Q.noalias() = Z->transpose() * A_iter;
+        ParallelKernels::MatMul(Q, *Z, A_iter);
+        this->report.warmStarted = true;
+    }
+    else if (exportVectors)
+        Z->setIdentity();
 
-        // Compute next iterate
-        A_iter = R * Q;
+    // The QR iterations preserve the Hessenberg form (and the tridiagonal form of symmetric matrices):
+    // only the subdiagonal can then differ from zero below the diagonal
+    const bool hessenberg = ConvergenceMonitor<T>::IsHessenberg(A_iter);
 
-        // Compute the error as the sum of the absolute below-diagonal elements
-        error = 0.0;
-        for (int i = 1; i < A_iter.rows(); ++i)
+    while (!this->monitor.Converged() && iterCount < maxIter)
+    {
+        // Perform QR decomposition, and compute next iterate
+        if (inPlace)
         {
-            for (int j = 0; j < i; ++j)
-            { // Below-diagonal entries
-                error += std::abs(A_iter(i, j));
-            }
+            QrDecompositionInPlace(A_iter, Q);
+            TraceSpan productSpan("rq product", "solver");
+            CounterRegion productRegion("rq product");
+            ParallelKernels::MatMulInPlace(A_iter, Q);
+        }
+        else
+        {
+            QrDecomposition(A_iter, Q, *R);
+            TraceSpan productSpan("rq product", "solver");
+            CounterRegion productRegion("rq product");
+            ParallelKernels::MatMul(*R, Q, A_iter);
+        }
+        if (exportVectors)
+        {
+            TraceSpan schurSpan("schur vectors", "solver");
+            ParallelKernels::MatMulInPlace(*Z, Q);
         }
 
         // Increment iteration count
         ++iterCount;
+
+        // Compute the error as the sum of the absolute below-diagonal elements, every few iterations
+        if (this->monitor.IsCheckDue(iterCount) || iterCount == maxIter)
+            this->monitor.CheckLowerPart(A_iter, hessenberg);
+        this->monitor.Record(iterCount, A_iter(0, 0)); // The first diagonal entry converges to the largest eigenvalue
     }
     if (iterCount >= maxIter)
     {
@@ -82,8 +456,15 @@ Vector<T> QrMethodSolver<T>::FindEigenvalues()
                   << "          Consider using a higher number for the maximum number of iterations."
                   << std::endl;
     }
+    this->report.iterations = iterCount;
+    this->report.converged = this->monitor.Converged();
+    this->RecordConvergence(hessenberg ? "subdiagonal" : "lower_part");
     std::cout << "Total number of iterations: " << iterCount << std::endl;
-    return A_iter.diagonal();
+    Vector<T> eigenvalues = A_iter.diagonal();
+    this->RecordResult(eigenvalues, exportVectors ? *Z : Matrix<T>());
+    if (inPlace)
+        this->ReleaseMatrix();
+    return eigenvalues;
 }
 
 // Explicit instantiation
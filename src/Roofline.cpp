@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "ParallelKernels.hpp"
+#include "Roofline.hpp"
+#include "SimdKernels.hpp"
+#include "TaskScheduler.hpp"
+
+namespace
+{
+    // Bytes of each array of the triad: well above the last-level caches
+    const long TRIAD_ARRAY_BYTES = 32L << 20;
+    // Multiply-adds of each chain of the arithmetic peak, on each thread
+    const long FMA_ITERATIONS = 1L << 24;
+    // The peaks are the best of these numbers of runs
+    const int TRIAD_RUNS = 5;
+    const int FMA_RUNS = 3;
+
+    // Runs a function on each thread of the scheduler (one part each) and returns the wall time
+    template <typename F>
+    double TimeParts(int threads, F &&body)
+    {
+        auto start = std::chrono::steady_clock::now();
+        TaskScheduler::Instance().ParallelForParts(threads, body);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Formats a value with a fixed number of decimals
+    std::string Fixed(double value, int decimals)
+    {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(decimals) << value;
+        return text.str();
+    }
+}
+
+Roofline &Roofline::Instance()
+{
+    static Roofline roofline;
+    return roofline;
+}
+
+void Roofline::Add(const char *name, double flops, double bytes, double seconds)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Kernel &kernel = kernels[name];
+    ++kernel.calls;
+    kernel.seconds += seconds;
+    kernel.flops += flops;
+    kernel.bytes += bytes;
+}
+
+std::map<std::string, Roofline::Kernel> Roofline::GetKernels() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return kernels;
+}
+
+void Roofline::Reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    kernels.clear();
+}
+
+template <typename T>
+Roofline::Peak Roofline::MeasurePeak()
+{
+    Peak peak;
+    peak.threads = ParallelKernels::GetNumThreads();
+    const int threads = peak.threads;
+
+    // Arithmetic peak: independent chains of multiply-adds in the registers of each thread
+    std::vector<T> results(threads);
+    std::vector<long> flops(threads);
+    for (int run = 0; run < FMA_RUNS; ++run)
+    {
+        double seconds = TimeParts(threads, [&](int part)
+                                   { flops[part] = SimdKernels::FmaLoop<T>(T(0.999), T(1e-3), FMA_ITERATIONS, results[part]); });
+        double total = 0.0;
+        for (long partFlops : flops)
+            total += static_cast<double>(partFlops);
+        peak.flops = std::max(peak.flops, total / seconds);
+    }
+
+    // Memory bandwidth: triad a = b + s c, the arrays initialized by the threads that use them (first touch)
+    const int n = static_cast<int>(TRIAD_ARRAY_BYTES / static_cast<long>(sizeof(T)));
+    std::unique_ptr<T[]> a(new T[n]); // Not initialized here: the pages are mapped at the first touch
+    std::unique_ptr<T[]> b(new T[n]);
+    std::unique_ptr<T[]> c(new T[n]);
+    const int align = ParallelKernels::RowAlignment<T>(n);
+    auto forPart = [&](int part, auto &&body)
+    {
+        int begin, end;
+        ParallelKernels::Partition(n, threads, align, part, begin, end);
+        for (int i = begin; i < end; ++i)
+            body(i);
+    };
+    TimeParts(threads, [&](int part)
+              { forPart(part, [&](int i)
+                        { a[i] = T(0); b[i] = T(1); c[i] = T(2); }); });
+    const T scalar = T(3);
+    for (int run = 0; run < TRIAD_RUNS; ++run)
+    {
+        double seconds = TimeParts(threads, [&](int part)
+                                   { forPart(part, [&](int i)
+                                             { a[i] = b[i] + scalar * c[i]; }); });
+        peak.bandwidth = std::max(peak.bandwidth, 3.0 * TRIAD_ARRAY_BYTES / seconds);
+    }
+    return peak;
+}
+
+void Roofline::PrintReport(const Peak &peak) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const double ridge = peak.bandwidth > 0 ? peak.flops / peak.bandwidth : 0.0;
+    std::cout << "==== ROOFLINE REPORT ====" << std::endl;
+    std::cout << "Peak (" << peak.threads << " threads, " << SimdKernels::IsaName(SimdKernels::GetIsa()) << "): "
+              << Fixed(peak.flops * 1e-9, 2) << " GFLOP/s (multiply-adds), " << Fixed(peak.bandwidth * 1e-9, 2)
+              << " GB/s (triad), ridge point " << Fixed(ridge, 2) << " flop/B" << std::endl;
+    std::cout << std::left << std::setw(24) << "Kernel" << std::right << std::setw(8) << "Calls" << std::setw(12) << "Time (ms)"
+              << std::setw(10) << "GFLOP" << std::setw(10) << "GB" << std::setw(10) << "GFLOP/s" << std::setw(10) << "GB/s"
+              << std::setw(10) << "Flop/B" << std::setw(9) << "Bound" << std::setw(11) << "% of roof" << std::endl;
+
+    auto printRow = [&](const std::string &name, const Kernel &kernel)
+    {
+        const double intensity = kernel.bytes > 0 ? kernel.flops / kernel.bytes : 0.0;
+        const double attainable = std::min(peak.flops, intensity * peak.bandwidth);
+        const double achieved = kernel.seconds > 0 ? kernel.flops / kernel.seconds : 0.0;
+        std::cout << std::left << std::setw(24) << name << std::right << std::setw(8) << kernel.calls << std::setw(12)
+                  << Fixed(kernel.seconds * 1e3, 3) << std::setw(10) << Fixed(kernel.flops * 1e-9, 3) << std::setw(10)
+                  << Fixed(kernel.bytes * 1e-9, 3) << std::setw(10) << Fixed(achieved * 1e-9, 2) << std::setw(10)
+                  << Fixed(kernel.seconds > 0 ? kernel.bytes / kernel.seconds * 1e-9 : 0.0, 2) << std::setw(10)
+                  << Fixed(intensity, 2) << std::setw(9) << (intensity < ridge ? "memory" : "compute") << std::setw(10)
+                  << Fixed(attainable > 0 ? 100.0 * achieved / attainable : 0.0, 1) << "%" << std::endl;
+    };
+    Kernel total;
+    for (const auto &[name, kernel] : kernels)
+    {
+        printRow(name, kernel);
+        total.calls += kernel.calls;
+        total.seconds += kernel.seconds;
+        total.flops += kernel.flops;
+        total.bytes += kernel.bytes;
+    }
+    if (kernels.size() > 1)
+        printRow("total", total);
+    std::cout << "(analytic counts: a multiply-add is 2 flops, each operand is read or written once from the memory)" << std::endl;
+}
+
+// Explicit instantiations
+template Roofline::Peak Roofline::MeasurePeak<float>();
+template Roofline::Peak Roofline::MeasurePeak<double>();
@@ -0,0 +1,705 @@
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+#include "SimdKernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define SIMD_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // Independent chains of the multiply-add loops: enough to hide the latency of the FMA units
+    // (about 4 cycles, 2 units per core)
+    const int FMA_CHAINS = 12;
+
+    // *******************************
+    // Portable scalar implementations
+    // *******************************
+
+    namespace scalar
+    {
+        template <typename T>
+        T Dot(const T *x, const T *y, int n)
+        {
+            T sum = 0;
+            for (int i = 0; i < n; ++i)
+                sum += x[i] * y[i];
+            return sum;
+        }
+
+        template <typename T>
+        void Axpy(T alpha, const T *x, T *y, int n)
+        {
+            for (int i = 0; i < n; ++i)
+                y[i] += alpha * x[i];
+        }
+
+        template <typename T>
+        void Scale(T alpha, T *x, int n)
+        {
+            for (int i = 0; i < n; ++i)
+                x[i] *= alpha;
+        }
+
+        template <typename T>
+        T AbsSum(const T *x, int n)
+        {
+            T sum = 0;
+            for (int i = 0; i < n; ++i)
+                sum += std::abs(x[i]);
+            return sum;
+        }
+
+        template <typename T>
+        long FmaLoop(T a, T b, long iterations, T &result)
+        {
+            T x[FMA_CHAINS] = {};
+            for (long i = 0; i < iterations; ++i)
+                for (int k = 0; k < FMA_CHAINS; ++k)
+                    x[k] = a * x[k] + b;
+            result = 0;
+            for (int k = 0; k < FMA_CHAINS; ++k)
+                result += x[k];
+            return 2L * FMA_CHAINS * iterations;
+        }
+    }
+
+#ifdef SIMD_KERNELS_X86
+    // *****************************************************************
+    // AVX2 + FMA: 4 doubles or 8 floats per register, two accumulators
+    // *****************************************************************
+
+    namespace avx2
+    {
+        __attribute__((target("avx2,fma"))) inline double HorizontalSum(__m256d v)
+        {
+            __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+            return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+        }
+
+        __attribute__((target("avx2,fma"))) inline float HorizontalSum(__m256 v)
+        {
+            __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            return _mm_cvtss_f32(_mm_add_ss(sum, _mm_movehdup_ps(sum)));
+        }
+
+        __attribute__((target("avx2,fma"))) double Dot(const double *x, const double *y, int n)
+        {
+            __m256d sum0 = _mm256_setzero_pd();
+            __m256d sum1 = _mm256_setzero_pd();
+            int i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+                sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), sum1);
+            }
+            double sum = HorizontalSum(_mm256_add_pd(sum0, sum1));
+            for (; i < n; ++i)
+                sum += x[i] * y[i];
+            return sum;
+        }
+
+        __attribute__((target("avx2,fma"))) float Dot(const float *x, const float *y, int n)
+        {
+            __m256 sum0 = _mm256_setzero_ps();
+            __m256 sum1 = _mm256_setzero_ps();
+            int i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+                sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), sum1);
+            }
+            float sum = HorizontalSum(_mm256_add_ps(sum0, sum1));
+            for (; i < n; ++i)
+                sum += x[i] * y[i];
+            return sum;
+        }
+
+        __attribute__((target("avx2,fma"))) void Axpy(double alpha, const double *x, double *y, int n)
+        {
+            const __m256d a = _mm256_set1_pd(alpha);
+            int i = 0;
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+            for (; i < n; ++i)
+                y[i] += alpha * x[i];
+        }
+
+        __attribute__((target("avx2,fma"))) void Axpy(float alpha, const float *x, float *y, int n)
+        {
+            const __m256 a = _mm256_set1_ps(alpha);
+            int i = 0;
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(y + i, _mm256_fmadd_ps(a, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+            for (; i < n; ++i)
+                y[i] += alpha * x[i];
+        }
+
+        __attribute__((target("avx2,fma"))) void Scale(double alpha, double *x, int n)
+        {
+            const __m256d a = _mm256_set1_pd(alpha);
+            int i = 0;
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(x + i, _mm256_mul_pd(a, _mm256_loadu_pd(x + i)));
+            for (; i < n; ++i)
+                x[i] *= alpha;
+        }
+
+        __attribute__((target("avx2,fma"))) void Scale(float alpha, float *x, int n)
+        {
+            const __m256 a = _mm256_set1_ps(alpha);
+            int i = 0;
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(x + i, _mm256_mul_ps(a, _mm256_loadu_ps(x + i)));
+            for (; i < n; ++i)
+                x[i] *= alpha;
+        }
+
+        __attribute__((target("avx2,fma"))) double AbsSum(const double *x, int n)
+        {
+            // The absolute value clears the sign bit
+            const __m256d signMask = _mm256_set1_pd(-0.0);
+            __m256d sum0 = _mm256_setzero_pd();
+            __m256d sum1 = _mm256_setzero_pd();
+            int i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                sum0 = _mm256_add_pd(sum0, _mm256_andnot_pd(signMask, _mm256_loadu_pd(x + i)));
+                sum1 = _mm256_add_pd(sum1, _mm256_andnot_pd(signMask, _mm256_loadu_pd(x + i + 4)));
+            }
+            double sum = HorizontalSum(_mm256_add_pd(sum0, sum1));
+            for (; i < n; ++i)
+                sum += std::abs(x[i]);
+            return sum;
+        }
+
+        __attribute__((target("avx2,fma"))) float AbsSum(const float *x, int n)
+        {
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+            __m256 sum0 = _mm256_setzero_ps();
+            __m256 sum1 = _mm256_setzero_ps();
+            int i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                sum0 = _mm256_add_ps(sum0, _mm256_andnot_ps(signMask, _mm256_loadu_ps(x + i)));
+                sum1 = _mm256_add_ps(sum1, _mm256_andnot_ps(signMask, _mm256_loadu_ps(x + i + 8)));
+            }
+            float sum = HorizontalSum(_mm256_add_ps(sum0, sum1));
+            for (; i < n; ++i)
+                sum += std::abs(x[i]);
+            return sum;
+        }
+        __attribute__((target("avx2,fma"))) long FmaLoop(double a, double b, long iterations, double &result)
+        {
+            const __m256d va = _mm256_set1_pd(a);
+            const __m256d vb = _mm256_set1_pd(b);
+            __m256d x[FMA_CHAINS];
+            for (int k = 0; k < FMA_CHAINS; ++k)
+                x[k] = _mm256_setzero_pd();
+            for (long i = 0; i < iterations; ++i)
+                for (int k = 0; k < FMA_CHAINS; ++k)
+                    x[k] = _mm256_fmadd_pd(va, x[k], vb);
+            for (int k = 1; k < FMA_CHAINS; ++k)
+                x[0] = _mm256_add_pd(x[0], x[k]);
+            result = HorizontalSum(x[0]);
+            return 2L * 4 * FMA_CHAINS * iterations;
+        }
+
+        __attribute__((target("avx2,fma"))) long FmaLoop(float a, float b, long iterations, float &result)
+        {
+            const __m256 va = _mm256_set1_ps(a);
+            const __m256 vb = _mm256_set1_ps(b);
+            __m256 x[FMA_CHAINS];
+            for (int k = 0; k < FMA_CHAINS; ++k)
+                x[k] = _mm256_setzero_ps();
+            for (long i = 0; i < iterations; ++i)
+                for (int k = 0; k < FMA_CHAINS; ++k)
+                    x[k] = _mm256_fmadd_ps(va, x[k], vb);
+            for (int k = 1; k < FMA_CHAINS; ++k)
+                x[0] = _mm256_add_ps(x[0], x[k]);
+            result = HorizontalSum(x[0]);
+            return 2L * 8 * FMA_CHAINS * iterations;
+        }
+    }
+
+    // *******************************************************************************
+    // AVX-512: 8 doubles or 16 floats per register, the last entries with a mask load
+    // *******************************************************************************
+
+    namespace avx512
+    {
+        __attribute__((target("avx512f"))) double Dot(const double *x, const double *y, int n)
+        {
+            __m512d sum0 = _mm512_setzero_pd();
+            __m512d sum1 = _mm512_setzero_pd();
+            int i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), sum0);
+                sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), sum1);
+            }
+            for (; i < n; i += 8)
+            {
+                const __mmask8 mask = n - i >= 8 ? 0xFF : static_cast<__mmask8>((1u << (n - i)) - 1);
+                sum0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i), sum0);
+            }
+            return _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+        }
+
+        __attribute__((target("avx512f"))) float Dot(const float *x, const float *y, int n)
+        {
+            __m512 sum0 = _mm512_setzero_ps();
+            __m512 sum1 = _mm512_setzero_ps();
+            int i = 0;
+            for (; i + 32 <= n; i += 32)
+            {
+                sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum0);
+                sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16), sum1);
+            }
+            for (; i < n; i += 16)
+            {
+                const __mmask16 mask = n - i >= 16 ? 0xFFFF : static_cast<__mmask16>((1u << (n - i)) - 1);
+                sum0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i), sum0);
+            }
+            return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+        }
+
+        __attribute__((target("avx512f"))) void Axpy(double alpha, const double *x, double *y, int n)
+        {
+            const __m512d a = _mm512_set1_pd(alpha);
+            for (int i = 0; i < n; i += 8)
+            {
+                const __mmask8 mask = n - i >= 8 ? 0xFF : static_cast<__mmask8>((1u << (n - i)) - 1);
+                __m512d result = _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+                _mm512_mask_storeu_pd(y + i, mask, result);
+            }
+        }
+
+        __attribute__((target("avx512f"))) void Axpy(float alpha, const float *x, float *y, int n)
+        {
+            const __m512 a = _mm512_set1_ps(alpha);
+            for (int i = 0; i < n; i += 16)
+            {
+                const __mmask16 mask = n - i >= 16 ? 0xFFFF : static_cast<__mmask16>((1u << (n - i)) - 1);
+                __m512 result = _mm512_fmadd_ps(a, _mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i));
+                _mm512_mask_storeu_ps(y + i, mask, result);
+            }
+        }
+
+        __attribute__((target("avx512f"))) void Scale(double alpha, double *x, int n)
+        {
+            const __m512d a = _mm512_set1_pd(alpha);
+            for (int i = 0; i < n; i += 8)
+            {
+                const __mmask8 mask = n - i >= 8 ? 0xFF : static_cast<__mmask8>((1u << (n - i)) - 1);
+                _mm512_mask_storeu_pd(x + i, mask, _mm512_mul_pd(a, _mm512_maskz_loadu_pd(mask, x + i)));
+            }
+        }
+
+        __attribute__((target("avx512f"))) void Scale(float alpha, float *x, int n)
+        {
+            const __m512 a = _mm512_set1_ps(alpha);
+            for (int i = 0; i < n; i += 16)
+            {
+                const __mmask16 mask = n - i >= 16 ? 0xFFFF : static_cast<__mmask16>((1u << (n - i)) - 1);
+                _mm512_mask_storeu_ps(x + i, mask, _mm512_mul_ps(a, _mm512_maskz_loadu_ps(mask, x + i)));
+            }
+        }
+
+        __attribute__((target("avx512f"))) double AbsSum(const double *x, int n)
+        {
+            __m512d sum0 = _mm512_setzero_pd();
+            __m512d sum1 = _mm512_setzero_pd();
+            int i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                sum0 = _mm512_add_pd(sum0, _mm512_abs_pd(_mm512_loadu_pd(x + i)));
+                sum1 = _mm512_add_pd(sum1, _mm512_abs_pd(_mm512_loadu_pd(x + i + 8)));
+            }
+            for (; i < n; i += 8)
+            {
+                const __mmask8 mask = n - i >= 8 ? 0xFF : static_cast<__mmask8>((1u << (n - i)) - 1);
+                sum0 = _mm512_add_pd(sum0, _mm512_abs_pd(_mm512_maskz_loadu_pd(mask, x + i)));
+            }
+            return _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+        }
+
+        __attribute__((target("avx512f"))) float AbsSum(const float *x, int n)
+        {
+            __m512 sum0 = _mm512_setzero_ps();
+            __m512 sum1 = _mm512_setzero_ps();
+            int i = 0;
+            for (; i + 32 <= n; i += 32)
+            {
+                sum0 = _mm512_add_ps(sum0, _mm512_abs_ps(_mm512_loadu_ps(x + i)));
+                sum1 = _mm512_add_ps(sum1, _mm512_abs_ps(_mm512_loadu_ps(x + i + 16)));
+            }
+            for (; i < n; i += 16)
+            {
+                const __mmask16 mask = n - i >= 16 ? 0xFFFF : static_cast<__mmask16>((1u << (n - i)) - 1);
+                sum0 = _mm512_add_ps(sum0, _mm512_abs_ps(_mm512_maskz_loadu_ps(mask, x + i)));
+            }
+            return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+        }
+
+        __attribute__((target("avx512f"))) long FmaLoop(double a, double b, long iterations, double &result)
+        {
+            const __m512d va = _mm512_set1_pd(a);
+            const __m512d vb = _mm512_set1_pd(b);
+            __m512d x[FMA_CHAINS];
+            for (int k = 0; k < FMA_CHAINS; ++k)
+                x[k] = _mm512_setzero_pd();
+            for (long i = 0; i < iterations; ++i)
+                for (int k = 0; k < FMA_CHAINS; ++k)
+                    x[k] = _mm512_fmadd_pd(va, x[k], vb);
+            for (int k = 1; k < FMA_CHAINS; ++k)
+                x[0] = _mm512_add_pd(x[0], x[k]);
+            result = _mm512_reduce_add_pd(x[0]);
+            return 2L * 8 * FMA_CHAINS * iterations;
+        }
+
+        __attribute__((target("avx512f"))) long FmaLoop(float a, float b, long iterations, float &result)
+        {
+            const __m512 va = _mm512_set1_ps(a);
+            const __m512 vb = _mm512_set1_ps(b);
+            __m512 x[FMA_CHAINS];
+            for (int k = 0; k < FMA_CHAINS; ++k)
+                x[k] = _mm512_setzero_ps();
+            for (long i = 0; i < iterations; ++i)
+                for (int k = 0; k < FMA_CHAINS; ++k)
+                    x[k] = _mm512_fmadd_ps(va, x[k], vb);
+            for (int k = 1; k < FMA_CHAINS; ++k)
+                x[0] = _mm512_add_ps(x[0], x[k]);
+            result = _mm512_reduce_add_ps(x[0]);
+            return 2L * 16 * FMA_CHAINS * iterations;
+        }
+    }
+#endif
+
+#ifdef SIMD_KERNELS_NEON
+    // ***************************************************************************
+    // NEON (always available on ARM64): 2 doubles or 4 floats per register
+    // ***************************************************************************
+
+    namespace neon
+    {
+        double Dot(const double *x, const double *y, int n)
+        {
+            float64x2_t sum0 = vdupq_n_f64(0.0);
+            float64x2_t sum1 = vdupq_n_f64(0.0);
+            int i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                sum0 = vfmaq_f64(sum0, vld1q_f64(x + i), vld1q_f64(y + i));
+                sum1 = vfmaq_f64(sum1, vld1q_f64(x + i + 2), vld1q_f64(y + i + 2));
+            }
+            double sum = vaddvq_f64(vaddq_f64(sum0, sum1));
+            for (; i < n; ++i)
+                sum += x[i] * y[i];
+            return sum;
+        }
+
+        float Dot(const float *x, const float *y, int n)
+        {
+            float32x4_t sum0 = vdupq_n_f32(0.0f);
+            float32x4_t sum1 = vdupq_n_f32(0.0f);
+            int i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                sum0 = vfmaq_f32(sum0, vld1q_f32(x + i), vld1q_f32(y + i));
+                sum1 = vfmaq_f32(sum1, vld1q_f32(x + i + 4), vld1q_f32(y + i + 4));
+            }
+            float sum = vaddvq_f32(vaddq_f32(sum0, sum1));
+            for (; i < n; ++i)
+                sum += x[i] * y[i];
+            return sum;
+        }
+
+        void Axpy(double alpha, const double *x, double *y, int n)
+        {
+            int i = 0;
+            for (; i + 2 <= n; i += 2)
+                vst1q_f64(y + i, vfmaq_n_f64(vld1q_f64(y + i), vld1q_f64(x + i), alpha));
+            for (; i < n; ++i)
+                y[i] += alpha * x[i];
+        }
+
+        void Axpy(float alpha, const float *x, float *y, int n)
+        {
+            int i = 0;
+            for (; i + 4 <= n; i += 4)
+                vst1q_f32(y + i, vfmaq_n_f32(vld1q_f32(y + i), vld1q_f32(x + i), alpha));
+            for (; i < n; ++i)
+                y[i] += alpha * x[i];
+        }
+
+        void Scale(double alpha, double *x, int n)
+        {
+            int i = 0;
+            for (; i + 2 <= n; i += 2)
+                vst1q_f64(x + i, vmulq_n_f64(vld1q_f64(x + i), alpha));
+            for (; i < n; ++i)
+                x[i] *= alpha;
+        }
+
+        void Scale(float alpha, float *x, int n)
+        {
+            int i = 0;
+            for (; i + 4 <= n; i += 4)
+                vst1q_f32(x + i, vmulq_n_f32(vld1q_f32(x + i), alpha));
+            for (; i < n; ++i)
+                x[i] *= alpha;
+        }
+
+        double AbsSum(const double *x, int n)
+        {
+            float64x2_t sum0 = vdupq_n_f64(0.0);
+            float64x2_t sum1 = vdupq_n_f64(0.0);
+            int i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                sum0 = vaddq_f64(sum0, vabsq_f64(vld1q_f64(x + i)));
+                sum1 = vaddq_f64(sum1, vabsq_f64(vld1q_f64(x + i + 2)));
+            }
+            double sum = vaddvq_f64(vaddq_f64(sum0, sum1));
+            for (; i < n; ++i)
+                sum += std::abs(x[i]);
+            return sum;
+        }
+
+        float AbsSum(const float *x, int n)
+        {
+            float32x4_t sum0 = vdupq_n_f32(0.0f);
+            float32x4_t sum1 = vdupq_n_f32(0.0f);
+            int i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                sum0 = vaddq_f32(sum0, vabsq_f32(vld1q_f32(x + i)));
+                sum1 = vaddq_f32(sum1, vabsq_f32(vld1q_f32(x + i + 4)));
+            }
+            float sum = vaddvq_f32(vaddq_f32(sum0, sum1));
+            for (; i < n; ++i)
+                sum += std::abs(x[i]);
+            return sum;
+        }
+
+        long FmaLoop(double a, double b, long iterations, double &result)
+        {
+            const float64x2_t va = vdupq_n_f64(a);
+            const float64x2_t vb = vdupq_n_f64(b);
+            float64x2_t x[FMA_CHAINS];
+            for (int k = 0; k < FMA_CHAINS; ++k)
+                x[k] = vdupq_n_f64(0.0);
+            for (long i = 0; i < iterations; ++i)
+                for (int k = 0; k < FMA_CHAINS; ++k)
+                    x[k] = vfmaq_f64(vb, va, x[k]);
+            for (int k = 1; k < FMA_CHAINS; ++k)
+                x[0] = vaddq_f64(x[0], x[k]);
+            result = vaddvq_f64(x[0]);
+            return 2L * 2 * FMA_CHAINS * iterations;
+        }
+
+        long FmaLoop(float a, float b, long iterations, float &result)
+        {
+            const float32x4_t va = vdupq_n_f32(a);
+            const float32x4_t vb = vdupq_n_f32(b);
+            float32x4_t x[FMA_CHAINS];
+            for (int k = 0; k < FMA_CHAINS; ++k)
+                x[k] = vdupq_n_f32(0.0f);
+            for (long i = 0; i < iterations; ++i)
+                for (int k = 0; k < FMA_CHAINS; ++k)
+                    x[k] = vfmaq_f32(vb, va, x[k]);
+            for (int k = 1; k < FMA_CHAINS; ++k)
+                x[0] = vaddq_f32(x[0], x[k]);
+            result = vaddvq_f32(x[0]);
+            return 2L * 4 * FMA_CHAINS * iterations;
+        }
+    }
+#endif
+
+    // ********
+    // DISPATCH
+    // ********
+
+    // Kernels of an instruction set, for one data type
+    template <typename T>
+    struct KernelTable
+    {
+        T (*dot)(const T *, const T *, int);
+        void (*axpy)(T, const T *, T *, int);
+        void (*scale)(T, T *, int);
+        T (*absSum)(const T *, int);
+        long (*fmaLoop)(T, T, long, T &);
+    };
+
+    template <typename T>
+    const KernelTable<T> &Table(SimdKernels::Isa isa)
+    {
+        static const KernelTable<T> scalarTable = {scalar::Dot<T>, scalar::Axpy<T>, scalar::Scale<T>, scalar::AbsSum<T>, scalar::FmaLoop<T>};
+        switch (isa)
+        {
+#ifdef SIMD_KERNELS_X86
+        case SimdKernels::Isa::AVX2:
+        {
+            static const KernelTable<T> table = {avx2::Dot, avx2::Axpy, avx2::Scale, avx2::AbsSum, avx2::FmaLoop};
+            return table;
+        }
+        case SimdKernels::Isa::AVX512:
+        {
+            static const KernelTable<T> table = {avx512::Dot, avx512::Axpy, avx512::Scale, avx512::AbsSum, avx512::FmaLoop};
+            return table;
+        }
+#endif
+#ifdef SIMD_KERNELS_NEON
+        case SimdKernels::Isa::NEON:
+        {
+            static const KernelTable<T> table = {neon::Dot, neon::Axpy, neon::Scale, neon::AbsSum, neon::FmaLoop};
+            return table;
+        }
+#endif
+        default:
+            return scalarTable;
+        }
+    }
+
+    // Instruction set of the kernels, detected at the first call
+    std::atomic<SimdKernels::Isa> &CurrentIsa()
+    {
+        static std::atomic<SimdKernels::Isa> isa(SimdKernels::DetectIsa());
+        return isa;
+    }
+}
+
+namespace SimdKernels
+{
+    bool IsSupported(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::SCALAR:
+            return true;
+#ifdef SIMD_KERNELS_X86
+        case Isa::AVX2:
+            // The CPUID checks of the compiler also check that the OS saves the AVX registers
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case Isa::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+#ifdef SIMD_KERNELS_NEON
+        case Isa::NEON:
+            return true;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    Isa DetectIsa()
+    {
+        for (Isa isa : {Isa::AVX512, Isa::AVX2, Isa::NEON})
+        {
+            if (IsSupported(isa))
+                return isa;
+        }
+        return Isa::SCALAR;
+    }
+
+    std::vector<Isa> SupportedIsas()
+    {
+        std::vector<Isa> isas;
+        for (Isa isa : {Isa::SCALAR, Isa::AVX2, Isa::AVX512, Isa::NEON})
+        {
+            if (IsSupported(isa))
+                isas.push_back(isa);
+        }
+        return isas;
+    }
+
+    void SetIsa(Isa isa)
+    {
+        if (!IsSupported(isa))
+            throw std::invalid_argument("the instruction set " + IsaName(isa) + " is not supported by this processor");
+        CurrentIsa().store(isa);
+    }
+
+    Isa GetIsa()
+    {
+        return CurrentIsa().load(std::memory_order_relaxed);
+    }
+
+    std::string IsaName(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::AVX2:
+            return "avx2";
+        case Isa::AVX512:
+            return "avx512";
+        case Isa::NEON:
+            return "neon";
+        default:
+            return "scalar";
+        }
+    }
+
+    Isa IsaFromName(const std::string &name)
+    {
+        for (Isa isa : {Isa::SCALAR, Isa::AVX2, Isa::AVX512, Isa::NEON})
+        {
+            if (IsaName(isa) == name)
+                return isa;
+        }
+        throw std::invalid_argument("unknown instruction set (" + name + ")");
+    }
+
+    template <typename T>
+    T Dot(const T *x, const T *y, int n)
+    {
+        return Table<T>(GetIsa()).dot(x, y, n);
+    }
+
+    template <typename T>
+    void Axpy(T alpha, const T *x, T *y, int n)
+    {
+        Table<T>(GetIsa()).axpy(alpha, x, y, n);
+    }
+
+    template <typename T>
+    void Scale(T alpha, T *x, int n)
+    {
+        Table<T>(GetIsa()).scale(alpha, x, n);
+    }
+
+    template <typename T>
+    T AbsSum(const T *x, int n)
+    {
+        return Table<T>(GetIsa()).absSum(x, n);
+    }
+
+    template <typename T>
+    long FmaLoop(T a, T b, long iterations, T &result)
+    {
+        return Table<T>(GetIsa()).fmaLoop(a, b, iterations, result);
+    }
+
+    // Explicit instantiations
+    template float Dot<float>(const float *, const float *, int);
+    template double Dot<double>(const double *, const double *, int);
+    template void Axpy<float>(float, const float *, float *, int);
+    template void Axpy<double>(double, const double *, double *, int);
+    template void Scale<float>(float, float *, int);
+    template void Scale<double>(double, double *, int);
+    template float AbsSum<float>(const float *, int);
+    template double AbsSum<double>(const double *, int);
+    template long FmaLoop<float>(float, float, long, float &);
+    template long FmaLoop<double>(double, double, long, double &);
+}
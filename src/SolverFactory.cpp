@@ -2,17 +2,27 @@
 #include "PowerMethodSolver.hpp"
 #include "InversePowerMethodSolver.hpp"
 #include "QrMethodSolver.hpp"
+#include "LanczosSolver.hpp"
+#include "JacobiSolver.hpp"
+#include "FixedSizeSolver.hpp"
 
 template <typename T>
-std::unique_ptr<AbstractIterativeSolver<T>> SolverFactory<T>::ChooseSolver()
+std::unique_ptr<AbstractIterativeSolver<T>> SolverFactory<T>::ChooseSolver(int size)
 {
-    // Check validity of user input methodArgs
-    if (methodArgs.size() > 3)
+    // Check validity of user input methodArgs (the power method also accepts an acceleration mode,
+    // the inverse power method a factorization)
+    if (methodName == "power_method" && methodArgs.size() > 4)
+        throw std::invalid_argument("Expected maximum 4 arguments for the power method (tolerance, maximum iterations, shift and acceleration), but got " + std::to_string(methodArgs.size()));
+    if (methodName == "inverse_power_method" && methodArgs.size() > 4)
+        throw std::invalid_argument("Expected maximum 4 arguments for the inverse power method (tolerance, maximum iterations, shift and factorization), but got " + std::to_string(methodArgs.size()));
+    if (methodName != "power_method" && methodName != "inverse_power_method" && methodArgs.size() > 3)
         throw std::invalid_argument("Expected maximum 3 arguments for the solver (tolerance, maximum iterations and shift), but got " + std::to_string(methodArgs.size()));
     // Declare and initialize methodArgs with default values
     double tolerance = DefaultSolverArgs::TOLERANCE;
     int maxIter = DefaultSolverArgs::MAX_ITER;
     float shift = DefaultSolverArgs::SHIFT;
+    std::string acceleration = DefaultSolverArgs::ACCELERATION;
+    std::string factorization = DefaultSolverArgs::FACTORIZATION;
 
     // Check tolerance input, set tolerance = 1e-6 if no argument or invalue argument
     if (methodArgs.size() > 0)
@@ -65,25 +75,62 @@ std::unique_ptr<AbstractIterativeSolver<T>> SolverFactory<T>::ChooseSolver()
         }
     }
 
-    std::unique_ptr<AbstractIterativeSolver<T>> solver;
-    // Instantiate correct solver
-    if (methodName == "power_method")
-    {
-        solver = std::make_unique<PowerMethodSolver<T>>(tolerance, maxIter, shift);
-    }
-    else if (methodName == "inverse_power_method")
+    // Check acceleration input, set acceleration = none if no arguments or invalid argument
+    if (methodName == "power_method" && methodArgs.size() > 3)
     {
-        solver = std::make_unique<InversePowerMethodSolver<T>>(tolerance, maxIter, shift);
+        if (SupportedArguments::SUPPORTED_ACCELERATIONS.find(methodArgs[3]) != SupportedArguments::SUPPORTED_ACCELERATIONS.end())
+            acceleration = methodArgs[3];
+        else
+            std::cerr << "[WARNING] Error processing the argument 'acceleration' during solver initialization: unsupported mode " << methodArgs[3] << std::endl
+                      << "          Handling the issue by setting 'acceleration' to the default value (" << acceleration << ")"
+                      << std::endl;
     }
-    else if (methodName == "QR_method")
+
+    // Check factorization input, set factorization = full if no arguments or invalid argument
+    if (methodName == "inverse_power_method" && methodArgs.size() > 3)
     {
-        solver = std::make_unique<QrMethodSolver<T>>(tolerance, maxIter);
+        if (SupportedArguments::SUPPORTED_FACTORIZATIONS.find(methodArgs[3]) != SupportedArguments::SUPPORTED_FACTORIZATIONS.end())
+            factorization = methodArgs[3];
+        else
+            std::cerr << "[WARNING] Error processing the argument 'factorization' during solver initialization: unsupported factorization " << methodArgs[3] << std::endl
+                      << "          Handling the issue by setting 'factorization' to the default value (" << factorization << ")"
+                      << std::endl;
     }
-    else
+
+    std::unique_ptr<AbstractIterativeSolver<T>> solver;
+    // Instantiate correct solver: the small matrices get a solver of their size, if the method has one
+    if (size > 0 && (methodName != "power_method" || acceleration == "none"))
+        solver = CreateFixedSizeSolver<T>(methodName, size, tolerance, maxIter, shift);
+    if (!solver)
     {
-        throw std::runtime_error(methodName + " is a supported method but is not linked to a valid implementation.\n"
-                                              "Consider updating the SolverFactory to consider this method");
+        if (methodName == "power_method")
+        {
+            solver = std::make_unique<PowerMethodSolver<T>>(tolerance, maxIter, shift, acceleration);
+        }
+        else if (methodName == "inverse_power_method")
+        {
+            solver = std::make_unique<InversePowerMethodSolver<T>>(tolerance, maxIter, shift, factorization);
+        }
+        else if (methodName == "QR_method")
+        {
+            solver = std::make_unique<QrMethodSolver<T>>(tolerance, maxIter);
+        }
+        else if (methodName == "lanczos_method")
+        {
+            solver = std::make_unique<LanczosSolver<T>>(tolerance, maxIter);
+        }
+        else if (methodName == "jacobi_method")
+        {
+            solver = std::make_unique<JacobiSolver<T>>(tolerance, maxIter);
+        }
+        else
+        {
+            throw std::runtime_error(methodName + " is a supported method but is not linked to a valid implementation.\n"
+                                                  "Consider updating the SolverFactory to consider this method");
+        }
     }
+    solver->SetStoppingCriterion(stoppingCriterion);
+    solver->SetCheckInterval(checkInterval);
     return solver;
 }
 
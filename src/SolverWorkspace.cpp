@@ -0,0 +1,56 @@
+#include <stdexcept>
+
+#include "SolverWorkspace.hpp"
+
+template <typename T>
+void SolverWorkspace<T>::SetSize(int size)
+{
+    if (size < 0)
+        throw std::invalid_argument("The size of the workspace must be positive, but got " + std::to_string(size));
+    if (size == this->size)
+        return;
+    this->size = size;
+    for (auto &vector : vectors)
+    {
+        if (vector.size() == 0) // Slot not in use yet
+            continue;
+        vector.resize(size);
+        ++allocations;
+    }
+}
+
+template <typename T>
+Vector<T> &SolverWorkspace<T>::GetVector(int slot)
+{
+    if (slot < 0)
+        throw std::invalid_argument("Invalid workspace slot " + std::to_string(slot));
+    while (static_cast<int>(vectors.size()) <= slot)
+        vectors.emplace_back();
+    Vector<T> &vector = vectors[slot];
+    if (vector.size() != size)
+    {
+        vector.resize(size);
+        ++allocations;
+    }
+    return vector;
+}
+
+template <typename T>
+Matrix<T> &SolverWorkspace<T>::GetMatrix(int slot, int rows, int cols)
+{
+    if (slot < 0)
+        throw std::invalid_argument("Invalid workspace slot " + std::to_string(slot));
+    while (static_cast<int>(matrices.size()) <= slot)
+        matrices.emplace_back();
+    Matrix<T> &matrix = matrices[slot];
+    if (matrix.rows() != rows || matrix.cols() != cols)
+    {
+        matrix.resize(rows, cols);
+        ++allocations;
+    }
+    return matrix;
+}
+
+// Explicit instantiations
+template class SolverWorkspace<float>;
+template class SolverWorkspace<double>;
@@ -0,0 +1,506 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+
+#include "TaskScheduler.hpp"
+#include "Tracer.hpp"
+
+namespace
+{
+    thread_local int currentWorker = 0; // Index of the worker running on this thread (0 outside the pool)
+    thread_local int taskDepth = 0;     // Number of nested tasks running on this thread (to count busy time once)
+
+    // Number of chunks per worker in ParallelFor when no grain is given (for load balancing)
+    const int CHUNKS_PER_WORKER = 4;
+    // Initial capacity of the deques of tasks
+    const size_t MIN_DEQUE_CAPACITY = 64;
+
+    long NowNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+TaskScheduler &TaskScheduler::Instance()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler() : statsStart(NowNanoseconds())
+{
+    workers.push_back(std::make_unique<Worker>());
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    StopWorkers();
+}
+
+void TaskScheduler::SetNumWorkers(int count)
+{
+    if (count <= 0)
+        count = std::max(1u, std::thread::hardware_concurrency());
+    if (count == GetNumWorkers())
+        return;
+    StopWorkers();
+    StartWorkers(count);
+    ResetStats();
+}
+
+void TaskScheduler::StartWorkers(int count)
+{
+    workers.clear();
+    for (int i = 0; i < count; ++i)
+        workers.push_back(std::make_unique<Worker>());
+    stopping = false;
+    for (int i = 1; i < count; ++i)
+        threads.emplace_back(&TaskScheduler::WorkerLoop, this, i);
+}
+
+void TaskScheduler::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all();
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+}
+
+void TaskScheduler::WorkerLoop(int index)
+{
+    currentWorker = index;
+    Tracer::Instance().NameThread("worker " + std::to_string(index));
+    while (true)
+    {
+        if (RunPendingTask())
+            continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this, index]()
+                            { return stopping || pendingTasks > 0 || workers[index]->pinnedCount > 0; });
+        if (stopping)
+            return;
+    }
+}
+
+int TaskScheduler::CurrentWorker() const
+{
+    return currentWorker < GetNumWorkers() ? currentWorker : 0;
+}
+
+void TaskScheduler::Submit(Task task, const void *owner)
+{
+    Worker &worker = *workers[CurrentWorker()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.PushBack({std::move(task), owner});
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        ++pendingTasks;
+    }
+    sleepCondition.notify_one();
+}
+
+bool TaskScheduler::PopTask(int index, const void *owner, Task &task, bool &stolen)
+{
+    // First look at the tasks pinned to this worker, then at the own deque (most recent task, still in cache)
+    {
+        Worker &worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.pinnedTasks.PopFront(owner, task))
+        {
+            --worker.pinnedCount;
+            stolen = false;
+            return true;
+        }
+        if (worker.tasks.PopBack(owner, task))
+        {
+            --pendingTasks;
+            stolen = false;
+            return true;
+        }
+    }
+    // Then steal the oldest task of another worker
+    const int count = GetNumWorkers();
+    for (int offset = 1; offset < count; ++offset)
+    {
+        Worker &victim = *workers[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.PopFront(owner, task))
+        {
+            --pendingTasks;
+            stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::TaskDeque::PushBack(PendingTask &&task)
+{
+    if (count == buffer.size())
+    {
+        // Full: move the tasks, in order, to a buffer twice as large
+        std::vector<PendingTask> larger(std::max<size_t>(MIN_DEQUE_CAPACITY, 2 * buffer.size()));
+        for (size_t i = 0; i < count; ++i)
+            larger[i] = std::move(At(i));
+        buffer.swap(larger);
+        first = 0;
+    }
+    At(count++) = std::move(task);
+}
+
+bool TaskScheduler::TaskDeque::PopBack(const void *owner, Task &task)
+{
+    for (size_t i = count; i-- > 0;)
+    {
+        if (owner == nullptr || At(i).owner == owner)
+        {
+            task = std::move(At(i).task);
+            Remove(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::TaskDeque::PopFront(const void *owner, Task &task)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (owner == nullptr || At(i).owner == owner)
+        {
+            task = std::move(At(i).task);
+            Remove(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::TaskDeque::Remove(size_t index)
+{
+    // Close the gap from the nearest end (nothing to move for the first and the last tasks)
+    if (index < count / 2)
+    {
+        for (size_t i = index; i > 0; --i)
+            At(i) = std::move(At(i - 1));
+        At(0) = PendingTask();
+        first = (first + 1) % buffer.size();
+    }
+    else
+    {
+        for (size_t i = index; i + 1 < count; ++i)
+            At(i) = std::move(At(i + 1));
+        At(count - 1) = PendingTask();
+    }
+    --count;
+}
+
+bool TaskScheduler::RunPendingTask(const void *owner)
+{
+    const int index = CurrentWorker();
+    Task task;
+    bool stolen;
+    if ((pendingTasks == 0 && workers[index]->pinnedCount == 0) || !PopTask(index, owner, task, stolen))
+        return false;
+
+    Worker &worker = *workers[index];
+    long start = NowNanoseconds();
+    ++taskDepth;
+    try
+    {
+        task();
+    }
+    catch (...) // Tasks submitted directly have nobody to report to
+    {
+    }
+    --taskDepth;
+    worker.busyNanoseconds += NowNanoseconds() - start;
+    ++worker.tasksExecuted;
+    if (stolen)
+        ++worker.tasksStolen;
+    return true;
+}
+
+int TaskScheduler::ChunkSize(int size, int grain) const
+{
+    if (grain > 0)
+        return grain;
+    const int chunks = CHUNKS_PER_WORKER * GetNumWorkers();
+    return std::max(1, (size + chunks - 1) / chunks);
+}
+
+void TaskScheduler::ParallelForImpl(int begin, int end, int grain, const std::function<void(int, int)> &body)
+{
+    const int chunkSize = ChunkSize(end - begin, grain);
+    std::atomic<int> remaining((end - begin + chunkSize - 1) / chunkSize);
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+
+    auto runChunk = [&](int chunkBegin)
+    {
+        try
+        {
+            // Recorded before the chunk is counted as done, while the caller still waits for it
+            TraceSpan span("parallel chunk", "scheduler");
+            body(chunkBegin, std::min(end, chunkBegin + chunkSize));
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(exceptionMutex);
+            if (!exception)
+                exception = std::current_exception();
+        }
+        --remaining;
+    };
+
+    // Submit all chunks but the first one, which is executed by the calling thread. The chunks are
+    // tagged with the counter of this loop, the only tasks the calling thread executes while it waits.
+    for (int chunkBegin = begin + chunkSize; chunkBegin < end; chunkBegin += chunkSize)
+        Submit([&runChunk, chunkBegin]()
+               { runChunk(chunkBegin); }, &remaining);
+    Worker &worker = *workers[CurrentWorker()];
+    long start = NowNanoseconds();
+    runChunk(begin);
+    if (taskDepth == 0) // Otherwise the time is already counted for the enclosing task
+        worker.busyNanoseconds += NowNanoseconds() - start;
+    ++worker.tasksExecuted;
+
+    // Help with the pending chunks until all chunks are done
+    while (remaining > 0)
+    {
+        if (!RunPendingTask(&remaining))
+            std::this_thread::yield();
+    }
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void TaskScheduler::ParallelForPartsImpl(int parts, const std::function<void(int)> &body)
+{
+    // In a task, the other workers may be waiting for this one and would never start their parts: share them
+    if (taskDepth > 0)
+    {
+        ParallelForImpl(0, parts, 1, [&body](int firstPart, int lastPart)
+                        {
+                            for (int part = firstPart; part < lastPart; ++part)
+                                body(part); });
+        return;
+    }
+
+    const int count = GetNumWorkers();
+    const int self = CurrentWorker();
+    std::atomic<int> remaining(0);
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+
+    auto runPart = [&](int part)
+    {
+        try
+        {
+            TraceSpan span("parallel part", "scheduler");
+            body(part);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(exceptionMutex);
+            if (!exception)
+                exception = std::current_exception();
+        }
+        --remaining;
+    };
+
+    // Pin the parts of the other workers to their deques, then wake them up all at once
+    for (int part = 0; part < parts; ++part)
+    {
+        if (part % count == self)
+            continue;
+        Worker &worker = *workers[part % count];
+        ++remaining;
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.pinnedTasks.PushBack({[&runPart, part]()
+                                         { runPart(part); },
+                                         &remaining});
+        }
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        ++worker.pinnedCount;
+    }
+    sleepCondition.notify_all();
+
+    // The parts of this worker run on the calling thread
+    Worker &worker = *workers[self];
+    for (int part = self; part < parts; part += count)
+    {
+        long start = NowNanoseconds();
+        ++remaining;
+        runPart(part);
+        worker.busyNanoseconds += NowNanoseconds() - start;
+        ++worker.tasksExecuted;
+    }
+
+    // The other parts can only run on their workers: wait for them
+    while (remaining > 0)
+        std::this_thread::yield();
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+std::vector<TaskScheduler::WorkerStats> TaskScheduler::GetWorkerStats() const
+{
+    double elapsed = (NowNanoseconds() - statsStart) * 1e-9;
+    std::vector<WorkerStats> stats;
+    for (const auto &worker : workers)
+    {
+        double busy = worker->busyNanoseconds * 1e-9;
+        stats.push_back({worker->tasksExecuted, worker->tasksStolen, busy, elapsed > 0.0 ? busy / elapsed : 0.0});
+    }
+    return stats;
+}
+
+void TaskScheduler::ResetStats()
+{
+    for (auto &worker : workers)
+    {
+        worker->tasksExecuted = 0;
+        worker->tasksStolen = 0;
+        worker->busyNanoseconds = 0;
+    }
+    statsStart = NowNanoseconds();
+}
+
+void TaskScheduler::PrintUtilization() const
+{
+    std::vector<WorkerStats> stats = GetWorkerStats();
+    double maxBusy = 0.0;
+    double totalBusy = 0.0;
+    std::cout << "==== WORKER UTILIZATION ====" << std::endl;
+    std::cout << std::setw(8) << "Worker" << std::setw(10) << "Tasks" << std::setw(10) << "Stolen"
+              << std::setw(12) << "Busy (s)" << std::setw(14) << "Utilization" << std::endl;
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        std::cout << std::setw(8) << i << std::setw(10) << stats[i].tasksExecuted << std::setw(10) << stats[i].tasksStolen
+                  << std::setw(12) << std::fixed << std::setprecision(3) << stats[i].busySeconds
+                  << std::setw(13) << std::setprecision(1) << 100.0 * stats[i].utilization << "%" << std::endl;
+        maxBusy = std::max(maxBusy, stats[i].busySeconds);
+        totalBusy += stats[i].busySeconds;
+    }
+    // Load imbalance: how much longer the busiest worker worked compared to the average
+    double averageBusy = totalBusy / stats.size();
+    std::cout << "Load imbalance (max / average busy time): " << std::setprecision(2)
+              << (averageBusy > 0.0 ? maxBusy / averageBusy : 1.0) << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+TaskGroup::~TaskGroup()
+{
+    // Never leave tasks referring to a destroyed group
+    while (unfinished > 0)
+    {
+        if (!scheduler.RunPendingTask(this))
+            std::this_thread::yield();
+    }
+}
+
+TaskGroup::TaskId TaskGroup::Add(std::function<void()> task, const std::vector<TaskId> &dependencies)
+{
+    TaskId id;
+    bool ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = static_cast<TaskId>(nodes.size());
+        nodes.push_back({std::move(task), 0, 0, {}, false});
+        for (TaskId dependency : dependencies)
+        {
+            if (dependency < 0 || dependency >= id)
+                throw std::invalid_argument("Invalid task dependency (" + std::to_string(dependency) + ") in TaskGroup");
+            // Every edge is kept for the next runs, but a task already done does not delay this run
+            nodes[dependency].successors.push_back(id);
+            ++nodes[id].dependencies;
+            if (!nodes[dependency].done)
+                ++nodes[id].remainingDependencies;
+        }
+        ready = nodes[id].remainingDependencies == 0;
+        ++unfinished;
+    }
+    if (ready)
+        Schedule(id);
+    return id;
+}
+
+void TaskGroup::Schedule(TaskId id)
+{
+    scheduler.Submit([this, id]()
+                     {
+                         std::function<void()> *task;
+                         {
+                             std::lock_guard<std::mutex> lock(mutex);
+                             task = &nodes[id].task; // Elements of a deque do not move when it grows
+                         }
+                         try
+                         {
+                             TraceSpan span("graph task", "scheduler");
+                             (*task)();
+                         }
+                         catch (...)
+                         {
+                             std::lock_guard<std::mutex> lock(mutex);
+                             if (!exception)
+                                 exception = std::current_exception();
+                         }
+                         Complete(id); },
+                     this);
+}
+
+void TaskGroup::Complete(TaskId id)
+{
+    {
+        // The ready successors are scheduled under the lock, which avoids collecting them in a list
+        std::lock_guard<std::mutex> lock(mutex);
+        nodes[id].done = true;
+        for (TaskId successor : nodes[id].successors)
+        {
+            if (--nodes[successor].remainingDependencies == 0)
+                Schedule(successor);
+        }
+    }
+    --unfinished; // Last, so that Wait() cannot return before the successors are scheduled
+}
+
+void TaskGroup::Rerun()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    unfinished = static_cast<int>(nodes.size());
+    for (Node &node : nodes)
+    {
+        node.remainingDependencies = node.dependencies;
+        node.done = false;
+    }
+    for (TaskId id = 0; id < static_cast<TaskId>(nodes.size()); ++id)
+    {
+        if (nodes[id].dependencies == 0)
+            Schedule(id);
+    }
+}
+
+void TaskGroup::Wait()
+{
+    while (unfinished > 0)
+    {
+        if (!scheduler.RunPendingTask(this))
+            std::this_thread::yield();
+    }
+    std::exception_ptr thrown;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(thrown, exception);
+    }
+    if (thrown)
+        std::rethrow_exception(thrown);
+}
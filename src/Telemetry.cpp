@@ -0,0 +1,92 @@
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "Telemetry.hpp"
+#include "FileReader.hpp"
+
+template <typename T>
+ConvergenceTelemetry<T>::ConvergenceTelemetry(int capacity)
+{
+    if (capacity <= 0)
+        throw std::invalid_argument("The capacity of the telemetry must be positive (" + std::to_string(capacity) + ")");
+    samples.resize(capacity);
+    Start();
+}
+
+template <typename T>
+void ConvergenceTelemetry<T>::Start()
+{
+    next = 0;
+    recorded = 0;
+    start = std::chrono::steady_clock::now();
+}
+
+template <typename T>
+const typename ConvergenceTelemetry<T>::Sample &ConvergenceTelemetry<T>::Get(int i) const
+{
+    // The oldest sample is at the next position once the buffer has wrapped around
+    const int capacity = samples.size();
+    const int oldest = recorded > capacity ? next : 0;
+    return samples[(oldest + i) % capacity];
+}
+
+template <typename T>
+void ConvergenceTelemetry<T>::WriteCsv(std::ostream &out) const
+{
+    out.precision(std::numeric_limits<T>::max_digits10);
+    out << "iteration,estimate,error,seconds\n";
+    for (int i = 0; i < Size(); ++i)
+    {
+        const Sample &sample = Get(i);
+        out << sample.iteration << "," << sample.estimate << "," << sample.error << "," << sample.seconds << "\n";
+    }
+}
+
+template <typename T>
+void ConvergenceTelemetry<T>::WriteJson(std::ostream &out, const std::string &solverName) const
+{
+    // JSON has no infinity: the error before the first check is null
+    auto number = [&out](double value)
+    {
+        if (std::isfinite(value))
+            out << value;
+        else
+            out << "null";
+    };
+    out.precision(std::numeric_limits<T>::max_digits10);
+    out << "{\n  \"solver\": \"" << solverName << "\",\n  \"recorded\": " << recorded << ",\n  \"kept\": " << Size()
+        << ",\n  \"samples\": [";
+    for (int i = 0; i < Size(); ++i)
+    {
+        const Sample &sample = Get(i);
+        out << (i > 0 ? ",\n    " : "\n    ") << "{\"iteration\": " << sample.iteration << ", \"estimate\": ";
+        number(sample.estimate);
+        out << ", \"error\": ";
+        number(sample.error);
+        out << ", \"seconds\": " << sample.seconds << "}";
+    }
+    out << (Size() > 0 ? "\n  ]\n}\n" : "]\n}\n");
+}
+
+template <typename T>
+void ConvergenceTelemetry<T>::Save(const std::string &fileName, const std::string &solverName) const
+{
+    auto pos = fileName.find_last_of('.');
+    std::string extension = pos == std::string::npos ? "" : fileName.substr(pos + 1);
+    if (extension != "csv" && extension != "json")
+        throw std::invalid_argument("Unsupported telemetry file extension (" + extension + "): use csv or json");
+
+    std::ofstream file(std::string(Paths::PATH_OUTPUT_FILE).append(fileName));
+    if (!file.is_open())
+        throw FileException("Failed to open file " + fileName + " when saving the telemetry");
+    if (extension == "csv")
+        WriteCsv(file);
+    else
+        WriteJson(file, solverName);
+}
+
+// Explicit instantiation
+template class ConvergenceTelemetry<float>;
+template class ConvergenceTelemetry<double>;
@@ -0,0 +1,126 @@
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+#include "Tracer.hpp"
+#include "constants.hpp"
+#include "FileReader.hpp"
+
+namespace
+{
+    // Spans reserved in a new buffer, to avoid reallocations during short runs
+    const int RESERVED_EVENTS = 4096;
+
+    long SteadyNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+thread_local Tracer::ThreadBuffer *Tracer::localBuffer = nullptr;
+
+Tracer &Tracer::Instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer() : origin(SteadyNanoseconds()) {}
+
+long Tracer::Now() const
+{
+    return SteadyNanoseconds() - origin;
+}
+
+Tracer::ThreadBuffer &Tracer::LocalBuffer()
+{
+    if (localBuffer == nullptr)
+    {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.reserve(RESERVED_EVENTS);
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer->id = static_cast<int>(buffers.size()) + 1;
+        buffer->name = "thread " + std::to_string(buffer->id);
+        buffers.push_back(buffer);
+        localBuffer = buffer.get();
+    }
+    return *localBuffer;
+}
+
+void Tracer::Record(const char *name, const char *category, long start, long end)
+{
+    LocalBuffer().events.push_back({name, category, start, end - start});
+}
+
+void Tracer::NameThread(const std::string &name)
+{
+    ThreadBuffer &buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer.name = name;
+}
+
+long Tracer::EventCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    long count = 0;
+    for (const auto &buffer : buffers)
+        count += buffer->events.size();
+    return count;
+}
+
+const std::vector<Tracer::Event> &Tracer::ThreadEvents()
+{
+    return LocalBuffer().events;
+}
+
+void Tracer::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &buffer : buffers)
+        buffer->events.clear();
+}
+
+void Tracer::WriteChromeTrace(std::ostream &out) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision(3);
+    out << std::fixed << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    auto separator = [&out, &first]()
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    // Metadata events name the lanes; the times of the complete events ("X") are in microseconds
+    for (const auto &buffer : buffers)
+    {
+        separator();
+        out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->id
+            << ", \"args\": {\"name\": \"" << buffer->name << "\"}}";
+        separator();
+        out << "{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->id
+            << ", \"args\": {\"sort_index\": " << buffer->id << "}}";
+    }
+    for (const auto &buffer : buffers)
+    {
+        for (const Event &event : buffer->events)
+        {
+            separator();
+            out << "{\"name\": \"" << event.name << "\", \"cat\": \"" << event.category << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                << buffer->id << ", \"ts\": " << event.start * 1e-3 << ", \"dur\": " << event.duration * 1e-3 << "}";
+        }
+    }
+    out << "\n]}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Tracer::Save(const std::string &fileName) const
+{
+    std::ofstream file(std::string(Paths::PATH_OUTPUT_FILE).append(fileName));
+    if (!file.is_open())
+        throw FileException("Failed to open file " + fileName + " when saving the trace");
+    WriteChromeTrace(file);
+}
@@ -0,0 +1,79 @@
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "WarmStart.hpp"
+#include "FileReader.hpp"
+
+template <typename T>
+void SaveWarmStart(const std::string &fileName, const WarmStart<T> &warmStart)
+{
+    std::ofstream file(std::string(Paths::PATH_OUTPUT_FILE).append(fileName));
+    if (!file.is_open())
+        throw FileException("Failed to open file " + fileName + " when saving the warm start");
+
+    // All the digits: the vectors are read back exactly
+    file.precision(std::numeric_limits<T>::max_digits10);
+    const Matrix<T> &vectors = warmStart.eigenvectors;
+    file << vectors.rows() << " " << vectors.cols() << "\n";
+    for (int i = 0; i < warmStart.eigenvalues.size(); ++i)
+        file << (i > 0 ? " " : "") << warmStart.eigenvalues(i);
+    file << "\n";
+    for (int i = 0; i < vectors.rows(); ++i)
+    {
+        for (int j = 0; j < vectors.cols(); ++j)
+            file << (j > 0 ? " " : "") << vectors(i, j);
+        file << "\n";
+    }
+    if (!file)
+        throw FileException("Failed to write the warm start to " + fileName);
+}
+
+template <typename T>
+WarmStart<T> LoadWarmStart(const std::string &fileName)
+{
+    std::ifstream file(std::string(Paths::PATH_INPUT_FILE).append(fileName));
+    if (!file.is_open())
+        throw FileException("Failed to open warm start file: " + fileName);
+
+    // Header: size of the vectors and number of vectors
+    std::string line;
+    long rows = -1;
+    long cols = -1;
+    if (std::getline(file, line))
+        std::istringstream(line) >> rows >> cols;
+    if (rows < 0 || cols < 0)
+        throw FileException("Invalid header in warm start file: " + fileName);
+
+    // Eigenvalue estimates (any number, possibly none)
+    WarmStart<T> warmStart;
+    std::vector<T> eigenvalues;
+    if (!std::getline(file, line))
+        throw FileException("Missing eigenvalue line in warm start file: " + fileName);
+    std::istringstream eigenvalueStream(line);
+    double value;
+    while (eigenvalueStream >> value)
+        eigenvalues.push_back(static_cast<T>(value));
+    warmStart.eigenvalues = Eigen::Map<Vector<T>>(eigenvalues.data(), eigenvalues.size());
+
+    warmStart.eigenvectors.resize(rows, cols);
+    for (long i = 0; i < rows; ++i)
+    {
+        if (!std::getline(file, line))
+            throw FileException("Missing rows in warm start file: " + fileName);
+        std::istringstream rowStream(line);
+        for (long j = 0; j < cols; ++j)
+        {
+            if (!(rowStream >> value))
+                throw FileException("Invalid row " + std::to_string(i + 1) + " in warm start file: " + fileName);
+            warmStart.eigenvectors(i, j) = static_cast<T>(value);
+        }
+    }
+    return warmStart;
+}
+
+// Explicit instantiation
+template void SaveWarmStart<float>(const std::string &, const WarmStart<float> &);
+template void SaveWarmStart<double>(const std::string &, const WarmStart<double> &);
+template WarmStart<float> LoadWarmStart<float>(const std::string &);
+template WarmStart<double> LoadWarmStart<double>(const std::string &);
@@ -36,5 +36,119 @@ Config parseYAML(const std::string &fileName)
     }
     parsedConfig.output.outputArgs = config["output"]["output_args"].as<std::vector<std::string>>();
 
+    // The options section is optional
+    if (config["options"])
+    {
+        for (const auto &option : config["options"])
+        {
+            std::string optionName = option.first.as<std::string>();
+            if (SupportedArguments::SUPPORTED_OPTIONS.find(optionName) == SupportedArguments::SUPPORTED_OPTIONS.end())
+            {
+                throw std::invalid_argument("unsupported option (" + optionName + ")");
+            }
+        }
+        if (config["options"]["threads"])
+        {
+            parsedConfig.options.threads = config["options"]["threads"].as<int>();
+            if (parsedConfig.options.threads < 0)
+            {
+                throw std::invalid_argument("the number of threads must be positive, or 0 to use all cores (got " + std::to_string(parsedConfig.options.threads) + ")");
+            }
+        }
+        if (config["options"]["utilization_report"])
+        {
+            parsedConfig.options.utilizationReport = config["options"]["utilization_report"].as<bool>();
+        }
+        if (config["options"]["solver_report"])
+        {
+            parsedConfig.options.solverReport = config["options"]["solver_report"].as<bool>();
+        }
+        if (config["options"]["in_place"])
+        {
+            parsedConfig.options.inPlace = config["options"]["in_place"].as<bool>();
+        }
+        if (config["options"]["memory_report"])
+        {
+            parsedConfig.options.memoryReport = config["options"]["memory_report"].as<bool>();
+        }
+        if (config["options"]["storage"])
+        {
+            parsedConfig.options.storage = config["options"]["storage"].as<std::string>();
+            if (SupportedArguments::SUPPORTED_STORAGE_TYPES.find(parsedConfig.options.storage) == SupportedArguments::SUPPORTED_STORAGE_TYPES.end())
+            {
+                throw std::invalid_argument("unsupported storage type (" + parsedConfig.options.storage + ")");
+            }
+        }
+        if (config["options"]["accuracy_report"])
+        {
+            parsedConfig.options.accuracyReport = config["options"]["accuracy_report"].as<bool>();
+        }
+        if (config["options"]["simd"])
+        {
+            parsedConfig.options.simd = config["options"]["simd"].as<std::string>();
+            if (SupportedArguments::SUPPORTED_SIMD.find(parsedConfig.options.simd) == SupportedArguments::SUPPORTED_SIMD.end())
+            {
+                throw std::invalid_argument("unsupported instruction set (" + parsedConfig.options.simd + ")");
+            }
+        }
+        if (config["options"]["stopping_criterion"])
+        {
+            parsedConfig.options.stoppingCriterion = config["options"]["stopping_criterion"].as<std::string>();
+            if (SupportedArguments::SUPPORTED_STOPPING_CRITERIA.find(parsedConfig.options.stoppingCriterion) == SupportedArguments::SUPPORTED_STOPPING_CRITERIA.end())
+            {
+                throw std::invalid_argument("unsupported stopping criterion (" + parsedConfig.options.stoppingCriterion + ")");
+            }
+        }
+        if (config["options"]["check_interval"])
+        {
+            parsedConfig.options.checkInterval = config["options"]["check_interval"].as<int>();
+            if (parsedConfig.options.checkInterval <= 0)
+            {
+                throw std::invalid_argument("The check interval must be a positive integer, but got " + std::to_string(parsedConfig.options.checkInterval));
+            }
+        }
+        if (config["options"]["warm_start"])
+        {
+            parsedConfig.options.warmStart = config["options"]["warm_start"].as<std::string>();
+        }
+        if (config["options"]["export_vectors"])
+        {
+            parsedConfig.options.exportVectors = config["options"]["export_vectors"].as<std::string>();
+        }
+        if (config["options"]["telemetry"])
+        {
+            parsedConfig.options.telemetry = config["options"]["telemetry"].as<std::string>();
+            std::string extension = parsedConfig.options.telemetry.substr(parsedConfig.options.telemetry.find_last_of('.') + 1);
+            if (extension != "csv" && extension != "json")
+            {
+                throw std::invalid_argument("unsupported telemetry file (" + parsedConfig.options.telemetry + "): use a csv or json file");
+            }
+        }
+        if (config["options"]["trace"])
+        {
+            parsedConfig.options.trace = config["options"]["trace"].as<std::string>();
+            if (parsedConfig.options.trace.substr(parsedConfig.options.trace.find_last_of('.') + 1) != "json")
+            {
+                throw std::invalid_argument("unsupported trace file (" + parsedConfig.options.trace + "): use a json file");
+            }
+        }
+        if (config["options"]["hardware_counters"])
+        {
+            parsedConfig.options.hardwareCounters = config["options"]["hardware_counters"].as<bool>();
+        }
+        if (config["options"]["roofline_report"])
+        {
+            parsedConfig.options.rooflineReport = config["options"]["roofline_report"].as<bool>();
+        }
+        if (config["options"]["sweep_segments"])
+        {
+            parsedConfig.options.sweepSegments = config["options"]["sweep_segments"].as<int>();
+            if (parsedConfig.options.sweepSegments < 0)
+            {
+                throw std::invalid_argument("the number of sweep segments must be positive, or 0 to use one per thread (got " + std::to_string(parsedConfig.options.sweepSegments) + ")");
+            }
+        }
+    }
+
     return parsedConfig;
 }
\ No newline at end of file
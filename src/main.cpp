@@ -1,4 +1,8 @@
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <numeric>
 #include <Eigen/Dense>
 
 #include "constants.hpp"
@@ -12,11 +16,24 @@
 #include "InversePowerMethodSolver.hpp"
 #include "QrMethodSolver.hpp"
 #include "OutputGenerator.hpp"
+#include "OutOfCoreOperator.hpp"
+#include "MixedPrecisionOperator.hpp"
+#include "ParallelKernels.hpp"
+#include "SimdKernels.hpp"
+#include "TaskScheduler.hpp"
+#include "HardwareCounters.hpp"
+#include "Roofline.hpp"
+#include "MemoryReport.hpp"
+#include "Tracer.hpp"
+#include "ParameterSweep.hpp"
+#include "BatchSolver.hpp"
+#include "FileReader.hpp"
 
 // Instantiate the Matrix based on user args
 template <typename T>
 MatrixPointer<T> CreateMatrix(const std::string &inputName, const std::vector<std::string> &inputArgs)
 {
+    TraceSpan span("matrix generation", "main");
     std::cout << "Generating Matrix..." << std::endl;
     auto matrixGeneratorFactory = MatrixGeneratorFactory<T>(inputName, inputArgs);
     std::unique_ptr<MatrixGenerator<T>> generator = matrixGeneratorFactory.ChooseGenerator();
@@ -24,26 +41,219 @@ MatrixPointer<T> CreateMatrix(const std::string &inputName, const std::vector<st
     return matrixPointer;
 }
 
-// Solve the eigenvalue problem
+// Start the solver from the vectors of a previous run, keep its final vectors if they are exported,
+// and record its iterations if the telemetry is saved
 template <typename T>
-Vector<T> SolveProblem(const std::string &methodName, const std::vector<std::string> &methodArgs, MatrixPointer<T> matrixPointer)
+void ConfigureSolver(AbstractIterativeSolver<T> &solver, const Config::Options &options)
 {
-    // Instantiate right solver based on methodName and methodArgs
-    auto solverFactory = SolverFactory<T>(methodName, methodArgs);
-    std::unique_ptr<AbstractIterativeSolver<T>> solver = solverFactory.ChooseSolver();
-    solver->SetMatrix(matrixPointer);
+    if (!options.warmStart.empty())
+        solver.SetWarmStart(LoadWarmStart<T>(options.warmStart));
+    solver.SetExportVectors(!options.exportVectors.empty());
+    if (!options.telemetry.empty())
+    {
+        if (!Telemetry::ENABLED)
+            std::cerr << "[WARNING] The telemetry is compiled out (build with TELEMETRY=ON): no history is saved." << std::endl;
+        solver.EnableTelemetry();
+    }
+}
+
+// Save the final vectors of the solve, to warm-start a next run, and the history of its iterations
+template <typename T>
+void ExportSolverData(const AbstractIterativeSolver<T> &solver, const std::string &methodName, const Config::Options &options)
+{
+    if (!options.exportVectors.empty())
+    {
+        SaveWarmStart(options.exportVectors, solver.GetWarmStart());
+        std::cout << "Final vectors saved to " << Paths::PATH_OUTPUT_FILE << options.exportVectors << std::endl;
+    }
+    if (!options.telemetry.empty() && Telemetry::ENABLED)
+    {
+        solver.GetTelemetry()->Save(options.telemetry, methodName);
+        std::cout << "Telemetry (" << solver.GetTelemetry()->Size() << " iterations) saved to " << Paths::PATH_OUTPUT_FILE
+                  << options.telemetry << std::endl;
+    }
+}
+
+// Solve the eigenvalue problem (in-place: the solver takes over the matrix, and may overwrite it)
+template <typename T>
+Vector<T> SolveProblem(const std::string &methodName, const std::vector<std::string> &methodArgs, MatrixPointer<T> matrixPointer, const Config::Options &options)
+{
+    TraceSpan span("solve", "main");
+    // Instantiate right solver based on methodName and methodArgs (the small matrices get a solver of their size)
+    auto solverFactory = SolverFactory<T>(methodName, methodArgs, options.stoppingCriterion, options.checkInterval);
+    std::unique_ptr<AbstractIterativeSolver<T>> solver = solverFactory.ChooseSolver(matrixPointer->rows());
+    if (options.inPlace)
+        solver->TakeMatrix(std::move(matrixPointer));
+    else
+        solver->SetMatrix(matrixPointer);
+    ConfigureSolver(*solver, options);
     // std::cout << "matrix: \n"
     //   << *matrixPointer << std::endl;
 
     // Solve eigenvalue problem
     std::cout << "Solving eigenvalue problem..." << std::endl;
     Vector<T> eigenvalues = solver->FindEigenvalues();
+    if (options.solverReport)
+        solver->PrintReport();
+    ExportSolverData(*solver, methodName, options);
+    return eigenvalues;
+}
+
+// Solve the eigenvalue problem with the matrix streamed from a tiled file
+template <typename T>
+Vector<T> SolveOutOfCoreProblem(const std::string &methodName, const std::vector<std::string> &methodArgs, const std::vector<std::string> &inputArgs, const Config::Options &options)
+{
+    TraceSpan span("solve (out-of-core)", "main");
+    if (methodName != "power_method" && methodName != "lanczos_method")
+        throw std::invalid_argument("the method " + methodName + " can not run out-of-core (use power_method or lanczos_method)");
+    if (inputArgs.size() != 1)
+        throw std::invalid_argument("Expected exactly one argument for matrix initialization (tiled file name), but got " + std::to_string(inputArgs.size()));
+    auto outOfCoreOperator = std::make_shared<OutOfCoreOperator<T>>(inputArgs[0]);
+
+    auto solverFactory = SolverFactory<T>(methodName, methodArgs, options.stoppingCriterion, options.checkInterval);
+    std::unique_ptr<AbstractIterativeSolver<T>> solver = solverFactory.ChooseSolver();
+    solver->SetOperator(outOfCoreOperator);
+    ConfigureSolver(*solver, options);
+
+    std::cout << "Solving eigenvalue problem (out-of-core)..." << std::endl;
+    Vector<T> eigenvalues = solver->FindEigenvalues();
+    if (options.solverReport)
+        solver->PrintReport();
+    ExportSolverData(*solver, methodName, options);
+    outOfCoreOperator->PrintIoReport();
+    return eigenvalues;
+}
+
+// Solve the eigenvalue problem with the matrix converted to a smaller storage type.
+// With the accuracy report, the problem is solved again in full precision for comparison.
+template <typename T>
+Vector<T> SolveReducedPrecisionProblem(const std::string &methodName, const std::vector<std::string> &methodArgs, MatrixPointer<T> matrixPointer,
+                                       const Config::Options &options)
+{
+    TraceSpan span("solve (reduced precision)", "main");
+    const std::string &storage = options.storage;
+    const bool accuracyReport = options.accuracyReport;
+    if (methodName != "power_method" && methodName != "lanczos_method")
+        throw std::invalid_argument("the method " + methodName + " can not use a reduced-precision storage (use power_method or lanczos_method)");
+
+    std::cout << "Converting the matrix to " << storage << "..." << std::endl;
+    std::shared_ptr<LinearOperator<T>> storageOperator = CreateStorageOperator<T>(matrixPointer, storage);
+    if (!accuracyReport)
+        matrixPointer.reset(); // Only the converted matrix is kept (unless the operator uses it as is)
+
+    auto solverFactory = SolverFactory<T>(methodName, methodArgs, options.stoppingCriterion, options.checkInterval);
+    std::unique_ptr<AbstractIterativeSolver<T>> solver = solverFactory.ChooseSolver();
+    solver->SetOperator(storageOperator);
+    ConfigureSolver(*solver, options);
+
+    std::cout << "Solving eigenvalue problem (" << storage << " storage)..." << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    Vector<T> eigenvalues = solver->FindEigenvalues();
+    double reducedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (options.solverReport)
+        solver->PrintReport();
+    ExportSolverData(*solver, methodName, options);
+    if (!accuracyReport)
+        return eigenvalues;
+
+    // Reference: same solver in full precision
+    std::cout << "Solving eigenvalue problem (full precision, for the accuracy report)..." << std::endl;
+    std::unique_ptr<AbstractIterativeSolver<T>> fullSolver = solverFactory.ChooseSolver();
+    fullSolver->SetMatrix(matrixPointer);
+    start = std::chrono::steady_clock::now();
+    Vector<T> fullEigenvalues = fullSolver->FindEigenvalues();
+    double fullSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Error of the eigenvalues, and of a product with a random vector
+    const int count = std::min(eigenvalues.size(), fullEigenvalues.size());
+    Vector<T> difference = (eigenvalues.head(count) - fullEigenvalues.head(count)).cwiseAbs();
+    T largest = fullEigenvalues.head(count).cwiseAbs().maxCoeff();
+    Vector<T> x = Vector<T>::Random(matrixPointer->cols());
+    Vector<T> reducedProduct;
+    Vector<T> fullProduct;
+    storageOperator->Apply(x, reducedProduct);
+    fullSolver->GetOperator()->Apply(x, fullProduct);
+    int fullBytes = sizeof(T);
+    int storageBytes = StorageBytes(storage, fullBytes);
+
+    std::cout << "==== ACCURACY REPORT ====" << std::endl;
+    std::cout << "Storage: " << storage << " (" << storageBytes << " bytes per entry instead of " << fullBytes << ")" << std::endl;
+    std::cout << std::scientific << std::setprecision(3);
+    std::cout << "Eigenvalues: max absolute difference " << difference.maxCoeff()
+              << ", relative to the largest eigenvalue " << (largest > 0 ? difference.maxCoeff() / largest : T(0)) << std::endl;
+    std::cout << "Relative error of a matrix-vector product: " << (reducedProduct - fullProduct).norm() / fullProduct.norm() << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Solve time: " << reducedSeconds << " s (" << storage << ") / " << fullSeconds << " s (full precision)" << std::endl;
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "=========================" << std::endl;
     return eigenvalues;
 }
 
+// Solve the eigenvalue problems of a matrix family along a grid of parameters, by continuation
+template <typename T>
+SweepResult<T> SolveSweepProblem(const std::string &methodName, const std::vector<std::string> &methodArgs, const std::vector<std::string> &inputArgs,
+                                 const Config::Options &options)
+{
+    TraceSpan span("solve (sweep)", "main");
+    if (options.storage != "full")
+        throw std::invalid_argument("a parameter sweep can not use a reduced-precision storage");
+    ParameterSweep<T> sweep = ParameterSweep<T>::FromArgs(inputArgs);
+    auto solverFactory = SolverFactory<T>(methodName, methodArgs, options.stoppingCriterion, options.checkInterval);
+
+    std::cout << "Solving " << sweep.GetParameters().size() << " eigenvalue problems along the parameter sweep..." << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    SweepResult<T> result = sweep.Run(solverFactory, options.sweepSegments);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long iterations = std::accumulate(result.iterations.begin(), result.iterations.end(), 0L);
+    std::cout << "Sweep: " << result.parameters.size() << " parameters in " << result.segments << " segments, "
+              << iterations << " iterations in total, " << std::fixed << std::setprecision(3) << seconds << " s"
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+    return result;
+}
+
+// Solve the eigenvalue problems of a batch of small matrices with the batched SIMD kernels
+template <typename T>
+BatchResult<T> SolveBatchProblem(const std::vector<std::string> &methodArgs, const std::vector<std::string> &inputArgs, const Config::Options &options)
+{
+    TraceSpan span("solve (batch)", "main");
+    if (options.storage != "full")
+        throw std::invalid_argument("a batch can not use a reduced-precision storage");
+    BatchSolver<T> solver = BatchSolver<T>::FromArgs(methodArgs, inputArgs);
+    MatrixBatch<T> batch = MatrixBatch<T>::FromFile(inputArgs[0]);
+
+    std::cout << "Solving " << batch.count << " eigenvalue problems of size " << batch.size << " in a batch..." << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    BatchResult<T> result = solver.Solve(batch);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Batch: " << batch.count << " matrices, " << result.kernel << " kernel (" << result.lanes << " matrices per SIMD group), "
+              << result.Unconverged() << " not converged, " << std::fixed << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(0) << (seconds > 0 ? batch.count / seconds : 0.0) << " matrices/s)"
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+    return result;
+}
+
+// Output the eigenvalues of a parameter sweep or of a batch as one table (one line per problem)
+template <typename Result>
+void OutputTable(const std::string &outputType, const std::vector<std::string> &outputArgs, const Result &result)
+{
+    TraceSpan span("output", "main");
+    std::cout << "Generating Output..." << std::endl;
+    if (outputType == "print")
+    {
+        result.WriteTable(std::cout);
+        return;
+    }
+    std::string fileName = outputArgs.empty() || outputArgs[0].empty() ? DefaultOutputArgs::FILENAME : outputArgs[0];
+    std::ofstream outFile(std::string(Paths::PATH_OUTPUT_FILE).append(fileName));
+    if (!outFile.is_open())
+        throw FileException("Failed to open file " + fileName + " when generating output");
+    result.WriteTable(outFile);
+}
+
 template <typename T>
 void OutputResults(const std::string &outputType, const std::vector<std::string> &outputArgs, Vector<T> eigenvalues)
 {
+    TraceSpan span("output", "main");
     // Output eigenvalues
     std::cout << "Generating Output..." << std::endl;
     OutputGenerator<T> outputGenerator(outputType, outputArgs, eigenvalues);
@@ -80,11 +290,35 @@ void PrintParameters(Config &config)
     {
         std::cout << "      * " << outputArg << std::endl;
     }
+
+    std::cout << "Options:" << std::endl;
+    std::cout << "  - Threads: " << (config.options.threads == 0 ? "all available cores" : std::to_string(config.options.threads)) << std::endl;
+    std::cout << "  - Utilization report: " << (config.options.utilizationReport ? "yes" : "no") << std::endl;
+    std::cout << "  - Solver report: " << (config.options.solverReport ? "yes" : "no") << std::endl;
+    std::cout << "  - In-place solve: " << (config.options.inPlace ? "yes" : "no") << std::endl;
+    std::cout << "  - Memory report: " << (config.options.memoryReport ? "yes" : "no") << std::endl;
+    std::cout << "  - Storage: " << config.options.storage << std::endl;
+    std::cout << "  - Accuracy report: " << (config.options.accuracyReport ? "yes" : "no") << std::endl;
+    std::cout << "  - SIMD: " << config.options.simd << std::endl;
+    std::cout << "  - Stopping criterion: " << config.options.stoppingCriterion << " (expensive checks every "
+              << config.options.checkInterval << " iterations)" << std::endl;
+    std::cout << "  - Warm start: " << (config.options.warmStart.empty() ? "no" : config.options.warmStart) << std::endl;
+    std::cout << "  - Sweep segments: " << (config.options.sweepSegments == 0 ? "one per thread" : std::to_string(config.options.sweepSegments)) << std::endl;
+    std::cout << "  - Telemetry: " << (config.options.telemetry.empty() ? "no" : config.options.telemetry) << std::endl;
+    std::cout << "  - Export vectors: " << (config.options.exportVectors.empty() ? "no" : config.options.exportVectors) << std::endl;
+    std::cout << "  - Trace: " << (config.options.trace.empty() ? "no" : config.options.trace) << std::endl;
+    std::cout << "  - Hardware counters: " << (config.options.hardwareCounters ? "yes" : "no") << std::endl;
+    std::cout << "  - Roofline report: " << (config.options.rooflineReport ? "yes" : "no") << std::endl;
     std::cout << "=========================" << std::endl;
 }
 
 int main(int argc, char *argv[])
 {
+    // The parsing is traced once the options are known
+    Tracer &tracer = Tracer::Instance();
+    tracer.NameThread("main");
+    const long parseStart = tracer.Now();
+
     // Parse input YAML config file and catch errors
     Config config;
     try
@@ -109,13 +343,40 @@ int main(int argc, char *argv[])
         std::cerr << "Error during config file parsing: " << e.what() << std::endl;
         return -1;
     }
+    if (!config.options.trace.empty())
+    {
+        tracer.SetEnabled(true);
+        tracer.Record("parse config", "main", parseStart, tracer.Now());
+    }
 
     // Print parameters
     PrintParameters(config);
 
+    // Set the number of threads used by the solvers
+    ParallelKernels::SetNumThreads(config.options.threads);
+
+    // Select the instruction set of the vector kernels (by default, the widest one of the processor)
+    try
+    {
+        if (config.options.simd != "auto")
+            SimdKernels::SetIsa(SimdKernels::IsaFromName(config.options.simd));
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << "Error (user input): " << e.what() << std::endl;
+        return -1;
+    }
+    std::cout << "Vector kernels: " << SimdKernels::IsaName(SimdKernels::GetIsa()) << std::endl;
+
+    // Open the hardware counters once the workers are started: they are counted with the main thread
+    if (config.options.hardwareCounters && !HardwareCounters::Instance().Enable())
+        std::cerr << "[WARNING] No hardware counter is available (perf_event_open failed): the counters are not measured." << std::endl;
+    Roofline::Instance().SetEnabled(config.options.rooflineReport);
+
     // Solve eigenvalue problem
     std::string type = config.type;
     MatrixVariant variantType;
+    MemoryReport memoryReport;
 
     try
     {
@@ -142,11 +403,76 @@ int main(int argc, char *argv[])
             [&](auto &&chosenType)
             {
                 using ChosenType = std::decay_t<decltype(chosenType)>;
-                MatrixPointer<ChosenType> matrixPointer = CreateMatrix<ChosenType>(config.input.type, config.input.inputArgs);
-                Vector<ChosenType> eigenvalues = SolveProblem<ChosenType>(config.method.name, config.method.methodArgs, matrixPointer);
+                Vector<ChosenType> eigenvalues;
+                if (config.input.type == "sweep") // One table for the whole grid
+                {
+                    memoryReport.StartPhase("solve (sweep)");
+                    SweepResult<ChosenType> result = SolveSweepProblem<ChosenType>(config.method.name, config.method.methodArgs, config.input.inputArgs, config.options);
+                    memoryReport.StartPhase("output");
+                    OutputTable(config.output.type, config.output.outputArgs, result);
+                    memoryReport.EndPhase();
+                    return;
+                }
+                if (config.input.type == "batch") // One table for the whole batch
+                {
+                    memoryReport.StartPhase("solve (batch)");
+                    BatchResult<ChosenType> result = SolveBatchProblem<ChosenType>(config.method.methodArgs, config.input.inputArgs, config.options);
+                    memoryReport.StartPhase("output");
+                    OutputTable(config.output.type, config.output.outputArgs, result);
+                    memoryReport.EndPhase();
+                    return;
+                }
+                if (config.input.type == "tiled_file") // The matrix is never loaded in memory
+                {
+                    memoryReport.StartPhase("solve (out-of-core)");
+                    eigenvalues = SolveOutOfCoreProblem<ChosenType>(config.method.name, config.method.methodArgs, config.input.inputArgs, config.options);
+                }
+                else
+                {
+                    memoryReport.StartPhase("matrix generation");
+                    MatrixPointer<ChosenType> matrixPointer = CreateMatrix<ChosenType>(config.input.type, config.input.inputArgs);
+                    memoryReport.StartPhase("solve");
+                    if (config.options.storage != "full")
+                        eigenvalues = SolveReducedPrecisionProblem<ChosenType>(config.method.name, config.method.methodArgs, std::move(matrixPointer), config.options);
+                    else
+                        eigenvalues = SolveProblem<ChosenType>(config.method.name, config.method.methodArgs, std::move(matrixPointer), config.options);
+                }
+                memoryReport.StartPhase("output");
                 OutputResults<ChosenType>(config.output.type, config.output.outputArgs, eigenvalues);
+                memoryReport.EndPhase();
             },
             variantType);
+
+        // Save the spans of the run, one lane per thread
+        if (!config.options.trace.empty())
+        {
+            tracer.SetEnabled(false);
+            tracer.Save(config.options.trace);
+            std::cout << "Trace (" << tracer.EventCount() << " spans) saved to " << Paths::PATH_OUTPUT_FILE << config.options.trace << std::endl;
+        }
+
+        // Print the peak resident memory of each phase
+        if (config.options.memoryReport)
+            memoryReport.Print();
+
+        // Print the time and the hardware counters of the kernels
+        if (HardwareCounters::Instance().IsEnabled())
+        {
+            HardwareCounters::Instance().Disable();
+            HardwareCounters::Instance().PrintReport();
+        }
+
+        // Print the flops and bytes of the kernels against the peaks of the machine, measured after the solve
+        if (Roofline::Instance().IsEnabled())
+        {
+            Roofline::Instance().SetEnabled(false);
+            Roofline::Peak peak = std::holds_alternative<float>(variantType) ? Roofline::MeasurePeak<float>() : Roofline::MeasurePeak<double>();
+            Roofline::Instance().PrintReport(peak);
+        }
+
+        // Print the load balance of the workers
+        if (config.options.utilizationReport)
+            TaskScheduler::Instance().PrintUtilization();
     }
     catch (const std::invalid_argument &e) // Exceptions related to invalid user arguments
     {
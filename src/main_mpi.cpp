@@ -0,0 +1,227 @@
+#include <iostream>
+#include <thread>
+#include <Eigen/Dense>
+#include <mpi.h>
+
+#include "constants.hpp"
+#include "Config.hpp"
+#include "FileReader.hpp"
+#include "FileReaderMTX.hpp"
+#include "FunctionManager.hpp"
+#include "MatrixGeneratorFromFunction.hpp"
+#include "SolverFactory.hpp"
+#include "OutputGenerator.hpp"
+#include "DistributedOperator.hpp"
+#include "ParallelKernels.hpp"
+#include "Tracer.hpp"
+
+// Methods based on matrix-vector products only, which can run on a distributed matrix
+const std::set<std::string> DISTRIBUTED_METHODS = {
+    "power_method",
+    "lanczos_method"};
+
+// Create the rows of the matrix stored by this process, based on user args
+template <typename T>
+std::shared_ptr<DistributedOperator<T>> CreateDistributedOperator(const std::string &inputName, const std::vector<std::string> &inputArgs,
+                                                                  int rank, int processes)
+{
+    if (rank == 0)
+        std::cout << "Generating Matrix..." << std::endl;
+    int size;
+    int firstRow;
+    int lastRow;
+    MatrixPointer<T> localBlock;
+
+    if (inputName == "function")
+    {
+        if (inputArgs.size() != 3)
+            throw std::invalid_argument("Expected exactly 3 arguments for matrix initialization (function name, number of rows, number of columns), but got " + std::to_string(inputArgs.size()));
+        int nbRows;
+        int nbCols;
+        try
+        {
+            nbRows = std::stoi(inputArgs[1]);
+            nbCols = std::stoi(inputArgs[2]);
+        }
+        catch (const std::exception &e)
+        {
+            throw std::invalid_argument("Failed to convert rows or columns to integers during matrix initialization: " + std::string(e.what()));
+        }
+        size = nbRows;
+        DistributedOperator<T>::Partition(size, rank, processes, firstRow, lastRow);
+        auto function = std::make_unique<FunctionManager<T>>(inputArgs[0]);
+        MatrixGeneratorFromFunction<T> generator(std::move(function), nbRows, nbCols);
+        localBlock = generator.GenerateRowBlock(firstRow, lastRow);
+    }
+    else if (inputName == "file")
+    {
+        if (inputArgs.size() != 1)
+            throw std::invalid_argument("Expected exactly one argument for matrix initialization (file name), but got " + std::to_string(inputArgs.size()));
+        std::string fileName = inputArgs[0];
+        if (fileName.size() < 4 || fileName.substr(fileName.size() - 4) != ".mtx")
+            throw std::invalid_argument("Only MTX files can be distributed (" + fileName + ")");
+        FileReaderMTX<T> fileReader(fileName);
+        size_t numRows;
+        size_t numCols;
+        fileReader.ReadDimensions(numRows, numCols);
+        size = numRows;
+        DistributedOperator<T>::Partition(size, rank, processes, firstRow, lastRow);
+        localBlock = fileReader.ReadRowBlock(firstRow, lastRow);
+    }
+    else
+    {
+        throw std::runtime_error(inputName + " is a supported input type but is not linked to a valid implementation.\n"
+                                             "Consider updating main_mpi to consider this input type");
+    }
+
+    if (localBlock->cols() != size)
+        throw SolverException("The provided matrix must be square. Rows and columns are not equal.");
+    return std::make_shared<DistributedOperator<T>>(localBlock, firstRow, MPI_COMM_WORLD);
+}
+
+// Solve the eigenvalue problem on the distributed matrix
+template <typename T>
+Vector<T> SolveProblem(const std::string &methodName, const std::vector<std::string> &methodArgs, std::shared_ptr<DistributedOperator<T>> distributedOperator,
+                       const Config::Options &options, int rank)
+{
+    auto solverFactory = SolverFactory<T>(methodName, methodArgs, options.stoppingCriterion, options.checkInterval);
+    std::unique_ptr<AbstractIterativeSolver<T>> solver = solverFactory.ChooseSolver();
+    solver->SetOperator(distributedOperator);
+    // Every process reads the vectors, and keeps the rows it stores
+    if (!options.warmStart.empty())
+        solver->SetWarmStart(LoadWarmStart<T>(options.warmStart));
+    if (!options.exportVectors.empty() && rank == 0)
+        std::cerr << "[WARNING] The final vectors are not exported by the distributed solver." << std::endl;
+
+    if (rank == 0)
+        std::cout << "Solving eigenvalue problem..." << std::endl;
+    Vector<T> eigenvalues = solver->FindEigenvalues();
+    distributedOperator->PrintTimings();
+    return eigenvalues;
+}
+
+// Threads per process: the cores of the node are shared by the processes running on it
+int ThreadsPerProcess(int threads)
+{
+    if (threads > 0)
+        return threads;
+    MPI_Comm nodeCommunicator;
+    int processesOnNode;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodeCommunicator);
+    MPI_Comm_size(nodeCommunicator, &processesOnNode);
+    MPI_Comm_free(&nodeCommunicator);
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / processesOnNode);
+}
+
+int Run(int argc, char *argv[], int rank, int processes)
+{
+    // Parse input YAML config file and catch errors
+    Config config;
+    try
+    {
+        if (argc != 2)
+            throw std::invalid_argument(
+                "A YAML config file needs to be provided as the only argument.\n"
+                "Usage: mpirun -np <processes> main_mpi <input_file.yaml>");
+        config = parseYAML(std::string(Paths::PATH_INPUT_FILE).append(argv[1])); // Parse the YAML file
+        if (DISTRIBUTED_METHODS.find(config.method.name) == DISTRIBUTED_METHODS.end())
+            throw std::invalid_argument("the method " + config.method.name + " can not run on a distributed matrix (use power_method or lanczos_method)");
+    }
+    catch (const std::invalid_argument &e) // Catch our own thrown exceptions
+    {
+        std::cerr << "Error (user input): " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception &e) // Catch exceptions from yaml-cpp library
+    {
+        std::cerr << "Error during config file parsing: " << e.what() << std::endl;
+        return -1;
+    }
+
+    if (rank == 0)
+    {
+        std::cout << "==== DISTRIBUTED RUN ====" << std::endl;
+        std::cout << "Processes: " << processes << std::endl;
+        std::cout << "Input type: " << config.input.type << std::endl;
+        std::cout << "Method: " << config.method.name << std::endl;
+        std::cout << "=========================" << std::endl;
+    }
+    ParallelKernels::SetNumThreads(ThreadsPerProcess(config.options.threads));
+    Tracer &tracer = Tracer::Instance();
+    tracer.NameThread("main (rank " + std::to_string(rank) + ")");
+    tracer.SetEnabled(!config.options.trace.empty());
+
+    try
+    {
+        auto solve = [&](auto chosenType)
+        {
+            using ChosenType = decltype(chosenType);
+            auto distributedOperator = CreateDistributedOperator<ChosenType>(config.input.type, config.input.inputArgs, rank, processes);
+            Vector<ChosenType> eigenvalues = SolveProblem<ChosenType>(config.method.name, config.method.methodArgs, distributedOperator, config.options, rank);
+            if (rank == 0)
+            {
+                std::cout << "Generating Output..." << std::endl;
+                OutputGenerator<ChosenType> outputGenerator(config.output.type, config.output.outputArgs, eigenvalues);
+                outputGenerator.GenerateOutput();
+            }
+        };
+        if (config.type == "double")
+            solve(double{});
+        else
+            solve(float{});
+
+        // One trace per process: <name>_rank<r>.json
+        if (!config.options.trace.empty())
+        {
+            const std::size_t extension = config.options.trace.find_last_of('.');
+            std::string fileName = config.options.trace;
+            tracer.SetEnabled(false);
+            tracer.Save(fileName.insert(extension, "_rank" + std::to_string(rank)));
+            std::cout << "Traces saved to " << Paths::PATH_OUTPUT_FILE << config.options.trace.substr(0, extension) << "_rank<r>.json"
+                      << " (one per process)" << std::endl;
+        }
+    }
+    catch (const std::invalid_argument &e) // Exceptions related to invalid user arguments
+    {
+        std::cerr << "Error (invalid user argument): " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const FileException &e) // Expection related to file handling
+    {
+        std::cerr << "Error (file handling): " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const SolverException &e) // Expection related to the solvers
+    {
+        std::cerr << "Error (solver): " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception &e) // All other exceptions
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    MPI_Init(&argc, &argv);
+    int rank;
+    int processes;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &processes);
+
+    // Only the first process prints the progress of the solvers
+    std::streambuf *coutBuffer = std::cout.rdbuf();
+    if (rank != 0)
+        std::cout.rdbuf(nullptr);
+
+    int status = Run(argc, argv, rank, processes);
+
+    std::cout.rdbuf(coutBuffer);
+    if (status != 0)
+        MPI_Abort(MPI_COMM_WORLD, status); // The other processes may be waiting in a collective operation
+    MPI_Finalize();
+    return status;
+}
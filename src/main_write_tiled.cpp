@@ -0,0 +1,68 @@
+#include <iostream>
+#include <string>
+
+#include "constants.hpp"
+#include "FileReader.hpp"
+#include "FileReaderMTX.hpp"
+#include "FunctionManager.hpp"
+#include "MatrixGeneratorFromFunction.hpp"
+#include "OutOfCoreOperator.hpp"
+
+// Writes a matrix in the tiled format read by the out-of-core solvers, one panel of rows at a time,
+// so that matrices larger than the memory can be written (MTX files are read once per panel).
+//
+// Usage: write_tiled <function name> <size> <tile size> <output file> <float|double>
+//        write_tiled <file.mtx> <tile size> <output file> <float|double>
+template <typename T>
+void WriteTiled(int argc, char *argv[])
+{
+    if (argc == 6)
+    {
+        int size = std::stoi(argv[2]);
+        MatrixGeneratorFromFunction<T> generator(std::make_unique<FunctionManager<T>>(argv[1]), size, size);
+        OutOfCoreOperator<T>::WriteTiledFile(argv[4], size, std::stoi(argv[3]), [&](int first, int last)
+                                             { return generator.GenerateRowBlock(first, last); });
+    }
+    else
+    {
+        FileReaderMTX<T> fileReader(argv[1]);
+        size_t numRows;
+        size_t numCols;
+        fileReader.ReadDimensions(numRows, numCols);
+        if (numRows != numCols)
+            throw std::invalid_argument("The matrix must be square to be written in the tiled format");
+        OutOfCoreOperator<T>::WriteTiledFile(argv[3], numRows, std::stoi(argv[2]), [&](int first, int last)
+                                             { return fileReader.ReadRowBlock(first, last); });
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 5 && argc != 6)
+    {
+        std::cerr << "Usage: write_tiled <function name> <size> <tile size> <output file> <float|double>\n"
+                  << "       write_tiled <file.mtx> <tile size> <output file> <float|double>" << std::endl;
+        return -1;
+    }
+    try
+    {
+        std::string type = argv[argc - 1];
+        if (type == "double")
+            WriteTiled<double>(argc, argv);
+        else if (type == "float")
+            WriteTiled<float>(argc, argv);
+        else
+            throw std::invalid_argument("unsupported type (" + type + ")");
+    }
+    catch (const FileException &e) // Expection related to file handling
+    {
+        std::cerr << "Error (file handling): " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception &e) // All other exceptions
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
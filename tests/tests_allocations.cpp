@@ -0,0 +1,219 @@
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include "constants.hpp"
+#include "PowerMethodSolver.hpp"
+#include "InversePowerMethodSolver.hpp"
+#include "QrMethodSolver.hpp"
+#include "TaskScheduler.hpp"
+#include <Eigen/Dense>
+
+using type_test = double;                                                    // Choose float or double: enable to avoid redundent testing
+using MatrixTest = Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic>; // For readability
+using VectorTest = Eigen::Matrix<type_test, Eigen::Dynamic, 1>;              // For readability
+
+// *****************
+// ALLOCATION COUNTER
+// *****************
+
+// Every heap allocation of the process (operator new and Eigen both end up in malloc) is counted by
+// replacing the allocation functions of the C library (glibc), which forward to the original ones.
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+extern "C" void *__libc_memalign(size_t alignment, size_t size);
+
+namespace
+{
+    std::atomic<long> allocationCount(0);
+}
+
+extern "C" void *malloc(size_t size)
+{
+    ++allocationCount;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    ++allocationCount;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+    ++allocationCount;
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" int posix_memalign(void **pointer, size_t alignment, size_t size)
+{
+    ++allocationCount;
+    *pointer = __libc_memalign(alignment, size);
+    return *pointer == nullptr ? ENOMEM : 0;
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size)
+{
+    ++allocationCount;
+    return __libc_memalign(alignment, size);
+}
+
+// Returns the number of heap allocations made by a call to the solver
+template <typename Solver>
+long CountAllocations(Solver &solver)
+{
+    long before = allocationCount.load();
+    solver.FindEigenvalues();
+    return allocationCount.load() - before;
+}
+
+// Same for a second call: the workspace and the buffers allocated once per thread already exist
+template <typename Solver>
+long CountAllocationsOfSecondSolve(Solver &solver)
+{
+    solver.FindEigenvalues();
+    return CountAllocations(solver);
+}
+
+// ********
+// FIXTURES
+// ********
+
+// Fixture class: diagonal matrix whose two dominant eigenvalues are very close, so that the
+// iterative methods run until the maximum number of iterations
+class AllocationTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TaskScheduler::Instance().SetNumWorkers(1);
+        VectorTest diagonal = VectorTest::LinSpaced(size, 1.0, 2.9);
+        diagonal(size - 2) = 3.0 - 1e-9;
+        diagonal(size - 1) = 3.0;
+        matrix = std::make_shared<MatrixTest>(diagonal.asDiagonal());
+    }
+    std::shared_ptr<Matrix<type_test>> matrix;
+    double tolerance = 1e-300;
+    double shift = 0.0;
+    int fewIterations = 5;
+    int manyIterations = 50;
+    int size = 40;
+};
+
+// ******************************
+// ALLOCATION-FREE ITERATION LOOPS
+// ******************************
+
+// The allocations of a solve do not depend on the number of iterations: there is none in the loop
+TEST_F(AllocationTest, PowerMethod)
+{
+    for (const std::string acceleration : {"none", "aitken"})
+    {
+        PowerMethodSolver<type_test> fewSolver(tolerance, fewIterations, shift, acceleration);
+        PowerMethodSolver<type_test> manySolver(tolerance, manyIterations, shift, acceleration);
+        fewSolver.SetMatrix(matrix);
+        manySolver.SetMatrix(matrix);
+        long workspaceAllocations = manySolver.GetWorkspace().GetAllocations();
+        long fewAllocations = CountAllocationsOfSecondSolve(fewSolver);
+        long manyAllocations = CountAllocationsOfSecondSolve(manySolver);
+        ASSERT_EQ(manySolver.GetReport().iterations, manyIterations);
+        EXPECT_EQ(fewAllocations, manyAllocations) << "acceleration: " << acceleration;
+
+        // The buffers of the iterations are allocated once, at the first solve
+        EXPECT_EQ(manySolver.GetWorkspace().GetAllocations(), workspaceAllocations + 2);
+    }
+}
+
+TEST_F(AllocationTest, PowerMethodChebyshev)
+{
+    PowerMethodSolver<type_test> fewSolver(tolerance, fewIterations, shift, "chebyshev");
+    PowerMethodSolver<type_test> manySolver(tolerance, manyIterations, shift, "chebyshev");
+    fewSolver.SetMatrix(matrix);
+    manySolver.SetMatrix(matrix);
+    long fewAllocations = CountAllocationsOfSecondSolve(fewSolver);
+    long manyAllocations = CountAllocationsOfSecondSolve(manySolver);
+    ASSERT_EQ(manySolver.GetReport().acceleration, "chebyshev");
+    ASSERT_GT(manySolver.GetReport().iterations, fewIterations);
+    EXPECT_EQ(fewAllocations, manyAllocations);
+}
+
+TEST_F(AllocationTest, InversePowerMethod)
+{
+    // Shift close to the smallest eigenvalue (1.0), with the next one very close: slow convergence
+    (*matrix)(1, 1) = 1.0 + 1e-9;
+    InversePowerMethodSolver<type_test> fewSolver(tolerance, fewIterations, 0.5);
+    InversePowerMethodSolver<type_test> manySolver(tolerance, manyIterations, 0.5);
+    fewSolver.SetMatrix(matrix);
+    manySolver.SetMatrix(matrix);
+    long fewAllocations = CountAllocationsOfSecondSolve(fewSolver);
+    long workspaceAllocations = manySolver.GetWorkspace().GetAllocations();
+    long manyAllocations = CountAllocationsOfSecondSolve(manySolver);
+    ASSERT_EQ(manySolver.GetReport().iterations, manyIterations);
+    EXPECT_EQ(fewAllocations, manyAllocations);
+
+    // The shifted matrix and the four vectors of the iterations are allocated once, at the first solve
+    EXPECT_EQ(manySolver.GetWorkspace().GetAllocations(), workspaceAllocations + 5);
+}
+
+TEST_F(AllocationTest, QrMethod)
+{
+    // Random symmetric matrices: the QR iterations do not converge in a few steps. From two tiles per
+    // dimension (128), the decomposition is tiled; 160 also has a smaller last tile.
+    for (int n : {size, 2 * DefaultSolverArgs::TILE_SIZE, 160})
+    {
+        MatrixTest random = MatrixTest::Random(n, n);
+        auto symmetric = std::make_shared<MatrixTest>(random + random.transpose());
+        QrMethodSolver<type_test> fewSolver(tolerance, fewIterations);
+        QrMethodSolver<type_test> manySolver(tolerance, manyIterations);
+        fewSolver.SetMatrix(symmetric);
+        manySolver.SetMatrix(symmetric);
+        long fewAllocations = CountAllocationsOfSecondSolve(fewSolver);
+        long manyAllocations = CountAllocationsOfSecondSolve(manySolver);
+        ASSERT_EQ(manySolver.GetReport().iterations, manyIterations);
+        EXPECT_EQ(fewAllocations, manyAllocations) << "size: " << n;
+    }
+}
+
+// Same for the tiled decomposition with several workers: the task graph is executed again at each
+// iteration, and the deques of the scheduler keep their capacity
+TEST_F(AllocationTest, QrMethodTiledWorkers)
+{
+    TaskScheduler::Instance().SetNumWorkers(4);
+    const int n = 3 * DefaultSolverArgs::TILE_SIZE;
+    MatrixTest random = MatrixTest::Random(n, n);
+    auto symmetric = std::make_shared<MatrixTest>(random + random.transpose());
+    QrMethodSolver<type_test> solver(tolerance, fewIterations);
+    solver.SetMatrix(symmetric);
+    solver.FindEigenvalues();
+    long firstAllocations = CountAllocations(solver);
+    long secondAllocations = CountAllocations(solver);
+    TaskScheduler::Instance().SetNumWorkers(1);
+    EXPECT_EQ(firstAllocations, secondAllocations);
+}
+
+TEST(SolverWorkspaceTest, ReuseAndResize)
+{
+    SolverWorkspace<type_test> workspace;
+    workspace.SetSize(10);
+    Vector<type_test> &first = workspace.GetVector(0);
+    type_test *data = first.data();
+    EXPECT_EQ(first.size(), 10);
+    workspace.GetVector(3); // Adding slots keeps the references valid
+    EXPECT_EQ(workspace.GetVector(0).data(), data);
+    EXPECT_EQ(workspace.GetAllocations(), 2);
+
+    workspace.SetSize(10); // Same size: nothing to do
+    EXPECT_EQ(workspace.GetAllocations(), 2);
+    workspace.SetSize(20);
+    EXPECT_EQ(workspace.GetVector(0).size(), 20);
+    EXPECT_EQ(workspace.GetAllocations(), 4);
+
+    EXPECT_EQ(workspace.GetMatrix(0, 3, 4).cols(), 4);
+    workspace.GetMatrix(0, 3, 4);
+    EXPECT_EQ(workspace.GetAllocations(), 5);
+    workspace.GetMatrix(0, 4, 3);
+    EXPECT_EQ(workspace.GetAllocations(), 6);
+    EXPECT_THROW(workspace.GetVector(-1), std::invalid_argument);
+}
@@ -0,0 +1,194 @@
+#include <cmath>
+#include <gtest/gtest.h>
+#include <mpi.h>
+#include "constants.hpp"
+#include "DistributedOperator.hpp"
+#include "DenseOperator.hpp"
+#include "FunctionManager.hpp"
+#include "MatrixGeneratorFromFunction.hpp"
+#include "FileReaderMTX.hpp"
+#include "PowerMethodSolver.hpp"
+#include "LanczosSolver.hpp"
+#include <iostream>
+#include <Eigen/Dense>
+
+// Run with several processes, e.g.: mpirun -np 4 ./tests_distributed_solvers
+
+using type_test = double;                                                    // Choose float or double: enable to avoid redundent testing
+using MatrixTest = Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic>; // For readability
+using VectorTest = Eigen::Matrix<type_test, Eigen::Dynamic, 1>;              // For readability
+
+// ********
+// FIXTURES
+// ********
+
+// Fixture class: a matrix generated by a function, each process generating its own rows,
+// and the whole matrix to compare with the results of the solvers on a single process
+class DistributedHilbertTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &processes);
+        int firstRow, lastRow;
+        DistributedOperator<type_test>::Partition(size, rank, processes, firstRow, lastRow);
+
+        MatrixGeneratorFromFunction<type_test> generator(std::make_unique<FunctionManager<type_test>>("hilbert"), size, size);
+        matrix = generator.GenerateMatrix();
+        distributedOperator = std::make_shared<DistributedOperator<type_test>>(generator.GenerateRowBlock(firstRow, lastRow), firstRow);
+    }
+    std::shared_ptr<Matrix<type_test>> matrix;
+    std::shared_ptr<DistributedOperator<type_test>> distributedOperator;
+    int rank;
+    int processes;
+    int maxIter = 1000;
+    double tolerance = 1e-10;
+    double shift = 0.0;
+    int size = 50;
+};
+
+// Fixture class: tridiagonal matrix, whose blocks of rows only need the vector entries
+// of the neighbouring processes
+class DistributedTridiagonalTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &processes);
+        DistributedOperator<type_test>::Partition(size, rank, processes, firstRow, lastRow);
+
+        matrix = std::make_shared<MatrixTest>(MatrixTest::Zero(size, size));
+        for (int i = 0; i < size; ++i)
+        {
+            (*matrix)(i, i) = 2.0;
+            if (i > 0)
+                (*matrix)(i, i - 1) = -1.0;
+            if (i < size - 1)
+                (*matrix)(i, i + 1) = -1.0;
+        }
+        auto block = std::make_shared<MatrixTest>(matrix->middleRows(firstRow, lastRow - firstRow));
+        distributedOperator = std::make_shared<DistributedOperator<type_test>>(block, firstRow);
+    }
+    std::shared_ptr<Matrix<type_test>> matrix;
+    std::shared_ptr<DistributedOperator<type_test>> distributedOperator;
+    int rank;
+    int processes;
+    int firstRow;
+    int lastRow;
+    int size = 40;
+};
+
+// *******************
+// DISTRIBUTED PRODUCT
+// *******************
+
+TEST_F(DistributedTridiagonalTest, MatVec)
+{
+    VectorTest x = VectorTest::LinSpaced(size, 1.0, size);
+    VectorTest y;
+    distributedOperator->Apply(x.segment(firstRow, lastRow - firstRow), y);
+
+    VectorTest expected = (*matrix * x).segment(firstRow, lastRow - firstRow);
+    EXPECT_TRUE(y.isApprox(expected, 1e-12));
+}
+
+TEST_F(DistributedTridiagonalTest, OnlyNeighbourEntriesExchanged)
+{
+    // At most one entry from the previous process and one from the next one
+    long exchanged = distributedOperator->GetTimings().exchangedEntries;
+    EXPECT_LE(exchanged, 2);
+    if (processes > 1)
+    {
+        EXPECT_GE(exchanged, 1);
+    }
+}
+
+TEST_F(DistributedTridiagonalTest, DotProduct)
+{
+    VectorTest x = VectorTest::LinSpaced(size, 1.0, size);
+    VectorTest local = x.segment(firstRow, lastRow - firstRow);
+    EXPECT_NEAR(distributedOperator->Dot(local, local), x.squaredNorm(), 1e-9);
+}
+
+// *****************
+// DISTRIBUTED SOLVERS
+// *****************
+
+TEST_F(DistributedHilbertTest, PowerMethod)
+{
+    PowerMethodSolver<type_test> solver = PowerMethodSolver<type_test>(tolerance, maxIter, shift);
+    solver.SetOperator(distributedOperator);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    // Same result as the solver on the whole matrix
+    PowerMethodSolver<type_test> serialSolver = PowerMethodSolver<type_test>(tolerance, maxIter, shift);
+    serialSolver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = serialSolver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), expectedEigenvalues(0), 1e-10);
+
+    // Every process spent some time in the products and in the communications
+    auto timings = distributedOperator->GetTimings();
+    EXPECT_GT(timings.products, 0);
+    EXPECT_GT(timings.communicationSeconds, 0.0);
+}
+
+TEST_F(DistributedHilbertTest, LanczosMethod)
+{
+    LanczosSolver<type_test> solver = LanczosSolver<type_test>(tolerance, maxIter);
+    solver.SetOperator(distributedOperator);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    Eigen::SelfAdjointEigenSolver<MatrixTest> eigenSolver(*matrix);
+    ASSERT_NEAR(eigenvalues(0), eigenSolver.eigenvalues().maxCoeff(), 1e-8);
+}
+
+TEST(DistributedMtxTest, LanczosMethod)
+{
+    int rank, processes;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &processes);
+
+    // Small matrix: with 4 processes, one of them has no rows
+    FileReaderMTX<type_test> fileReader("B.mtx");
+    size_t numRows, numCols;
+    fileReader.ReadDimensions(numRows, numCols);
+    int firstRow, lastRow;
+    DistributedOperator<type_test>::Partition(numRows, rank, processes, firstRow, lastRow);
+    auto distributedOperator = std::make_shared<DistributedOperator<type_test>>(fileReader.ReadRowBlock(firstRow, lastRow), firstRow);
+
+    LanczosSolver<type_test> solver = LanczosSolver<type_test>(1e-10, 100);
+    solver.SetOperator(distributedOperator);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    ASSERT_EQ(eigenvalues.size(), 3);
+    EXPECT_NEAR(eigenvalues(0), 3.5, 1e-10);
+    EXPECT_NEAR(eigenvalues(1), 2.5, 1e-10);
+    EXPECT_NEAR(eigenvalues(2), 1.5, 1e-10);
+}
+
+// The tests need MPI to be initialized: custom main instead of gtest_main
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleTest(&argc, argv);
+
+    // Only the first process reports the results
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank != 0)
+    {
+        ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+        delete listeners.Release(listeners.default_result_printer());
+        std::cout.rdbuf(nullptr);
+    }
+
+    int result = RUN_ALL_TESTS();
+
+    // Fail if any of the processes failed
+    int globalResult;
+    MPI_Allreduce(&result, &globalResult, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Finalize();
+    return globalResult;
+}
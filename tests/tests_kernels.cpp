@@ -0,0 +1,578 @@
+#include <cmath>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+#include "constants.hpp"
+#include "HardwareCounters.hpp"
+#include "ParallelKernels.hpp"
+#include "Roofline.hpp"
+#include "SimdKernels.hpp"
+#include "TaskScheduler.hpp"
+#include "Tracer.hpp"
+#include <iostream>
+#include <Eigen/Dense>
+
+using type_test = double;                                                    // Choose float or double: enable to avoid redundent testing
+using MatrixTest = Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic>; // For readability
+using VectorTest = Eigen::Matrix<type_test, Eigen::Dynamic, 1>;              // For readability
+
+// ********
+// FIXTURES
+// ********
+
+// Fixture class: random matrices large enough to be split among several threads.
+// The size is not a multiple of the block alignment to test the last (partial) blocks.
+class ParallelKernelsTest : public ::testing::TestWithParam<int>
+{
+protected:
+    void SetUp() override
+    {
+        ParallelKernels::SetNumThreads(GetParam());
+        A = MatrixTest::Random(size, size);
+        B = MatrixTest::Random(size, size);
+        x = VectorTest::Random(size);
+        v = VectorTest::Random(size).normalized();
+    }
+    void TearDown() override
+    {
+        ParallelKernels::SetNumThreads(1);
+    }
+    MatrixTest A;
+    MatrixTest B;
+    VectorTest x;
+    VectorTest v;
+    int size = 301;
+};
+
+// *****************
+// PARTITIONING TEST
+// *****************
+
+TEST(PartitionTest, BlocksCoverAllRows)
+{
+    int size = 1000;
+    int parts = 7;
+    int align = 16;
+    int previousEnd = 0;
+    for (int part = 0; part < parts; ++part)
+    {
+        int begin, end;
+        ParallelKernels::Partition(size, parts, align, part, begin, end);
+        EXPECT_EQ(begin, previousEnd); // Blocks are contiguous
+        if (end < size)
+        {
+            EXPECT_EQ(end % align, 0); // Inner boundaries are aligned
+        }
+        previousEnd = end;
+    }
+    EXPECT_EQ(previousEnd, size);
+}
+
+// ********************
+// PARALLEL KERNEL TESTS
+// ********************
+
+TEST_P(ParallelKernelsTest, MatVec)
+{
+    VectorTest y;
+    ParallelKernels::MatVec(A, x, y);
+    VectorTest expected = A * x;
+    EXPECT_TRUE(y.isApprox(expected, 1e-10));
+}
+
+TEST_P(ParallelKernelsTest, MatVecDots)
+{
+    VectorTest y;
+    type_test xDotY, yDotY;
+    type_test shift = 0.5;
+    ParallelKernels::MatVecDots<type_test>(A, x, shift, y, xDotY, yDotY);
+    VectorTest expected = A * x - shift * x;
+    EXPECT_TRUE(y.isApprox(expected, 1e-10));
+    EXPECT_NEAR(xDotY, x.dot(expected), 1e-9);
+    EXPECT_NEAR(yDotY, expected.squaredNorm(), 1e-9);
+}
+
+TEST_P(ParallelKernelsTest, MatMul)
+{
+    MatrixTest C;
+    ParallelKernels::MatMul(A, B, C);
+    MatrixTest expected = A * B;
+    EXPECT_TRUE(C.isApprox(expected, 1e-10));
+}
+
+// The entries are converted to the computation type: same result as the product with the rounded matrix
+TEST_P(ParallelKernelsTest, MatVecMixed)
+{
+    VectorTest y;
+    ParallelKernels::MatVecMixed<type_test, float>(A.cast<float>(), x, y);
+    VectorTest expected = A.cast<float>().cast<type_test>() * x;
+    EXPECT_TRUE(y.isApprox(expected, 1e-12));
+
+    Matrix<Eigen::half> halfA = A.cast<Eigen::half>();
+    ParallelKernels::MatVecMixed<type_test, Eigen::half>(halfA, x, y);
+    expected = halfA.cast<type_test>() * x;
+    EXPECT_TRUE(y.isApprox(expected, 1e-12));
+
+    Vector<float> floatY;
+    Matrix<Eigen::bfloat16> bfloatA = A.cast<Eigen::bfloat16>();
+    ParallelKernels::MatVecMixed<float, Eigen::bfloat16>(bfloatA, x.cast<float>(), floatY);
+    Vector<float> floatExpected = bfloatA.cast<float>() * x.cast<float>();
+    EXPECT_TRUE(floatY.isApprox(floatExpected, 1e-4f));
+}
+
+TEST_P(ParallelKernelsTest, MatMulInPlace)
+{
+    MatrixTest expected = A * B;
+    ParallelKernels::MatMulInPlace(A, B);
+    EXPECT_TRUE(A.isApprox(expected, 1e-10));
+}
+
+TEST_P(ParallelKernelsTest, ApplyReflectorLeft)
+{
+    MatrixTest expected = A - 2 * v * (v.transpose() * A);
+    ParallelKernels::ApplyReflectorLeft<type_test>(A, v);
+    EXPECT_TRUE(A.isApprox(expected, 1e-10));
+}
+
+TEST_P(ParallelKernelsTest, ApplyReflectorRight)
+{
+    MatrixTest expected = A - 2 * (A * v) * v.transpose();
+    ParallelKernels::ApplyReflectorRight<type_test>(A, v);
+    EXPECT_TRUE(A.isApprox(expected, 1e-10));
+}
+
+TEST_P(ParallelKernelsTest, SolveUpperTriangular)
+{
+    MatrixTest U = A.triangularView<Eigen::Upper>();
+    U.diagonal().array() += size; // Make the system well-conditioned
+    VectorTest b = x;
+    ParallelKernels::SolveUpperTriangular<type_test>(U, b);
+    EXPECT_TRUE((U * b).isApprox(x, 1e-10));
+}
+
+// Run all the kernel tests with 1, 2 and 4 threads
+INSTANTIATE_TEST_SUITE_P(Threads, ParallelKernelsTest, ::testing::Values(1, 2, 4));
+
+// *****************
+// SIMD KERNEL TESTS
+// *****************
+
+// Fixture class: runs the kernels with each instruction set supported by the processor
+// and compares them with the scalar reference. The sizes are not multiples of the vector
+// widths to test the last (partial) vectors.
+class SimdKernelsTest : public ::testing::TestWithParam<SimdKernels::Isa>
+{
+protected:
+    void SetUp() override
+    {
+        if (!SimdKernels::IsSupported(GetParam()))
+            GTEST_SKIP() << "instruction set not supported: " << SimdKernels::IsaName(GetParam());
+        SimdKernels::SetIsa(GetParam());
+    }
+    void TearDown() override
+    {
+        SimdKernels::SetIsa(SimdKernels::DetectIsa());
+    }
+    std::vector<int> sizes = {0, 1, 3, 7, 17, 33, 1001};
+};
+
+TEST_P(SimdKernelsTest, Dot)
+{
+    for (int n : sizes)
+    {
+        VectorTest x = VectorTest::Random(n);
+        VectorTest y = VectorTest::Random(n);
+        EXPECT_NEAR(SimdKernels::Dot<type_test>(x.data(), y.data(), n), x.dot(y), 1e-12 * n) << "n = " << n;
+
+        Eigen::VectorXf xf = x.cast<float>();
+        Eigen::VectorXf yf = y.cast<float>();
+        EXPECT_NEAR(SimdKernels::Dot<float>(xf.data(), yf.data(), n), xf.dot(yf), 1e-5 * n) << "n = " << n;
+    }
+}
+
+TEST_P(SimdKernelsTest, Axpy)
+{
+    for (int n : sizes)
+    {
+        VectorTest x = VectorTest::Random(n);
+        VectorTest y = VectorTest::Random(n);
+        VectorTest expected = y + 0.7 * x;
+        SimdKernels::Axpy<type_test>(0.7, x.data(), y.data(), n);
+        EXPECT_TRUE(y.isApprox(expected, 1e-14)) << "n = " << n;
+
+        Eigen::VectorXf xf = x.cast<float>();
+        Eigen::VectorXf yf = Eigen::VectorXf::Ones(n + 1); // The entry after the array must not change
+        SimdKernels::Axpy<float>(-2.0f, xf.data(), yf.data(), n);
+        EXPECT_TRUE(yf.head(n).isApprox((1.0f - 2.0f * xf.array()).matrix(), 1e-6f)) << "n = " << n;
+        EXPECT_EQ(yf(n), 1.0f);
+    }
+}
+
+TEST_P(SimdKernelsTest, Scale)
+{
+    for (int n : sizes)
+    {
+        VectorTest x = VectorTest::Random(n + 1);
+        VectorTest expected = x;
+        expected.head(n) *= -3.5;
+        SimdKernels::Scale<type_test>(-3.5, x.data(), n);
+        EXPECT_TRUE(x.isApprox(expected, 1e-15)) << "n = " << n;
+    }
+}
+
+TEST_P(SimdKernelsTest, AbsSum)
+{
+    for (int n : sizes)
+    {
+        VectorTest x = VectorTest::Random(n);
+        EXPECT_NEAR(SimdKernels::AbsSum<type_test>(x.data(), n), x.cwiseAbs().sum(), 1e-12 * n) << "n = " << n;
+
+        Eigen::VectorXf xf = x.cast<float>();
+        EXPECT_NEAR(SimdKernels::AbsSum<float>(xf.data(), n), xf.cwiseAbs().sum(), 1e-5 * n) << "n = " << n;
+    }
+}
+
+TEST_P(SimdKernelsTest, FmaLoop)
+{
+    // Each chain converges to b / (1 - a): the sum over the chains divided by their number is the same for every vector width
+    const long iterations = 1000;
+    double result;
+    long flops = SimdKernels::FmaLoop<double>(0.5, 1.0, iterations, result);
+    ASSERT_GT(flops, 0);
+    EXPECT_EQ(flops % (2 * iterations), 0);
+    EXPECT_NEAR(result / (flops / (2 * iterations)), 2.0, 1e-12);
+
+    float resultFloat;
+    long flopsFloat = SimdKernels::FmaLoop<float>(0.5f, 1.0f, iterations, resultFloat);
+    EXPECT_GE(flopsFloat, flops); // At least as many floats as doubles per register
+    EXPECT_NEAR(resultFloat / (flopsFloat / (2 * iterations)), 2.0f, 1e-5f);
+}
+
+TEST_P(SimdKernelsTest, Unaligned)
+{
+    // Arrays starting in the middle of a vector register
+    VectorTest x = VectorTest::Random(100);
+    VectorTest y = VectorTest::Random(100);
+    EXPECT_NEAR(SimdKernels::Dot<type_test>(x.data() + 1, y.data() + 3, 95), x.segment(1, 95).dot(y.segment(3, 95)), 1e-12);
+}
+
+INSTANTIATE_TEST_SUITE_P(Isas, SimdKernelsTest,
+                         ::testing::Values(SimdKernels::Isa::SCALAR, SimdKernels::Isa::AVX2,
+                                           SimdKernels::Isa::AVX512, SimdKernels::Isa::NEON),
+                         [](const ::testing::TestParamInfo<SimdKernels::Isa> &info)
+                         { return SimdKernels::IsaName(info.param); });
+
+TEST(SimdDispatchTest, Selection)
+{
+    EXPECT_TRUE(SimdKernels::IsSupported(SimdKernels::Isa::SCALAR));
+    EXPECT_TRUE(SimdKernels::IsSupported(SimdKernels::DetectIsa()));
+    EXPECT_EQ(SimdKernels::SupportedIsas().front(), SimdKernels::Isa::SCALAR);
+    EXPECT_EQ(SimdKernels::IsaFromName("avx512"), SimdKernels::Isa::AVX512);
+    EXPECT_THROW(SimdKernels::IsaFromName("sse9"), std::invalid_argument);
+    for (SimdKernels::Isa isa : {SimdKernels::Isa::AVX2, SimdKernels::Isa::AVX512, SimdKernels::Isa::NEON})
+    {
+        if (!SimdKernels::IsSupported(isa))
+        {
+            EXPECT_THROW(SimdKernels::SetIsa(isa), std::invalid_argument);
+        }
+    }
+}
+
+// ********************
+// TASK SCHEDULER TESTS
+// ********************
+
+// Fixture class: scheduler with several workers
+class TaskSchedulerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TaskScheduler::Instance().SetNumWorkers(4);
+    }
+    void TearDown() override
+    {
+        TaskScheduler::Instance().SetNumWorkers(1);
+    }
+};
+
+TEST_F(TaskSchedulerTest, ParallelForCoversRange)
+{
+    std::vector<int> visits(1000, 0);
+    TaskScheduler::Instance().ParallelFor(0, 1000, 7, [&](int begin, int end)
+                                          {
+        for (int i = begin; i < end; ++i)
+            ++visits[i]; });
+    for (int visit : visits)
+        EXPECT_EQ(visit, 1); // Each index is visited exactly once
+}
+
+TEST_F(TaskSchedulerTest, ParallelReduce)
+{
+    long sum = TaskScheduler::Instance().ParallelReduce(
+        0, 10000, 0, 0L, [](int begin, int end)
+        {
+            long partial = 0;
+            for (int i = begin; i < end; ++i)
+                partial += i;
+            return partial; },
+        [](long a, long b)
+        { return a + b; });
+    EXPECT_EQ(sum, 10000L * 9999L / 2);
+}
+
+TEST_F(TaskSchedulerTest, ParallelForPropagatesExceptions)
+{
+    EXPECT_THROW(TaskScheduler::Instance().ParallelFor(0, 100, 1, [](int begin, int end)
+                                                       {
+        if (begin == 42)
+            throw std::runtime_error("error in chunk"); }),
+                 std::runtime_error);
+}
+
+// A thread waiting for the chunks of a loop executes no other task: unrelated work (e.g. the solve of
+// another segment of a parameter sweep) never runs inside the wait of a kernel
+TEST_F(TaskSchedulerTest, WaitRunsOnlyOwnChunks)
+{
+    TaskScheduler &scheduler = TaskScheduler::Instance();
+    static thread_local bool waiting = false; // Whether this thread is inside the loop
+    std::atomic<bool> started(false);
+    std::atomic<int> nested(0);
+    waiting = true;
+    scheduler.ParallelFor(0, 2, 1, [&](int begin, int end)
+                          {
+        if (begin == 1) // Executed by another worker, while the calling thread waits for it
+        {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return;
+        }
+        while (!started)
+            std::this_thread::yield();
+        for (int i = 0; i < 64; ++i)
+            scheduler.Submit([&nested]()
+                             {
+                if (waiting)
+                    ++nested; }); });
+    waiting = false;
+    while (scheduler.RunPendingTask())
+        ;
+    EXPECT_EQ(nested, 0);
+}
+
+// The part p of a ParallelForParts runs on the same thread at each call (the calling thread for the parts of the
+// first worker), so that the memory pages first touched by a block of rows are later used by the same thread
+TEST_F(TaskSchedulerTest, PartsKeepTheirWorker)
+{
+    TaskScheduler &scheduler = TaskScheduler::Instance();
+    const int parts = 8; // Two parts per worker
+    std::vector<std::thread::id> first(parts);
+    scheduler.ParallelForParts(parts, [&](int part)
+                               { first[part] = std::this_thread::get_id(); });
+    EXPECT_EQ(first[0], std::this_thread::get_id());
+    EXPECT_EQ(first[4], first[0]);
+    for (int part = 1; part < 4; ++part)
+    {
+        EXPECT_NE(first[part], first[0]);
+        EXPECT_EQ(first[part + 4], first[part]);
+    }
+    for (int call = 0; call < 20; ++call)
+    {
+        std::vector<std::thread::id> threads(parts);
+        scheduler.ParallelForParts(parts, [&](int part)
+                                   { threads[part] = std::this_thread::get_id(); });
+        EXPECT_EQ(threads, first);
+    }
+}
+
+// Called from a task, the parts are shared: the workers they are pinned to may be waiting for the task
+TEST_F(TaskSchedulerTest, NestedPartsComplete)
+{
+    TaskScheduler &scheduler = TaskScheduler::Instance();
+    std::atomic<int> visits(0);
+    scheduler.ParallelFor(0, 8, 1, [&](int begin, int end)
+                          { scheduler.ParallelForParts(4, [&](int part)
+                                                       { ++visits; }); });
+    EXPECT_EQ(visits, 32);
+}
+
+TEST_F(TaskSchedulerTest, ParallelForPartsPropagatesExceptions)
+{
+    EXPECT_THROW(TaskScheduler::Instance().ParallelForParts(4, [](int part)
+                                                            {
+        if (part == 2)
+            throw std::runtime_error("error in part"); }),
+                 std::runtime_error);
+}
+
+TEST_F(TaskSchedulerTest, TaskGroupRespectsDependencies)
+{
+    // Diamond graph: first -> (left, right) -> last
+    std::atomic<int> counter(0);
+    int first = -1, left = -1, right = -1, last = -1;
+    TaskGroup group;
+    auto idFirst = group.Add([&]()
+                             { first = counter++; });
+    auto idLeft = group.Add([&]()
+                            { left = counter++; }, {idFirst});
+    auto idRight = group.Add([&]()
+                             { right = counter++; }, {idFirst});
+    group.Add([&]()
+              { last = counter++; }, {idLeft, idRight});
+    group.Wait();
+
+    EXPECT_EQ(first, 0);
+    EXPECT_GT(left, first);
+    EXPECT_GT(right, first);
+    EXPECT_EQ(last, 3);
+}
+
+TEST_F(TaskSchedulerTest, TaskGroupInvalidDependency)
+{
+    TaskGroup group;
+    EXPECT_THROW(group.Add([]() {}, {5}), std::invalid_argument); // Task 5 does not exist yet
+}
+
+TEST_F(TaskSchedulerTest, UtilizationCounters)
+{
+    TaskScheduler::Instance().ResetStats();
+    TaskScheduler::Instance().ParallelFor(0, 64, 1, [](int begin, int end) {});
+
+    auto stats = TaskScheduler::Instance().GetWorkerStats();
+    ASSERT_EQ(stats.size(), 4);
+    long executed = 0;
+    for (const auto &worker : stats)
+        executed += worker.tasksExecuted;
+    EXPECT_EQ(executed, 64); // One task per chunk
+}
+
+// *************
+// TRACING TESTS
+// *************
+
+TEST(TracerTest, SpansOnlyWhenEnabled)
+{
+    Tracer &tracer = Tracer::Instance();
+    tracer.Clear();
+    {
+        TraceSpan span("disabled", "test");
+    }
+    EXPECT_EQ(tracer.EventCount(), 0);
+
+    tracer.SetEnabled(true);
+    {
+        TraceSpan outer("outer", "test");
+        TraceSpan inner("inner", "test");
+        inner.End();
+        inner.End(); // Recorded once
+    }
+    tracer.SetEnabled(false);
+
+    // The inner span ends first, inside the outer one
+    const std::vector<Tracer::Event> &events = tracer.ThreadEvents();
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_STREQ(events[0].name, "inner");
+    EXPECT_STREQ(events[1].name, "outer");
+    EXPECT_GE(events[0].start, events[1].start);
+    EXPECT_LE(events[0].start + events[0].duration, events[1].start + events[1].duration);
+    tracer.Clear();
+}
+
+TEST_F(TaskSchedulerTest, TracerLanePerWorker)
+{
+    Tracer &tracer = Tracer::Instance();
+    tracer.Clear();
+    tracer.SetEnabled(true);
+    TaskScheduler::Instance().ParallelFor(0, 64, 1, [](int begin, int end)
+                                          {
+        TraceSpan span("chunk", "test");
+        std::this_thread::sleep_for(std::chrono::microseconds(500)); });
+    tracer.SetEnabled(false);
+    EXPECT_EQ(tracer.EventCount(), 2 * 64); // One span of the scheduler and one of the body per chunk
+
+    std::ostringstream trace;
+    tracer.WriteChromeTrace(trace);
+    const std::string json = trace.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [", 0), 0);
+    EXPECT_NE(json.find("\"args\": {\"name\": \"worker 1\"}"), std::string::npos); // Named lanes of the workers
+    EXPECT_NE(json.find("\"name\": \"chunk\", \"cat\": \"test\", \"ph\": \"X\""), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+    tracer.Clear();
+}
+
+TEST_F(TaskSchedulerTest, HardwareCountersRegions)
+{
+    HardwareCounters &counters = HardwareCounters::Instance();
+    counters.Reset();
+    {
+        CounterRegion region("disabled");
+    }
+    EXPECT_TRUE(counters.GetRegions().empty());
+
+    // Graceful no-op when the system provides no counter (e.g. perf_event_open not permitted)
+    if (!counters.Enable())
+        GTEST_SKIP() << "No hardware counter available";
+    std::vector<double> sums(64, 0.0);
+    {
+        CounterRegion region("parallel work");
+        TaskScheduler::Instance().ParallelFor(0, 64, 1, [&sums](int begin, int end)
+                                              {
+            for (int i = begin; i < end; ++i)
+                for (int k = 1; k < 200000; ++k)
+                    sums[i] += 1.0 / k; });
+        region.End();
+        region.End(); // Measured once
+    }
+    counters.Disable();
+
+    std::map<std::string, HardwareCounters::Region> regions = counters.GetRegions();
+    ASSERT_EQ(regions.size(), 1);
+    const HardwareCounters::Region &region = regions["parallel work"];
+    EXPECT_EQ(region.calls, 1);
+    EXPECT_GT(region.seconds, 0.0);
+    for (int counter = 0; counter < HardwareCounters::NUM_COUNTERS; ++counter)
+        EXPECT_GE(region.counts[counter], 0.0);
+    EXPECT_GT(region.counts[HardwareCounters::CPU_TIME] + region.counts[HardwareCounters::INSTRUCTIONS], 0.0);
+    EXPECT_GT(sums[63], 0.0);
+    counters.Reset();
+}
+
+TEST_F(TaskSchedulerTest, RooflineAccounting)
+{
+    Roofline &roofline = Roofline::Instance();
+    roofline.Reset();
+    MatrixTest A = MatrixTest::Random(300, 200);
+    VectorTest x = VectorTest::Random(200);
+    VectorTest y;
+    ParallelKernels::MatVec(A, x, y);
+    EXPECT_TRUE(roofline.GetKernels().empty()); // Disabled by default
+
+    roofline.SetEnabled(true);
+    ParallelKernels::MatVec(A, x, y);
+    ParallelKernels::MatVec(A, x, y);
+    {
+        RooflineRegion outer("outer", 1.0, 1.0);
+        ParallelKernels::MatVec(A, x, y); // Nested: counted in the outer region only
+        outer.End();
+        outer.End(); // Counted once
+    }
+    roofline.SetEnabled(false);
+
+    std::map<std::string, Roofline::Kernel> kernels = roofline.GetKernels();
+    ASSERT_EQ(kernels.size(), 2);
+    const Roofline::Kernel &matvec = kernels["matvec"];
+    EXPECT_EQ(matvec.calls, 2);
+    EXPECT_DOUBLE_EQ(matvec.flops, 2 * 2.0 * 300 * 200);
+    EXPECT_DOUBLE_EQ(matvec.bytes, 2 * sizeof(type_test) * (300.0 * 200 + 300 + 200));
+    EXPECT_GT(matvec.seconds, 0.0);
+    EXPECT_EQ(kernels["outer"].calls, 1);
+    EXPECT_DOUBLE_EQ(kernels["outer"].flops, 1.0);
+
+    Roofline::Peak peak = Roofline::MeasurePeak<type_test>();
+    EXPECT_EQ(peak.threads, ParallelKernels::GetNumThreads());
+    EXPECT_GT(peak.flops, 0.0);
+    EXPECT_GT(peak.bandwidth, 0.0);
+    roofline.Reset();
+}
@@ -106,6 +106,57 @@ TEST_F(MatrixGeneratorFromFunctionTest, GenerateHilbertMatrix)
     EXPECT_TRUE(matrix->isApprox(expected, 1e-5)); // Compare matrices with a tolerance
 }
 
+TEST_F(MatrixGeneratorFromFunctionTest, GenerateHilbertRowBlock)
+{
+    initialize("hilbert", 5, 5);
+    auto matrix = generator->GenerateMatrix();
+    auto block = generator->GenerateRowBlock(2, 4);
+
+    ASSERT_TRUE(block != nullptr);
+    EXPECT_EQ(block->rows(), 2);
+    EXPECT_EQ(block->cols(), 5);
+    EXPECT_TRUE(block->isApprox(matrix->middleRows(2, 2), 1e-12)); // Same rows as the whole matrix
+}
+
+TEST_F(MatrixGeneratorFromFunctionTest, GenerateLaplacianMatrix)
+{
+    initialize("laplacian", 4, 4);
+    auto matrix = generator->GenerateMatrix();
+
+    // Define the expected matrix
+    Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic> expected(4, 4);
+    expected << 2.0, -1.0, 0.0, 0.0,
+        -1.0, 2.0, -1.0, 0.0,
+        0.0, -1.0, 2.0, -1.0,
+        0.0, 0.0, -1.0, 2.0;
+
+    ASSERT_TRUE(matrix != nullptr);
+    EXPECT_TRUE(matrix->isApprox(expected, 1e-12));
+}
+
+TEST_F(MatrixGeneratorFromFunctionTest, GenerateRandomMatrices)
+{
+    initialize("random_symmetric", 50, 50);
+    auto symmetric = generator->GenerateMatrix();
+    auto block = generator->GenerateRowBlock(10, 20);
+    EXPECT_TRUE(symmetric->isApprox(symmetric->transpose(), 1e-15));
+    EXPECT_TRUE(block->isApprox(symmetric->middleRows(10, 10), 1e-15)); // The same entries in any order of generation
+    EXPECT_LE(symmetric->cwiseAbs().maxCoeff(), 1.0);
+    EXPECT_NEAR(symmetric->mean(), 0.0, 0.05); // Uniform in [-1, 1)
+
+    initialize("random", 50, 50);
+    auto random = generator->GenerateMatrix();
+    EXPECT_FALSE(random->isApprox(random->transpose(), 1e-2));
+    EXPECT_TRUE(random->isApprox(*generator->GenerateMatrix(), 1e-15)); // Fixed seed
+    EXPECT_EQ(random->triangularView<Eigen::Upper>().toDenseMatrix(), symmetric->triangularView<Eigen::Upper>().toDenseMatrix());
+}
+
+TEST_F(MatrixGeneratorFromFunctionTest, GenerateInvalidRowBlock)
+{
+    initialize("hilbert", 5, 5);
+    EXPECT_THROW(generator->GenerateRowBlock(3, 6), std::invalid_argument);
+}
+
 // ********************************
 // GENETATE MATRICES FROM TXT FILES
 // ********************************
@@ -272,6 +323,26 @@ TEST_F(MatrixGeneratorFromFileMtxTest, MtxFile)
     EXPECT_TRUE(matrix->isApprox(expected, 1e-5)); // Compare matrices with a tolerance
 }
 
+TEST_F(MatrixGeneratorFromFileMtxTest, MtxRowBlock)
+{
+    FileReaderMTX<type_test> fileReader("B.mtx");
+    size_t numRows;
+    size_t numCols;
+    fileReader.ReadDimensions(numRows, numCols);
+    EXPECT_EQ(numRows, 3);
+    EXPECT_EQ(numCols, 3);
+
+    // Only the entries of the second and third rows are kept
+    auto block = fileReader.ReadRowBlock(1, 3);
+    Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic> expected(2, 3);
+    expected << 0.0, 2.5, 0.0,
+        0.0, 0.0, 3.5;
+
+    ASSERT_TRUE(block != nullptr);
+    EXPECT_TRUE(block->isApprox(expected, 1e-5));
+    EXPECT_THROW(fileReader.ReadRowBlock(2, 4), FileException);
+}
+
 TEST_F(MatrixGeneratorFromFileMtxTest, MtxFileEmpty)
 {
     // Create a temporary empty file
@@ -301,6 +372,36 @@ TEST_F(MatrixGeneratorFromFileMtxTest, MtxFileInvalid)
     std::remove(("../input/matrices/" + invalidFile).c_str()); // Clean up the temporary file
 }
 
+TEST_F(MatrixGeneratorFromFileMtxTest, MtxFileDuplicateEntries)
+{
+    // Repeated entries spread over the whole file: the last one must be kept
+    const std::string duplicateFile = "duplicate_entries.mtx";
+    const int repeats = 5000;
+    std::ofstream tempFile("../input/matrices/" + duplicateFile);
+    tempFile << "% every entry of a 4x4 matrix, repeated\n"
+                "4 4 " << 16 * repeats << "\n";
+    for (int r = 0; r < repeats; ++r)
+    {
+        for (int k = 0; k < 16; ++k)
+        {
+            tempFile << k % 4 + 1 << " " << k / 4 + 1 << " " << r * 16 + k << "\n";
+        }
+    }
+    tempFile.close();
+    initialize(duplicateFile);
+
+    Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic> expected(4, 4);
+    for (int k = 0; k < 16; ++k)
+    {
+        expected(k % 4, k / 4) = static_cast<type_test>((repeats - 1) * 16 + k);
+    }
+    auto matrix = generator->GenerateMatrix();
+    ASSERT_TRUE(matrix != nullptr);
+    EXPECT_EQ(*matrix, expected);
+
+    std::remove(("../input/matrices/" + duplicateFile).c_str()); // Clean up the temporary file
+}
+
 TEST_F(MatrixGeneratorFromFileMtxTest, MtxNoFile)
 {
     initialize("invalid_file.mtx");
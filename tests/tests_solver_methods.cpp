@@ -5,10 +5,24 @@
 #include "PowerMethodSolver.hpp"
 #include "InversePowerMethodSolver.hpp"
 #include "QrMethodSolver.hpp"
+#include "LanczosSolver.hpp"
+#include "JacobiSolver.hpp"
+#include "TaskScheduler.hpp"
+#include "OutOfCoreOperator.hpp"
+#include "MatrixGeneratorFromFunction.hpp"
+#include "FileReader.hpp"
+#include "DenseOperator.hpp"
+#include "MemoryReport.hpp"
+#include "MixedPrecisionOperator.hpp"
+#include "ParameterSweep.hpp"
+#include "BatchSolver.hpp"
+#include "FixedSizeSolver.hpp"
+#include "SimdKernels.hpp"
 #include <iostream>
 #include <Eigen/Dense>
 #include <fstream>
 #include <numeric>
+#include <sstream>
 
 using type_test = double;                                                    // Choose float or double: enable to avoid redundent testing
 using MatrixTest = Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic>; // For readability
@@ -134,6 +148,17 @@ TEST_F(IdentityMatrixTest, QrMethod)
     EXPECT_TRUE(eigenvalues.isApprox(expectedEigenvalues, 1e-6));
 };
 
+TEST_F(IdentityMatrixTest, LanczosMethod)
+{
+    LanczosSolver<type_test> solver = LanczosSolver<type_test>(tolerance, maxIter);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    // The Krylov space is invariant after one iteration
+    ASSERT_EQ(eigenvalues.size(), 1);
+    ASSERT_NEAR(eigenvalues(0), 1.0, 1e-6);
+};
+
 // **********************
 // DIAGONAL MATRIX TESTS
 // **********************
@@ -206,6 +231,18 @@ TEST_F(DiagonalMatrixTest, QrMethod)
     EXPECT_TRUE(eigenvalues.isApprox(expectedEigenvalues, 1e-6));
 };
 
+TEST_F(DiagonalMatrixTest, LanczosMethod)
+{
+    LanczosSolver<type_test> solver = LanczosSolver<type_test>(tolerance, maxIter);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    // The extreme eigenvalues are always among the converged ones
+    ASSERT_GE(eigenvalues.size(), 2);
+    ASSERT_NEAR(eigenvalues(0), size, 1e-6);
+    ASSERT_NEAR(eigenvalues(eigenvalues.size() - 1), 1.0, 1e-6);
+};
+
 // ********************
 // HILBERT MATRIX TESTS
 // ********************
@@ -282,6 +319,30 @@ TEST_F(LargeHilbertMatrixTest, QrMethod)
     EXPECT_TRUE(eigenvalues.isApprox(expectedEigenvalues, 1e-6));
 };
 
+TEST_F(HilbertMatrixTest, LanczosMethod)
+{
+    LanczosSolver<type_test> solver = LanczosSolver<type_test>(tolerance, maxIter);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    // The Krylov space spans the whole space after 5 iterations: all the eigenvalues are found
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic>> eigenSolver(*matrix);
+    VectorTest expectedEigenvalues = eigenSolver.eigenvalues().reverse();
+    ASSERT_EQ(eigenvalues.size(), size);
+    EXPECT_TRUE((eigenvalues - expectedEigenvalues).cwiseAbs().maxCoeff() < 1e-10);
+};
+
+TEST_F(LargeHilbertMatrixTest, LanczosMethod)
+{
+    LanczosSolver<type_test> solver = LanczosSolver<type_test>(tolerance, maxIter);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    Eigen::EigenSolver<Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic>> eigenSolver(*matrix);
+    type_test expectedEigenvalue = eigenSolver.eigenvalues().real().maxCoeff();
+    ASSERT_NEAR(eigenvalues(0), expectedEigenvalue, 1e-6);
+};
+
 // *****************************
 // QR decomposition method tests
 // *****************************
@@ -375,4 +436,1226 @@ TEST_F(DiagonalMatrixTest, QrDecomposition)
     // Test the QR = *diagonal
     MatrixTest reconstructedDiagonal = Q * R;
     EXPECT_TRUE(reconstructedDiagonal.isApprox(*matrix, 1e-6));
-}
\ No newline at end of file
+}
+// ***********************************
+// Tiled QR decomposition method tests
+// ***********************************
+
+// Fixture class: random matrix split in tiles, the last ones being smaller, decomposed by several workers
+class TiledQrTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TaskScheduler::Instance().SetNumWorkers(4);
+        matrix = std::make_shared<MatrixTest>(MatrixTest::Random(size, size));
+    }
+    void TearDown() override
+    {
+        TaskScheduler::Instance().SetNumWorkers(1);
+    }
+    std::shared_ptr<Matrix<type_test>> matrix;
+    int maxIter = 1000;
+    double tolerance = 1e-10;
+    int size = 100;
+    int tileSize = 16;
+};
+
+TEST_F(TiledQrTest, QrDecomposition)
+{
+    MatrixTest Q(size, size);
+    MatrixTest R(size, size);
+
+    QrMethodSolver<type_test> solver = QrMethodSolver<type_test>(tolerance, maxIter);
+    solver.SetTileSize(tileSize);
+    solver.TiledQrDecomposition(*matrix, Q, R);
+
+    // Test that R is upper triangular
+    EXPECT_TRUE(IsUpperTriangular(R, size, 1e-12));
+
+    // Test that Q is orthogonal
+    MatrixTest identity = Q.transpose() * Q;
+    EXPECT_TRUE(identity.isApprox(MatrixTest::Identity(size, size), 1e-10));
+
+    // Test the QR = *matrix
+    MatrixTest reconstructed = Q * R;
+    EXPECT_TRUE(reconstructed.isApprox(*matrix, 1e-10));
+}
+
+TEST_F(TiledQrTest, InvalidTileSize)
+{
+    QrMethodSolver<type_test> solver = QrMethodSolver<type_test>(tolerance, maxIter);
+    EXPECT_THROW(solver.SetTileSize(0), std::invalid_argument);
+}
+
+TEST_F(LargeHilbertMatrixTest, TiledQrMethod)
+{
+    // Tiles of size 8: the 20 x 20 matrix is decomposed with the tiled algorithm
+    QrMethodSolver<type_test> solver = QrMethodSolver<type_test>(tolerance, maxIter);
+    solver.SetTileSize(8);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    Eigen::EigenSolver<Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic>> eigenSolver(*matrix);
+    VectorTest expectedEigenvalues = eigenSolver.eigenvalues().real();
+    EXPECT_TRUE(eigenvalues.isApprox(expectedEigenvalues, 1e-6));
+};
+
+// *****************
+// OUT-OF-CORE TESTS
+// *****************
+
+// Fixture class: Hilbert matrix written in a tiled file, the last tiles being smaller
+class OutOfCoreTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        MatrixGeneratorFromFunction<type_test> generator(std::make_unique<FunctionManager<type_test>>("hilbert"), size, size);
+        matrix = generator.GenerateMatrix();
+        OutOfCoreOperator<type_test>::WriteTiledFile(fileName, size, tileSize, [&](int first, int last)
+                                                     { return generator.GenerateRowBlock(first, last); });
+    }
+    void TearDown() override
+    {
+        std::remove(("../input/matrices/" + fileName).c_str()); // Clean up the temporary file
+    }
+    std::shared_ptr<Matrix<type_test>> matrix;
+    std::string fileName = "hilbert_test.tiled";
+    int maxIter = 1000;
+    double tolerance = 1e-10;
+    double shift = 0.0;
+    int size = 50;
+    int tileSize = 16;
+};
+
+TEST_F(OutOfCoreTest, MatVec)
+{
+    OutOfCoreOperator<type_test> outOfCoreOperator(fileName);
+    VectorTest x = VectorTest::LinSpaced(size, 1.0, size);
+    VectorTest y;
+    for (int repetition = 0; repetition < 2; ++repetition) // The second product uses the prefetched first panel
+    {
+        outOfCoreOperator.Apply(x, y);
+        EXPECT_TRUE(y.isApprox(*matrix * x, 1e-12));
+    }
+
+    // The whole matrix is read once per product
+    auto stats = outOfCoreOperator.GetIoStats();
+    EXPECT_EQ(stats.products, 2);
+    EXPECT_EQ(stats.bytesRead, 2 * size * size * sizeof(type_test));
+}
+
+TEST_F(OutOfCoreTest, PowerMethod)
+{
+    PowerMethodSolver<type_test> solver = PowerMethodSolver<type_test>(tolerance, maxIter, shift);
+    solver.SetOperator(std::make_shared<OutOfCoreOperator<type_test>>(fileName));
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    // Same result as with the matrix in memory
+    PowerMethodSolver<type_test> inMemorySolver = PowerMethodSolver<type_test>(tolerance, maxIter, shift);
+    inMemorySolver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = inMemorySolver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), expectedEigenvalues(0), 1e-10);
+}
+
+TEST_F(OutOfCoreTest, LanczosMethod)
+{
+    LanczosSolver<type_test> solver = LanczosSolver<type_test>(tolerance, maxIter);
+    solver.SetOperator(std::make_shared<OutOfCoreOperator<type_test>>(fileName));
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    Eigen::SelfAdjointEigenSolver<MatrixTest> eigenSolver(*matrix);
+    ASSERT_NEAR(eigenvalues(0), eigenSolver.eigenvalues().maxCoeff(), 1e-8);
+}
+
+TEST_F(OutOfCoreTest, InvalidFiles)
+{
+    EXPECT_THROW(OutOfCoreOperator<float>{fileName}, FileException); // Entries stored in double precision
+    EXPECT_THROW(OutOfCoreOperator<type_test>{"missing.tiled"}, FileException);
+}
+
+// *********************************
+// ACCELERATED POWER METHOD TESTS
+// *********************************
+
+// Fixture class: symmetric matrix whose two dominant eigenvalues are close (ratio 0.98), the others in [0, 0.9]
+class NearlyDegenerateMatrixTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        VectorTest spectrum = VectorTest::LinSpaced(size, 0.0, 0.9);
+        spectrum(size - 2) = 0.98;
+        spectrum(size - 1) = 1.0;
+        std::srand(42);
+        MatrixTest Q = Eigen::HouseholderQR<MatrixTest>(MatrixTest::Random(size, size)).householderQ();
+        matrix = std::make_shared<MatrixTest>(Q * spectrum.asDiagonal() * Q.transpose());
+    }
+    int PlainIterations()
+    {
+        PowerMethodSolver<type_test> solver(tolerance, maxIter, shift);
+        solver.SetMatrix(matrix);
+        solver.FindEigenvalues();
+        return solver.GetReport().iterations;
+    }
+    std::shared_ptr<Matrix<type_test>> matrix;
+    int maxIter = 5000;
+    double tolerance = 1e-10;
+    double shift = 0.0;
+    int size = 100;
+};
+
+TEST_F(NearlyDegenerateMatrixTest, ChebyshevAcceleration)
+{
+    PowerMethodSolver<type_test> solver(tolerance, maxIter, shift, "chebyshev");
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), 1.0, 1e-8);
+
+    const SolverReport &report = solver.GetReport();
+    EXPECT_TRUE(report.converged);
+    EXPECT_EQ(report.acceleration, "chebyshev");
+    EXPECT_LT(report.iterations + report.extraProducts, PlainIterations() / 3);
+    EXPECT_GT(report.iterationsSaved, 0);
+    EXPECT_GT(report.convergenceRate, 0.0);
+    EXPECT_LT(report.convergenceRate, 0.98 * 0.98);
+}
+
+// Only the operator is known: the bounds come from the Lanczos run alone
+TEST_F(NearlyDegenerateMatrixTest, ChebyshevAccelerationOperator)
+{
+    PowerMethodSolver<type_test> solver(tolerance, maxIter, shift, "chebyshev");
+    solver.SetOperator(std::make_shared<DenseOperator<type_test>>(matrix));
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), 1.0, 1e-8);
+    EXPECT_LT(solver.GetReport().iterations, PlainIterations() / 3);
+}
+
+// An operator replaces the matrix set before: the bounds must not come from the previous matrix
+TEST_F(NearlyDegenerateMatrixTest, OperatorReplacesMatrix)
+{
+    PowerMethodSolver<type_test> solver(tolerance, maxIter, shift, "chebyshev");
+    solver.SetMatrix(matrix);
+    solver.SetOperator(std::make_shared<DenseOperator<type_test>>(matrix)); // Same matrix: still known
+    EXPECT_TRUE(solver.HasMatrix());
+    solver.SetOperator(std::make_shared<DenseOperator<type_test>>(std::make_shared<MatrixTest>(2.0 * *matrix)));
+    EXPECT_FALSE(solver.HasMatrix());
+    EXPECT_THROW(solver.GetMatrix(), std::runtime_error);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), 2.0, 2e-8);
+}
+
+TEST_F(NearlyDegenerateMatrixTest, AitkenAcceleration)
+{
+    PowerMethodSolver<type_test> solver(tolerance, maxIter, shift, "aitken");
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), 1.0, 1e-8);
+
+    const SolverReport &report = solver.GetReport();
+    EXPECT_TRUE(report.converged);
+    EXPECT_EQ(report.acceleration, "aitken");
+    EXPECT_LT(report.iterations, PlainIterations());
+    EXPECT_NEAR(report.convergenceRate, 0.98 * 0.98, 1e-2);
+}
+
+// With a big shift, the wanted eigenvalue is the smallest one
+TEST_F(DiagonalMatrixTest, PowerMethodChebyshevBigShift)
+{
+    PowerMethodSolver<type_test> solver(tolerance, maxIter, size + 1, "chebyshev");
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), 1.0, 1e-6);
+}
+
+// All the eigenvalues are equal: nothing to damp, the plain iteration is used
+TEST_F(IdentityMatrixTest, PowerMethodChebyshev)
+{
+    PowerMethodSolver<type_test> solver(tolerance, maxIter, shift, "chebyshev");
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), 1.0, 1e-10);
+    EXPECT_EQ(solver.GetReport().acceleration, "none");
+}
+
+TEST_F(IdentityMatrixTest, InvalidAcceleration)
+{
+    EXPECT_THROW(PowerMethodSolver<type_test>(tolerance, maxIter, shift, "richardson"), std::invalid_argument);
+}
+
+// ****************
+// IN-PLACE SOLVES
+// ****************
+
+// The solver overwrites the matrix handed over with TakeMatrix: same results as with a copy
+TEST_F(LargeHilbertMatrixTest, QrMethodInPlace)
+{
+    QrMethodSolver<type_test> solver(tolerance, maxIter);
+    solver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = solver.FindEigenvalues();
+
+    solver.TakeMatrix(std::make_shared<MatrixTest>(*matrix));
+    EXPECT_TRUE(solver.OwnsMatrix());
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    EXPECT_TRUE(eigenvalues.isApprox(expectedEigenvalues, 1e-10));
+
+    // The matrix was consumed by the solve
+    EXPECT_FALSE(solver.OwnsMatrix());
+    EXPECT_FALSE(solver.HasMatrix());
+    EXPECT_THROW(solver.FindEigenvalues(), std::runtime_error);
+}
+
+TEST_F(TiledQrTest, QrMethodInPlace)
+{
+    // Symmetric matrix decomposed with the tiled algorithm by several workers
+    // (a few iterations: the results are compared after the same number of iterations)
+    *matrix = *matrix + matrix->transpose().eval();
+    QrMethodSolver<type_test> solver(tolerance, 20);
+    solver.SetTileSize(tileSize);
+    solver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = solver.FindEigenvalues();
+
+    solver.TakeMatrix(std::make_shared<MatrixTest>(*matrix));
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    EXPECT_TRUE(eigenvalues.isApprox(expectedEigenvalues, 1e-8));
+}
+
+TEST_F(DiagonalMatrixTest, InversePowerMethodShiftInPlace)
+{
+    InversePowerMethodSolver<type_test> solver(tolerance, maxIter, 2.2);
+    solver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = solver.FindEigenvalues();
+
+    solver.TakeMatrix(std::make_shared<MatrixTest>(*matrix));
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), 2.0, 1e-6);
+    EXPECT_NEAR(eigenvalues(0), expectedEigenvalues(0), 1e-10);
+    EXPECT_FALSE(solver.HasMatrix());
+}
+
+TEST_F(HilbertMatrixTest, InversePowerMethodInPlace)
+{
+    InversePowerMethodSolver<type_test> solver(tolerance, maxIter, shift);
+    solver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = solver.FindEigenvalues();
+
+    solver.TakeMatrix(std::make_shared<MatrixTest>(*matrix));
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    EXPECT_NEAR(eigenvalues(0), expectedEigenvalues(0), 1e-6 * std::abs(expectedEigenvalues(0)));
+}
+
+// A matrix still used elsewhere can not be overwritten
+TEST_F(HilbertMatrixTest, TakeSharedMatrix)
+{
+    QrMethodSolver<type_test> solver(tolerance, maxIter);
+    std::shared_ptr<Matrix<type_test>> shared = matrix;
+    EXPECT_THROW(solver.TakeMatrix(std::move(shared)), std::invalid_argument);
+    EXPECT_FALSE(solver.OwnsMatrix());
+    EXPECT_THROW(solver.TakeMatrix(nullptr), std::runtime_error);
+
+    // SetMatrix keeps the matrix of the caller intact
+    solver.SetMatrix(matrix);
+    EXPECT_FALSE(solver.OwnsMatrix());
+}
+
+TEST(MemoryReportTest, Phases)
+{
+    MemoryReport report;
+    report.StartPhase("allocation");
+    std::vector<char> buffer(64 << 20, 1); // 64 MB, touched
+    report.StartPhase("release");
+    buffer = std::vector<char>();
+    report.EndPhase();
+    report.EndPhase(); // Nothing to end
+
+    const std::vector<MemoryReport::Phase> &phases = report.GetPhases();
+    ASSERT_EQ(phases.size(), 2);
+    EXPECT_EQ(phases[0].name, "allocation");
+    if (MemoryReport::ResidentBytes() == 0)
+        GTEST_SKIP() << "/proc/self/status is not available";
+    EXPECT_GE(phases[0].peakBytes, phases[0].startBytes + (64 << 20) - (1 << 20));
+    EXPECT_GE(phases[0].peakBytes, phases[0].endBytes);
+    EXPECT_LT(phases[1].endBytes, phases[1].startBytes);
+}
+
+// ****************************
+// REDUCED-PRECISION STORAGE
+// ****************************
+
+// The entries of the diagonal matrix (integers up to 20) are exact in all the storage types
+TEST_F(DiagonalMatrixTest, PowerMethodReducedStorage)
+{
+    for (const std::string storage : {"float", "bfloat16", "half"})
+    {
+        PowerMethodSolver<type_test> solver(tolerance, maxIter, shift);
+        solver.SetOperator(CreateStorageOperator<type_test>(matrix, storage));
+        VectorTest eigenvalues = solver.FindEigenvalues();
+        ASSERT_NEAR(eigenvalues(0), 20.0, 1e-6) << "storage: " << storage;
+    }
+}
+
+// The error on the eigenvalues is of the order of the rounding of the entries
+TEST_F(LargeHilbertMatrixTest, LanczosMethodReducedStorage)
+{
+    Eigen::SelfAdjointEigenSolver<MatrixTest> eigenSolver(*matrix);
+    type_test largest = eigenSolver.eigenvalues().maxCoeff();
+    for (const auto &[storage, roundoff] : std::vector<std::pair<std::string, double>>{{"float", 6e-8}, {"half", 5e-4}, {"bfloat16", 4e-3}})
+    {
+        LanczosSolver<type_test> solver(tolerance, maxIter);
+        solver.SetOperator(CreateStorageOperator<type_test>(matrix, storage));
+        VectorTest eigenvalues = solver.FindEigenvalues();
+        EXPECT_NEAR(eigenvalues.maxCoeff(), largest, roundoff * largest) << "storage: " << storage;
+    }
+}
+
+TEST_F(HilbertMatrixTest, StorageOperator)
+{
+    // Full precision: the matrix is used as is
+    std::shared_ptr<LinearOperator<type_test>> fullOperator = CreateStorageOperator<type_test>(matrix, "full");
+    EXPECT_NE(std::dynamic_pointer_cast<DenseOperator<type_test>>(fullOperator), nullptr);
+    EXPECT_THROW(CreateStorageOperator<type_test>(matrix, "int8"), std::invalid_argument);
+
+    // The converted matrix does not depend on the full-precision one anymore
+    std::shared_ptr<LinearOperator<type_test>> halfOperator = CreateStorageOperator<type_test>(matrix, "half");
+    EXPECT_EQ(matrix.use_count(), 2);
+    EXPECT_EQ(halfOperator->GetSize(), size);
+    EXPECT_EQ(StorageBytes("half", sizeof(type_test)), 2);
+    EXPECT_EQ(StorageBytes("float", sizeof(float)), 4);
+    EXPECT_EQ(StorageBytes("full", sizeof(type_test)), 8);
+}
+
+// ******************************************
+// MIXED-PRECISION INVERSE POWER METHOD TESTS
+// ******************************************
+
+// The float factorization with iterative refinement gives the accuracy of the double one
+TEST_F(DiagonalMatrixTest, InversePowerMethodMixed)
+{
+    InversePowerMethodSolver<type_test> fullSolver(tolerance, maxIter, 2.2);
+    fullSolver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = fullSolver.FindEigenvalues();
+
+    InversePowerMethodSolver<type_test> solver(tolerance, maxIter, 2.2, "mixed");
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), 2.0, 1e-10);
+    EXPECT_NEAR(eigenvalues(0), expectedEigenvalues(0), 1e-12);
+    EXPECT_EQ(solver.GetReport().factorization, "mixed");
+    EXPECT_GT(solver.GetReport().refinementSteps, 0);
+    EXPECT_LE(solver.GetReport().refinementSteps, solver.GetReport().iterations * DefaultSolverArgs::MAX_REFINEMENT_STEPS);
+}
+
+TEST_F(HilbertMatrixTest, InversePowerMethodMixed)
+{
+    // Condition number of about 5e5: the refinement converges, a little slower
+    InversePowerMethodSolver<type_test> fullSolver(tolerance, maxIter, shift);
+    fullSolver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = fullSolver.FindEigenvalues();
+
+    InversePowerMethodSolver<type_test> solver(tolerance, maxIter, shift, "mixed");
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    EXPECT_NEAR(eigenvalues(0), expectedEigenvalues(0), 1e-10 * std::abs(expectedEigenvalues(0)));
+    EXPECT_EQ(solver.GetReport().factorization, "mixed");
+}
+
+// Shift too close to an eigenvalue for a float factorization: the solver falls back to double
+TEST_F(DiagonalMatrixTest, InversePowerMethodMixedFallback)
+{
+    InversePowerMethodSolver<type_test> solver(tolerance, maxIter, 2.0 + 2e-6, "mixed");
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), 2.0, 1e-10);
+    EXPECT_EQ(solver.GetReport().factorization, "mixed, fell back to full");
+}
+
+TEST_F(DiagonalMatrixTest, InversePowerMethodMixedInPlace)
+{
+    InversePowerMethodSolver<type_test> solver(tolerance, maxIter, 2.2, "mixed");
+    solver.TakeMatrix(std::make_shared<MatrixTest>(*matrix));
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    ASSERT_NEAR(eigenvalues(0), 2.0, 1e-10);
+    EXPECT_FALSE(solver.HasMatrix());
+}
+
+TEST_F(IdentityMatrixTest, InvalidFactorization)
+{
+    EXPECT_THROW(InversePowerMethodSolver<type_test>(1e-6, 100, shift, "half"), std::invalid_argument);
+}
+
+// ***********************
+// CONVERGENCE CHECK TESTS
+// ***********************
+
+// Fixture class: symmetric tridiagonal matrix (second difference), eigenvalues 2 - 2 cos(k pi / (n + 1))
+class TridiagonalMatrixTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        matrix = std::make_shared<MatrixTest>(MatrixTest::Zero(size, size));
+        for (int i = 0; i < size; ++i)
+        {
+            (*matrix)(i, i) = 2.0;
+            if (i + 1 < size)
+                (*matrix)(i, i + 1) = (*matrix)(i + 1, i) = -1.0;
+        }
+        expectedEigenvalues.resize(size);
+        for (int k = 0; k < size; ++k)
+            expectedEigenvalues(k) = 2.0 - 2.0 * std::cos((k + 1) * M_PI / (size + 1));
+    }
+    std::shared_ptr<Matrix<type_test>> matrix;
+    VectorTest expectedEigenvalues; // In increasing order
+    int maxIter = 5000;
+    double tolerance = 1e-10;
+    int size = 24;
+};
+
+TEST(ConvergenceMonitorTest, LowerPartSums)
+{
+    MatrixTest A = MatrixTest::Random(7, 7);
+    type_test expected = 0.0;
+    for (int i = 1; i < 7; ++i)
+        for (int j = 0; j < i; ++j)
+            expected += std::abs(A(i, j));
+    EXPECT_NEAR(ConvergenceMonitor<type_test>::LowerTriangleSum(A), expected, 1e-12);
+    EXPECT_NEAR(ConvergenceMonitor<type_test>::SubdiagonalSum(A), A.diagonal(-1).cwiseAbs().sum(), 1e-12);
+
+    EXPECT_FALSE(ConvergenceMonitor<type_test>::IsHessenberg(A));
+    MatrixTest hessenberg = A.triangularView<Eigen::Upper>();
+    hessenberg.diagonal(-1) = A.diagonal(-1);
+    EXPECT_TRUE(ConvergenceMonitor<type_test>::IsHessenberg(hessenberg));
+}
+
+TEST(ConvergenceMonitorTest, Checks)
+{
+    ConvergenceMonitor<type_test> monitor(1e-6, "residual", 3);
+    EXPECT_FALSE(monitor.Converged()); // No check yet
+    EXPECT_TRUE(monitor.IsCheckDue(6));
+    EXPECT_FALSE(monitor.IsCheckDue(7));
+    EXPECT_FALSE(monitor.CheckChange(1.1, 1.0));
+    EXPECT_TRUE(monitor.CheckChange(1.0 + 1e-8, 1.0));
+    EXPECT_EQ(monitor.GetChecks(), 2);
+
+    // Exact eigenpair of a diagonal matrix: no residual
+    VectorTest x = VectorTest::Unit(4, 2);
+    VectorTest Ax = 3.0 * x;
+    EXPECT_TRUE(monitor.CheckResidual(x, Ax, 3.0, 3.0));
+    EXPECT_FALSE(monitor.CheckResidual(x, Ax, 2.0, 2.0));
+    EXPECT_NEAR(monitor.GetError(), 0.5, 1e-12);
+
+    monitor.Reset();
+    EXPECT_EQ(monitor.GetChecks(), 0);
+    EXPECT_THROW(monitor.SetCriterion("norm"), std::invalid_argument);
+    EXPECT_THROW(monitor.SetCheckInterval(0), std::invalid_argument);
+}
+
+TEST_F(TridiagonalMatrixTest, ResidualNorms)
+{
+    Eigen::SelfAdjointEigenSolver<MatrixTest> eigenSolver(*matrix);
+    VectorTest residuals = ConvergenceMonitor<type_test>::ResidualNorms(*matrix, eigenSolver.eigenvalues(), eigenSolver.eigenvectors());
+    EXPECT_LT(residuals.maxCoeff(), 1e-12);
+}
+
+// The QR iterations of a tridiagonal matrix only monitor the subdiagonal
+TEST_F(TridiagonalMatrixTest, QrMethodSubdiagonal)
+{
+    for (int tileSize : {64, 8}) // Householder and tiled decompositions
+    {
+        QrMethodSolver<type_test> solver(tolerance, maxIter);
+        solver.SetTileSize(tileSize);
+        solver.SetMatrix(matrix);
+        VectorTest eigenvalues = solver.FindEigenvalues();
+        std::sort(eigenvalues.begin(), eigenvalues.end());
+        EXPECT_TRUE(eigenvalues.isApprox(expectedEigenvalues, 1e-8)) << "tile size: " << tileSize;
+        EXPECT_EQ(solver.GetReport().stoppingCriterion, "subdiagonal");
+        EXPECT_TRUE(solver.GetReport().converged);
+    }
+}
+
+// Checking every 5 iterations: the solve stops at a multiple of 5, with 5 times fewer checks
+TEST_F(HilbertMatrixTest, QrMethodCheckInterval)
+{
+    QrMethodSolver<type_test> solver(tolerance, maxIter);
+    solver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = solver.FindEigenvalues();
+    EXPECT_EQ(solver.GetReport().stoppingCriterion, "lower_part");
+    int iterations = solver.GetReport().iterations;
+
+    solver.SetCheckInterval(5);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    const SolverReport &report = solver.GetReport();
+    EXPECT_EQ(report.iterations % 5, 0);
+    EXPECT_GE(report.iterations, iterations);
+    EXPECT_LT(report.iterations, iterations + 5);
+    EXPECT_EQ(report.convergenceChecks, report.iterations / 5);
+    EXPECT_TRUE(eigenvalues.isApprox(expectedEigenvalues, 1e-8));
+}
+
+// The residual criterion stops when the eigenpair is accurate, whatever the change of the eigenvalue
+TEST_F(NearlyDegenerateMatrixTest, PowerMethodResidual)
+{
+    for (const std::string acceleration : {"none", "aitken", "chebyshev"})
+    {
+        PowerMethodSolver<type_test> solver(1e-8, maxIter, shift, acceleration);
+        solver.SetStoppingCriterion("residual");
+        solver.SetMatrix(matrix);
+        VectorTest eigenvalues = solver.FindEigenvalues();
+        const SolverReport &report = solver.GetReport();
+        EXPECT_TRUE(report.converged) << "acceleration: " << acceleration;
+        EXPECT_EQ(report.stoppingCriterion, "residual");
+        EXPECT_LE(report.finalError, 1e-8);
+        // Symmetric matrix: the eigenvalue error is bounded by the squared residual over the gap (0.02)
+        EXPECT_NEAR(eigenvalues(0), 1.0, 1e-12) << "acceleration: " << acceleration;
+    }
+}
+
+TEST_F(DiagonalMatrixTest, InversePowerMethodResidual)
+{
+    InversePowerMethodSolver<type_test> solver(1e-9, maxIter, 2.2);
+    solver.SetStoppingCriterion("residual");
+    solver.SetCheckInterval(2);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    EXPECT_NEAR(eigenvalues(0), 2.0, 1e-12);
+    EXPECT_TRUE(solver.GetReport().converged);
+    EXPECT_EQ(solver.GetReport().iterations % 2, 0);
+}
+
+// The Ritz values are only computed every few steps: the same eigenvalues, a few more steps
+TEST_F(LargeHilbertMatrixTest, LanczosMethodCheckInterval)
+{
+    LanczosSolver<type_test> solver(tolerance, maxIter);
+    solver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = solver.FindEigenvalues();
+    int checks = solver.GetReport().convergenceChecks;
+
+    solver.SetCheckInterval(4);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    // The extra steps may converge more eigenvalues
+    ASSERT_GE(eigenvalues.size(), expectedEigenvalues.size());
+    EXPECT_TRUE(eigenvalues.head(expectedEigenvalues.size()).isApprox(expectedEigenvalues, 1e-8));
+    EXPECT_LT(solver.GetReport().convergenceChecks, checks);
+    EXPECT_EQ(solver.GetReport().stoppingCriterion, "ritz_residual");
+}
+
+// The factory sets the stopping test of the solvers
+TEST(SolverFactoryTest, StoppingCriterion)
+{
+    SolverFactory<type_test> factory("power_method", {"1e-8", "100"}, "residual", 3);
+    std::unique_ptr<AbstractIterativeSolver<type_test>> solver = factory.ChooseSolver();
+    solver->SetMatrix(std::make_shared<MatrixTest>(MatrixTest::Identity(4, 4)));
+    solver->FindEigenvalues();
+    EXPECT_EQ(solver->GetReport().stoppingCriterion, "residual");
+    EXPECT_EQ(solver->GetReport().checkInterval, 3);
+
+    SolverFactory<type_test> invalidFactory("power_method", {}, "norm", 1);
+    EXPECT_THROW(invalidFactory.ChooseSolver(), std::invalid_argument);
+}
+
+// ****************
+// WARM START TESTS
+// ****************
+
+// The vectors and eigenvalues are read back exactly
+TEST(WarmStartTest, SaveAndLoad)
+{
+    WarmStart<type_test> warmStart;
+    warmStart.eigenvalues = VectorTest::Random(3);
+    warmStart.eigenvectors = MatrixTest::Random(5, 3);
+    const std::string fileName = "warm_start_test.txt";
+    SaveWarmStart(fileName, warmStart);
+    std::rename((Paths::PATH_OUTPUT_FILE + fileName).c_str(), (Paths::PATH_INPUT_FILE + fileName).c_str());
+
+    WarmStart<type_test> loaded = LoadWarmStart<type_test>(fileName);
+    std::remove((Paths::PATH_INPUT_FILE + fileName).c_str()); // Clean up the temporary file
+    EXPECT_EQ(loaded.eigenvalues, warmStart.eigenvalues);
+    EXPECT_EQ(loaded.eigenvectors, warmStart.eigenvectors);
+
+    EXPECT_THROW(LoadWarmStart<type_test>("missing_warm_start.txt"), FileException);
+}
+
+// The eigenvector of a slightly different matrix is a much better initial vector than the default one
+TEST_F(TridiagonalMatrixTest, PowerMethodWarmStart)
+{
+    PowerMethodSolver<type_test> solver(1e-8, maxIter, 0.0);
+    solver.SetExportVectors(true);
+    solver.SetMatrix(matrix);
+    solver.FindEigenvalues();
+    WarmStart<type_test> previous = solver.GetWarmStart();
+    ASSERT_EQ(previous.eigenvectors.rows(), size);
+    ASSERT_EQ(previous.eigenvectors.cols(), 1);
+
+    auto perturbed = std::make_shared<MatrixTest>(*matrix);
+    perturbed->diagonal() += 1e-6 * VectorTest::LinSpaced(size, 0.0, 1.0);
+    solver.SetMatrix(perturbed);
+    VectorTest expectedEigenvalues = solver.FindEigenvalues();
+    int coldIterations = solver.GetReport().iterations;
+    EXPECT_FALSE(solver.GetReport().warmStarted);
+
+    solver.SetWarmStart(previous);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    const SolverReport &report = solver.GetReport();
+    EXPECT_TRUE(report.warmStarted);
+    EXPECT_LT(10 * report.iterations, coldIterations);
+    EXPECT_NEAR(eigenvalues(0), expectedEigenvalues(0), 1e-6);
+    EXPECT_LT(report.warmStartChange, 1e-5);
+}
+
+// Starting from the Schur vectors of a nearby matrix, the QR iterate is nearly triangular from the start
+TEST_F(TridiagonalMatrixTest, QrMethodWarmStart)
+{
+    QrMethodSolver<type_test> solver(tolerance, maxIter);
+    solver.SetExportVectors(true);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    WarmStart<type_test> previous = solver.GetWarmStart();
+    // A = Z T Z^T, with T triangular (diagonal: symmetric matrix)
+    MatrixTest T = previous.eigenvectors.transpose() * *matrix * previous.eigenvectors;
+    EXPECT_TRUE(T.isApprox(MatrixTest(eigenvalues.asDiagonal()), 1e-8));
+
+    auto perturbed = std::make_shared<MatrixTest>(*matrix);
+    perturbed->diagonal() += 1e-6 * VectorTest::LinSpaced(size, 0.0, 1.0);
+    solver.SetMatrix(perturbed);
+    VectorTest expectedEigenvalues = solver.FindEigenvalues();
+    int coldIterations = solver.GetReport().iterations;
+
+    solver.SetWarmStart(previous);
+    eigenvalues = solver.FindEigenvalues();
+    EXPECT_TRUE(solver.GetReport().warmStarted);
+    EXPECT_LT(2 * solver.GetReport().iterations, coldIterations);
+    std::sort(eigenvalues.begin(), eigenvalues.end());
+    std::sort(expectedEigenvalues.begin(), expectedEigenvalues.end());
+    EXPECT_TRUE(eigenvalues.isApprox(expectedEigenvalues, 1e-8));
+}
+
+// The Lanczos method exports the Ritz vectors of its converged eigenvalues
+TEST_F(TridiagonalMatrixTest, LanczosMethodWarmStart)
+{
+    LanczosSolver<type_test> solver(tolerance, maxIter);
+    solver.SetExportVectors(true);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    WarmStart<type_test> previous = solver.GetWarmStart();
+    ASSERT_EQ(previous.eigenvectors.cols(), eigenvalues.size());
+    EXPECT_LT(ConvergenceMonitor<type_test>::ResidualNorms(*matrix, eigenvalues, previous.eigenvectors).maxCoeff(), 1e-8);
+
+    solver.SetWarmStart(previous);
+    VectorTest warmEigenvalues = solver.FindEigenvalues();
+    EXPECT_TRUE(solver.GetReport().warmStarted);
+    ASSERT_GE(warmEigenvalues.size(), 1);
+    EXPECT_NEAR(warmEigenvalues(0), expectedEigenvalues(size - 1), 1e-8);
+}
+
+TEST_F(TridiagonalMatrixTest, InvalidWarmStart)
+{
+    WarmStart<type_test> warmStart;
+    warmStart.eigenvectors = MatrixTest::Ones(size + 1, 1);
+    PowerMethodSolver<type_test> powerSolver(tolerance, maxIter, 0.0);
+    powerSolver.SetMatrix(matrix);
+    powerSolver.SetWarmStart(warmStart);
+    EXPECT_THROW(powerSolver.FindEigenvalues(), std::invalid_argument);
+
+    // The QR method needs a whole basis
+    warmStart.eigenvectors = MatrixTest::Identity(size, size - 1);
+    QrMethodSolver<type_test> qrSolver(tolerance, maxIter);
+    qrSolver.SetMatrix(matrix);
+    qrSolver.SetWarmStart(warmStart);
+    EXPECT_THROW(qrSolver.FindEigenvalues(), std::invalid_argument);
+}
+
+// *********************
+// PARAMETER SWEEP TESTS
+// *********************
+
+TEST(ParameterSweepTest, Assemble)
+{
+    std::vector<MatrixPointer<type_test>> terms;
+    for (int k = 0; k < 3; ++k)
+        terms.push_back(std::make_shared<MatrixTest>(MatrixTest::Random(4, 4)));
+    ParameterSweep<type_test> sweep(terms, -1.0, 1.0, 5);
+    EXPECT_TRUE(sweep.GetParameters().isApprox(VectorTest::LinSpaced(5, -1.0, 1.0)));
+
+    MatrixTest A;
+    sweep.Assemble(0.5, A);
+    EXPECT_TRUE(A.isApprox(*terms[0] + 0.5 * *terms[1] + 0.25 * *terms[2]));
+}
+
+TEST(ParameterSweepTest, InvalidArguments)
+{
+    std::vector<MatrixPointer<type_test>> terms = {std::make_shared<MatrixTest>(MatrixTest::Identity(4, 4)),
+                                                   std::make_shared<MatrixTest>(MatrixTest::Identity(5, 5))};
+    EXPECT_THROW(ParameterSweep<type_test>(terms, 0.0, 1.0, 10), std::invalid_argument);
+    terms.pop_back();
+    EXPECT_THROW(ParameterSweep<type_test>(terms, 0.0, 1.0, 0), std::invalid_argument);
+    EXPECT_THROW(ParameterSweep<type_test>::FromArgs({"0.0", "1.0", "10", "A.txt"}), std::invalid_argument);
+    EXPECT_THROW(ParameterSweep<type_test>::FromArgs({"0.0", "one", "10", "A.txt", "A.txt"}), std::invalid_argument);
+}
+
+// A(t) = A_0 + t D: the continuation saves iterations, and the segments give the same eigenvalues
+TEST_F(TridiagonalMatrixTest, PowerMethodSweep)
+{
+    // The diagonal terms break the symmetry of T, whose dominant eigenvector is orthogonal to the initial vector
+    auto A0 = std::make_shared<MatrixTest>(*matrix);
+    A0->diagonal() += VectorTest::LinSpaced(size, 0.0, 0.5);
+    auto D = std::make_shared<MatrixTest>(VectorTest::LinSpaced(size, 0.01, 0.0).asDiagonal());
+    ParameterSweep<type_test> sweep({A0, D}, 0.0, 1.0, 40);
+    SolverFactory<type_test> factory("power_method", {"1e-8", "20000"}, "residual");
+
+    SweepResult<type_test> independent = sweep.Run(factory, 1, false);
+    SweepResult<type_test> continued = sweep.Run(factory, 1, true);
+    SweepResult<type_test> parallel = sweep.Run(factory, 4, true);
+    EXPECT_EQ(parallel.segments, 4);
+    ASSERT_EQ(continued.eigenvalues.rows(), 40);
+    ASSERT_EQ(continued.eigenvalues.cols(), 1);
+    int independentIterations = std::accumulate(independent.iterations.begin(), independent.iterations.end(), 0);
+    int continuedIterations = std::accumulate(continued.iterations.begin(), continued.iterations.end(), 0);
+    EXPECT_LT(2 * continuedIterations, independentIterations) << continuedIterations << " / " << independentIterations;
+
+    for (int i = 0; i < 40; ++i)
+    {
+        MatrixTest A;
+        sweep.Assemble(sweep.GetParameters()(i), A);
+        type_test largest = Eigen::SelfAdjointEigenSolver<MatrixTest>(A).eigenvalues()(size - 1);
+        EXPECT_NEAR(continued.eigenvalues(i, 0), largest, 1e-8) << "parameter: " << sweep.GetParameters()(i);
+        EXPECT_NEAR(parallel.eigenvalues(i, 0), largest, 1e-8) << "parameter: " << sweep.GetParameters()(i);
+    }
+
+    std::ostringstream table;
+    continued.WriteTable(table);
+    std::string text = table.str();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 41); // Header and one line per parameter
+}
+
+// The shift of the inverse power method follows the eigenvalue 1 + 2t away from the initial shift
+TEST(ParameterSweepTest, InversePowerMethodTracking)
+{
+    VectorTest diagonal(4);
+    diagonal << 0.5, 1.0, 4.0, 5.0;
+    auto A0 = std::make_shared<MatrixTest>(diagonal.asDiagonal());
+    auto A1 = std::make_shared<MatrixTest>(MatrixTest::Zero(4, 4));
+    (*A1)(1, 1) = 2.0;
+    ParameterSweep<type_test> sweep({A0, A1}, 0.0, 0.9, 19);
+    SolverFactory<type_test> factory("inverse_power_method", {"1e-12", "1000", "0.87"});
+
+    SweepResult<type_test> continued = sweep.Run(factory, 1, true);
+    for (int i = 0; i < 19; ++i)
+        EXPECT_NEAR(continued.eigenvalues(i, 0), 1.0 + 2.0 * sweep.GetParameters()(i), 1e-8);
+
+    // Without continuation, the fixed shift finds the eigenvalue 0.5 once 1 + 2t is further from it
+    ParameterSweep<type_test> lastPoint({A0, A1}, 0.9, 0.9, 1);
+    SweepResult<type_test> independent = lastPoint.Run(factory, 1, false);
+    EXPECT_NEAR(independent.eigenvalues(0, 0), 0.5, 1e-8);
+}
+
+// ***************
+// TELEMETRY TESTS
+// ***************
+
+// The buffer keeps the last samples
+TEST(TelemetryTest, RingBuffer)
+{
+    ConvergenceTelemetry<type_test> telemetry(3);
+    for (int i = 1; i <= 5; ++i)
+        telemetry.Record(i, 10.0 * i, i == 1 ? std::numeric_limits<double>::infinity() : 1.0 / i);
+    EXPECT_EQ(telemetry.Size(), 3);
+    EXPECT_EQ(telemetry.Recorded(), 5);
+    EXPECT_EQ(telemetry.Get(0).iteration, 3);
+    EXPECT_EQ(telemetry.Get(2).iteration, 5);
+    EXPECT_EQ(telemetry.Get(2).estimate, 50.0);
+
+    std::ostringstream csv;
+    telemetry.WriteCsv(csv);
+    std::string text = csv.str();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 4); // Header and one line per sample
+    EXPECT_EQ(text.rfind("iteration,estimate,error,seconds\n", 0), 0);
+
+    // JSON has no infinity
+    telemetry.Start();
+    EXPECT_EQ(telemetry.Size(), 0);
+    telemetry.Record(1, 1.0, std::numeric_limits<double>::infinity());
+    std::ostringstream json;
+    telemetry.WriteJson(json, "power_method");
+    EXPECT_NE(json.str().find("\"error\": null"), std::string::npos);
+    EXPECT_NE(json.str().find("\"solver\": \"power_method\""), std::string::npos);
+
+    EXPECT_THROW(telemetry.Save("history.txt", "power_method"), std::invalid_argument);
+    EXPECT_THROW(ConvergenceTelemetry<type_test>(0), std::invalid_argument);
+}
+
+// One sample per iteration, converging to the eigenvalue
+TEST_F(HilbertMatrixTest, PowerMethodTelemetry)
+{
+    if (!Telemetry::ENABLED)
+        GTEST_SKIP() << "The telemetry is compiled out";
+    PowerMethodSolver<type_test> solver(tolerance, maxIter, 0.0);
+    solver.SetMatrix(matrix);
+    EXPECT_EQ(solver.GetTelemetry(), nullptr);
+    solver.EnableTelemetry();
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    const ConvergenceTelemetry<type_test> &telemetry = *solver.GetTelemetry();
+    ASSERT_EQ(telemetry.Size(), solver.GetReport().iterations);
+    EXPECT_EQ(telemetry.Get(telemetry.Size() - 1).estimate, eigenvalues(0));
+    EXPECT_LE(telemetry.Get(telemetry.Size() - 1).error, tolerance);
+    for (int i = 1; i < telemetry.Size(); ++i)
+    {
+        EXPECT_EQ(telemetry.Get(i).iteration, i + 1);
+        EXPECT_GE(telemetry.Get(i).seconds, telemetry.Get(i - 1).seconds);
+    }
+
+    // A new solve starts a new history
+    solver.FindEigenvalues();
+    EXPECT_EQ(telemetry.Size(), solver.GetReport().iterations);
+}
+
+TEST_F(HilbertMatrixTest, QrAndLanczosTelemetry)
+{
+    if (!Telemetry::ENABLED)
+        GTEST_SKIP() << "The telemetry is compiled out";
+    QrMethodSolver<type_test> qrSolver(tolerance, maxIter);
+    qrSolver.SetMatrix(matrix);
+    qrSolver.EnableTelemetry();
+    qrSolver.FindEigenvalues();
+    EXPECT_EQ(qrSolver.GetTelemetry()->Size(), qrSolver.GetReport().iterations);
+
+    // The Lanczos method records the steps computing the Ritz values
+    LanczosSolver<type_test> lanczosSolver(tolerance, maxIter);
+    lanczosSolver.SetMatrix(matrix);
+    lanczosSolver.EnableTelemetry();
+    lanczosSolver.FindEigenvalues();
+    EXPECT_EQ(lanczosSolver.GetTelemetry()->Size(), lanczosSolver.GetReport().convergenceChecks);
+}
+
+// ******************
+// BATCH SOLVER TESTS
+// ******************
+
+// A batch of random symmetric matrices of each size, with a number of matrices that is not a multiple of the lanes
+MatrixBatch<type_test> RandomSymmetricBatch(int count, int size)
+{
+    MatrixBatch<type_test> batch(count, size);
+    for (int matrix = 0; matrix < count; ++matrix)
+    {
+        MatrixTest A = MatrixTest::Random(size, size);
+        Eigen::Map<Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(batch.Data(matrix), size, size) = A + A.transpose();
+    }
+    return batch;
+}
+
+// The eigenvalues of each matrix are the ones of Eigen, with each instruction set (one matrix per lane)
+TEST(BatchSolverTest, SymmetricMatrices)
+{
+    for (SimdKernels::Isa isa : SimdKernels::SupportedIsas())
+    {
+        SimdKernels::SetIsa(isa);
+        for (int size : {3, 4, 7, 16})
+        {
+            MatrixBatch<type_test> batch = RandomSymmetricBatch(37, size);
+            ASSERT_TRUE(batch.IsSymmetric());
+            BatchResult<type_test> result = BatchSolver<type_test>(1e-12, 50).Solve(batch);
+            EXPECT_EQ(result.kernel, "jacobi");
+            EXPECT_EQ(result.Unconverged(), 0);
+            for (int matrix = 0; matrix < batch.count; ++matrix)
+            {
+                MatrixTest A = Eigen::Map<const Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(batch.Data(matrix), size, size);
+                VectorTest expected = Eigen::SelfAdjointEigenSolver<MatrixTest>(A).eigenvalues().reverse();
+                EXPECT_LT((result.eigenvalues.row(matrix).transpose() - expected).norm(), 1e-10 * A.norm()) << SimdKernels::IsaName(isa) << ", size " << size << ", matrix " << matrix;
+            }
+        }
+    }
+    SimdKernels::SetIsa(SimdKernels::DetectIsa());
+}
+
+// General matrices S D S^-1 with real distinct eigenvalues: the QR kernel finds D
+TEST(BatchSolverTest, GeneralMatrices)
+{
+    const int size = 5;
+    VectorTest D(size);
+    D << 5.0, 3.0, 1.5, 0.25, -0.75; // Decreasing, as the eigenvalues of the result
+    MatrixBatch<type_test> batch(11, size);
+    for (int matrix = 0; matrix < batch.count; ++matrix)
+    {
+        MatrixTest S = MatrixTest::Random(size, size) + 3.0 * MatrixTest::Identity(size, size);
+        Eigen::Map<Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(batch.Data(matrix), size, size) = S * D.asDiagonal() * S.inverse();
+    }
+    for (SimdKernels::Isa isa : SimdKernels::SupportedIsas())
+    {
+        SimdKernels::SetIsa(isa);
+        BatchResult<type_test> result = BatchSolver<type_test>(1e-12, 1000).Solve(batch);
+        EXPECT_EQ(result.kernel, "qr");
+        EXPECT_EQ(result.Unconverged(), 0);
+        for (int matrix = 0; matrix < batch.count; ++matrix)
+            EXPECT_LT((result.eigenvalues.row(matrix).transpose() - D).norm(), 1e-8) << SimdKernels::IsaName(isa) << ", matrix " << matrix;
+    }
+    SimdKernels::SetIsa(SimdKernels::DetectIsa());
+
+    // The QR kernel also solves symmetric matrices
+    MatrixBatch<type_test> symmetric = RandomSymmetricBatch(5, 4);
+    BatchResult<type_test> jacobi = BatchSolver<type_test>(1e-12, 50).Solve(symmetric);
+    BatchResult<type_test> qr = BatchSolver<type_test>(1e-12, 5000, "general").Solve(symmetric);
+    EXPECT_EQ(qr.kernel, "qr");
+    EXPECT_LT((jacobi.eigenvalues - qr.eigenvalues).norm(), 1e-8);
+}
+
+TEST(BatchSolverTest, InvalidArguments)
+{
+    EXPECT_THROW(BatchSolver<type_test>(0.0, 10), std::invalid_argument);
+    EXPECT_THROW(BatchSolver<type_test>(1e-6, 0), std::invalid_argument);
+    EXPECT_THROW(BatchSolver<type_test>(1e-6, 10, "hermitian"), std::invalid_argument);
+    EXPECT_THROW(BatchSolver<type_test>::FromArgs({"1e-6", "ten"}, {"batch.txt"}), std::invalid_argument);
+    EXPECT_THROW(BatchSolver<type_test>::FromArgs({"1e-6", "10"}, {}), std::invalid_argument);
+    EXPECT_NO_THROW(BatchSolver<type_test>::FromArgs({"1e-6", "10"}, {"batch.txt", "symmetric"}));
+}
+
+// The file holds the number of matrices, their size and their entries, with comments
+TEST(BatchSolverTest, ReadFile)
+{
+    const std::string fileName = "batch_solver_test.txt";
+    std::ofstream file(Paths::PATH_MATRICES + fileName);
+    file << "# Two 2x2 matrices\n2 2\n2 1\n1 2\n\n% Second matrix\n4 0 0 -1\n";
+    file.close();
+    MatrixBatch<type_test> batch = MatrixBatch<type_test>::FromFile(fileName);
+    EXPECT_EQ(batch.count, 2);
+    EXPECT_EQ(batch.size, 2);
+    EXPECT_EQ(batch.entries, std::vector<type_test>({2, 1, 1, 2, 4, 0, 0, -1}));
+    BatchResult<type_test> result = BatchSolver<type_test>(1e-12, 50).Solve(batch);
+    EXPECT_NEAR(result.eigenvalues(0, 0), 3.0, 1e-12);
+    EXPECT_NEAR(result.eigenvalues(0, 1), 1.0, 1e-12);
+    EXPECT_NEAR(result.eigenvalues(1, 1), -1.0, 1e-12);
+
+    file.open(Paths::PATH_MATRICES + fileName);
+    file << "2 2\n1 2 3 4 5 6 7\n"; // One entry missing
+    file.close();
+    EXPECT_THROW(MatrixBatch<type_test>::FromFile(fileName), FileException);
+    std::remove((Paths::PATH_MATRICES + fileName).c_str()); // Clean up the temporary file
+    EXPECT_THROW(MatrixBatch<type_test>::FromFile(fileName), FileException);
+}
+
+// ************************
+// FIXED-SIZE SOLVER TESTS
+// ************************
+
+// The factory instantiates the solvers of the size of the small matrices when it is given
+TEST(SolverFactoryTest, FixedSizeSolvers)
+{
+    auto isFixed = [](const std::string &method, const std::vector<std::string> &args, int size)
+    {
+        std::unique_ptr<AbstractIterativeSolver<type_test>> solver = SolverFactory<type_test>(method, args).ChooseSolver(size);
+        return dynamic_cast<QrMethodSolver<type_test> *>(solver.get()) == nullptr && dynamic_cast<PowerMethodSolver<type_test> *>(solver.get()) == nullptr;
+    };
+    EXPECT_TRUE(isFixed("QR_method", {"1e-6", "100"}, 2));
+    EXPECT_TRUE(isFixed("power_method", {"1e-6", "100"}, DefaultSolverArgs::MAX_FIXED_SIZE));
+    EXPECT_FALSE(isFixed("QR_method", {"1e-6", "100"}, 0));
+    EXPECT_FALSE(isFixed("QR_method", {"1e-6", "100"}, 1));
+    EXPECT_FALSE(isFixed("QR_method", {"1e-6", "100"}, DefaultSolverArgs::MAX_FIXED_SIZE + 1));
+    EXPECT_FALSE(isFixed("power_method", {"1e-6", "100", "0.0", "aitken"}, 4));
+    EXPECT_EQ(CreateFixedSizeSolver<type_test>("lanczos_method", 4, 1e-6, 100, 0.0), nullptr);
+}
+
+// Same eigenvalues and iterations as the dynamic-size solvers, for all the sizes
+TEST(FixedSizeSolverTest, SameAsDynamic)
+{
+    for (int n = 2; n <= DefaultSolverArgs::MAX_FIXED_SIZE; ++n)
+    {
+        // Symmetric positive definite, with well separated eigenvalues
+        MatrixTest B = MatrixTest::Random(n, n);
+        VectorTest D = VectorTest::LinSpaced(n, 2.0 * n, 2.0);
+        Eigen::HouseholderQR<MatrixTest> qr(B);
+        MatrixTest V = qr.householderQ();
+        auto matrix = std::make_shared<MatrixTest>(V * D.asDiagonal() * V.transpose());
+
+        for (const std::string &method : {"QR_method", "power_method"})
+        {
+            SolverFactory<type_test> factory(method, {"1e-10", "2000", "0.5"});
+            std::unique_ptr<AbstractIterativeSolver<type_test>> fixed = factory.ChooseSolver(n);
+            std::unique_ptr<AbstractIterativeSolver<type_test>> dynamic = factory.ChooseSolver();
+            fixed->SetMatrix(matrix);
+            dynamic->SetMatrix(matrix);
+            VectorTest fixedEigenvalues = fixed->FindEigenvalues();
+            VectorTest dynamicEigenvalues = dynamic->FindEigenvalues();
+            ASSERT_EQ(fixedEigenvalues.size(), dynamicEigenvalues.size());
+            EXPECT_LT((fixedEigenvalues - dynamicEigenvalues).cwiseAbs().maxCoeff(), 1e-8 * n) << method << ", size " << n;
+            EXPECT_TRUE(fixed->GetReport().converged);
+            EXPECT_NEAR(fixed->GetReport().iterations, dynamic->GetReport().iterations, 1) << method << ", size " << n;
+        }
+    }
+}
+
+TEST_F(HilbertMatrixTest, FixedSizeQrMethodVectors)
+{
+    std::unique_ptr<AbstractIterativeSolver<type_test>> solver = SolverFactory<type_test>("QR_method", {"1e-12", "1000"}).ChooseSolver(size);
+    solver->SetExportVectors(true);
+    solver->SetMatrix(matrix);
+    VectorTest eigenvalues = solver->FindEigenvalues();
+
+    // The Schur vectors of a symmetric matrix are its eigenvectors
+    const MatrixTest &Z = solver->GetWarmStart().eigenvectors;
+    EXPECT_TRUE((Z.transpose() * Z).isIdentity(1e-10));
+    EXPECT_LT(((*matrix) * Z - Z * eigenvalues.asDiagonal()).norm(), 1e-10);
+
+    // The warm start from the vectors of the solve converges at once
+    WarmStart<type_test> warmStart = solver->GetWarmStart();
+    solver->SetWarmStart(warmStart);
+    solver->SetMatrix(matrix);
+    solver->FindEigenvalues();
+    EXPECT_TRUE(solver->GetReport().warmStarted);
+    EXPECT_LE(solver->GetReport().iterations, 2);
+}
+
+TEST_F(HilbertMatrixTest, FixedSizeInvalidMatrix)
+{
+    std::unique_ptr<AbstractIterativeSolver<type_test>> solver = SolverFactory<type_test>("power_method", {}).ChooseSolver(size + 1);
+    solver->SetMatrix(matrix);
+    EXPECT_THROW(solver->FindEigenvalues(), std::invalid_argument);
+}
+
+// *******************
+// JACOBI METHOD TESTS
+// *******************
+
+// Every pair of indices is in one round, and the pairs of a round have no common index
+TEST(JacobiSolverTest, RoundRobinPairs)
+{
+    for (int n : {1, 2, 7, 8})
+    {
+        std::vector<std::vector<std::pair<int, int>>> rounds = JacobiSolver<type_test>::RoundRobinPairs(n);
+        EXPECT_EQ(static_cast<int>(rounds.size()), n % 2 == 0 ? n - 1 : n);
+        std::set<std::pair<int, int>> pairs;
+        for (const std::vector<std::pair<int, int>> &round : rounds)
+        {
+            EXPECT_EQ(static_cast<int>(round.size()), n / 2);
+            std::set<int> indices;
+            for (const auto &[p, q] : round)
+            {
+                EXPECT_LT(p, q);
+                EXPECT_TRUE(indices.insert(p).second && indices.insert(q).second) << "size " << n;
+                EXPECT_TRUE(pairs.insert({p, q}).second) << "size " << n;
+            }
+        }
+        EXPECT_EQ(static_cast<int>(pairs.size()), n * (n - 1) / 2);
+    }
+}
+
+TEST_F(HilbertMatrixTest, JacobiMethod)
+{
+    JacobiSolver<type_test> solver(tolerance, maxIter);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic>> eigenSolver(*matrix);
+    VectorTest expectedEigenvalues = eigenSolver.eigenvalues().reverse();
+    EXPECT_TRUE(solver.GetReport().converged);
+    EXPECT_LT((eigenvalues - expectedEigenvalues).cwiseAbs().maxCoeff(), 1e-12);
+}
+
+TEST_F(LargeHilbertMatrixTest, JacobiMethod)
+{
+    std::unique_ptr<AbstractIterativeSolver<type_test>> solver = SolverFactory<type_test>("jacobi_method", {"1e-10", "100"}).ChooseSolver();
+    solver->SetMatrix(matrix);
+    VectorTest eigenvalues = solver->FindEigenvalues();
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix<type_test, Eigen::Dynamic, Eigen::Dynamic>> eigenSolver(*matrix);
+    VectorTest expectedEigenvalues = eigenSolver.eigenvalues().reverse();
+    EXPECT_EQ(solver->GetReport().stoppingCriterion, "relative_offdiagonal");
+    EXPECT_LT((eigenvalues - expectedEigenvalues).cwiseAbs().maxCoeff(), 1e-12);
+}
+
+// Graded matrix D K D, with K = (0.5^|i - j|) and D = diag(10^(i - n + 1)): the eigenvalues range from 1 to 1e-22.
+// The smallest one is the inverse of the largest eigenvalue of D^-1 K^-1 D^-1 (K^-1 is tridiagonal), which has a
+// small relative error. The Jacobi method finds it with a relative error close to the machine epsilon.
+TEST(JacobiSolverTest, GradedMatrix)
+{
+    const int size = 12;
+    const type_test rho = 0.5;
+    VectorTest d(size);
+    for (int i = 0; i < size; ++i)
+        d(i) = std::pow(10.0, i - size + 1);
+    auto matrix = std::make_shared<MatrixTest>(size, size);
+    MatrixTest inverse = MatrixTest::Zero(size, size);
+    for (int i = 0; i < size; ++i)
+    {
+        for (int j = 0; j < size; ++j)
+            (*matrix)(i, j) = std::pow(rho, std::abs(i - j)) * d(i) * d(j);
+        inverse(i, i) = (i == 0 || i == size - 1 ? 1.0 : 1.0 + rho * rho) / ((1.0 - rho * rho) * d(i) * d(i));
+        if (i + 1 < size)
+            inverse(i, i + 1) = inverse(i + 1, i) = -rho / ((1.0 - rho * rho) * d(i) * d(i + 1));
+    }
+    type_test largest = Eigen::SelfAdjointEigenSolver<MatrixTest>(*matrix).eigenvalues().maxCoeff();
+    type_test smallest = 1.0 / Eigen::SelfAdjointEigenSolver<MatrixTest>(inverse).eigenvalues().maxCoeff();
+
+    JacobiSolver<type_test> solver(1e-15, 100);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    EXPECT_TRUE(solver.GetReport().converged);
+    EXPECT_LT(std::abs(eigenvalues(0) / largest - 1.0), 1e-13);
+    EXPECT_LT(std::abs(eigenvalues(size - 1) / smallest - 1.0), 1e-13);
+    EXPECT_TRUE((eigenvalues.array() > 0).all());
+}
+
+// The rotations of a round are independent: the result does not depend on the number of threads
+TEST(JacobiSolverTest, Threads)
+{
+    const int size = 200;
+    MatrixTest B = MatrixTest::Random(size, size);
+    auto matrix = std::make_shared<MatrixTest>(B + B.transpose());
+    VectorTest eigenvalues[2];
+    for (int threads : {1, 4})
+    {
+        TaskScheduler::Instance().SetNumWorkers(threads);
+        JacobiSolver<type_test> solver(1e-12, 100);
+        solver.SetMatrix(matrix);
+        eigenvalues[threads == 4] = solver.FindEigenvalues();
+        EXPECT_TRUE(solver.GetReport().converged);
+    }
+    TaskScheduler::Instance().SetNumWorkers(1);
+    EXPECT_EQ(eigenvalues[0], eigenvalues[1]);
+    VectorTest expectedEigenvalues = Eigen::SelfAdjointEigenSolver<MatrixTest>(*matrix).eigenvalues().reverse();
+    EXPECT_LT((eigenvalues[0] - expectedEigenvalues).cwiseAbs().maxCoeff(), 1e-10);
+}
+
+// The Jacobi method exports the eigenvectors, and converges in a few sweeps from those of a nearby matrix
+TEST_F(TridiagonalMatrixTest, JacobiMethodWarmStart)
+{
+    JacobiSolver<type_test> solver(tolerance, maxIter);
+    solver.SetExportVectors(true);
+    solver.SetMatrix(matrix);
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    EXPECT_TRUE(eigenvalues.reverse().isApprox(expectedEigenvalues, 1e-10));
+    WarmStart<type_test> previous = solver.GetWarmStart();
+    EXPECT_LT(ConvergenceMonitor<type_test>::ResidualNorms(*matrix, eigenvalues, previous.eigenvectors).maxCoeff(), 1e-8);
+
+    auto perturbed = std::make_shared<MatrixTest>(*matrix);
+    perturbed->diagonal() += 1e-6 * VectorTest::LinSpaced(size, 0.0, 1.0);
+    solver.SetMatrix(perturbed);
+    VectorTest expected = solver.FindEigenvalues();
+    int coldIterations = solver.GetReport().iterations;
+
+    solver.SetWarmStart(previous);
+    eigenvalues = solver.FindEigenvalues();
+    EXPECT_TRUE(solver.GetReport().warmStarted);
+    EXPECT_LT(solver.GetReport().iterations, coldIterations);
+    EXPECT_TRUE(eigenvalues.isApprox(expected, 1e-10));
+}
+
+TEST_F(LargeHilbertMatrixTest, JacobiMethodInPlace)
+{
+    JacobiSolver<type_test> solver(tolerance, maxIter);
+    solver.SetMatrix(matrix);
+    VectorTest expectedEigenvalues = solver.FindEigenvalues();
+
+    solver.TakeMatrix(std::make_shared<MatrixTest>(*matrix));
+    VectorTest eigenvalues = solver.FindEigenvalues();
+    EXPECT_EQ(eigenvalues, expectedEigenvalues);
+    EXPECT_FALSE(solver.HasMatrix());
+}
+
+TEST(JacobiSolverTest, NonSymmetricMatrix)
+{
+    auto matrix = std::make_shared<MatrixTest>(MatrixTest::Identity(4, 4));
+    (*matrix)(0, 3) = 1.0;
+    JacobiSolver<type_test> solver(1e-10, 100);
+    solver.SetMatrix(matrix);
+    EXPECT_THROW(solver.FindEigenvalues(), SolverException);
+}
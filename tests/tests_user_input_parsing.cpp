@@ -142,4 +142,183 @@ TEST(parse_user_args, invalid_output_type)
 
     // Clean up the temporary file
     std::remove(invalid_yaml_file.c_str());
-}
\ No newline at end of file
+}
+TEST(parse_user_args, valid_threads_option)
+{
+    // Create a temporary YAML file with the optional options section
+    const std::string yaml_file_name = "valid_input.yaml";
+    std::ofstream yaml_file(yaml_file_name);
+    yaml_file << "input:\n"
+                 "  type: file\n"
+                 "  input_args:\n"
+                 "    - A.csv\n"
+                 "type: double\n"
+                 "method:\n"
+                 "  name: power_method\n"
+                 "  method_args:\n"
+                 "    - 10e-6\n"
+                 "output:\n"
+                 "  type: print\n"
+                 "  output_args:\n"
+                 "    -\n"
+                 "options:\n"
+                 "  threads: 4\n";
+    yaml_file.close();
+
+    Config config = parseYAML(yaml_file_name);
+    EXPECT_EQ(config.options.threads, 4);
+
+    // Clean up the temporary file
+    std::remove(yaml_file_name.c_str());
+}
+
+TEST(parse_user_args, invalid_option)
+{
+    // Create a temporary YAML file with an invalid option
+    const std::string invalid_yaml_file = "invalid_input.yaml";
+    std::ofstream yaml_file(invalid_yaml_file);
+    yaml_file << "input:\n"
+                 "  type: file\n"
+                 "  input_args:\n"
+                 "    - A.csv\n"
+                 "type: double\n"
+                 "method:\n"
+                 "  name: power_method\n"
+                 "  method_args:\n"
+                 "    - 10e-6\n"
+                 "output:\n"
+                 "  type: print\n"
+                 "  output_args:\n"
+                 "    -\n"
+                 "options:\n"
+                 "  invalid_option: 4\n"; // invalid option
+    yaml_file.close();
+
+    // Make sure that parseYAML throws an exception
+    EXPECT_THROW(parseYAML(invalid_yaml_file), std::invalid_argument);
+
+    // Clean up the temporary file
+    std::remove(invalid_yaml_file.c_str());
+}
+
+TEST(parse_user_args, invalid_threads_option)
+{
+    // Create a temporary YAML file with a negative number of threads
+    const std::string invalid_yaml_file = "invalid_input.yaml";
+    std::ofstream yaml_file(invalid_yaml_file);
+    yaml_file << "input:\n"
+                 "  type: file\n"
+                 "  input_args:\n"
+                 "    - A.csv\n"
+                 "type: double\n"
+                 "method:\n"
+                 "  name: power_method\n"
+                 "  method_args:\n"
+                 "    - 10e-6\n"
+                 "output:\n"
+                 "  type: print\n"
+                 "  output_args:\n"
+                 "    -\n"
+                 "options:\n"
+                 "  threads: -2\n"; // invalid number of threads
+    yaml_file.close();
+
+    // Make sure that parseYAML throws an exception
+    EXPECT_THROW(parseYAML(invalid_yaml_file), std::invalid_argument);
+
+    // Clean up the temporary file
+    std::remove(invalid_yaml_file.c_str());
+}
+
+TEST(parse_user_args, invalid_storage_option)
+{
+    // Create a temporary YAML file with an unsupported storage type
+    const std::string invalid_yaml_file = "invalid_input.yaml";
+    std::ofstream yaml_file(invalid_yaml_file);
+    yaml_file << "input:\n"
+                 "  type: file\n"
+                 "  input_args:\n"
+                 "    - A.csv\n"
+                 "type: double\n"
+                 "method:\n"
+                 "  name: power_method\n"
+                 "  method_args:\n"
+                 "    - 10e-6\n"
+                 "output:\n"
+                 "  type: print\n"
+                 "  output_args:\n"
+                 "    -\n"
+                 "options:\n"
+                 "  storage: int8\n"; // unsupported storage type
+    yaml_file.close();
+
+    // Make sure that parseYAML throws an exception
+    EXPECT_THROW(parseYAML(invalid_yaml_file), std::invalid_argument);
+
+    // Clean up the temporary file
+    std::remove(invalid_yaml_file.c_str());
+}
+
+TEST(parse_user_args, invalid_simd_option)
+{
+    // Create a temporary YAML file with an unknown instruction set
+    const std::string invalid_yaml_file = "invalid_input.yaml";
+    std::ofstream yaml_file(invalid_yaml_file);
+    yaml_file << "input:\n"
+                 "  type: file\n"
+                 "  input_args:\n"
+                 "    - A.csv\n"
+                 "type: double\n"
+                 "method:\n"
+                 "  name: power_method\n"
+                 "  method_args:\n"
+                 "    - 10e-6\n"
+                 "output:\n"
+                 "  type: print\n"
+                 "  output_args:\n"
+                 "    -\n"
+                 "options:\n"
+                 "  simd: sse9\n"; // unknown instruction set
+    yaml_file.close();
+
+    // Make sure that parseYAML throws an exception
+    EXPECT_THROW(parseYAML(invalid_yaml_file), std::invalid_argument);
+
+    // Clean up the temporary file
+    std::remove(invalid_yaml_file.c_str());
+}
+
+TEST(parse_user_args, sweep_input)
+{
+    // Create a temporary YAML file with a parameter sweep
+    const std::string yaml_file_name = "sweep_input.yaml";
+    std::ofstream yaml_file(yaml_file_name);
+    yaml_file << "input:\n"
+                 "  type: sweep\n"
+                 "  input_args:\n"
+                 "    - 0.0\n"
+                 "    - 1.0\n"
+                 "    - 101\n"
+                 "    - A.txt\n"
+                 "    - A.csv\n"
+                 "type: double\n"
+                 "method:\n"
+                 "  name: power_method\n"
+                 "  method_args:\n"
+                 "    - 10e-6\n"
+                 "output:\n"
+                 "  type: print\n"
+                 "  output_args:\n"
+                 "    -\n"
+                 "options:\n"
+                 "  sweep_segments: 4\n";
+    yaml_file.close();
+
+    Config config = parseYAML(yaml_file_name);
+    EXPECT_EQ(config.input.type, "sweep");
+    EXPECT_EQ(config.input.inputArgs.size(), 5);
+    EXPECT_EQ(config.options.sweepSegments, 4);
+
+    // Clean up the temporary file
+    std::remove(yaml_file_name.c_str());
+}